@@ -1661,8 +1661,16 @@ void CodeGenModule::SetLLVMFunctionAttributesForDefinition(const Decl *D,
 
     if (D->hasAttr<MinSizeAttr>())
       B.addAttribute(llvm::Attribute::MinSize);
+
+    if (D->hasAttr<ThreadedDispatchAttr>())
+      B.addAttribute("threaded-dispatch");
   }
 
+  if (const auto *IBM = D->getAttr<IndirectBranchMitigationAttr>())
+    B.addAttribute("indirect-branch-mitigation",
+                   IndirectBranchMitigationAttr::ConvertMitigationKindToStr(
+                       IBM->getMitigation()));
+
   F->addAttributes(llvm::AttributeList::FunctionIndex, B);
 
   unsigned alignment = D->getMaxAlignment() / Context.getCharWidth();
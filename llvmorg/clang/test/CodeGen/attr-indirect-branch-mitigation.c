@@ -0,0 +1,14 @@
+// RUN: %clang_cc1 -triple x86_64-unknown-linux-gnu -emit-llvm %s -o - | FileCheck %s
+
+// CHECK: define{{.*}} void @lfence() [[LFENCE:#[0-9]+]]
+void __attribute__((indirect_branch_mitigation(lfence))) lfence(void) {}
+
+// CHECK: define{{.*}} void @retpoline() [[RETPOLINE:#[0-9]+]]
+void __attribute__((indirect_branch_mitigation(retpoline))) retpoline(void) {}
+
+// CHECK: define{{.*}} void @plain() [[PLAIN:#[0-9]+]]
+void plain(void) {}
+
+// CHECK: attributes [[LFENCE]] = {{{.*}} "indirect-branch-mitigation"="lfence"
+// CHECK: attributes [[RETPOLINE]] = {{{.*}} "indirect-branch-mitigation"="retpoline"
+// CHECK-NOT: attributes [[PLAIN]] = {{{.*}} "indirect-branch-mitigation"
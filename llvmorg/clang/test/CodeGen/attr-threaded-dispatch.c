@@ -0,0 +1,21 @@
+// RUN: %clang_cc1 -triple x86_64-unknown-linux-gnu -O2 -disable-llvm-passes -emit-llvm %s -o - | FileCheck %s
+
+// CHECK: define{{.*}} i32 @run(i8* %pc) [[THREADED:#[0-9]+]]
+int __attribute__((threaded_dispatch)) run(const unsigned char *pc) {
+  int acc = 0;
+  for (;;) {
+    switch (*pc++) {
+    case 0: acc++; break;
+    case 1: acc--; break;
+    case 2: acc *= 2; break;
+    case 3: acc = -acc; break;
+    default: return acc;
+    }
+  }
+}
+
+// CHECK: define{{.*}} i32 @plain(i8* %pc) [[PLAIN:#[0-9]+]]
+int plain(const unsigned char *pc) { return *pc; }
+
+// CHECK: attributes [[THREADED]] = {{{.*}} "threaded-dispatch"
+// CHECK-NOT: attributes [[PLAIN]] = {{{.*}} "threaded-dispatch"
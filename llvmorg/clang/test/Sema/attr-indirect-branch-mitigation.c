@@ -0,0 +1,10 @@
+// RUN: %clang_cc1 -fsyntax-only -verify %s
+
+void __attribute__((indirect_branch_mitigation(lfence))) f1(void) {}
+void __attribute__((indirect_branch_mitigation(retpoline))) f2(void) {}
+void __attribute__((indirect_branch_mitigation(lfence))) f3(void);
+
+int __attribute__((indirect_branch_mitigation(lfence))) var; // expected-warning {{'indirect_branch_mitigation' attribute only applies to functions}}
+void __attribute__((indirect_branch_mitigation)) f4(void) {} // expected-error {{'indirect_branch_mitigation' attribute takes one argument}}
+void __attribute__((indirect_branch_mitigation("lfence"))) f5(void) {} // expected-error {{'indirect_branch_mitigation' attribute requires an identifier}}
+void __attribute__((indirect_branch_mitigation(thunk))) f6(void) {} // expected-warning {{'indirect_branch_mitigation' attribute argument not supported: 'thunk'}}
@@ -0,0 +1,5 @@
+// RUN: %clang_cc1 -fsyntax-only -verify %s
+
+int __attribute__((threaded_dispatch)) run(const unsigned char *pc) { return *pc; }
+int __attribute__((threaded_dispatch)) var; // expected-warning {{'threaded_dispatch' attribute only applies to functions}}
+void __attribute__((threaded_dispatch(1))) bar() {} // expected-error {{'threaded_dispatch' attribute takes no arguments}}
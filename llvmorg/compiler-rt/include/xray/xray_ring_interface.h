@@ -0,0 +1,52 @@
+//===-- xray_ring_interface.h -----------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file is a part of XRay, a function call tracing system.
+//
+// APIs provided by the "xray-ring" logging implementation.
+//
+//===----------------------------------------------------------------------===//
+///
+/// The ring mode keeps the most recent records of every thread in fixed size
+/// in-memory ring buffers, overwriting the oldest records when a buffer is
+/// full. Nothing is written out until requested, which keeps the overhead low
+/// enough to leave tracing on in production and dump the recent history when
+/// something goes wrong, for example:
+///
+///   if (RequestLatency > Threshold)
+///     __xray_ring_snapshot(/*WindowMs=*/2 * RequestLatency);
+///
+/// Snapshots are written as basic mode logs, which can be processed with
+/// `llvm-xray`. The mode is linked in with `-fxray-modes=xray-ring` and
+/// selected with `XRAY_OPTIONS=xray_mode=xray-ring`, or through the
+/// xray_log_interface.h APIs. See compiler-rt/lib/xray/xray_ring_flags.inc for
+/// the options accepted in `XRAY_RING_OPTIONS`.
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef XRAY_XRAY_RING_INTERFACE_H
+#define XRAY_XRAY_RING_INTERFACE_H
+
+#include "xray/xray_log_interface.h"
+
+#include <cstdint>
+
+extern "C" {
+
+/// Writes the records of all threads from the last |WindowMs| milliseconds, or
+/// all of the buffered records if |WindowMs| is 0, to a new log file named
+/// after the `xray_logfile_base` flag. Tracing goes on while the snapshot is
+/// taken, records overwritten in the meantime are left out.
+///
+/// Returns XRAY_LOG_FLUSHED on success, XRAY_LOG_NOT_FLUSHING if the ring mode
+/// was never initialized.
+XRayLogFlushStatus __xray_ring_snapshot(uint64_t WindowMs);
+
+} // extern "C"
+
+#endif // XRAY_XRAY_RING_INTERFACE_H
@@ -161,6 +161,31 @@ int __llvm_orderfile_write_file(void);
  */
 int __llvm_profile_dump(void);
 
+/*!
+ * \brief Ask for the profile to be written while the program keeps running.
+ *
+ * The request is served by the next sampled counter update (see
+ * \c __llvm_profile_sample_hit) on any thread, so it only takes effect in
+ * programs built with -mllvm -instrprof-sample-period. It is async-signal-safe
+ * and can be called from a signal handler; setting LLVM_PROFILE_DUMP_SIGNAL to
+ * a signal number installs such a handler at startup.
+ *
+ * Unlike \c __llvm_profile_dump, the profile is still written at exit. When
+ * online profile merging is on, the counters are reset after each write so
+ * that every write only adds the counts collected since the previous one.
+ */
+void __llvm_profile_request_dump(void);
+
+/*!
+ * \brief Slow path of a sampled counter update.
+ *
+ * Called by instrumented code when the calling thread's
+ * \c __llvm_profile_sample_countdown expires. Resets the countdown to a random
+ * interval averaging \p Period updates, serves pending dump requests and
+ * returns the weight to add to the sampled counter.
+ */
+uint64_t __llvm_profile_sample_hit(uint32_t Period);
+
 int __llvm_orderfile_dump(void);
 
 /*!
@@ -989,8 +989,10 @@ void __llvm_profile_initialize_file(void) {
 COMPILER_RT_VISIBILITY
 void __llvm_profile_initialize(void) {
   __llvm_profile_initialize_file();
-  if (!__llvm_profile_is_continuous_mode_enabled())
+  if (!__llvm_profile_is_continuous_mode_enabled()) {
     __llvm_profile_register_write_file_atexit();
+    lprofInstallDumpSignalHandler();
+  }
 }
 
 /* This API is directly called by the user application code. It has the
@@ -1066,6 +1068,19 @@ int __llvm_profile_dump(void) {
   return rc;
 }
 
+COMPILER_RT_VISIBILITY
+int lprofWriteFileOnRequest(void) {
+  int rc = __llvm_profile_write_file();
+  /* Unlike __llvm_profile_dump(), keep the profile live. When merging into
+   * the file, reset the counters so that the next write, possibly the one at
+   * exit, does not add the same counts again. Without merging every write
+   * replaces the file with the totals so far. Updates racing with the reset
+   * may be lost. */
+  if (rc == 0 && doMerging())
+    __llvm_profile_reset_counters();
+  return rc;
+}
+
 /* Order file data will be saved in a file with suffx .order. */
 static const char *OrderFileSuffix = ".order";
 
@@ -184,6 +184,12 @@ uint64_t lprofGetLoadModuleSignature();
 unsigned lprofProfileDumped(void);
 void lprofSetProfileDumped(unsigned);
 
+/* Write the profile in response to __llvm_profile_request_dump(). */
+int lprofWriteFileOnRequest(void);
+
+/* Install the signal handler selected by LLVM_PROFILE_DUMP_SIGNAL, if any. */
+void lprofInstallDumpSignalHandler(void);
+
 /* Return non zero value if counters are being relocated at runtime. */
 unsigned lprofRuntimeCounterRelocation(void);
 void lprofSetRuntimeCounterRelocation(unsigned);
@@ -0,0 +1,105 @@
+/*===- InstrProfilingSampling.c - Sampled counter updates -----------------===*\
+|*
+|* Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+|* See https://llvm.org/LICENSE.txt for license information.
+|* SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+|*
+\*===----------------------------------------------------------------------===*/
+
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if !defined(_WIN32) && !defined(__Fuchsia__)
+#include <signal.h>
+#endif
+
+#include "InstrProfiling.h"
+#include "InstrProfilingInternal.h"
+
+#if defined(_WIN32)
+#define THREAD_LOCAL __declspec(thread)
+#else
+#define THREAD_LOCAL __thread __attribute__((tls_model("initial-exec")))
+#endif
+
+/* The number of counter updates this thread skips before the next sampled
+ * update. Instrumented code built with -instrprof-sample-period decrements it
+ * inline and calls __llvm_profile_sample_hit() once it drops below zero. */
+COMPILER_RT_VISIBILITY THREAD_LOCAL int64_t __llvm_profile_sample_countdown;
+
+/* State of the per-thread xorshift generator used to randomize the sampling
+ * intervals. */
+static THREAD_LOCAL uint32_t SampleSeed;
+
+/* Set to a non-null value by __llvm_profile_request_dump(). This is a pointer
+ * so that it can be claimed with COMPILER_RT_BOOL_CMPXCHG on all targets. */
+static void *volatile DumpRequested;
+
+static uint32_t nextRandom(void) {
+  uint32_t X = SampleSeed;
+  if (X == 0)
+    X = (uint32_t)(uintptr_t)&SampleSeed | 1;
+  X ^= X << 13;
+  X ^= X >> 17;
+  X ^= X << 5;
+  SampleSeed = X;
+  return X;
+}
+
+COMPILER_RT_VISIBILITY uint64_t __llvm_profile_sample_hit(uint32_t Period) {
+  /* Draw the next interval uniformly from [1, 2 * Period - 1]. Its mean is
+   * Period, so weighting each sampled update by Period keeps the counts
+   * unbiased, while the randomization avoids systematically sampling the same
+   * counter in code whose updates repeat with a period dividing Period.
+   * The interval is below 2^33, so it always fits the 64-bit countdown. */
+  uint64_t Interval = 1;
+  if (Period > 1) {
+    uint64_t Random = (uint64_t)nextRandom() << 32 | nextRandom();
+    Interval += Random % (2 * (uint64_t)Period - 1);
+  }
+  __llvm_profile_sample_countdown = (int64_t)(Interval - 1);
+
+  if (DumpRequested &&
+      COMPILER_RT_BOOL_CMPXCHG(&DumpRequested, (void *)1, (void *)0))
+    lprofWriteFileOnRequest();
+
+  return Period;
+}
+
+COMPILER_RT_VISIBILITY void __llvm_profile_request_dump(void) {
+  DumpRequested = (void *)1;
+}
+
+#if !defined(_WIN32) && !defined(__Fuchsia__)
+static void dumpSignalHandler(int Sig) {
+  (void)Sig;
+  __llvm_profile_request_dump();
+}
+#endif
+
+COMPILER_RT_VISIBILITY void lprofInstallDumpSignalHandler(void) {
+#if !defined(_WIN32) && !defined(__Fuchsia__)
+  struct sigaction SA;
+  const char *SigStr = getenv("LLVM_PROFILE_DUMP_SIGNAL");
+  char *End;
+  long Sig;
+  if (!SigStr || !SigStr[0])
+    return;
+  Sig = strtol(SigStr, &End, 10);
+  /* sigaction() rejects the numbers that do not name a signal. */
+  if (*End || Sig <= 0 || Sig > INT_MAX) {
+    PROF_WARN("LLVM_PROFILE_DUMP_SIGNAL=%s is not a valid signal number.\n",
+              SigStr);
+    return;
+  }
+
+  memset(&SA, 0, sizeof(SA));
+  SA.sa_handler = dumpSignalHandler;
+  SA.sa_flags = SA_RESTART;
+  sigemptyset(&SA.sa_mask);
+  if (sigaction((int)Sig, &SA, NULL) != 0)
+    PROF_WARN("Unable to install the profile dump handler for signal %ld.\n",
+              Sig);
+#endif
+}
@@ -13,6 +13,7 @@
 #include "benchmark/benchmark.h"
 
 #include <memory>
+#include <vector>
 
 template <typename Config> static void BM_malloc_free(benchmark::State &State) {
   using AllocatorT = scudo::Allocator<Config>;
@@ -100,4 +101,70 @@ BENCHMARK_TEMPLATE(BM_malloc_free_loop, scudo::FuchsiaConfig)
     ->Range(MinIters, MaxIters);
 #endif
 
+// Allocates State.range(0) small objects then frees them all, either one by
+// one or by releasing the arena they were allocated from.
+template <typename Config>
+static void BM_malloc_free_group(benchmark::State &State) {
+  using AllocatorT = scudo::Allocator<Config>;
+  auto Deleter = [](AllocatorT *A) {
+    A->unmapTestOnly();
+    delete A;
+  };
+  std::unique_ptr<AllocatorT, decltype(Deleter)> Allocator(new AllocatorT,
+                                                           Deleter);
+  Allocator->reset();
+
+  const size_t NumObjects = State.range(0);
+  std::vector<void *> Ptrs(NumObjects);
+
+  for (auto _ : State) {
+    for (size_t I = 0; I < NumObjects; I++) {
+      Ptrs[I] = Allocator->allocate(16 + (I % 8) * 8,
+                                    scudo::Chunk::Origin::Malloc);
+      benchmark::DoNotOptimize(Ptrs[I]);
+    }
+    for (void *Ptr : Ptrs)
+      Allocator->deallocate(Ptr, scudo::Chunk::Origin::Malloc);
+  }
+
+  State.SetItemsProcessed(uint64_t(State.iterations()) * NumObjects);
+}
+
+template <typename Config>
+static void BM_arena_group(benchmark::State &State) {
+  using AllocatorT = scudo::Allocator<Config>;
+  auto Deleter = [](AllocatorT *A) {
+    A->unmapTestOnly();
+    delete A;
+  };
+  std::unique_ptr<AllocatorT, decltype(Deleter)> Allocator(new AllocatorT,
+                                                           Deleter);
+  Allocator->reset();
+
+  const size_t NumObjects = State.range(0);
+
+  for (auto _ : State) {
+    auto *Arena = Allocator->createArena();
+    for (size_t I = 0; I < NumObjects; I++) {
+      void *Ptr = Allocator->allocateFromArena(Arena, 16 + (I % 8) * 8);
+      benchmark::DoNotOptimize(Ptr);
+    }
+    Allocator->releaseArena(Arena);
+  }
+
+  State.SetItemsProcessed(uint64_t(State.iterations()) * NumObjects);
+}
+
+static const size_t MinObjects = 16;
+static const size_t MaxObjects = 16 * 1024;
+
+BENCHMARK_TEMPLATE(BM_malloc_free_group, scudo::AndroidConfig)
+    ->Range(MinObjects, MaxObjects);
+BENCHMARK_TEMPLATE(BM_arena_group, scudo::AndroidConfig)
+    ->Range(MinObjects, MaxObjects);
+BENCHMARK_TEMPLATE(BM_malloc_free_group, scudo::AndroidSvelteConfig)
+    ->Range(MinObjects, MaxObjects);
+BENCHMARK_TEMPLATE(BM_arena_group, scudo::AndroidSvelteConfig)
+    ->Range(MinObjects, MaxObjects);
+
 BENCHMARK_MAIN();
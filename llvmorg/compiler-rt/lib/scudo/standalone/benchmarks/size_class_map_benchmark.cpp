@@ -0,0 +1,158 @@
+//===-- size_class_map_benchmark.cpp ----------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Compares the throughput and memory footprint of size class maps on a
+// workload dominated by small allocations, such as the one of an interpreter.
+//
+// A map tuned for a given program can be evaluated by recording its allocation
+// profile with tools/record_allocation_sizes.cpp, feeding it to
+// tools/compute_size_class_config.cpp and building this file with
+// -DSCUDO_BENCHMARK_SIZE_CLASS_CONFIG=<header> where the header holds the
+// resulting MySizeClassConfig. The workload below should then be replaced with
+// one following the same profile.
+//
+//===----------------------------------------------------------------------===//
+
+#include "allocator_config.h"
+#include "combined.h"
+#include "common.h"
+
+#include "benchmark/benchmark.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include <memory>
+#include <vector>
+
+#ifdef SCUDO_BENCHMARK_SIZE_CLASS_CONFIG
+#include SCUDO_BENCHMARK_SIZE_CLASS_CONFIG
+#else
+// Generated by compute_size_class_config -n 16 -c 4112 -m 28 -l 13 from a
+// profile holding the sizes of WorkloadSizes below, with their multiplicity as
+// counts: few classes, all of them small, and more blocks cached per class so
+// that refills of the local cache are rarer. The wastage is 88 bytes per pass
+// over WorkloadSizes.
+struct MySizeClassConfig {
+  static const scudo::uptr NumBits = 5;
+  static const scudo::uptr MinSizeLog = 4;
+  static const scudo::uptr MidSizeLog = 6;
+  static const scudo::uptr MaxSizeLog = 12;
+  static const scudo::u32 MaxNumCachedHint = 28;
+  static const scudo::uptr MaxBytesCachedLog = 13;
+
+  static constexpr scudo::u32 Classes[] = {
+      0x00020, 0x00030, 0x00040, 0x00050, 0x00060, 0x00070, 0x00090, 0x000c0,
+      0x00110, 0x00210, 0x01010,
+  };
+  static const scudo::uptr SizeDelta = 16;
+};
+#endif
+
+// The Android configuration with the size class map as a parameter.
+template <typename SizeClassMapT> struct SizeClassMapConfig {
+  using SizeClassMap = SizeClassMapT;
+#if SCUDO_CAN_USE_PRIMARY64
+  typedef scudo::SizeClassAllocator64<SizeClassMap, 28U, 1000, 1000> Primary;
+#else
+  typedef scudo::SizeClassAllocator32<SizeClassMap, 18U, 1000, 1000> Primary;
+#endif
+  typedef scudo::MapAllocator<scudo::MapAllocatorCache<32U, 2UL << 20, 0, 1000>>
+      Secondary;
+  template <class A> using TSDRegistryT = scudo::TSDRegistrySharedT<A, 2U>;
+};
+
+using DefaultMapConfig = SizeClassMapConfig<scudo::DefaultSizeClassMap>;
+using AndroidMapConfig = SizeClassMapConfig<scudo::AndroidSizeClassMap>;
+using TunedMapConfig =
+    SizeClassMapConfig<scudo::TableSizeClassMap<MySizeClassConfig>>;
+
+// Allocation sizes drawn uniformly: three quarters of the requests are for 48
+// bytes or less.
+static const size_t WorkloadSizes[] = {
+    16, 16, 16, 16, 16, 16, 24, 24, 24, 24, 24, 32, 32, 32,  32,  32,
+    40, 40, 40, 48, 48, 48, 56, 56, 64, 64, 72, 96, 128, 176, 256, 512,
+};
+
+static size_t nextWorkloadSize(scudo::u32 &State) {
+  // xorshift32
+  State ^= State << 13;
+  State ^= State >> 17;
+  State ^= State << 5;
+  return WorkloadSizes[State % ARRAY_SIZE(WorkloadSizes)];
+}
+
+// Returns the resident set size of the process, or 0 if it isn't available.
+static scudo::uptr getResidentBytes() {
+#if SCUDO_LINUX
+  FILE *F = fopen("/proc/self/statm", "r");
+  if (!F)
+    return 0;
+  unsigned long Size, Resident;
+  const bool Read = fscanf(F, "%lu %lu", &Size, &Resident) == 2;
+  fclose(F);
+  return Read ? Resident * scudo::getPageSizeCached() : 0;
+#else
+  return 0;
+#endif
+}
+
+// Keeps State.range(0) blocks live, each iteration replaces the oldest one.
+// Besides the throughput, reports the growth of the resident set and the
+// memory mapped by the allocator once the working set has been churned.
+template <typename Config>
+static void BM_size_class_map(benchmark::State &State) {
+  using AllocatorT = scudo::Allocator<Config>;
+  auto Deleter = [](AllocatorT *A) {
+    A->unmapTestOnly();
+    delete A;
+  };
+  std::unique_ptr<AllocatorT, decltype(Deleter)> Allocator(new AllocatorT,
+                                                           Deleter);
+  Allocator->reset();
+
+  const size_t NumLive = State.range(0);
+  std::vector<void *> Ptrs(NumLive, nullptr);
+  const scudo::uptr ResidentBefore = getResidentBytes();
+  scudo::u32 Seed = 0x9e3779b9;
+  size_t I = 0;
+
+  for (auto _ : State) {
+    void *&Ptr = Ptrs[I];
+    if (++I == NumLive)
+      I = 0;
+    if (Ptr)
+      Allocator->deallocate(Ptr, scudo::Chunk::Origin::Malloc);
+    const size_t Size = nextWorkloadSize(Seed);
+    Ptr = Allocator->allocate(Size, scudo::Chunk::Origin::Malloc);
+    memset(Ptr, 0, Size);
+    benchmark::DoNotOptimize(Ptr);
+  }
+
+  State.counters["RSS"] =
+      static_cast<double>(getResidentBytes()) - double(ResidentBefore);
+  scudo::StatCounters Stats;
+  Allocator->getStats(Stats);
+  State.counters["Mapped"] = static_cast<double>(Stats[scudo::StatMapped]);
+  State.SetItemsProcessed(State.iterations());
+
+  for (void *Ptr : Ptrs)
+    if (Ptr)
+      Allocator->deallocate(Ptr, scudo::Chunk::Origin::Malloc);
+}
+
+static const size_t MinLive = 1024;
+static const size_t MaxLive = 256 * 1024;
+
+BENCHMARK_TEMPLATE(BM_size_class_map, DefaultMapConfig)
+    ->Range(MinLive, MaxLive);
+BENCHMARK_TEMPLATE(BM_size_class_map, AndroidMapConfig)
+    ->Range(MinLive, MaxLive);
+BENCHMARK_TEMPLATE(BM_size_class_map, TunedMapConfig)->Range(MinLive, MaxLive);
+
+BENCHMARK_MAIN();
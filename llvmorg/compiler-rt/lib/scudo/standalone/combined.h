@@ -576,6 +576,101 @@ public:
     return NewPtr;
   }
 
+  // Arenas group short-lived allocations that are all released at once. Blocks
+  // are carved with a bump pointer from slabs obtained from the Secondary and
+  // don't have a chunk header: there is no per-block checksum, quarantine or
+  // memory tagging, and they must not be passed to deallocate() or
+  // reallocate(). The arena and slab headers are checksummed instead, and
+  // verified when the arena grows or is released. The bump pointer is left out
+  // of the checksum to keep allocations cheap, but is checked to be within the
+  // current slab. An arena must only be used by one thread at a time.
+  struct Arena {
+    uptr Current;
+    uptr CurrentSlab;
+    uptr End;
+    uptr Slabs; // Most recent slab first, the last one holds the arena.
+    uptr SlabSize;
+    uptr Checksum;
+  };
+
+  Arena *createArena(uptr SlabSize = DefaultArenaSlabSize) {
+    initThreadMaybe();
+    SlabSize = roundUpTo(Max(SlabSize, MinArenaSlabSize), getPageSizeCached());
+    uptr SlabEnd;
+    ArenaSlab *Slab = allocateArenaSlab(SlabSize, &SlabEnd);
+    if (UNLIKELY(!Slab)) {
+      if (Options.MayReturnNull)
+        return nullptr;
+      reportOutOfMemory(SlabSize);
+    }
+    Slab->Next = 0;
+    storeArenaChecksum(Slab);
+
+    Arena *A = reinterpret_cast<Arena *>(Slab + 1);
+    A->Slabs = reinterpret_cast<uptr>(Slab);
+    A->CurrentSlab = reinterpret_cast<uptr>(Slab);
+    A->Current = roundUpTo(reinterpret_cast<uptr>(A + 1), MinAlignment);
+    A->End = SlabEnd;
+    A->SlabSize = SlabSize;
+    storeArenaChecksum(A);
+    return A;
+  }
+
+  void *allocateFromArena(Arena *A, uptr Size, uptr Alignment = MinAlignment,
+                          bool ZeroContents = false) {
+    if (UNLIKELY(A->Current < A->CurrentSlab || A->Current > A->End))
+      reportHeaderCorruption(A);
+
+    if (UNLIKELY(Alignment > MaxAlignment)) {
+      if (Options.MayReturnNull)
+        return nullptr;
+      reportAlignmentTooBig(Alignment, MaxAlignment);
+    }
+    if (Alignment < MinAlignment)
+      Alignment = MinAlignment;
+    if (UNLIKELY(Size >= MaxAllowedMallocSize)) {
+      if (Options.MayReturnNull)
+        return nullptr;
+      reportAllocationSizeTooBig(Size, Size, MaxAllowedMallocSize);
+    }
+    // Zero sized allocations still get a distinct address.
+    const uptr NeededSize = roundUpTo(Max<uptr>(Size, 1U), MinAlignment);
+
+    uptr Ptr = roundUpTo(A->Current, Alignment);
+    if (LIKELY(Ptr <= A->End && A->End - Ptr >= NeededSize)) {
+      A->Current = Ptr + NeededSize;
+    } else {
+      Ptr = growArena(A, NeededSize, Alignment);
+      if (UNLIKELY(!Ptr)) {
+        if (Options.MayReturnNull)
+          return nullptr;
+        reportOutOfMemory(NeededSize);
+      }
+    }
+
+    const FillContentsMode FillContents =
+        ZeroContents ? ZeroFill : Options.FillContents;
+    if (UNLIKELY(FillContents != NoFill))
+      memset(reinterpret_cast<void *>(Ptr),
+             FillContents == ZeroFill ? 0 : PatternFillByte, Size);
+    return reinterpret_cast<void *>(Ptr);
+  }
+
+  // Returns all the slabs of the arena to the Secondary, which caches them for
+  // the arenas created next.
+  void releaseArena(Arena *A) {
+    initThreadMaybe(/*MinimalInit=*/true);
+    loadArenaChecksum(A);
+    // The first slab holds the arena, it is the last one of the list.
+    ArenaSlab *Slab = reinterpret_cast<ArenaSlab *>(A->Slabs);
+    while (Slab) {
+      loadArenaChecksum(Slab);
+      ArenaSlab *Next = reinterpret_cast<ArenaSlab *>(Slab->Next);
+      Secondary.deallocate(Slab);
+      Slab = Next;
+    }
+  }
+
   // TODO(kostyak): disable() is currently best-effort. There are some small
   //                windows of time when an allocation could still succeed after
   //                this function finishes. We will revisit that later.
@@ -903,6 +998,18 @@ private:
 
   static const uptr MaxTraceSize = 64;
 
+  static const uptr DefaultArenaSlabSize = 1UL << 16;
+  static const uptr MinArenaSlabSize = 1UL << 12;
+
+  // Header of the slabs of an arena. The first word is read as the header of a
+  // chunk in the Available state when iterating over the blocks of the
+  // Secondary, which keeps slabs from being reported as allocated chunks.
+  struct ArenaSlab {
+    u64 Zero;
+    uptr Next;
+    uptr Checksum;
+  };
+
   GlobalStats Stats;
   TSDRegistryT TSDRegistry;
   PrimaryT Primary;
@@ -1059,6 +1166,66 @@ private:
     Ptr32[MemTagPrevTagIndex] = PrevTag;
   }
 
+  u16 computeArenaChecksum(const Arena *A) {
+    uptr Fields[] = {A->CurrentSlab, A->End, A->Slabs, A->SlabSize};
+    return computeChecksum(Cookie, reinterpret_cast<uptr>(A), Fields,
+                           ARRAY_SIZE(Fields));
+  }
+
+  u16 computeArenaChecksum(const ArenaSlab *Slab) {
+    uptr Fields[] = {Slab->Next};
+    return computeChecksum(Cookie, reinterpret_cast<uptr>(Slab), Fields,
+                           ARRAY_SIZE(Fields));
+  }
+
+  template <typename T> void storeArenaChecksum(T *Header) {
+    Header->Checksum = computeArenaChecksum(Header);
+  }
+
+  template <typename T> void loadArenaChecksum(T *Header) {
+    if (UNLIKELY(Header->Checksum != computeArenaChecksum(Header)))
+      reportHeaderCorruption(Header);
+  }
+
+  ArenaSlab *allocateArenaSlab(uptr Size, uptr *SlabEnd) {
+    void *Block = Secondary.allocate(Size, 0, SlabEnd);
+    if (UNLIKELY(!Block))
+      return nullptr;
+    ArenaSlab *Slab = reinterpret_cast<ArenaSlab *>(Block);
+    Slab->Zero = 0;
+    return Slab;
+  }
+
+  // Continues the arena in a new slab and returns a block of NeededSize bytes
+  // from it. Blocks needing more than a quarter of a slab, alignment padding
+  // included, get a slab of their own, so that the space left in the current
+  // slab isn't wasted.
+  uptr growArena(Arena *A, uptr NeededSize, uptr Alignment) {
+    loadArenaChecksum(A);
+    const uptr HeaderSize = roundUpTo(sizeof(ArenaSlab), MinAlignment);
+    const uptr PaddedSize = NeededSize + Alignment - MinAlignment;
+    const bool Dedicated = PaddedSize > A->SlabSize / 4;
+    const uptr SlabSize = Dedicated ? HeaderSize + PaddedSize : A->SlabSize;
+    uptr SlabEnd;
+    ArenaSlab *Slab = allocateArenaSlab(SlabSize, &SlabEnd);
+    if (UNLIKELY(!Slab))
+      return 0;
+    Slab->Next = A->Slabs;
+    storeArenaChecksum(Slab);
+    A->Slabs = reinterpret_cast<uptr>(Slab);
+
+    const uptr Ptr =
+        roundUpTo(reinterpret_cast<uptr>(Slab) + HeaderSize, Alignment);
+    DCHECK_LE(Ptr + NeededSize, SlabEnd);
+    if (!Dedicated) {
+      A->Current = Ptr + NeededSize;
+      A->CurrentSlab = reinterpret_cast<uptr>(Slab);
+      A->End = SlabEnd;
+    }
+    storeArenaChecksum(A);
+    return Ptr;
+  }
+
   uptr getStats(ScopedString *Str) {
     Primary.getStats(Str);
     Secondary.getStats(Str);
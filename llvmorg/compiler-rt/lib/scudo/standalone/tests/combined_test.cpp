@@ -491,3 +491,78 @@ TEST(ScudoCombinedTest, FullRegion) {
   }
   EXPECT_EQ(FailedAllocationsCount, 0U);
 }
+
+TEST(ScudoCombinedTest, ArenaCombined) {
+  using AllocatorT = scudo::Allocator<DeathConfig>;
+  auto Deleter = [](AllocatorT *A) {
+    A->unmapTestOnly();
+    delete A;
+  };
+  std::unique_ptr<AllocatorT, decltype(Deleter)> Allocator(new AllocatorT,
+                                                           Deleter);
+  Allocator->reset();
+
+  // Recreate arenas to exercise slabs coming back from the Secondary cache.
+  for (scudo::uptr I = 0; I < 4U; I++) {
+    AllocatorT::Arena *A = Allocator->createArena();
+    EXPECT_NE(A, nullptr);
+    std::vector<std::pair<char *, scudo::uptr>> V;
+    for (scudo::uptr SizeLog = 0U; SizeLog <= 18U; SizeLog++) {
+      for (scudo::uptr AlignLog = 3U; AlignLog <= 12U; AlignLog++) {
+        const scudo::uptr Size = (1U << SizeLog) + (SizeLog & 7U);
+        const scudo::uptr Align = 1U << AlignLog;
+        char *P = reinterpret_cast<char *>(
+            Allocator->allocateFromArena(A, Size, Align));
+        EXPECT_NE(P, nullptr);
+        EXPECT_TRUE(scudo::isAligned(reinterpret_cast<scudo::uptr>(P), Align));
+        // Arena blocks don't have a chunk header.
+        EXPECT_FALSE(Allocator->isOwned(P));
+        memset(P, static_cast<int>(V.size() & 0xff), Size);
+        V.push_back(std::make_pair(P, Size));
+      }
+    }
+    // No block was overwritten by a later one.
+    for (scudo::uptr J = 0; J < V.size(); J++) {
+      const char Expected = static_cast<char>(J & 0xff);
+      EXPECT_EQ(V[J].first[0], Expected);
+      EXPECT_EQ(V[J].first[V[J].second - 1], Expected);
+    }
+    char *Z = reinterpret_cast<char *>(
+        Allocator->allocateFromArena(A, 4096U, 16U, /*ZeroContents=*/true));
+    for (scudo::uptr J = 0; J < 4096U; J++)
+      EXPECT_EQ(Z[J], 0);
+    Allocator->releaseArena(A);
+  }
+
+  // Alignments up to the maximum, most of them larger than the slabs. The
+  // blocks must fit in their slab, and the arena must remain usable.
+  {
+    AllocatorT::Arena *A = Allocator->createArena(4096U);
+    EXPECT_NE(A, nullptr);
+    for (scudo::uptr AlignLog = 12U; AlignLog <= 24U; AlignLog++) {
+      for (scudo::uptr Size : {1U, 4096U}) {
+        const scudo::uptr Align = 1U << AlignLog;
+        char *P = reinterpret_cast<char *>(
+            Allocator->allocateFromArena(A, Size, Align));
+        EXPECT_NE(P, nullptr);
+        EXPECT_TRUE(scudo::isAligned(reinterpret_cast<scudo::uptr>(P), Align));
+        memset(P, 0x42, Size);
+        EXPECT_NE(Allocator->allocateFromArena(A, 32U), nullptr);
+      }
+    }
+    Allocator->releaseArena(A);
+  }
+
+  // Arena header corruption.
+  AllocatorT::Arena *A = Allocator->createArena();
+  EXPECT_NE(Allocator->allocateFromArena(A, 32U), nullptr);
+  const scudo::uptr Current = A->Current;
+  A->Current = A->End + 16U;
+  EXPECT_DEATH(Allocator->allocateFromArena(A, 32U), "");
+  A->Current = Current;
+  A->End ^= 0x1000U;
+  EXPECT_DEATH(Allocator->allocateFromArena(A, 1U << 20), "");
+  EXPECT_DEATH(Allocator->releaseArena(A), "");
+  A->End ^= 0x1000U;
+  Allocator->releaseArena(A);
+}
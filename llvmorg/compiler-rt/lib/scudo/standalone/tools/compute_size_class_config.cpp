@@ -65,7 +65,8 @@ size_t log2Floor(size_t x) { return sizeof(long) * 8 - 1 - __builtin_clzl(x); }
 void usage() {
   fprintf(stderr,
           "usage: compute_size_class_config [-p pageSize] [-c largestClass] "
-          "[-h headerSize] [-n numClasses] [-b numBits] profile...\n");
+          "[-h headerSize] [-n numClasses] [-b numBits] "
+          "[-m maxNumCachedHint] [-l maxBytesCachedLog] profile...\n");
   exit(1);
 }
 
@@ -75,6 +76,8 @@ int main(int argc, char **argv) {
   size_t headerSize = 16;
   size_t numClasses = 32;
   size_t numBits = 5;
+  size_t maxNumCachedHint = 14;
+  size_t maxBytesCachedLog = 14;
 
   std::vector<Alloc> allocs;
   for (size_t i = 1; i != argc;) {
@@ -92,7 +95,8 @@ int main(int argc, char **argv) {
     };
     if (matchArg(pageSize, "-p") || matchArg(largestClass, "-c") ||
         matchArg(headerSize, "-h") || matchArg(numClasses, "-n") ||
-        matchArg(numBits, "-b"))
+        matchArg(numBits, "-b") || matchArg(maxNumCachedHint, "-m") ||
+        matchArg(maxBytesCachedLog, "-l"))
       continue;
     readAllocs(allocs, argv[i]);
     ++i;
@@ -103,10 +107,18 @@ int main(int argc, char **argv) {
 
   std::vector<size_t> classes;
   classes.push_back(largestClass);
+  size_t wastage = measureWastage(allocs, classes, pageSize, headerSize);
   for (size_t i = 1; i != numClasses; ++i) {
-    size_t minWastage = -1ull;
-    size_t minWastageClass;
+    // Profiles with few distinct sizes may not need all the classes: stop as
+    // soon as no new class reduces the wastage.
+    size_t minWastage = wastage;
+    size_t minWastageClass = 0;
     for (size_t newClass = 16; newClass != largestClass; newClass += 16) {
+      // Don't pad the map with duplicates or classes too small to hold a
+      // header.
+      if (newClass <= headerSize ||
+          std::find(classes.begin(), classes.end(), newClass) != classes.end())
+        continue;
       // Skip classes with more than numBits bits, ignoring leading or trailing
       // zero bits.
       if (__builtin_ctzl(newClass - headerSize) +
@@ -122,13 +134,17 @@ int main(int argc, char **argv) {
         minWastageClass = newClass;
       }
     }
+    if (!minWastageClass)
+      break;
     classes.push_back(minWastageClass);
+    wastage = minWastage;
   }
 
   std::sort(classes.begin(), classes.end());
   size_t minSizeLog = log2Floor(headerSize);
   size_t midSizeIndex = 0;
-  while (classes[midSizeIndex + 1] - classes[midSizeIndex] == (1 << minSizeLog))
+  while (midSizeIndex + 1 != classes.size() &&
+         classes[midSizeIndex + 1] - classes[midSizeIndex] == (1 << minSizeLog))
     midSizeIndex++;
   size_t midSizeLog = log2Floor(classes[midSizeIndex] - headerSize);
   size_t maxSizeLog = log2Floor(classes.back() - headerSize - 1) + 1;
@@ -140,12 +156,13 @@ struct MySizeClassConfig {
   static const uptr MinSizeLog = %zu;
   static const uptr MidSizeLog = %zu;
   static const uptr MaxSizeLog = %zu;
-  static const u32 MaxNumCachedHint = 14;
-  static const uptr MaxBytesCachedLog = 14;
+  static const u32 MaxNumCachedHint = %zu;
+  static const uptr MaxBytesCachedLog = %zu;
 
   static constexpr u32 Classes[] = {)",
-         measureWastage(allocs, classes, pageSize, headerSize), numBits,
-         minSizeLog, midSizeLog, maxSizeLog);
+         wastage, numBits,
+         minSizeLog, midSizeLog, maxSizeLog, maxNumCachedHint,
+         maxBytesCachedLog);
   for (size_t i = 0; i != classes.size(); ++i) {
     if ((i % 8) == 0)
       printf("\n      ");
@@ -0,0 +1,224 @@
+//===-- record_allocation_sizes.cpp ---------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// A preloadable library recording the size of every allocation made by a
+// program, for compute_size_class_config to derive a size class map from.
+//
+// malloc_info() only reports the chunks that are live when it is called, which
+// misses the short-lived allocations that dominate the allocator throughput.
+// This library counts every call to the allocation functions instead and
+// writes the histogram in the malloc_info() format when the program exits:
+//
+//   $ clang++ -shared -fPIC -O2 record_allocation_sizes.cpp -ldl
+//         -o librecord_allocation_sizes.so
+//   $ SCUDO_ALLOCATION_PROFILE=profile.xml
+//         LD_PRELOAD=./librecord_allocation_sizes.so ./program
+//   $ compute_size_class_config profile.xml
+//
+// Sizes of MaxRecordedSize bytes or more are not recorded: they are larger than
+// any primary size class.
+//
+//===----------------------------------------------------------------------===//
+
+#include <dlfcn.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+
+namespace {
+
+constexpr size_t MaxRecordedSize = 1 << 20;
+std::atomic<size_t> Counts[MaxRecordedSize];
+
+using MallocT = void *(*)(size_t);
+using CallocT = void *(*)(size_t, size_t);
+using ReallocT = void *(*)(void *, size_t);
+using FreeT = void (*)(void *);
+using MemalignT = void *(*)(size_t, size_t);
+using PosixMemalignT = int (*)(void **, size_t, size_t);
+
+MallocT RealMalloc;
+CallocT RealCalloc;
+ReallocT RealRealloc;
+FreeT RealFree;
+MemalignT RealMemalign;
+MemalignT RealAlignedAlloc;
+PosixMemalignT RealPosixMemalign;
+
+// dlsym() may allocate before the real functions are known, those requests are
+// served from this buffer and never freed. Every chunk is preceded by its size,
+// for realloc() to know how much to copy.
+constexpr size_t BootstrapHeaderSize = 16;
+alignas(16) char BootstrapBuffer[4096];
+size_t BootstrapUsed;
+
+void *bootstrapAlloc(size_t Size) {
+  size_t Rounded = (Size + 15) & ~size_t(15);
+  if (Rounded < Size ||
+      Rounded > sizeof(BootstrapBuffer) - BootstrapHeaderSize - BootstrapUsed)
+    return nullptr;
+  char *P = BootstrapBuffer + BootstrapUsed + BootstrapHeaderSize;
+  *reinterpret_cast<size_t *>(P - BootstrapHeaderSize) = Size;
+  BootstrapUsed += BootstrapHeaderSize + Rounded;
+  return P;
+}
+
+bool isBootstrap(void *P) {
+  return P >= BootstrapBuffer && P < BootstrapBuffer + sizeof(BootstrapBuffer);
+}
+
+size_t bootstrapSize(void *P) {
+  return *reinterpret_cast<size_t *>(static_cast<char *>(P) -
+                                     BootstrapHeaderSize);
+}
+
+template <typename T> void lookup(T &Fn, const char *Name) {
+  Fn = reinterpret_cast<T>(dlsym(RTLD_NEXT, Name));
+}
+
+bool resolve() {
+  static bool Resolving = false;
+  if (RealFree)
+    return true;
+  if (Resolving)
+    return false;
+  Resolving = true;
+  lookup(RealMalloc, "malloc");
+  lookup(RealCalloc, "calloc");
+  lookup(RealRealloc, "realloc");
+  lookup(RealMemalign, "memalign");
+  lookup(RealAlignedAlloc, "aligned_alloc");
+  lookup(RealPosixMemalign, "posix_memalign");
+  // Set last: a non-null RealFree means everything else is known.
+  lookup(RealFree, "free");
+  Resolving = false;
+  return RealFree != nullptr;
+}
+
+void record(size_t Size) {
+  if (Size < MaxRecordedSize)
+    Counts[Size].fetch_add(1, std::memory_order_relaxed);
+}
+
+// Writes the histogram without allocating, the allocator may not be usable
+// anymore at this point.
+__attribute__((destructor)) void writeProfile() {
+  const char *Path = getenv("SCUDO_ALLOCATION_PROFILE");
+  char DefaultPath[64];
+  if (!Path) {
+    snprintf(DefaultPath, sizeof(DefaultPath), "scudo_allocations.%d.xml",
+             static_cast<int>(getpid()));
+    Path = DefaultPath;
+  }
+  int Fd = open(Path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (Fd < 0)
+    return;
+
+  char Buffer[4096];
+  size_t Used = 0;
+  auto Flush = [&]() {
+    for (size_t Written = 0; Written != Used;) {
+      ssize_t N = write(Fd, Buffer + Written, Used - Written);
+      if (N <= 0)
+        break;
+      Written += static_cast<size_t>(N);
+    }
+    Used = 0;
+  };
+  auto Append = [&](const char *Format, size_t Size, size_t Count) {
+    if (sizeof(Buffer) - Used < 128)
+      Flush();
+    Used += static_cast<size_t>(
+        snprintf(Buffer + Used, sizeof(Buffer) - Used, Format, Size, Count));
+  };
+
+  Append("<malloc version=\"scudo-1\">\n", 0, 0);
+  for (size_t Size = 0; Size != MaxRecordedSize; ++Size)
+    if (size_t Count = Counts[Size].load(std::memory_order_relaxed))
+      Append("<alloc size=\"%zu\" count=\"%zu\"/>\n", Size, Count);
+  Append("</malloc>\n", 0, 0);
+  Flush();
+  close(Fd);
+}
+
+} // namespace
+
+extern "C" {
+
+void *malloc(size_t Size) {
+  if (!resolve())
+    return bootstrapAlloc(Size);
+  record(Size);
+  return RealMalloc(Size);
+}
+
+void *calloc(size_t NumElements, size_t ElementSize) {
+  if (!resolve())
+    return bootstrapAlloc(NumElements * ElementSize); // Static, so zeroed.
+  record(NumElements * ElementSize);
+  return RealCalloc(NumElements, ElementSize);
+}
+
+void *realloc(void *Ptr, size_t Size) {
+  bool Resolved = resolve();
+  if (Resolved && !isBootstrap(Ptr)) {
+    if (Size)
+      record(Size);
+    return RealRealloc(Ptr, Size);
+  }
+
+  // A chunk of the bootstrap buffer, which is never freed, or a request made
+  // before the real functions are known: copy the contents to a new chunk.
+  if (Ptr && !Size)
+    return nullptr;
+  void *NewPtr;
+  if (Resolved) {
+    record(Size);
+    NewPtr = RealMalloc(Size);
+  } else {
+    NewPtr = bootstrapAlloc(Size);
+  }
+  if (NewPtr && Ptr)
+    memcpy(NewPtr, Ptr, std::min(Size, bootstrapSize(Ptr)));
+  return NewPtr;
+}
+
+void free(void *Ptr) {
+  if (!Ptr || isBootstrap(Ptr) || !resolve())
+    return;
+  RealFree(Ptr);
+}
+
+void *memalign(size_t Alignment, size_t Size) {
+  if (!resolve())
+    return nullptr;
+  record(Size);
+  return RealMemalign(Alignment, Size);
+}
+
+void *aligned_alloc(size_t Alignment, size_t Size) {
+  if (!resolve())
+    return nullptr;
+  record(Size);
+  return RealAlignedAlloc(Alignment, Size);
+}
+
+int posix_memalign(void **MemPtr, size_t Alignment, size_t Size) {
+  if (!resolve())
+    return ENOMEM;
+  record(Size);
+  return RealPosixMemalign(MemPtr, Alignment, Size);
+}
+
+} // extern "C"
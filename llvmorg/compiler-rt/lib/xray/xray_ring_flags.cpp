@@ -0,0 +1,49 @@
+//===-- xray_ring_flags.cpp -------------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file is a part of XRay, a dynamic runtime instrumentation system.
+//
+// XRay Ring Mode flag parsing logic.
+//===----------------------------------------------------------------------===//
+
+#include "xray_ring_flags.h"
+#include "sanitizer_common/sanitizer_common.h"
+#include "sanitizer_common/sanitizer_flag_parser.h"
+#include "sanitizer_common/sanitizer_libc.h"
+#include "xray_defs.h"
+
+using namespace __sanitizer;
+
+namespace __xray {
+
+/// Use via ringFlags().
+RingFlags xray_ring_flags_dont_use_directly;
+
+void RingFlags::setDefaults() XRAY_NEVER_INSTRUMENT {
+#define XRAY_FLAG(Type, Name, DefaultValue, Description) Name = DefaultValue;
+#include "xray_ring_flags.inc"
+#undef XRAY_FLAG
+}
+
+void registerXRayRingFlags(FlagParser *P,
+                            RingFlags *F) XRAY_NEVER_INSTRUMENT {
+#define XRAY_FLAG(Type, Name, DefaultValue, Description)                       \
+  RegisterFlag(P, #Name, Description, &F->Name);
+#include "xray_ring_flags.inc"
+#undef XRAY_FLAG
+}
+
+const char *useCompilerDefinedRingFlags() XRAY_NEVER_INSTRUMENT {
+#ifdef XRAY_RING_OPTIONS
+  return SANITIZER_STRINGIFY(XRAY_RING_OPTIONS);
+#else
+  return "";
+#endif
+}
+
+} // namespace __xray
@@ -0,0 +1,37 @@
+//===-- xray_ring_flags.h ---------------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file is a part of XRay, a dynamic runtime instruementation system.
+//
+// XRay Ring Mode runtime flags.
+//===----------------------------------------------------------------------===//
+
+#ifndef XRAY_RING_FLAGS_H
+#define XRAY_RING_FLAGS_H
+
+#include "sanitizer_common/sanitizer_flag_parser.h"
+#include "sanitizer_common/sanitizer_internal_defs.h"
+
+namespace __xray {
+
+struct RingFlags {
+#define XRAY_FLAG(Type, Name, DefaultValue, Description) Type Name;
+#include "xray_ring_flags.inc"
+#undef XRAY_FLAG
+
+  void setDefaults();
+};
+
+extern RingFlags xray_ring_flags_dont_use_directly;
+extern void registerXRayRingFlags(FlagParser *P, RingFlags *F);
+const char *useCompilerDefinedRingFlags();
+inline RingFlags *ringFlags() { return &xray_ring_flags_dont_use_directly; }
+
+} // namespace __xray
+
+#endif // XRAY_RING_FLAGS_H
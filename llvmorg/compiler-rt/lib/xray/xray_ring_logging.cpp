@@ -0,0 +1,424 @@
+//===-- xray_ring_logging.cpp -----------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file is a part of XRay, a dynamic runtime instrumentation system.
+//
+// Implementation of the ring mode: per-thread in-memory ring buffers of XRay
+// events, written out as basic mode logs on demand.
+//
+//===----------------------------------------------------------------------===//
+
+#include <errno.h>
+#include <pthread.h>
+#include <time.h>
+#include <limits>
+
+#include "sanitizer_common/sanitizer_atomic.h"
+#include "sanitizer_common/sanitizer_common.h"
+#include "sanitizer_common/sanitizer_libc.h"
+#include "sanitizer_common/sanitizer_mutex.h"
+#include "xray/xray_records.h"
+#include "xray/xray_ring_interface.h"
+#include "xray_allocator.h"
+#include "xray_defs.h"
+#include "xray_flags.h"
+#include "xray_interface_internal.h"
+#include "xray_recursion_guard.h"
+#include "xray_ring_flags.h"
+#include "xray_ring_logging.h"
+#include "xray_tsc.h"
+#include "xray_utils.h"
+
+namespace __xray {
+
+namespace {
+// A ring buffer of the most recent records of one thread. Only the owning
+// thread writes to it; Head counts the records ever written, the record with
+// index I lives in Records[I & Mask] until index I + Mask + 1 is written.
+//
+// Rings are never freed. They are linked into a global list once and handed
+// over to a new thread when the owner exits, so that snapshots can read any
+// of them at any time without synchronizing with the writers. A ring handed
+// over after the size changed gets a buffer of the new size.
+struct ThreadRing {
+  atomic_uint64_t Head;
+  atomic_uint8_t InUse;
+  uint64_t Mask;
+  XRayRecord *Records;
+  ThreadRing *Next;
+};
+
+struct XRAY_TLS_ALIGNAS(64) ThreadLocalData {
+  ThreadRing *Ring = nullptr;
+  uint32_t TId = 0;
+};
+} // namespace
+
+static pthread_key_t PThreadKey;
+
+static atomic_uint8_t RingInitialized{0};
+static atomic_uint8_t RingRunning{0};
+
+// The head of the list of all rings, pushed to with a CAS.
+static atomic_uintptr_t Rings{0};
+
+// The number of records of the rings given to new threads, a power of two.
+static atomic_uint64_t RingSize{0};
+
+static atomic_uint8_t UseRealTSC{0};
+static atomic_uint64_t TicksPerSec{0};
+static atomic_uint64_t CycleFrequency{NanosecondsPerSecond};
+static uint32_t PId = 0;
+
+// Serializes snapshots, which share the scratch buffer below, and the resizing
+// of the buffers of the rings they read.
+static SpinMutex SnapshotMutex;
+static XRayRecord *SnapshotBuffer = nullptr;
+static uint64_t SnapshotBufferSize = 0;
+
+static thread_local atomic_uint8_t Guard{0};
+
+static ThreadRing *acquireRing() XRAY_NEVER_INSTRUMENT {
+  const uint64_t Size = atomic_load(&RingSize, memory_order_acquire);
+
+  // Take over the ring of a thread that exited, preferably one of the right
+  // size, so that the number of rings never exceeds the peak number of live
+  // threads.
+  ThreadRing *const First = reinterpret_cast<ThreadRing *>(
+      atomic_load(&Rings, memory_order_acquire));
+  for (auto *R = First; R != nullptr; R = R->Next) {
+    uint8_t Expected = 0;
+    if (R->Mask + 1 == Size &&
+        atomic_compare_exchange_strong(&R->InUse, &Expected, 1,
+                                       memory_order_acquire))
+      return R;
+  }
+  for (auto *R = First; R != nullptr; R = R->Next) {
+    uint8_t Expected = 0;
+    if (!atomic_compare_exchange_strong(&R->InUse, &Expected, 1,
+                                        memory_order_acquire))
+      continue;
+    // Keep the old buffer if there is no memory for the new one.
+    XRayRecord *Records = allocateBuffer<XRayRecord>(Size);
+    if (Records == nullptr)
+      return R;
+    SpinMutexLock Lock(&SnapshotMutex);
+    deallocateBuffer(R->Records, R->Mask + 1);
+    R->Records = Records;
+    R->Mask = Size - 1;
+    atomic_store(&R->Head, 0, memory_order_relaxed);
+    return R;
+  }
+
+  auto *R = allocate<ThreadRing>();
+  if (R == nullptr)
+    return nullptr;
+  R->Records = allocateBuffer<XRayRecord>(Size);
+  if (R->Records == nullptr) {
+    deallocate(R);
+    return nullptr;
+  }
+  atomic_store(&R->Head, 0, memory_order_relaxed);
+  atomic_store(&R->InUse, 1, memory_order_relaxed);
+  R->Mask = Size - 1;
+
+  uptr Expected = atomic_load(&Rings, memory_order_relaxed);
+  do
+    R->Next = reinterpret_cast<ThreadRing *>(Expected);
+  while (!atomic_compare_exchange_weak(&Rings, &Expected,
+                                       reinterpret_cast<uptr>(R),
+                                       memory_order_release));
+  return R;
+}
+
+static ThreadLocalData &getThreadLocalData() XRAY_NEVER_INSTRUMENT {
+  thread_local ThreadLocalData TLD;
+  if (UNLIKELY(TLD.Ring == nullptr)) {
+    TLD.Ring = acquireRing();
+    TLD.TId = GetTid();
+    pthread_setspecific(PThreadKey, &TLD);
+  }
+  return TLD;
+}
+
+static void TLDDestructor(void *P) XRAY_NEVER_INSTRUMENT {
+  ThreadLocalData &TLD = *reinterpret_cast<ThreadLocalData *>(P);
+  if (TLD.Ring == nullptr)
+    return;
+  // The records stay in the ring until the next owner overwrites them.
+  atomic_store(&TLD.Ring->InUse, 0, memory_order_release);
+  TLD.Ring = nullptr;
+}
+
+template <class RDTSC>
+void ringLog(int32_t FuncId, XRayEntryType Type,
+             RDTSC ReadTSC) XRAY_NEVER_INSTRUMENT {
+  if (!atomic_load(&RingRunning, memory_order_relaxed))
+    return;
+
+  RecursionGuard G(Guard);
+  if (!G)
+    return;
+
+  auto &TLD = getThreadLocalData();
+  if (TLD.Ring == nullptr)
+    return;
+
+  uint8_t CPU = 0;
+  uint64_t TSC = ReadTSC(CPU);
+
+  ThreadRing &R = *TLD.Ring;
+  const uint64_t Head = atomic_load(&R.Head, memory_order_relaxed);
+
+  // A snapshot copying the slot below while it is being overwritten must see
+  // the head stored for the previous record, so that it drops the copy. That
+  // store may not be reordered with the ones below: stores are kept in order
+  // on x86_64, elsewhere this takes a barrier.
+#if defined(__x86_64__)
+  atomic_signal_fence(memory_order_seq_cst);
+#else
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+#endif
+
+  XRayRecord &Record = R.Records[Head & R.Mask];
+  Record.RecordType = RecordTypes::NORMAL;
+  Record.CPU = CPU;
+  // The arguments are not recorded, so these are plain entries.
+  Record.Type = Type == XRayEntryType::LOG_ARGS_ENTRY ? XRayEntryType::ENTRY
+                                                      : Type;
+  Record.FuncId = FuncId;
+  Record.TSC = TSC;
+  Record.TId = TLD.TId;
+  Record.PId = PId;
+  atomic_store(&R.Head, Head + 1, memory_order_release);
+}
+
+static uint64_t emulatedTSC(uint8_t &CPU) XRAY_NEVER_INSTRUMENT {
+  timespec TS;
+  int result = clock_gettime(CLOCK_REALTIME, &TS);
+  if (result != 0) {
+    Report("clock_gettimg(2) return %d, errno=%d.", result, int(errno));
+    TS = {0, 0};
+  }
+  CPU = 0;
+  return TS.tv_sec * NanosecondsPerSecond + TS.tv_nsec;
+}
+
+void ringLoggingHandleArg0RealTSC(int32_t FuncId,
+                                  XRayEntryType Type) XRAY_NEVER_INSTRUMENT {
+  ringLog(FuncId, Type, readTSC);
+}
+
+void ringLoggingHandleArg0EmulateTSC(int32_t FuncId,
+                                     XRayEntryType Type) XRAY_NEVER_INSTRUMENT {
+  ringLog(FuncId, Type, emulatedTSC);
+}
+
+// Copies the records of R that are at least as recent as MinTSC to Buffer,
+// which holds at least R.Mask + 1 records, and returns their number.
+static uint64_t copyRing(const ThreadRing &R, uint64_t MinTSC,
+                         XRayRecord *Buffer) XRAY_NEVER_INSTRUMENT {
+  const uint64_t Size = R.Mask + 1;
+  const uint64_t End = atomic_load(&R.Head, memory_order_acquire);
+  const uint64_t Begin = End > Size ? End - Size : 0;
+  for (uint64_t I = Begin; I != End; ++I)
+    internal_memcpy(&Buffer[I - Begin], &R.Records[I & R.Mask],
+                    sizeof(XRayRecord));
+
+  // The owner may have gone on writing while we copied. It was at most
+  // writing the record of the head we see now, over the slot of index
+  // Head - Size, so only the records after that one are intact.
+  atomic_thread_fence(memory_order_acquire);
+  const uint64_t Head = atomic_load(&R.Head, memory_order_relaxed);
+  uint64_t First = Head + 1 > Size ? Head + 1 - Size : 0;
+  if (First < Begin)
+    First = Begin;
+
+  uint64_t Count = 0;
+  for (uint64_t I = First; I < End; ++I) {
+    const XRayRecord &Record = Buffer[I - Begin];
+    if (Record.TSC >= MinTSC)
+      internal_memcpy(&Buffer[Count++], &Record, sizeof(XRayRecord));
+  }
+  return Count;
+}
+
+XRayLogFlushStatus ringLoggingSnapshot(uint64_t WindowMs)
+    XRAY_NEVER_INSTRUMENT {
+  if (!atomic_load(&RingInitialized, memory_order_acquire)) {
+    if (Verbosity())
+      Report("Cannot take a snapshot before Ring Mode is initialized.\n");
+    return XRayLogFlushStatus::XRAY_LOG_NOT_FLUSHING;
+  }
+
+  // Keep this thread's own events out of its ring while copying it.
+  RecursionGuard G(Guard);
+  SpinMutexLock Lock(&SnapshotMutex);
+
+  uint64_t MinTSC = 0;
+  if (WindowMs != 0) {
+    uint8_t CPU = 0;
+    const uint64_t Now = atomic_load(&UseRealTSC, memory_order_acquire)
+                             ? readTSC(CPU)
+                             : emulatedTSC(CPU);
+    // Saturate rather than wrap around for windows too large to be counted in
+    // ticks, or when the frequency is unknown: they cover the whole trace.
+    const uint64_t Ticks = atomic_load(&TicksPerSec, memory_order_acquire);
+    const uint64_t Max = std::numeric_limits<uint64_t>::max();
+    const uint64_t Window =
+        Ticks == 0 || WindowMs > Max / Ticks ? Max : Ticks * WindowMs / 1000;
+    MinTSC = Now > Window ? Now - Window : 0;
+  }
+
+  LogWriter *LW = LogWriter::Open();
+  if (LW == nullptr)
+    return XRayLogFlushStatus::XRAY_LOG_NOT_FLUSHING;
+
+  XRayFileHeader Header;
+  // Version 3 includes pid inside records.
+  Header.Version = 3;
+  Header.Type = FileTypes::NAIVE_LOG;
+  Header.CycleFrequency = atomic_load(&CycleFrequency, memory_order_acquire);
+  // FIXME: Actually check whether we have 'constant_tsc' and 'nonstop_tsc'
+  // before setting the values in the header.
+  Header.ConstantTSC = 1;
+  Header.NonstopTSC = 1;
+  LW->WriteAll(reinterpret_cast<char *>(&Header),
+               reinterpret_cast<char *>(&Header) + sizeof(Header));
+
+  for (auto *R = reinterpret_cast<ThreadRing *>(
+           atomic_load(&Rings, memory_order_acquire));
+       R != nullptr; R = R->Next) {
+    const uint64_t Size = R->Mask + 1;
+    if (Size > SnapshotBufferSize) {
+      if (SnapshotBuffer != nullptr)
+        deallocateBuffer(SnapshotBuffer, SnapshotBufferSize);
+      SnapshotBuffer = allocateBuffer<XRayRecord>(Size);
+      SnapshotBufferSize = SnapshotBuffer != nullptr ? Size : 0;
+      if (SnapshotBuffer == nullptr)
+        break;
+    }
+    const uint64_t Count = copyRing(*R, MinTSC, SnapshotBuffer);
+    LW->WriteAll(reinterpret_cast<char *>(SnapshotBuffer),
+                 reinterpret_cast<char *>(SnapshotBuffer + Count));
+  }
+
+  LogWriter::Close(LW);
+  return XRayLogFlushStatus::XRAY_LOG_FLUSHED;
+}
+
+XRayLogInitStatus ringLoggingInit(UNUSED size_t BufferSize,
+                                  UNUSED size_t BufferMax, void *Options,
+                                  UNUSED size_t OptionsSize) XRAY_NEVER_INSTRUMENT {
+  static pthread_once_t OnceInit = PTHREAD_ONCE_INIT;
+  pthread_once(&OnceInit, +[] {
+    pthread_key_create(&PThreadKey, TLDDestructor);
+    atomic_store(&UseRealTSC, probeRequiredCPUFeatures(), memory_order_release);
+    atomic_store(&TicksPerSec,
+                 probeRequiredCPUFeatures() ? getTSCFrequency()
+                                            : NanosecondsPerSecond,
+                 memory_order_release);
+    if (atomic_load(&UseRealTSC, memory_order_relaxed))
+      atomic_store(&CycleFrequency, getTSCFrequency(), memory_order_release);
+    else if (Verbosity())
+      Report("WARNING: Required CPU features missing for XRay instrumentation, "
+             "using emulation instead.\n");
+    PId = internal_getpid();
+  });
+
+  FlagParser P;
+  RingFlags F;
+  F.setDefaults();
+  registerXRayRingFlags(&P, &F);
+  P.ParseString(useCompilerDefinedRingFlags());
+  auto *EnvOpts = GetEnv("XRAY_RING_OPTIONS");
+  P.ParseString(EnvOpts == nullptr ? "" : EnvOpts);
+  P.ParseString(static_cast<const char *>(Options));
+  if (F.thread_buffer_size <= 0) {
+    if (Verbosity())
+      Report("Invalid Ring Mode thread_buffer_size %d.\n",
+             F.thread_buffer_size);
+    return XRayLogInitStatus::XRAY_LOG_UNINITIALIZED;
+  }
+  *ringFlags() = F;
+
+  // Threads that already have a ring keep it, the new size applies to the
+  // threads that start from now on.
+  atomic_store(&RingSize, RoundUpToPowerOfTwo(F.thread_buffer_size),
+               memory_order_release);
+
+  __xray_set_handler(atomic_load(&UseRealTSC, memory_order_acquire)
+                         ? ringLoggingHandleArg0RealTSC
+                         : ringLoggingHandleArg0EmulateTSC);
+  __xray_remove_handler_arg1();
+  __xray_remove_customevent_handler();
+  __xray_remove_typedevent_handler();
+
+  atomic_store(&RingInitialized, 1, memory_order_release);
+  atomic_store(&RingRunning, 1, memory_order_release);
+  return XRayLogInitStatus::XRAY_LOG_INITIALIZED;
+}
+
+XRayLogInitStatus ringLoggingFinalize() XRAY_NEVER_INSTRUMENT {
+  // Stop recording, the rings stay around for snapshots.
+  uint8_t Expected = 1;
+  if (!atomic_compare_exchange_strong(&RingRunning, &Expected, 0,
+                                      memory_order_acq_rel) &&
+      Verbosity())
+    Report("Ring logging already finalized.\n");
+  return XRayLogInitStatus::XRAY_LOG_FINALIZED;
+}
+
+XRayLogFlushStatus ringLoggingFlush() XRAY_NEVER_INSTRUMENT {
+  return ringLoggingSnapshot(ringFlags()->flush_window_ms);
+}
+
+// This is a handler that, effectively, does nothing.
+void ringLoggingHandleArg0Empty(int32_t, XRayEntryType) XRAY_NEVER_INSTRUMENT {
+}
+
+bool ringLogDynamicInitializer() XRAY_NEVER_INSTRUMENT {
+  XRayLogImpl Impl{
+      ringLoggingInit,
+      ringLoggingFinalize,
+      ringLoggingHandleArg0Empty,
+      ringLoggingFlush,
+  };
+  auto RegistrationResult = __xray_log_register_mode("xray-ring", Impl);
+  if (RegistrationResult != XRayLogRegisterStatus::XRAY_REGISTRATION_OK &&
+      Verbosity())
+    Report("Cannot register XRay Ring Mode to 'xray-ring'; error = %d\n",
+           RegistrationResult);
+  if (!internal_strcmp(flags()->xray_mode, "xray-ring")) {
+    auto SelectResult = __xray_log_select_mode("xray-ring");
+    if (SelectResult != XRayLogRegisterStatus::XRAY_REGISTRATION_OK) {
+      if (Verbosity())
+        Report("Failed selecting XRay Ring Mode; error = %d\n", SelectResult);
+      return false;
+    }
+
+    auto *Env = GetEnv("XRAY_RING_OPTIONS");
+    auto InitResult =
+        __xray_log_init_mode("xray-ring", Env == nullptr ? "" : Env);
+    if (InitResult != XRayLogInitStatus::XRAY_LOG_INITIALIZED) {
+      if (Verbosity())
+        Report("Failed initializing XRay Ring Mode; error = %d\n", InitResult);
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace __xray
+
+extern "C" XRayLogFlushStatus
+__xray_ring_snapshot(uint64_t WindowMs) XRAY_NEVER_INSTRUMENT {
+  return __xray::ringLoggingSnapshot(WindowMs);
+}
+
+static auto UNUSED Unused = __xray::ringLogDynamicInitializer();
@@ -0,0 +1,45 @@
+//===-- xray_ring_logging.h -----------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file is a part of XRay, a function call tracing system.
+//
+//===----------------------------------------------------------------------===//
+#ifndef XRAY_XRAY_RING_LOGGING_H
+#define XRAY_XRAY_RING_LOGGING_H
+
+#include "xray/xray_log_interface.h"
+
+/// Ring Mode
+/// =========
+///
+/// This implementation hooks in through the XRay logging implementation
+/// framework. Every thread appends records to its own fixed size ring buffer,
+/// overwriting the oldest records once it is full, without taking any lock.
+/// Rings of exited threads are kept for snapshots and handed to the next
+/// threads that start, so memory use is bounded by the maximum number of
+/// threads running at once.
+///
+/// Nothing is written out until a snapshot is requested, either through
+/// `__xray_ring_snapshot(...)` or by flushing the log. Snapshots copy the
+/// records of a recent time window from all rings while they are being
+/// written to, and write them in the basic (naive) log format.
+
+namespace __xray {
+
+XRayLogInitStatus ringLoggingInit(size_t BufferSize, size_t BufferMax,
+                                  void *Options, size_t OptionsSize);
+XRayLogInitStatus ringLoggingFinalize();
+
+void ringLoggingHandleArg0RealTSC(int32_t FuncId, XRayEntryType Entry);
+void ringLoggingHandleArg0EmulateTSC(int32_t FuncId, XRayEntryType Entry);
+XRayLogFlushStatus ringLoggingFlush();
+XRayLogFlushStatus ringLoggingSnapshot(uint64_t WindowMs);
+
+} // namespace __xray
+
+#endif // XRAY_XRAY_RING_LOGGING_H
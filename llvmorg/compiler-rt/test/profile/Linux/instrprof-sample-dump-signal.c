@@ -0,0 +1,52 @@
+// Test sampled counter updates together with writing the profile of a
+// running process on a signal.
+//
+// RUN: %clang_profgen -mllvm -instrprof-sample-period=16 -o %t -O2 %s
+// RUN: %clang_profgen -mllvm -instrprof-sample-period=16 -o - -S -emit-llvm -O2 %s | FileCheck %s --check-prefix=IR
+// RUN: rm -f %t.profraw
+// RUN: env LLVM_PROFILE_FILE=%t.profraw %run %t %t.profraw
+// RUN: llvm-profdata show --all-functions --counts %t.profraw | FileCheck %s
+
+// IR: load i64, i64* @__llvm_profile_sample_countdown
+// IR: call i64 @__llvm_profile_sample_hit(i32 16)
+
+// CHECK: hot:
+// CHECK: Function count: {{[1-9][0-9]*}}
+
+#include <errno.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+volatile int Sink;
+
+__attribute__((noinline)) void hot(int I) { Sink += I; }
+
+int main(int argc, char **argv) {
+  int I;
+  // The handler is installed at startup, so run again with the number of
+  // SIGUSR1 on this target in the environment.
+  if (!getenv("LLVM_PROFILE_DUMP_SIGNAL")) {
+    char Sig[16];
+    snprintf(Sig, sizeof(Sig), "%d", SIGUSR1);
+    setenv("LLVM_PROFILE_DUMP_SIGNAL", Sig, 1);
+    execv(argv[0], argv);
+    return 4;
+  }
+
+  if (access(argv[1], F_OK) == 0 || errno != ENOENT)
+    return 1;
+
+  for (I = 0; I < 100000; ++I)
+    hot(I);
+  // SIGUSR1 only flags the request, the profile is written by the next
+  // sampled update.
+  if (raise(SIGUSR1) != 0)
+    return 2;
+  for (I = 0; I < 100000; ++I)
+    hot(I);
+
+  // The profile must have been written before exit.
+  return access(argv[1], F_OK) == 0 ? 0 : 3;
+}
@@ -0,0 +1,43 @@
+// Check that the ring mode keeps only the most recent records of a thread and
+// writes them out when a snapshot is requested.
+
+// RUN: %clangxx_xray -std=c++11 -fxray-modes=xray-ring %s -o %t -g
+// RUN: rm -f ring-mode-*
+// RUN: XRAY_OPTIONS="patch_premain=true xray_mode=xray-ring verbosity=1 \
+// RUN:     xray_logfile_base=ring-mode-" \
+// RUN: XRAY_RING_OPTIONS="thread_buffer_size=4" %run %t 2>&1 | FileCheck %s
+// RUN: %llvm_xray convert --symbolize --output-format=yaml -instr_map=%t \
+// RUN:     "`ls ring-mode-* | head -1`" | \
+// RUN:     FileCheck %s --check-prefix TRACE
+// RUN: rm -f ring-mode-*
+//
+// REQUIRES: x86_64-target-arch
+// REQUIRES: built-in-llvm-tree
+
+#include "xray/xray_ring_interface.h"
+
+#include <cstdio>
+
+[[clang::xray_always_instrument]] void __attribute__((noinline)) overwritten() {
+  printf("overwritten was called.\n");
+}
+
+[[clang::xray_always_instrument]] void __attribute__((noinline)) filler() {}
+
+[[clang::xray_always_instrument]] void __attribute__((noinline)) recent() {
+  printf("recent was called.\n");
+}
+
+int main(int argc, char *argv[]) {
+  overwritten(); // CHECK: overwritten was called.
+  for (int I = 0; I != 16; ++I)
+    filler();
+  recent(); // CHECK: recent was called.
+  auto Status = __xray_ring_snapshot(0);
+  printf("snapshot status = %d\n", Status);
+  // CHECK: snapshot status = 2
+}
+
+// TRACE-NOT: function: {{.*overwritten.*}}
+// TRACE-DAG: - { type: 0, func-id: [[FID:[0-9]+]], function: {{.*recent.*}}, cpu: {{.*}}, thread: {{.*}}, kind: function-enter, tsc: {{[0-9]+}}, data: '' }
+// TRACE-DAG: - { type: 0, func-id: [[FID]], function: {{.*recent.*}}, cpu: {{.*}}, thread: {{.*}}, kind: function-{{exit|tail-exit}}, tsc: {{[0-9]+}}, data: '' }
@@ -0,0 +1,72 @@
+//===-- Benchmark memchr implementation -----------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "LibcBenchmark.h"
+#include "LibcMemoryBenchmark.h"
+#include "LibcMemoryBenchmarkMain.h"
+#include "llvm/ADT/StringSwitch.h"
+#include "llvm/Support/raw_ostream.h"
+
+namespace __llvm_libc {
+void *memchr(const void *, int, size_t);
+} // namespace __llvm_libc
+
+namespace llvm {
+namespace libc_benchmarks {
+
+// The context encapsulates the buffers, parameters and the measure.
+struct MemchrContext : public BenchmarkRunner {
+  using FunctionPrototype = void *(*)(const void *, int, size_t);
+
+  struct ParameterType {
+    uint16_t SrcOffset = 0;
+  };
+
+  explicit MemchrContext(const StudyConfiguration &Conf)
+      : OD(Conf), SrcBuffer(Conf.BufferSize), PP(*this) {
+    // The searched character never appears so that exactly `Size` bytes are
+    // scanned.
+    for (char &C : SrcBuffer)
+      C = 'a';
+  }
+
+  // Needed by the ParameterProvider to update the current batch of parameter.
+  void Randomize(MutableArrayRef<ParameterType> Parameters) {
+    for (auto &P : Parameters) {
+      P.SrcOffset = OD(Gen);
+    }
+  }
+
+  ArrayRef<StringRef> getFunctionNames() const override {
+    static std::array<StringRef, 1> kFunctionNames = {"memchr"};
+    return kFunctionNames;
+  }
+
+  BenchmarkResult benchmark(const BenchmarkOptions &Options,
+                            StringRef FunctionName, size_t Size) override {
+    FunctionPrototype Function = StringSwitch<FunctionPrototype>(FunctionName)
+                                     .Case("memchr", &__llvm_libc::memchr);
+    return llvm::libc_benchmarks::benchmark(
+        Options, PP, [this, Function, Size](ParameterType p) {
+          return Function(SrcBuffer + p.SrcOffset, 'X', Size);
+        });
+  }
+
+private:
+  std::default_random_engine Gen;
+  OffsetDistribution OD;
+  AlignedBuffer SrcBuffer;
+  SmallParameterProvider<MemchrContext> PP;
+};
+
+std::unique_ptr<BenchmarkRunner> getRunner(const StudyConfiguration &Conf) {
+  return std::make_unique<MemchrContext>(Conf);
+}
+
+} // namespace libc_benchmarks
+} // namespace llvm
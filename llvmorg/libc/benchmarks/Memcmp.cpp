@@ -11,6 +11,20 @@
 #include "LibcMemoryBenchmarkMain.h"
 #include "llvm/ADT/StringSwitch.h"
 #include "llvm/Support/raw_ostream.h"
+#include <strings.h> // bcmp
+
+namespace __llvm_libc {
+int memcmp(const void *, const void *, size_t);
+int bcmp(const void *, const void *, size_t);
+} // namespace __llvm_libc
+
+#ifdef LIBC_BENCHMARK_HOST_LIBC
+#define MEMCMP ::memcmp
+#define BCMP ::bcmp
+#else
+#define MEMCMP __llvm_libc::memcmp
+#define BCMP __llvm_libc::bcmp
+#endif
 
 namespace llvm {
 namespace libc_benchmarks {
@@ -53,16 +67,16 @@ struct MemcmpContext : public BenchmarkRunner {
   }
 
   ArrayRef<StringRef> getFunctionNames() const override {
-    static std::array<StringRef, 1> kFunctionNames = {"memcmp"};
+    static std::array<StringRef, 2> kFunctionNames = {"memcmp", "bcmp"};
     return kFunctionNames;
   }
 
   BenchmarkResult benchmark(const BenchmarkOptions &Options,
                             StringRef FunctionName, size_t Size) override {
     CurrentSize = Size;
-    // FIXME: Add `bcmp` once we're guaranteed that the function is provided.
-    FunctionPrototype Function =
-        StringSwitch<FunctionPrototype>(FunctionName).Case("memcmp", &::memcmp);
+    FunctionPrototype Function = StringSwitch<FunctionPrototype>(FunctionName)
+                                     .Case("memcmp", &MEMCMP)
+                                     .Case("bcmp", &BCMP);
     return llvm::libc_benchmarks::benchmark(
         Options, PP, [this, Function, Size](ParameterType p) {
           return Function(ABuffer + p.Offset, BBuffer + p.Offset, Size);
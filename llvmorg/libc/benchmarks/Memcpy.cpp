@@ -17,6 +17,12 @@ namespace __llvm_libc {
 extern void *memcpy(void *__restrict, const void *__restrict, size_t);
 } // namespace __llvm_libc
 
+#ifdef LIBC_BENCHMARK_HOST_LIBC
+#define MEMCPY ::memcpy
+#else
+#define MEMCPY __llvm_libc::memcpy
+#endif
+
 namespace llvm {
 namespace libc_benchmarks {
 
@@ -49,7 +55,7 @@ struct MemcpyContext : public BenchmarkRunner {
   BenchmarkResult benchmark(const BenchmarkOptions &Options,
                             StringRef FunctionName, size_t Size) override {
     FunctionPrototype Function =
-        StringSwitch<FunctionPrototype>(FunctionName).Case("memcpy", &::memcpy);
+        StringSwitch<FunctionPrototype>(FunctionName).Case("memcpy", &MEMCPY);
     return llvm::libc_benchmarks::benchmark(
         Options, PP, [this, Function, Size](ParameterType p) {
           Function(DstBuffer + p.DstOffset, SrcBuffer + p.SrcOffset, Size);
@@ -0,0 +1,21 @@
+//===-- Implementation of bcmp --------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "src/string/bcmp.h"
+#include "src/__support/common.h"
+#include "src/string/memory_utils/memcmp_utils.h"
+
+namespace __llvm_libc {
+
+int LLVM_LIBC_ENTRYPOINT(bcmp)(const void *lhs, const void *rhs, size_t count) {
+  // The accumulated difference may not fit in an int.
+  return GeneralPurposeBcmp(reinterpret_cast<const char *>(lhs),
+                            reinterpret_cast<const char *>(rhs), count) != 0;
+}
+
+} // namespace __llvm_libc
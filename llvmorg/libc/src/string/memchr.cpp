@@ -8,17 +8,14 @@
 
 #include "src/string/memchr.h"
 #include "src/__support/common.h"
+#include "src/string/memory_utils/scan_utils.h"
 #include <stddef.h>
 
 namespace __llvm_libc {
 
-// TODO: Look at performance benefits of comparing words.
 void *LLVM_LIBC_ENTRYPOINT(memchr)(const void *src, int c, size_t n) {
-  const unsigned char *str = reinterpret_cast<const unsigned char *>(src);
-  const unsigned char ch = c;
-  for (; n && *str != ch; --n, ++str)
-    ;
-  return n ? const_cast<unsigned char *>(str) : nullptr;
+  return const_cast<char *>(FindEqual<BestScanner>(
+      reinterpret_cast<const char *>(src), static_cast<unsigned char>(c), n));
 }
 
 } // namespace __llvm_libc
@@ -0,0 +1,21 @@
+//===-- Implementation of memcmp ------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "src/string/memcmp.h"
+#include "src/__support/common.h"
+#include "src/string/memory_utils/memcmp_utils.h"
+
+namespace __llvm_libc {
+
+int LLVM_LIBC_ENTRYPOINT(memcmp)(const void *lhs, const void *rhs,
+                                 size_t count) {
+  return GeneralPurposeMemcmp(reinterpret_cast<const char *>(lhs),
+                              reinterpret_cast<const char *>(rhs), count);
+}
+
+} // namespace __llvm_libc
@@ -0,0 +1,21 @@
+//===-- Implementation of memmove -----------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "src/string/memmove.h"
+#include "src/__support/common.h"
+#include "src/string/memory_utils/memmove_utils.h"
+
+namespace __llvm_libc {
+
+void *LLVM_LIBC_ENTRYPOINT(memmove)(void *dst, const void *src, size_t count) {
+  GeneralPurposeMemmove(reinterpret_cast<char *>(dst),
+                        reinterpret_cast<const char *>(src), count);
+  return dst;
+}
+
+} // namespace __llvm_libc
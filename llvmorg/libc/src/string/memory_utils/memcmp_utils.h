@@ -0,0 +1,229 @@
+//===-- Memcmp utils --------------------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LIBC_SRC_STRING_MEMORY_UTILS_MEMCMP_UTILS_H
+#define LIBC_SRC_STRING_MEMORY_UTILS_MEMCMP_UTILS_H
+
+#include "src/string/memory_utils/utils.h"
+
+#include <stddef.h> // size_t
+#include <stdint.h> // uint64_t
+
+namespace __llvm_libc {
+
+// Loads a `T` from the possibly unaligned `ptr`.
+template <typename T> static T LoadWord(const char *ptr) {
+  T value;
+  __builtin_memcpy(&value, ptr, sizeof(T));
+  return value;
+}
+
+// Loads a `T` from `ptr` so that comparing two loaded values as integers
+// orders them like the bytes in memory.
+template <typename T> static T LoadBigEndian(const char *ptr) {
+  const T value = LoadWord<T>(ptr);
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  if (sizeof(T) == 2)
+    return __builtin_bswap16(value);
+  if (sizeof(T) == 4)
+    return __builtin_bswap32(value);
+  if (sizeof(T) == 8)
+    return __builtin_bswap64(value);
+#endif
+  return value;
+}
+
+//------------------------------------------------------------------------------
+// bcmp
+//------------------------------------------------------------------------------
+
+// Returns a value that is zero if and only if the `kBlockSize` bytes at `a`
+// and `b` are equal.
+//
+// Differences are accumulated without branches so that the compiler can use
+// the widest vector registers available for the larger blocks.
+template <size_t kBlockSize>
+static uint64_t BcmpBlock(const char *a, const char *b) {
+  static_assert(kBlockSize < 8 || kBlockSize % 8 == 0, "unsupported size");
+  if (kBlockSize == 1)
+    return LoadWord<uint8_t>(a) ^ LoadWord<uint8_t>(b);
+  if (kBlockSize == 2)
+    return LoadWord<uint16_t>(a) ^ LoadWord<uint16_t>(b);
+  if (kBlockSize == 4)
+    return LoadWord<uint32_t>(a) ^ LoadWord<uint32_t>(b);
+  uint64_t diff = 0;
+  for (size_t i = 0; i < kBlockSize; i += 8)
+    diff |= LoadWord<uint64_t>(a + i) ^ LoadWord<uint64_t>(b + i);
+  return diff;
+}
+
+// Compares `kBlockSize` bytes twice with an overlap between the two.
+//
+// Precondition: `count >= kBlockSize && count <= 2 * kBlockSize`.
+template <size_t kBlockSize>
+static uint64_t BcmpBlockOverlap(const char *a, const char *b, size_t count) {
+  const size_t offset = count - kBlockSize;
+  return BcmpBlock<kBlockSize>(a, b) |
+         BcmpBlock<kBlockSize>(a + offset, b + offset);
+}
+
+// Compares `count` bytes by blocks of `kBlockSize` bytes, stopping at the
+// first block that differs. Loads from `a` in the middle of the buffer are
+// aligned to `kBlockSize` so that a block never spans two cache lines of `a`.
+//
+// Precondition: `count > 2 * kBlockSize` for efficiency.
+//               `count >= kBlockSize` for correctness.
+template <size_t kBlockSize>
+static uint64_t BcmpAlignedBlocks(const char *a, const char *b, size_t count) {
+  if (uint64_t diff = BcmpBlock<kBlockSize>(a, b)) // Compare first block
+    return diff;
+
+  // Compare aligned blocks
+  size_t offset = kBlockSize - offset_from_last_aligned<kBlockSize>(a);
+  for (; offset + kBlockSize < count; offset += kBlockSize)
+    if (uint64_t diff = BcmpBlock<kBlockSize>(a + offset, b + offset))
+      return diff;
+
+  // Compare last block
+  return BcmpBlock<kBlockSize>(a + count - kBlockSize, b + count - kBlockSize);
+}
+
+// A general purpose implementation following the size classes of memcpy. Only
+// equality matters so the blocks are compared without looking for the first
+// byte that differs.
+inline static uint64_t GeneralPurposeBcmp(const char *a, const char *b,
+                                          size_t count) {
+  if (count == 0)
+    return 0;
+  if (count == 1)
+    return BcmpBlock<1>(a, b);
+  if (count == 2)
+    return BcmpBlock<2>(a, b);
+  if (count == 3)
+    return BcmpBlockOverlap<2>(a, b, count);
+  if (count == 4)
+    return BcmpBlock<4>(a, b);
+  if (count < 8)
+    return BcmpBlockOverlap<4>(a, b, count);
+  if (count == 8)
+    return BcmpBlock<8>(a, b);
+  if (count < 16)
+    return BcmpBlockOverlap<8>(a, b, count);
+  if (count == 16)
+    return BcmpBlock<16>(a, b);
+  if (count < 32)
+    return BcmpBlockOverlap<16>(a, b, count);
+  if (count < 64)
+    return BcmpBlockOverlap<32>(a, b, count);
+  if (count <= 128)
+    return BcmpBlockOverlap<64>(a, b, count);
+  return BcmpAlignedBlocks<32>(a, b, count);
+}
+
+//------------------------------------------------------------------------------
+// memcmp
+//------------------------------------------------------------------------------
+
+// Returns the difference of the `T` values at `a` and `b` in memory order.
+template <typename T> static int CompareWord(const char *a, const char *b) {
+  const T left = LoadBigEndian<T>(a);
+  const T right = LoadBigEndian<T>(b);
+  if (sizeof(T) < sizeof(int))
+    return int(left) - int(right);
+  return left < right ? -1 : left > right ? 1 : 0;
+}
+
+// Compares the `kBlockSize` bytes at `a` and `b` and returns a negative, zero
+// or positive value like memcmp.
+//
+// Equality is checked first as in `BcmpBlock`, ordering only needs to be
+// computed for the block that differs.
+template <size_t kBlockSize>
+static int MemcmpBlock(const char *a, const char *b) {
+  if (kBlockSize == 1)
+    return CompareWord<uint8_t>(a, b);
+  if (kBlockSize == 2)
+    return CompareWord<uint16_t>(a, b);
+  if (kBlockSize == 4)
+    return CompareWord<uint32_t>(a, b);
+  if (kBlockSize == 8)
+    return CompareWord<uint64_t>(a, b);
+  if (!BcmpBlock<kBlockSize>(a, b))
+    return 0;
+  for (size_t i = 0; i < kBlockSize; i += 8)
+    if (int result = CompareWord<uint64_t>(a + i, b + i))
+      return result;
+  return 0;
+}
+
+// Compares `kBlockSize` bytes twice with an overlap between the two. When the
+// first block is equal, the first difference can only be in the last block.
+//
+// Precondition: `count >= kBlockSize && count <= 2 * kBlockSize`.
+template <size_t kBlockSize>
+static int MemcmpBlockOverlap(const char *a, const char *b, size_t count) {
+  if (int result = MemcmpBlock<kBlockSize>(a, b))
+    return result;
+  const size_t offset = count - kBlockSize;
+  return MemcmpBlock<kBlockSize>(a + offset, b + offset);
+}
+
+// Same as `BcmpAlignedBlocks` but returns the ordering of the first block that
+// differs.
+//
+// Precondition: `count > 2 * kBlockSize` for efficiency.
+//               `count >= kBlockSize` for correctness.
+template <size_t kBlockSize>
+static int MemcmpAlignedBlocks(const char *a, const char *b, size_t count) {
+  if (int result = MemcmpBlock<kBlockSize>(a, b)) // Compare first block
+    return result;
+
+  // Compare aligned blocks
+  size_t offset = kBlockSize - offset_from_last_aligned<kBlockSize>(a);
+  for (; offset + kBlockSize < count; offset += kBlockSize)
+    if (int result = MemcmpBlock<kBlockSize>(a + offset, b + offset))
+      return result;
+
+  // Compare last block
+  return MemcmpBlock<kBlockSize>(a + count - kBlockSize,
+                                 b + count - kBlockSize);
+}
+
+// A general purpose implementation following the size classes of memcpy.
+inline static int GeneralPurposeMemcmp(const char *a, const char *b,
+                                       size_t count) {
+  if (count == 0)
+    return 0;
+  if (count == 1)
+    return MemcmpBlock<1>(a, b);
+  if (count == 2)
+    return MemcmpBlock<2>(a, b);
+  if (count == 3)
+    return MemcmpBlockOverlap<2>(a, b, count);
+  if (count == 4)
+    return MemcmpBlock<4>(a, b);
+  if (count < 8)
+    return MemcmpBlockOverlap<4>(a, b, count);
+  if (count == 8)
+    return MemcmpBlock<8>(a, b);
+  if (count < 16)
+    return MemcmpBlockOverlap<8>(a, b, count);
+  if (count == 16)
+    return MemcmpBlock<16>(a, b);
+  if (count < 32)
+    return MemcmpBlockOverlap<16>(a, b, count);
+  if (count < 64)
+    return MemcmpBlockOverlap<32>(a, b, count);
+  if (count <= 128)
+    return MemcmpBlockOverlap<64>(a, b, count);
+  return MemcmpAlignedBlocks<32>(a, b, count);
+}
+
+} // namespace __llvm_libc
+
+#endif //  LIBC_SRC_STRING_MEMORY_UTILS_MEMCMP_UTILS_H
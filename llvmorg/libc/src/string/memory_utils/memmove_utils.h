@@ -0,0 +1,149 @@
+//===-- Memmove utils -------------------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LIBC_SRC_STRING_MEMORY_UTILS_MEMMOVE_UTILS_H
+#define LIBC_SRC_STRING_MEMORY_UTILS_MEMMOVE_UTILS_H
+
+#include "src/string/memory_utils/memcpy_utils.h"
+#include "src/string/memory_utils/utils.h"
+
+#include <stddef.h> // size_t
+#include <stdint.h> // uintptr_t
+
+namespace __llvm_libc {
+
+// Source and destination of a move may overlap so bytes are always loaded into
+// a temporary before being stored. The temporary can't alias either buffer,
+// which makes it valid to use `CopyBlock` on both sides.
+template <size_t kBlockSize> struct MoveBuffer {
+  char bytes[kBlockSize];
+};
+
+template <size_t kBlockSize>
+static MoveBuffer<kBlockSize> LoadBlock(const char *src) {
+  MoveBuffer<kBlockSize> buffer;
+  CopyBlock<kBlockSize>(buffer.bytes, src);
+  return buffer;
+}
+
+template <size_t kBlockSize>
+static void StoreBlock(char *dst, const MoveBuffer<kBlockSize> &buffer) {
+  CopyBlock<kBlockSize>(dst, buffer.bytes);
+}
+
+// Moves `kBlockSize` bytes from `src` to `dst`.
+template <size_t kBlockSize> static void MoveBlock(char *dst, const char *src) {
+  StoreBlock<kBlockSize>(dst, LoadBlock<kBlockSize>(src));
+}
+
+// Moves `kBlockSize` bytes twice with an overlap between the two. Both blocks
+// are loaded before any of them is stored.
+//
+// [1234567812345678123]
+// [__XXXXXXXXXXXXXX___]
+// [__XXXXXXXX_________]
+// [________XXXXXXXX___]
+//
+// Precondition: `count >= kBlockSize && count <= 2 * kBlockSize`.
+template <size_t kBlockSize>
+static void MoveBlockOverlap(char *dst, const char *src, size_t count) {
+  const size_t offset = count - kBlockSize;
+  const auto head = LoadBlock<kBlockSize>(src);
+  const auto tail = LoadBlock<kBlockSize>(src + offset);
+  StoreBlock<kBlockSize>(dst, head);
+  StoreBlock<kBlockSize>(dst + offset, tail);
+}
+
+// Moves `count` bytes by blocks of `kBlockSize` bytes from the start to the
+// end of the buffers. Stores in the middle of the buffer are aligned to
+// `kBlockSize`.
+//
+// This is correct as long as `dst` does not start after `src`: each store only
+// overwrites source bytes that have already been loaded. The first and last
+// blocks are loaded up front as they overlap the blocks in the middle.
+//
+// Precondition: `count > 2 * kBlockSize` for efficiency.
+//               `count >= kBlockSize` for correctness.
+template <size_t kBlockSize>
+static void MoveAlignedBlocksForward(char *dst, const char *src,
+                                     size_t count) {
+  const auto head = LoadBlock<kBlockSize>(src);
+  const auto tail = LoadBlock<kBlockSize>(src + count - kBlockSize);
+
+  size_t offset = kBlockSize - offset_from_last_aligned<kBlockSize>(dst);
+  for (; offset + kBlockSize < count; offset += kBlockSize)
+    MoveBlock<kBlockSize>(dst + offset, src + offset);
+
+  StoreBlock<kBlockSize>(dst, head);
+  StoreBlock<kBlockSize>(dst + count - kBlockSize, tail);
+}
+
+// Same as `MoveAlignedBlocksForward` but from the end to the start of the
+// buffers, this is correct as long as `dst` does not start before `src`.
+//
+// Precondition: `count > 2 * kBlockSize` for efficiency.
+//               `count >= kBlockSize` for correctness.
+template <size_t kBlockSize>
+static void MoveAlignedBlocksBackward(char *dst, const char *src,
+                                      size_t count) {
+  const auto head = LoadBlock<kBlockSize>(src);
+  const auto tail = LoadBlock<kBlockSize>(src + count - kBlockSize);
+
+  size_t offset = count - offset_from_last_aligned<kBlockSize>(dst + count);
+  while (offset > kBlockSize) {
+    offset -= kBlockSize;
+    MoveBlock<kBlockSize>(dst + offset, src + offset);
+  }
+
+  StoreBlock<kBlockSize>(dst + count - kBlockSize, tail);
+  StoreBlock<kBlockSize>(dst, head);
+}
+
+// A general purpose implementation following the size classes of memcpy.
+//
+// Up to 128 bytes the whole source is loaded before anything is stored so that
+// the direction of the copy doesn't matter. Above that the direction is picked
+// so that no source byte is overwritten before being read, buffers that don't
+// overlap are copied forward.
+inline static void GeneralPurposeMemmove(char *dst, const char *src,
+                                         size_t count) {
+  if (count == 0)
+    return;
+  if (count == 1)
+    return MoveBlock<1>(dst, src);
+  if (count == 2)
+    return MoveBlock<2>(dst, src);
+  if (count == 3)
+    return MoveBlock<3>(dst, src);
+  if (count == 4)
+    return MoveBlock<4>(dst, src);
+  if (count < 8)
+    return MoveBlockOverlap<4>(dst, src, count);
+  if (count == 8)
+    return MoveBlock<8>(dst, src);
+  if (count < 16)
+    return MoveBlockOverlap<8>(dst, src, count);
+  if (count == 16)
+    return MoveBlock<16>(dst, src);
+  if (count < 32)
+    return MoveBlockOverlap<16>(dst, src, count);
+  if (count < 64)
+    return MoveBlockOverlap<32>(dst, src, count);
+  if (count <= 128)
+    return MoveBlockOverlap<64>(dst, src, count);
+  // Unsigned arithmetic makes this true when `dst` is before `src` as well as
+  // when `dst` starts past the end of `src`.
+  if (reinterpret_cast<uintptr_t>(dst) - reinterpret_cast<uintptr_t>(src) >=
+      count)
+    return MoveAlignedBlocksForward<32>(dst, src, count);
+  return MoveAlignedBlocksBackward<32>(dst, src, count);
+}
+
+} // namespace __llvm_libc
+
+#endif //  LIBC_SRC_STRING_MEMORY_UTILS_MEMMOVE_UTILS_H
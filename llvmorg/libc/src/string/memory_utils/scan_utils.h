@@ -0,0 +1,269 @@
+//===-- Scan utils ----------------------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LIBC_SRC_STRING_MEMORY_UTILS_SCAN_UTILS_H
+#define LIBC_SRC_STRING_MEMORY_UTILS_SCAN_UTILS_H
+
+#include "src/string/memory_utils/utils.h"
+
+#include <stddef.h> // size_t
+#include <stdint.h> // uintptr_t
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace __llvm_libc {
+
+// Scanning for a terminator or a given byte can't rely on a size being known
+// up front, so reads are done by blocks that never cross a page boundary:
+// - reads from an address aligned to the block size always stay within a
+//   page since the block size divides the page size,
+// - unaligned reads are only done when the block is known to fit in the
+//   current page (see `CrossesPage`).
+// Bytes read before the start or past the end of the string are masked out.
+//
+// A `Scanner` provides:
+// - `kSize` the number of bytes in a block, a power of two,
+// - `Mask` an unsigned integer type with `kBitsPerByte` bits per byte of the
+//   block, byte `i` of the block maps to bit `i * kBitsPerByte`,
+// - `ZeroMask(block)` the bytes equal to zero,
+// - `ZeroOrEqualMask(block, c)` the bytes equal to zero or `c`,
+// - `EqualMask(block, c)` the bytes equal to `c`,
+// - `DiffOrZeroMask(a, b)` the bytes that differ or are zero in `a`,
+// where `block`, `a` and `b` point to `kSize` readable bytes.
+
+// The smallest page size of all supported targets.
+static constexpr size_t kMinPageSize = 4096;
+
+// Returns whether reading `kBlockSize` bytes from `ptr` may cross a page
+// boundary.
+template <size_t kBlockSize> static bool CrossesPage(const void *ptr) {
+  static_assert(kBlockSize <= kMinPageSize, "block must fit in a page");
+  return offset_from_last_aligned<kMinPageSize>(ptr) >
+         intptr_t(kMinPageSize - kBlockSize);
+}
+
+// Returns `ptr` rounded down to a multiple of `kBlockSize`.
+template <size_t kBlockSize> static const char *AlignDown(const char *ptr) {
+  return ptr - offset_from_last_aligned<kBlockSize>(ptr);
+}
+
+// Returns the index of the first byte set in the non zero `mask`.
+template <typename Scanner>
+static size_t FirstIndex(typename Scanner::Mask mask) {
+  if (sizeof(typename Scanner::Mask) <= sizeof(unsigned))
+    return __builtin_ctz(mask) / Scanner::kBitsPerByte;
+  return __builtin_ctzll(mask) / Scanner::kBitsPerByte;
+}
+
+// Returns `mask` without the bytes before index `offset`.
+template <typename Scanner>
+static typename Scanner::Mask MaskFrom(typename Scanner::Mask mask,
+                                       size_t offset) {
+  using Mask = typename Scanner::Mask;
+  return mask & (~Mask(0) << (offset * Scanner::kBitsPerByte));
+}
+
+// Word at a time scanning, available on all targets.
+struct WordScanner {
+  using Mask = uintptr_t;
+  static constexpr size_t kSize = sizeof(uintptr_t);
+  static constexpr size_t kBitsPerByte = 8;
+
+  static constexpr uintptr_t kLowBits = ~uintptr_t(0) / 0xFF * 0x7F;
+
+  static uintptr_t Load(const char *ptr) {
+    uintptr_t value;
+    __builtin_memcpy(&value, ptr, kSize);
+    return value;
+  }
+
+  // Returns a word with the high bit set in each zero byte of `value` and all
+  // other bits cleared. Unlike the usual `(v - 0x01..) & ~v & 0x80..` trick
+  // this is exact for all bytes, so the result can be used on big endian
+  // targets and for bytes past the first match.
+  static uintptr_t ZeroBytes(uintptr_t value) {
+    return ~(((value & kLowBits) + kLowBits) | value | kLowBits);
+  }
+
+  // Moves the flag of each byte from its high to its low bit, matching the
+  // memory order of the bytes on big endian targets.
+  static Mask ToMask(uintptr_t flags) {
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    return flags >> 7;
+#else
+    if (kSize == 8)
+      return __builtin_bswap64(flags >> 7);
+    return __builtin_bswap32(flags >> 7);
+#endif
+  }
+
+  static Mask ZeroMask(const char *block) {
+    return ToMask(ZeroBytes(Load(block)));
+  }
+  static Mask EqualMask(const char *block, unsigned char c) {
+    return ToMask(ZeroBytes(Load(block) ^ (~uintptr_t(0) / 0xFF * c)));
+  }
+  static Mask ZeroOrEqualMask(const char *block, unsigned char c) {
+    const uintptr_t value = Load(block);
+    return ToMask(ZeroBytes(value) |
+                  ZeroBytes(value ^ (~uintptr_t(0) / 0xFF * c)));
+  }
+  static Mask DiffOrZeroMask(const char *a, const char *b) {
+    const uintptr_t value = Load(a);
+    const uintptr_t diff = ~ZeroBytes(value ^ Load(b)) & ~kLowBits;
+    return ToMask(ZeroBytes(value) | diff);
+  }
+};
+
+#if defined(__SSE2__)
+struct Sse2Scanner {
+  using Mask = uint32_t;
+  static constexpr size_t kSize = 16;
+  static constexpr size_t kBitsPerByte = 1;
+
+  static __m128i Load(const char *ptr) {
+    return _mm_loadu_si128(reinterpret_cast<const __m128i *>(ptr));
+  }
+
+  static Mask ZeroMask(const char *block) {
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(Load(block), _mm_setzero_si128()));
+  }
+  static Mask EqualMask(const char *block, unsigned char c) {
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(Load(block), _mm_set1_epi8(c)));
+  }
+  static Mask ZeroOrEqualMask(const char *block, unsigned char c) {
+    const __m128i value = Load(block);
+    return _mm_movemask_epi8(
+        _mm_or_si128(_mm_cmpeq_epi8(value, _mm_setzero_si128()),
+                     _mm_cmpeq_epi8(value, _mm_set1_epi8(c))));
+  }
+  static Mask DiffOrZeroMask(const char *a, const char *b) {
+    const __m128i value = Load(a);
+    // Bytes that are equal and non zero have their bit cleared.
+    const Mask equal = _mm_movemask_epi8(_mm_cmpeq_epi8(value, Load(b)));
+    return ZeroMask(a) | (~equal & 0xFFFF);
+  }
+};
+#endif // __SSE2__
+
+#if defined(__AVX2__)
+struct Avx2Scanner {
+  using Mask = uint32_t;
+  static constexpr size_t kSize = 32;
+  static constexpr size_t kBitsPerByte = 1;
+
+  static __m256i Load(const char *ptr) {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(ptr));
+  }
+
+  static Mask ZeroMask(const char *block) {
+    return _mm256_movemask_epi8(
+        _mm256_cmpeq_epi8(Load(block), _mm256_setzero_si256()));
+  }
+  static Mask EqualMask(const char *block, unsigned char c) {
+    return _mm256_movemask_epi8(
+        _mm256_cmpeq_epi8(Load(block), _mm256_set1_epi8(c)));
+  }
+  static Mask ZeroOrEqualMask(const char *block, unsigned char c) {
+    const __m256i value = Load(block);
+    return _mm256_movemask_epi8(
+        _mm256_or_si256(_mm256_cmpeq_epi8(value, _mm256_setzero_si256()),
+                        _mm256_cmpeq_epi8(value, _mm256_set1_epi8(c))));
+  }
+  static Mask DiffOrZeroMask(const char *a, const char *b) {
+    const __m256i value = Load(a);
+    const Mask equal = _mm256_movemask_epi8(_mm256_cmpeq_epi8(value, Load(b)));
+    return ZeroMask(a) | ~equal;
+  }
+};
+#endif // __AVX2__
+
+// The widest scanner available for the target the code is compiled for.
+#if defined(__AVX2__)
+using BestScanner = Avx2Scanner;
+#elif defined(__SSE2__)
+using BestScanner = Sse2Scanner;
+#else
+using BestScanner = WordScanner;
+#endif
+
+// Returns a pointer to the first zero byte at or after `src`.
+template <typename Scanner> static const char *FindZero(const char *src) {
+  const char *block = AlignDown<Scanner::kSize>(src);
+  auto mask = MaskFrom<Scanner>(Scanner::ZeroMask(block), src - block);
+  while (!mask) {
+    block += Scanner::kSize;
+    mask = Scanner::ZeroMask(block);
+  }
+  return block + FirstIndex<Scanner>(mask);
+}
+
+// Returns a pointer to the first byte equal to `c` or zero at or after `src`.
+template <typename Scanner>
+static const char *FindZeroOrEqual(const char *src, unsigned char c) {
+  const char *block = AlignDown<Scanner::kSize>(src);
+  auto mask =
+      MaskFrom<Scanner>(Scanner::ZeroOrEqualMask(block, c), src - block);
+  while (!mask) {
+    block += Scanner::kSize;
+    mask = Scanner::ZeroOrEqualMask(block, c);
+  }
+  return block + FirstIndex<Scanner>(mask);
+}
+
+// Returns a pointer to the first byte equal to `c` in the `count` bytes
+// starting at `src`, or nullptr if there is none.
+template <typename Scanner>
+static const char *FindEqual(const char *src, unsigned char c, size_t count) {
+  if (count == 0)
+    return nullptr;
+  const uintptr_t begin = reinterpret_cast<uintptr_t>(src);
+  // Clamp the end so that huge counts don't wrap around.
+  const uintptr_t end =
+      count > UINTPTR_MAX - begin ? UINTPTR_MAX : begin + count;
+  const char *block = AlignDown<Scanner::kSize>(src);
+  auto mask = MaskFrom<Scanner>(Scanner::EqualMask(block, c), src - block);
+  while (!mask) {
+    block += Scanner::kSize;
+    if (reinterpret_cast<uintptr_t>(block) >= end)
+      return nullptr;
+    mask = Scanner::EqualMask(block, c);
+  }
+  const char *match = block + FirstIndex<Scanner>(mask);
+  return reinterpret_cast<uintptr_t>(match) < end ? match : nullptr;
+}
+
+// Returns the difference between the first differing bytes of the strings
+// `left` and `right`, or zero if they are equal.
+template <typename Scanner>
+static int CompareStrings(const char *left, const char *right) {
+  for (;;) {
+    if (CrossesPage<Scanner::kSize>(left) ||
+        CrossesPage<Scanner::kSize>(right)) {
+      // Step bytewise until the end of the page and retry.
+      for (size_t i = 0; i < Scanner::kSize; ++i, ++left, ++right)
+        if (*left == 0 || *left != *right)
+          return static_cast<unsigned char>(*left) -
+                 static_cast<unsigned char>(*right);
+      continue;
+    }
+    if (auto mask = Scanner::DiffOrZeroMask(left, right)) {
+      const size_t index = FirstIndex<Scanner>(mask);
+      return static_cast<unsigned char>(left[index]) -
+             static_cast<unsigned char>(right[index]);
+    }
+    left += Scanner::kSize;
+    right += Scanner::kSize;
+  }
+}
+
+} // namespace __llvm_libc
+
+#endif // LIBC_SRC_STRING_MEMORY_UTILS_SCAN_UTILS_H
@@ -9,17 +9,16 @@
 #include "src/string/strchr.h"
 
 #include "src/__support/common.h"
+#include "src/string/memory_utils/scan_utils.h"
 
 namespace __llvm_libc {
 
-// TODO: Look at performance benefits of comparing words.
 char *LLVM_LIBC_ENTRYPOINT(strchr)(const char *src, int c) {
-  unsigned char *str =
-      const_cast<unsigned char *>(reinterpret_cast<const unsigned char *>(src));
   const unsigned char ch = c;
-  for (; *str && *str != ch; ++str)
-    ;
-  return *str == ch ? reinterpret_cast<char *>(str) : nullptr;
+  const char *str = FindZeroOrEqual<BestScanner>(src, ch);
+  // When `ch` is zero the terminator is the character searched for.
+  return static_cast<unsigned char>(*str) == ch ? const_cast<char *>(str)
+                                                : nullptr;
 }
 
 } // namespace __llvm_libc
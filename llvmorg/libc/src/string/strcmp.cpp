@@ -9,15 +9,12 @@
 #include "src/string/strcmp.h"
 
 #include "src/__support/common.h"
+#include "src/string/memory_utils/scan_utils.h"
 
 namespace __llvm_libc {
 
-// TODO: Look at benefits for comparing words at a time.
 int LLVM_LIBC_ENTRYPOINT(strcmp)(const char *left, const char *right) {
-  for (; *left && *left == *right; ++left, ++right)
-    ;
-  return *reinterpret_cast<const unsigned char *>(left) -
-         *reinterpret_cast<const unsigned char *>(right);
+  return CompareStrings<BestScanner>(left, right);
 }
 
 } // namespace __llvm_libc
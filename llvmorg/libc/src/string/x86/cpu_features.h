@@ -0,0 +1,70 @@
+//===-- x86 CPU feature detection -------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_LIBC_SRC_STRING_X86_CPU_FEATURES_H
+#define LLVM_LIBC_SRC_STRING_X86_CPU_FEATURES_H
+
+#include <cpuid.h>
+#include <stdint.h> // uint64_t
+
+namespace __llvm_libc {
+namespace x86 {
+
+// The features relevant to the selection of string function variants, as a
+// bitmask.
+enum CpuFeature : unsigned {
+  kSse2 = 1U << 0,
+  kAvx = 1U << 1,
+  kAvx2 = 1U << 2,
+  kAvx512f = 1U << 3,
+};
+
+// Reads the extended control register holding the register states enabled by
+// the operating system. Written in assembly so that callers don't need to be
+// compiled with -mxsave.
+static inline uint64_t ReadXcr0() {
+  uint32_t eax, edx;
+  asm("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+  return (uint64_t(edx) << 32) | eax;
+}
+
+// Returns the features of the running CPU.
+//
+// This only relies on `cpuid`, which makes it usable before any runtime
+// initialization took place. Vector extensions are only reported when the
+// operating system saves the corresponding registers on context switches.
+static inline unsigned DetectCpuFeatures() {
+  unsigned eax, ebx, ecx, edx;
+  if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+    return 0;
+  unsigned features = 0;
+  if (edx & bit_SSE2)
+    features |= kSse2;
+  if (!(ecx & bit_OSXSAVE) || !(ecx & bit_AVX))
+    return features;
+
+  constexpr uint64_t kSseAndAvxState = 0x6;
+  constexpr uint64_t kAvx512State = 0xE0;
+  const uint64_t xcr0 = ReadXcr0();
+  if ((xcr0 & kSseAndAvxState) != kSseAndAvxState)
+    return features;
+  features |= kAvx;
+
+  if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx))
+    return features;
+  if (ebx & bit_AVX2)
+    features |= kAvx2;
+  if ((ebx & bit_AVX512F) && (xcr0 & kAvx512State) == kAvx512State)
+    features |= kAvx512f;
+  return features;
+}
+
+} // namespace x86
+} // namespace __llvm_libc
+
+#endif // LLVM_LIBC_SRC_STRING_X86_CPU_FEATURES_H
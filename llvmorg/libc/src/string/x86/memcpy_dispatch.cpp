@@ -0,0 +1,34 @@
+//===-- Run time dispatched implementation of memcpy ----------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "src/string/memcpy.h"
+#include "src/__support/common.h"
+#include "src/string/x86/string_variants.h"
+
+namespace __llvm_libc {
+
+// Points to the resolver until the first call, then to the selected variant.
+// All threads would select the same variant so concurrent first calls are
+// harmless, the atomic accesses only make that well defined.
+static void *ResolveMemcpy(void *__restrict dst, const void *__restrict src,
+                           size_t size);
+static x86::MemcpyFunction memcpy_impl = &ResolveMemcpy;
+
+static void *ResolveMemcpy(void *__restrict dst, const void *__restrict src,
+                           size_t size) {
+  const x86::MemcpyFunction impl = x86::SelectMemcpy(x86::DetectCpuFeatures());
+  __atomic_store_n(&memcpy_impl, impl, __ATOMIC_RELAXED);
+  return impl(dst, src, size);
+}
+
+void *LLVM_LIBC_ENTRYPOINT(memcpy)(void *__restrict dst,
+                                   const void *__restrict src, size_t size) {
+  return __atomic_load_n(&memcpy_impl, __ATOMIC_RELAXED)(dst, src, size);
+}
+
+} // namespace __llvm_libc
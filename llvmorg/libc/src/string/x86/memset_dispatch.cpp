@@ -0,0 +1,29 @@
+//===-- Run time dispatched implementation of memset ----------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "src/string/memset.h"
+#include "src/__support/common.h"
+#include "src/string/x86/string_variants.h"
+
+namespace __llvm_libc {
+
+// See memcpy_dispatch.cpp.
+static void *ResolveMemset(void *dst, int value, size_t count);
+static x86::MemsetFunction memset_impl = &ResolveMemset;
+
+static void *ResolveMemset(void *dst, int value, size_t count) {
+  const x86::MemsetFunction impl = x86::SelectMemset(x86::DetectCpuFeatures());
+  __atomic_store_n(&memset_impl, impl, __ATOMIC_RELAXED);
+  return impl(dst, value, count);
+}
+
+void *LLVM_LIBC_ENTRYPOINT(memset)(void *dst, int value, size_t count) {
+  return __atomic_load_n(&memset_impl, __ATOMIC_RELAXED)(dst, value, count);
+}
+
+} // namespace __llvm_libc
@@ -0,0 +1,41 @@
+//===-- x86 string function variants --------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "src/string/x86/string_variants.h"
+#include "src/string/memory_utils/memset_utils.h"
+#include "src/string/memory_utils/scan_utils.h"
+#include "src/string/x86/memcpy_impl.h"
+
+#ifndef LLVM_LIBC_STRING_VARIANT
+#error "LLVM_LIBC_STRING_VARIANT must be defined to the variant namespace."
+#endif
+
+namespace __llvm_libc {
+namespace x86 {
+namespace LLVM_LIBC_STRING_VARIANT {
+
+// The implementations are the same as the ones of the entrypoints, only the
+// compilation flags differ.
+
+void *memcpy(void *__restrict dst, const void *__restrict src, size_t count) {
+  memcpy_x86(reinterpret_cast<char *>(dst), reinterpret_cast<const char *>(src),
+             count);
+  return dst;
+}
+
+void *memset(void *dst, int value, size_t count) {
+  GeneralPurposeMemset(reinterpret_cast<char *>(dst),
+                       static_cast<unsigned char>(value), count);
+  return dst;
+}
+
+size_t strlen(const char *src) { return FindZero<BestScanner>(src) - src; }
+
+} // namespace LLVM_LIBC_STRING_VARIANT
+} // namespace x86
+} // namespace __llvm_libc
@@ -0,0 +1,75 @@
+//===-- x86 string function variants ----------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_LIBC_SRC_STRING_X86_STRING_VARIANTS_H
+#define LLVM_LIBC_SRC_STRING_X86_STRING_VARIANTS_H
+
+#include "src/string/x86/cpu_features.h"
+#include <stddef.h> // size_t
+
+namespace __llvm_libc {
+namespace x86 {
+
+// string_variants.cpp is compiled once per instruction set below, each time
+// defining the functions of the namespace of the same name. A library built
+// for the baseline x86-64 target can then bind to the best of them at run time.
+#define LLVM_LIBC_DECLARE_STRING_VARIANT(VARIANT)                              \
+  namespace VARIANT {                                                          \
+  void *memcpy(void *__restrict dst, const void *__restrict src,              \
+               size_t count);                                                  \
+  void *memset(void *dst, int value, size_t count);                            \
+  size_t strlen(const char *src);                                              \
+  }
+
+LLVM_LIBC_DECLARE_STRING_VARIANT(sse2)
+LLVM_LIBC_DECLARE_STRING_VARIANT(avx)
+LLVM_LIBC_DECLARE_STRING_VARIANT(avx2)
+LLVM_LIBC_DECLARE_STRING_VARIANT(avx512f)
+
+#undef LLVM_LIBC_DECLARE_STRING_VARIANT
+
+using MemcpyFunction = void *(*)(void *__restrict, const void *__restrict,
+                                 size_t);
+using MemsetFunction = void *(*)(void *, int, size_t);
+using StrlenFunction = size_t (*)(const char *);
+
+// Returns the variant compiled for the largest instruction set supported by a
+// CPU with `features`, a bitmask of `CpuFeature`.
+template <typename Function>
+static Function SelectVariant(unsigned features, Function sse2_variant,
+                              Function avx_variant, Function avx2_variant,
+                              Function avx512f_variant) {
+  if ((features & kAvx512f) && (features & kAvx2))
+    return avx512f_variant;
+  if (features & kAvx2)
+    return avx2_variant;
+  if (features & kAvx)
+    return avx_variant;
+  // SSE2 is part of the x86-64 baseline.
+  return sse2_variant;
+}
+
+static inline MemcpyFunction SelectMemcpy(unsigned features) {
+  return SelectVariant<MemcpyFunction>(features, &sse2::memcpy, &avx::memcpy,
+                                       &avx2::memcpy, &avx512f::memcpy);
+}
+
+static inline MemsetFunction SelectMemset(unsigned features) {
+  return SelectVariant<MemsetFunction>(features, &sse2::memset, &avx::memset,
+                                       &avx2::memset, &avx512f::memset);
+}
+
+static inline StrlenFunction SelectStrlen(unsigned features) {
+  return SelectVariant<StrlenFunction>(features, &sse2::strlen, &avx::strlen,
+                                       &avx2::strlen, &avx512f::strlen);
+}
+
+} // namespace x86
+} // namespace __llvm_libc
+
+#endif // LLVM_LIBC_SRC_STRING_X86_STRING_VARIANTS_H
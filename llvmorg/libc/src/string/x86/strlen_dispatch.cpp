@@ -0,0 +1,29 @@
+//===-- Run time dispatched implementation of strlen ----------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "src/string/strlen.h"
+#include "src/__support/common.h"
+#include "src/string/x86/string_variants.h"
+
+namespace __llvm_libc {
+
+// See memcpy_dispatch.cpp.
+static size_t ResolveStrlen(const char *src);
+static x86::StrlenFunction strlen_impl = &ResolveStrlen;
+
+static size_t ResolveStrlen(const char *src) {
+  const x86::StrlenFunction impl = x86::SelectStrlen(x86::DetectCpuFeatures());
+  __atomic_store_n(&strlen_impl, impl, __ATOMIC_RELAXED);
+  return impl(src);
+}
+
+size_t LLVM_LIBC_ENTRYPOINT(strlen)(const char *src) {
+  return __atomic_load_n(&strlen_impl, __ATOMIC_RELAXED)(src);
+}
+
+} // namespace __llvm_libc
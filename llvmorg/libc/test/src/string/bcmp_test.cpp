@@ -0,0 +1,55 @@
+//===-- Unittests for bcmp ----------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "src/string/bcmp.h"
+#include "utils/UnitTest/Test.h"
+
+TEST(BcmpTest, CmpZeroByte) {
+  const char *lhs = "ab";
+  const char *rhs = "bc";
+  EXPECT_EQ(__llvm_libc::bcmp(lhs, rhs, 0), 0);
+}
+
+TEST(BcmpTest, LhsRhsAreTheSame) {
+  const char *lhs = "ab";
+  const char *rhs = "ab";
+  EXPECT_EQ(__llvm_libc::bcmp(lhs, rhs, 2), 0);
+}
+
+TEST(BcmpTest, LhsRhsAreDifferent) {
+  const char *lhs = "ab";
+  const char *rhs = "ac";
+  EXPECT_NE(__llvm_libc::bcmp(lhs, rhs, 2), 0);
+}
+
+TEST(BcmpTest, Thorough) {
+  // A difference is put at every position of buffers of every size and
+  // alignment.
+  alignas(64) char lhs[320];
+  alignas(64) char rhs[320];
+  for (size_t count = 1; count < 256; ++count) {
+    for (size_t align = 0; align < 64; align += 3) {
+      for (size_t i = 0; i < sizeof(lhs); ++i)
+        lhs[i] = char(i * 7 % 251);
+      for (size_t i = 0; i + align < sizeof(lhs); ++i)
+        rhs[i] = lhs[align + i];
+      ASSERT_EQ(__llvm_libc::bcmp(lhs + align, rhs, count), 0);
+      for (size_t pos = 0; pos < count; ++pos) {
+        // Several differences must not cancel out.
+        if (pos + 1 < count)
+          rhs[pos + 1] = char(lhs[align + pos + 1] + 1);
+        rhs[pos] = char(lhs[align + pos] + 1);
+        ASSERT_NE(__llvm_libc::bcmp(lhs + align, rhs, count), 0);
+        ASSERT_NE(__llvm_libc::bcmp(rhs, lhs + align, count), 0);
+        // Bytes past `count` are not compared.
+        ASSERT_EQ(__llvm_libc::bcmp(lhs + align, rhs, pos), 0);
+        rhs[pos] = lhs[align + pos];
+      }
+    }
+  }
+}
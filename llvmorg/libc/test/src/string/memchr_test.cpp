@@ -120,3 +120,20 @@ TEST(MemChrTest, SignedCharacterFound) {
   // Should find the first character 'c'.
   ASSERT_EQ(actual[0], c);
 }
+
+TEST(MemChrTest, AllAlignmentsAndSizes) {
+  // Covers buffers starting and ending at every offset of a vector block,
+  // with the character just inside and just outside of the searched bytes.
+  alignas(64) char buffer[128];
+  for (size_t start = 0; start < 64; ++start) {
+    for (size_t size = 1; start + size < sizeof(buffer); ++size) {
+      for (size_t i = 0; i < sizeof(buffer); ++i)
+        buffer[i] = 'a';
+      buffer[start + size] = 'X';
+      ASSERT_EQ(__llvm_libc::memchr(buffer + start, 'X', size), nullptr);
+      buffer[start + size - 1] = 'X';
+      ASSERT_EQ(__llvm_libc::memchr(buffer + start, 'X', size),
+                static_cast<void *>(buffer + start + size - 1));
+    }
+  }
+}
@@ -0,0 +1,75 @@
+//===-- Unittests for memmove ---------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "src/string/memmove.h"
+#include "utils/CPP/ArrayRef.h"
+#include "utils/UnitTest/Test.h"
+
+using __llvm_libc::cpp::Array;
+using __llvm_libc::cpp::ArrayRef;
+using Data = Array<char, 2048>;
+
+static const ArrayRef<char> kNumbers("0123456789", 10);
+static const ArrayRef<char> kDeadcode("DEADC0DE", 8);
+
+// Returns a Data object filled with a repetition of `filler`.
+Data getData(ArrayRef<char> filler) {
+  Data out;
+  for (size_t i = 0; i < out.size(); ++i)
+    out[i] = filler[i % filler.size()];
+  return out;
+}
+
+TEST(MemmoveTest, Thorough) {
+  const Data groundtruth = getData(kNumbers);
+  const Data dirty = getData(kDeadcode);
+  for (size_t count = 0; count < 1024; ++count) {
+    for (size_t align = 0; align < 64; ++align) {
+      auto buffer = dirty;
+      const char *const src = groundtruth.data();
+      void *const dst = &buffer[align];
+      void *const ret = __llvm_libc::memmove(dst, src, count);
+      // Return value is `dst`.
+      ASSERT_EQ(ret, dst);
+      // Everything before copy is untouched.
+      for (size_t i = 0; i < align; ++i)
+        ASSERT_EQ(buffer[i], dirty[i]);
+      // Everything in between is copied.
+      for (size_t i = 0; i < count; ++i)
+        ASSERT_EQ(buffer[align + i], groundtruth[i]);
+      // Everything after copy is untouched.
+      for (size_t i = align + count; i < dirty.size(); ++i)
+        ASSERT_EQ(buffer[i], dirty[i]);
+    }
+  }
+}
+
+TEST(MemmoveTest, Overlapping) {
+  const Data groundtruth = getData(kNumbers);
+  constexpr size_t kBase = 512;
+  for (size_t count = 0; count < 1024; count += (count < 300 ? 1 : 37)) {
+    // `dst` goes from before to after `src` so that both directions of the
+    // copy and both partial and complete overlaps are exercised.
+    for (size_t dst_offset = kBase - 160; dst_offset <= kBase + 160;
+         ++dst_offset) {
+      auto buffer = groundtruth;
+      const char *const src = &buffer[kBase];
+      char *const dst = &buffer[dst_offset];
+      ASSERT_EQ(__llvm_libc::memmove(dst, src, count),
+                static_cast<void *>(dst));
+      // Everything outside of `dst` is untouched.
+      for (size_t i = 0; i < dst_offset; ++i)
+        ASSERT_EQ(buffer[i], groundtruth[i]);
+      for (size_t i = dst_offset + count; i < buffer.size(); ++i)
+        ASSERT_EQ(buffer[i], groundtruth[i]);
+      // `dst` holds the original content of `src`.
+      for (size_t i = 0; i < count; ++i)
+        ASSERT_EQ(buffer[dst_offset + i], groundtruth[kBase + i]);
+    }
+  }
+}
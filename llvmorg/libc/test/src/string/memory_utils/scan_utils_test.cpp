@@ -0,0 +1,151 @@
+//===-- Unittests for scan_utils ------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "include/sys/mman.h"
+#include "src/string/memory_utils/scan_utils.h"
+#include "src/sys/mman/mmap.h"
+#include "src/sys/mman/munmap.h"
+#include "utils/UnitTest/Test.h"
+
+namespace __llvm_libc {
+
+// The strings are placed at the end of a readable region followed by an
+// inaccessible one, so that any read past the end of the string faults. The
+// regions are large enough to start on a page boundary on every target.
+static constexpr size_t kRegionSize = 64 * 1024;
+
+// The widest block of all scanners, the strings placed against the end of the
+// readable region are at most this long so that every alignment is covered.
+static constexpr size_t kMaxBlockSize = 32;
+
+class ScanUtilsTest : public testing::Test {
+protected:
+  char *mapping = nullptr;
+  char *end = nullptr;
+
+public:
+  void SetUp() override {
+    void *addr = mmap(nullptr, 2 * kRegionSize, PROT_READ | PROT_WRITE,
+                      MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
+    if (addr == MAP_FAILED)
+      return;
+    mapping = reinterpret_cast<char *>(addr);
+    end = mapping + kRegionSize;
+    if (mmap(end, kRegionSize, PROT_NONE,
+             MAP_ANONYMOUS | MAP_PRIVATE | MAP_FIXED, -1, 0) == MAP_FAILED)
+      end = nullptr;
+  }
+
+  void TearDown() override {
+    if (mapping)
+      munmap(mapping, 2 * kRegionSize);
+  }
+
+  // Fills the `kRegionSize` readable bytes with 'a'.
+  void Fill() {
+    for (char *ptr = mapping; ptr != end; ++ptr)
+      *ptr = 'a';
+  }
+
+  // Covers strings starting at every offset of a block and ending with their
+  // terminator in the last readable byte, or anywhere in the last block.
+  template <typename Scanner> void CheckFindZero(testing::RunContext &Ctx) {
+    Fill();
+    for (size_t gap = 0; gap < 2 * kMaxBlockSize; ++gap) {
+      char *zero = end - 1 - gap;
+      *zero = '\0';
+      for (size_t length = 0; length < 2 * kMaxBlockSize; ++length)
+        ASSERT_EQ(FindZero<Scanner>(zero - length), (const char *)zero);
+      *zero = 'a';
+    }
+  }
+
+  // As above, with the byte searched for either as the last readable byte or
+  // replacing the terminator.
+  template <typename Scanner>
+  void CheckFindZeroOrEqual(testing::RunContext &Ctx) {
+    Fill();
+    const char kLast[] = {'\0', 'b'};
+    for (char last : kLast) {
+      for (size_t gap = 0; gap < 2 * kMaxBlockSize; ++gap) {
+        char *match = end - 1 - gap;
+        *match = last;
+        end[-1] = '\0';
+        for (size_t length = 0; length < 2 * kMaxBlockSize; ++length)
+          ASSERT_EQ(FindZeroOrEqual<Scanner>(match - length, 'b'),
+                    (const char *)match);
+        *match = 'a';
+      }
+    }
+  }
+
+  // Covers ranges starting at every offset of a block and ending at the last
+  // readable byte, with and without a match in them.
+  template <typename Scanner> void CheckFindEqual(testing::RunContext &Ctx) {
+    Fill();
+    for (size_t count = 0; count < 2 * kMaxBlockSize; ++count) {
+      const char *src = end - count;
+      ASSERT_EQ(FindEqual<Scanner>(src, 'b', count), (const char *)nullptr);
+      if (count == 0)
+        continue;
+      end[-1] = 'b';
+      ASSERT_EQ(FindEqual<Scanner>(src, 'b', count), (const char *)end - 1);
+      ASSERT_EQ(FindEqual<Scanner>(src, 'b', count - 1),
+                (const char *)nullptr);
+      end[-1] = 'a';
+    }
+  }
+
+  // Covers a left string ending with its terminator in the last readable byte
+  // against a right string at the start of the region, both starting at every
+  // offset of a block, when equal and when differing in their last byte.
+  template <typename Scanner>
+  void CheckCompareStrings(testing::RunContext &Ctx) {
+    Fill();
+    end[-1] = '\0';
+    for (size_t length = 0; length < 2 * kMaxBlockSize; ++length) {
+      const char *left = end - 1 - length;
+      for (size_t offset = 0; offset < kMaxBlockSize; ++offset) {
+        char *right = mapping + offset;
+        right[length] = '\0';
+        ASSERT_EQ(CompareStrings<Scanner>(left, right), 0);
+        ASSERT_EQ(CompareStrings<Scanner>(right, left), 0);
+        if (length != 0) {
+          right[length - 1] = 'b';
+          ASSERT_EQ(CompareStrings<Scanner>(left, right), 'a' - 'b');
+          ASSERT_EQ(CompareStrings<Scanner>(right, left), 'b' - 'a');
+          right[length - 1] = '\0';
+          ASSERT_EQ(CompareStrings<Scanner>(left, right), int('a'));
+          ASSERT_EQ(CompareStrings<Scanner>(right, left), -int('a'));
+          right[length - 1] = 'a';
+        }
+        right[length] = 'a';
+      }
+    }
+  }
+
+  template <typename Scanner> void CheckScanner(testing::RunContext &Ctx) {
+    ASSERT_NE(end, (char *)nullptr);
+    CheckFindZero<Scanner>(Ctx);
+    CheckFindZeroOrEqual<Scanner>(Ctx);
+    CheckFindEqual<Scanner>(Ctx);
+    CheckCompareStrings<Scanner>(Ctx);
+  }
+};
+
+TEST_F(ScanUtilsTest, WordScanner) { CheckScanner<WordScanner>(Ctx); }
+
+#if defined(__SSE2__)
+TEST_F(ScanUtilsTest, Sse2Scanner) { CheckScanner<Sse2Scanner>(Ctx); }
+#endif
+
+#if defined(__AVX2__)
+TEST_F(ScanUtilsTest, Avx2Scanner) { CheckScanner<Avx2Scanner>(Ctx); }
+#endif
+
+} // namespace __llvm_libc
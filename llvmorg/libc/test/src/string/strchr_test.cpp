@@ -85,3 +85,21 @@ TEST(StrChrTest, EmptyStringShouldOnlyMatchNullTerminator) {
   ASSERT_STREQ(__llvm_libc::strchr("", '3'), nullptr);
   ASSERT_STREQ(__llvm_libc::strchr("", '*'), nullptr);
 }
+
+TEST(StrChrTest, AllAlignmentsAndPositions) {
+  // Covers strings starting and matches or terminators found at every offset
+  // of a vector block.
+  alignas(64) char buffer[128];
+  for (size_t start = 0; start < 64; ++start) {
+    for (size_t pos = start; pos + 1 < sizeof(buffer); ++pos) {
+      for (size_t i = 0; i < sizeof(buffer); ++i)
+        buffer[i] = 'a';
+      buffer[sizeof(buffer) - 1] = '\0';
+      buffer[pos] = 'X';
+      ASSERT_EQ(__llvm_libc::strchr(buffer + start, 'X'), buffer + pos);
+      buffer[pos] = '\0';
+      ASSERT_EQ(__llvm_libc::strchr(buffer + start, 'X'), nullptr);
+      ASSERT_EQ(__llvm_libc::strchr(buffer + start, '\0'), buffer + pos);
+    }
+  }
+}
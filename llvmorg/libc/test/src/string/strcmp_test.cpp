@@ -95,3 +95,27 @@ TEST(StrCmpTest, StringArgumentSwapChangesSign) {
   // 'a' - 'b' = -1.
   ASSERT_EQ(result, -1);
 }
+
+TEST(StrCmpTest, AllAlignmentsAndMismatchPositions) {
+  // Covers both strings starting at every offset of a vector block, with the
+  // first difference at every position.
+  alignas(64) char left[128];
+  alignas(64) char right[192];
+  for (size_t left_start = 0; left_start < 64; left_start += 7) {
+    for (size_t right_start = 0; right_start < 64; ++right_start) {
+      for (size_t pos = 0; left_start + pos + 1 < sizeof(left); ++pos) {
+        for (size_t i = 0; i < sizeof(left); ++i)
+          left[i] = 'a';
+        for (size_t i = 0; i < sizeof(right); ++i)
+          right[i] = 'a';
+        left[sizeof(left) - 1] = '\0';
+        right[right_start + sizeof(left) - 1 - left_start] = '\0';
+        ASSERT_EQ(__llvm_libc::strcmp(left + left_start, right + right_start),
+                  0);
+        right[right_start + pos] = 'b';
+        ASSERT_EQ(__llvm_libc::strcmp(left + left_start, right + right_start),
+                  'a' - 'b');
+      }
+    }
+  }
+}
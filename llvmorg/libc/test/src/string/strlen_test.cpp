@@ -22,3 +22,16 @@ TEST(StrLenTest, AnyString) {
   size_t result = __llvm_libc::strlen(any);
   ASSERT_EQ((size_t)12, result);
 }
+
+TEST(StrLenTest, AllAlignmentsAndLengths) {
+  // Covers strings starting and ending at every offset of a vector block.
+  alignas(64) char buffer[128];
+  for (size_t start = 0; start < 64; ++start) {
+    for (size_t length = 0; start + length < sizeof(buffer); ++length) {
+      for (size_t i = 0; i < sizeof(buffer); ++i)
+        buffer[i] = 'a';
+      buffer[start + length] = '\0';
+      ASSERT_EQ(__llvm_libc::strlen(buffer + start), length);
+    }
+  }
+}
@@ -0,0 +1,82 @@
+//===-- Unittests for the x86 string function variants --------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "src/string/x86/string_variants.h"
+#include "utils/UnitTest/Test.h"
+
+namespace x86 = __llvm_libc::x86;
+
+// The feature masks of a few generations of CPUs.
+constexpr unsigned kBaseline = x86::kSse2;
+constexpr unsigned kSandyBridge = kBaseline | x86::kAvx;
+constexpr unsigned kHaswell = kSandyBridge | x86::kAvx2;
+constexpr unsigned kSkylakeServer = kHaswell | x86::kAvx512f;
+
+TEST(X86StringVariantsTest, SelectsBaselineVariant) {
+  ASSERT_EQ(x86::SelectMemcpy(kBaseline), &x86::sse2::memcpy);
+  ASSERT_EQ(x86::SelectMemset(kBaseline), &x86::sse2::memset);
+  ASSERT_EQ(x86::SelectStrlen(kBaseline), &x86::sse2::strlen);
+  // SSE2 is always available on x86-64, even if not reported.
+  ASSERT_EQ(x86::SelectMemcpy(0), &x86::sse2::memcpy);
+}
+
+TEST(X86StringVariantsTest, SelectsAvxVariant) {
+  ASSERT_EQ(x86::SelectMemcpy(kSandyBridge), &x86::avx::memcpy);
+  ASSERT_EQ(x86::SelectMemset(kSandyBridge), &x86::avx::memset);
+  ASSERT_EQ(x86::SelectStrlen(kSandyBridge), &x86::avx::strlen);
+}
+
+TEST(X86StringVariantsTest, SelectsAvx2Variant) {
+  ASSERT_EQ(x86::SelectMemcpy(kHaswell), &x86::avx2::memcpy);
+  ASSERT_EQ(x86::SelectMemset(kHaswell), &x86::avx2::memset);
+  ASSERT_EQ(x86::SelectStrlen(kHaswell), &x86::avx2::strlen);
+}
+
+TEST(X86StringVariantsTest, SelectsAvx512fVariant) {
+  ASSERT_EQ(x86::SelectMemcpy(kSkylakeServer), &x86::avx512f::memcpy);
+  ASSERT_EQ(x86::SelectMemset(kSkylakeServer), &x86::avx512f::memset);
+  ASSERT_EQ(x86::SelectStrlen(kSkylakeServer), &x86::avx512f::strlen);
+  // The AVX-512 variant is also compiled for AVX2.
+  ASSERT_EQ(x86::SelectMemcpy(kSandyBridge | x86::kAvx512f),
+            &x86::avx::memcpy);
+}
+
+TEST(X86StringVariantsTest, DetectsBaseline) {
+  const unsigned features = x86::DetectCpuFeatures();
+  ASSERT_TRUE((features & x86::kSse2) != 0);
+  // Features are only reported along with the ones they extend.
+  if (features & x86::kAvx2)
+    ASSERT_TRUE((features & x86::kAvx) != 0);
+  if (features & x86::kAvx512f)
+    ASSERT_TRUE((features & x86::kAvx) != 0);
+}
+
+TEST(X86StringVariantsTest, SelectedVariantsWork) {
+  // Only the variants the host can run are exercised, the others are covered
+  // by the selection tests above.
+  const unsigned features = x86::DetectCpuFeatures();
+  const unsigned masks[] = {kBaseline, kSandyBridge, kHaswell, kSkylakeServer};
+  for (unsigned mask : masks) {
+    if ((mask & features) != mask)
+      continue;
+    char src[300];
+    char dst[300];
+    for (size_t i = 0; i < sizeof(src); ++i)
+      src[i] = char('a' + i % 26);
+    for (size_t count = 0; count < sizeof(src); ++count) {
+      x86::SelectMemset(mask)(dst, 0, sizeof(dst));
+      for (size_t i = 0; i < sizeof(dst); ++i)
+        ASSERT_EQ(dst[i], '\0');
+      ASSERT_EQ(x86::SelectMemcpy(mask)(dst, src, count),
+                static_cast<void *>(dst));
+      for (size_t i = 0; i < count; ++i)
+        ASSERT_EQ(dst[i], src[i]);
+      ASSERT_EQ(x86::SelectStrlen(mask)(dst), count);
+    }
+  }
+}
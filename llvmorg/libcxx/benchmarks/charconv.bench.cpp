@@ -0,0 +1,150 @@
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+// Compares the floating-point std::to_chars and std::from_chars with the
+// snprintf("%.17g") and strtod round trip they replace.
+
+constexpr std::size_t TestNumInputs = 1024;
+
+template <class T>
+std::vector<T> getRandomBitPatterns(size_t N) {
+  std::mt19937_64 Gen(42);
+  std::vector<T> Inputs;
+  Inputs.reserve(N);
+  while (Inputs.size() < N) {
+    uint64_t Bits = Gen();
+    T Value;
+    std::memcpy(&Value, &Bits, sizeof(Value));
+    if (Value - Value == 0) // finite
+      Inputs.push_back(Value);
+  }
+  return Inputs;
+}
+
+// Values with few significant digits, like the ones in typical text formats.
+template <class T>
+std::vector<T> getShortDecimals(size_t N) {
+  std::mt19937_64 Gen(42);
+  std::uniform_int_distribution<int> Mantissa(0, 999999);
+  std::vector<T> Inputs;
+  Inputs.reserve(N);
+  for (size_t I = 0; I < N; ++I)
+    Inputs.push_back(T(Mantissa(Gen)) / 1000);
+  return Inputs;
+}
+
+template <class T>
+std::vector<std::string> toStrings(const std::vector<T>& Values) {
+  std::vector<std::string> Strings;
+  char Buffer[64];
+  for (T Value : Values) {
+    std::to_chars_result R =
+        std::to_chars(Buffer, Buffer + sizeof(Buffer), Value);
+    Strings.emplace_back(Buffer, R.ptr);
+  }
+  return Strings;
+}
+
+template <class T, class GenInputs>
+static void BM_ToChars(benchmark::State& st, T, GenInputs gen) {
+  std::vector<T> in = gen(st.range(0));
+  char Buffer[64];
+  while (st.KeepRunning()) {
+    for (T Value : in)
+      benchmark::DoNotOptimize(
+          std::to_chars(Buffer, Buffer + sizeof(Buffer), Value).ptr);
+    benchmark::ClobberMemory();
+  }
+}
+
+template <class T, class GenInputs>
+static void BM_Snprintf(benchmark::State& st, T, GenInputs gen) {
+  std::vector<T> in = gen(st.range(0));
+  char Buffer[64];
+  while (st.KeepRunning()) {
+    for (T Value : in)
+      benchmark::DoNotOptimize(std::snprintf(Buffer, sizeof(Buffer), "%.*g",
+                                             sizeof(T) == 4 ? 9 : 17,
+                                             static_cast<double>(Value)));
+    benchmark::ClobberMemory();
+  }
+}
+
+template <class T, class GenInputs>
+static void BM_FromChars(benchmark::State& st, T, GenInputs gen) {
+  std::vector<std::string> in = toStrings(gen(st.range(0)));
+  while (st.KeepRunning()) {
+    for (const std::string& S : in) {
+      T Value;
+      std::from_chars(S.data(), S.data() + S.size(), Value);
+      benchmark::DoNotOptimize(Value);
+    }
+  }
+}
+
+template <class T, class GenInputs>
+static void BM_Strtod(benchmark::State& st, T, GenInputs gen) {
+  std::vector<std::string> in = toStrings(gen(st.range(0)));
+  while (st.KeepRunning()) {
+    for (const std::string& S : in) {
+      if (sizeof(T) == 4)
+        benchmark::DoNotOptimize(std::strtof(S.c_str(), nullptr));
+      else
+        benchmark::DoNotOptimize(std::strtod(S.c_str(), nullptr));
+    }
+  }
+}
+
+//----------------------------------------------------------------------------//
+//                         BM_ToChars
+// ---------------------------------------------------------------------------//
+
+BENCHMARK_CAPTURE(BM_ToChars, double_random, double(),
+                  getRandomBitPatterns<double>)->Arg(TestNumInputs);
+
+BENCHMARK_CAPTURE(BM_Snprintf, double_random, double(),
+                  getRandomBitPatterns<double>)->Arg(TestNumInputs);
+
+BENCHMARK_CAPTURE(BM_ToChars, double_short, double(),
+                  getShortDecimals<double>)->Arg(TestNumInputs);
+
+BENCHMARK_CAPTURE(BM_Snprintf, double_short, double(),
+                  getShortDecimals<double>)->Arg(TestNumInputs);
+
+BENCHMARK_CAPTURE(BM_ToChars, float_random, float(),
+                  getRandomBitPatterns<float>)->Arg(TestNumInputs);
+
+BENCHMARK_CAPTURE(BM_Snprintf, float_random, float(),
+                  getRandomBitPatterns<float>)->Arg(TestNumInputs);
+
+//----------------------------------------------------------------------------//
+//                         BM_FromChars
+// ---------------------------------------------------------------------------//
+
+BENCHMARK_CAPTURE(BM_FromChars, double_random, double(),
+                  getRandomBitPatterns<double>)->Arg(TestNumInputs);
+
+BENCHMARK_CAPTURE(BM_Strtod, double_random, double(),
+                  getRandomBitPatterns<double>)->Arg(TestNumInputs);
+
+BENCHMARK_CAPTURE(BM_FromChars, double_short, double(),
+                  getShortDecimals<double>)->Arg(TestNumInputs);
+
+BENCHMARK_CAPTURE(BM_Strtod, double_short, double(),
+                  getShortDecimals<double>)->Arg(TestNumInputs);
+
+BENCHMARK_CAPTURE(BM_FromChars, float_random, float(),
+                  getRandomBitPatterns<float>)->Arg(TestNumInputs);
+
+BENCHMARK_CAPTURE(BM_Strtod, float_random, float(),
+                  getRandomBitPatterns<float>)->Arg(TestNumInputs);
+
+BENCHMARK_MAIN();
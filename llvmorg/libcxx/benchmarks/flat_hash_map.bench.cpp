@@ -0,0 +1,188 @@
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <utility>
+#include <cstdint>
+
+#include "benchmark/benchmark.h"
+
+#include "ContainerBenchmarks.h"
+#include "GenerateInput.h"
+
+using namespace ContainerBenchmarks;
+
+// Compares the node-based std::unordered_map with the open-addressing
+// std::__flat_hash_map, which is also what std::unordered_map uses for
+// trivially copyable elements with _LIBCPP_ABI_FLAT_UNORDERED_MAP.
+
+constexpr std::size_t TestNumInputs = 1024;
+
+template <class IntT>
+std::vector<std::pair<IntT, IntT> > getRandomPairInputs(size_t N) {
+  std::vector<IntT> Keys = getRandomIntegerInputs<IntT>(N);
+  std::vector<std::pair<IntT, IntT> > Inputs;
+  Inputs.reserve(N);
+  for (IntT K : Keys)
+    Inputs.emplace_back(K, ~K);
+  return Inputs;
+}
+
+template <class IntT>
+std::vector<std::pair<IntT, IntT> > getSortedPairInputs(size_t N) {
+  std::vector<std::pair<IntT, IntT> > Inputs;
+  Inputs.reserve(N);
+  for (size_t I = 0; I < N; ++I)
+    Inputs.emplace_back(I, ~I);
+  return Inputs;
+}
+
+template <class Container, class GenInputs>
+static void BM_FindKey(benchmark::State& st, Container c, GenInputs gen) {
+  auto in = gen(st.range(0));
+  c.insert(in.begin(), in.end());
+  benchmark::DoNotOptimize(&c);
+  while (st.KeepRunning()) {
+    for (const auto& P : in)
+      benchmark::DoNotOptimize(c.find(P.first)->second);
+    benchmark::ClobberMemory();
+  }
+}
+
+// Looks up keys that are not in the container, which probes until the first
+// group with an empty slot.
+template <class Container, class GenInputs>
+static void BM_FindMissing(benchmark::State& st, Container c, GenInputs gen) {
+  auto in = gen(st.range(0) * 2);
+  c.insert(in.begin(), in.begin() + in.size() / 2);
+  benchmark::DoNotOptimize(&c);
+  while (st.KeepRunning()) {
+    for (auto It = in.begin() + in.size() / 2; It != in.end(); ++It)
+      benchmark::DoNotOptimize(c.find(It->first) == c.end());
+    benchmark::ClobberMemory();
+  }
+}
+
+template <class Container, class GenInputs>
+static void BM_Iterate(benchmark::State& st, Container c, GenInputs gen) {
+  auto in = gen(st.range(0));
+  c.insert(in.begin(), in.end());
+  benchmark::DoNotOptimize(&c);
+  while (st.KeepRunning()) {
+    typename Container::mapped_type Sum = 0;
+    for (const auto& P : c)
+      Sum += P.second;
+    benchmark::DoNotOptimize(Sum);
+  }
+}
+
+template <class Container, class GenInputs>
+static void BM_EraseInsert(benchmark::State& st, Container c, GenInputs gen) {
+  auto in = gen(st.range(0));
+  c.insert(in.begin(), in.end());
+  benchmark::DoNotOptimize(&c);
+  while (st.KeepRunning()) {
+    for (const auto& P : in) {
+      c.erase(P.first);
+      benchmark::DoNotOptimize(&*c.insert(P).first);
+    }
+    benchmark::ClobberMemory();
+  }
+}
+
+//----------------------------------------------------------------------------//
+//                       BM_InsertValue
+// ---------------------------------------------------------------------------//
+
+BENCHMARK_CAPTURE(BM_InsertValue,
+    unordered_map_uint64_random,
+    std::unordered_map<uint64_t, uint64_t>{},
+    getRandomPairInputs<uint64_t>)->Arg(TestNumInputs)->Arg(1 << 16);
+
+BENCHMARK_CAPTURE(BM_InsertValue,
+    flat_hash_map_uint64_random,
+    std::__flat_hash_map<uint64_t, uint64_t>{},
+    getRandomPairInputs<uint64_t>)->Arg(TestNumInputs)->Arg(1 << 16);
+
+BENCHMARK_CAPTURE(BM_InsertValue,
+    unordered_map_uint32_sorted,
+    std::unordered_map<uint32_t, uint32_t>{},
+    getSortedPairInputs<uint32_t>)->Arg(TestNumInputs)->Arg(1 << 16);
+
+BENCHMARK_CAPTURE(BM_InsertValue,
+    flat_hash_map_uint32_sorted,
+    std::__flat_hash_map<uint32_t, uint32_t>{},
+    getSortedPairInputs<uint32_t>)->Arg(TestNumInputs)->Arg(1 << 16);
+
+BENCHMARK_CAPTURE(BM_InsertValue,
+    unordered_set_uint64_random,
+    std::unordered_set<uint64_t>{},
+    getRandomIntegerInputs<uint64_t>)->Arg(TestNumInputs);
+
+BENCHMARK_CAPTURE(BM_InsertValue,
+    flat_hash_set_uint64_random,
+    std::__flat_hash_set<uint64_t>{},
+    getRandomIntegerInputs<uint64_t>)->Arg(TestNumInputs);
+
+//----------------------------------------------------------------------------//
+//                         BM_FindKey
+// ---------------------------------------------------------------------------//
+
+BENCHMARK_CAPTURE(BM_FindKey,
+    unordered_map_uint64_random,
+    std::unordered_map<uint64_t, uint64_t>{},
+    getRandomPairInputs<uint64_t>)->Arg(TestNumInputs)->Arg(1 << 16);
+
+BENCHMARK_CAPTURE(BM_FindKey,
+    flat_hash_map_uint64_random,
+    std::__flat_hash_map<uint64_t, uint64_t>{},
+    getRandomPairInputs<uint64_t>)->Arg(TestNumInputs)->Arg(1 << 16);
+
+BENCHMARK_CAPTURE(BM_FindKey,
+    unordered_map_uint32_sorted,
+    std::unordered_map<uint32_t, uint32_t>{},
+    getSortedPairInputs<uint32_t>)->Arg(TestNumInputs)->Arg(1 << 16);
+
+BENCHMARK_CAPTURE(BM_FindKey,
+    flat_hash_map_uint32_sorted,
+    std::__flat_hash_map<uint32_t, uint32_t>{},
+    getSortedPairInputs<uint32_t>)->Arg(TestNumInputs)->Arg(1 << 16);
+
+BENCHMARK_CAPTURE(BM_FindMissing,
+    unordered_map_uint64_random,
+    std::unordered_map<uint64_t, uint64_t>{},
+    getRandomPairInputs<uint64_t>)->Arg(TestNumInputs)->Arg(1 << 16);
+
+BENCHMARK_CAPTURE(BM_FindMissing,
+    flat_hash_map_uint64_random,
+    std::__flat_hash_map<uint64_t, uint64_t>{},
+    getRandomPairInputs<uint64_t>)->Arg(TestNumInputs)->Arg(1 << 16);
+
+//----------------------------------------------------------------------------//
+//                         BM_Iterate
+// ---------------------------------------------------------------------------//
+
+BENCHMARK_CAPTURE(BM_Iterate,
+    unordered_map_uint64_random,
+    std::unordered_map<uint64_t, uint64_t>{},
+    getRandomPairInputs<uint64_t>)->Arg(TestNumInputs)->Arg(1 << 16);
+
+BENCHMARK_CAPTURE(BM_Iterate,
+    flat_hash_map_uint64_random,
+    std::__flat_hash_map<uint64_t, uint64_t>{},
+    getRandomPairInputs<uint64_t>)->Arg(TestNumInputs)->Arg(1 << 16);
+
+//----------------------------------------------------------------------------//
+//                         BM_EraseInsert
+// ---------------------------------------------------------------------------//
+
+BENCHMARK_CAPTURE(BM_EraseInsert,
+    unordered_map_uint64_random,
+    std::unordered_map<uint64_t, uint64_t>{},
+    getRandomPairInputs<uint64_t>)->Arg(TestNumInputs);
+
+BENCHMARK_CAPTURE(BM_EraseInsert,
+    flat_hash_map_uint64_random,
+    std::__flat_hash_map<uint64_t, uint64_t>{},
+    getRandomPairInputs<uint64_t>)->Arg(TestNumInputs);
+
+BENCHMARK_MAIN();
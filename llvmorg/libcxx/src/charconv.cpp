@@ -7,8 +7,14 @@
 //===----------------------------------------------------------------------===//
 
 #include "charconv"
+#include "bit"
+#include "locale"
+#include <float.h>
+#include <stdlib.h>
 #include <string.h>
 
+#include "include/charconv_tables.h"
+
 _LIBCPP_BEGIN_NAMESPACE_STD
 
 namespace __itoa
@@ -157,4 +163,1071 @@ __u64toa(uint64_t value, char* buffer) _NOEXCEPT
 
 }  // namespace __itoa
 
+// Floating-point conversions.
+//
+// The shortest to_chars uses Ryu (Ulf Adams, "Ryu: Fast Float-to-String
+// Conversion", PLDI 2018): it computes the shortest decimal in the rounding
+// interval of the value with a couple of 64x128-bit multiplications, without
+// the trial and error of printf("%.17g") and strtod.
+//
+// from_chars uses the Clinger fast path when the mantissa and the power of ten
+// are both exact, and the Eisel-Lemire algorithm (Daniel Lemire, "Number
+// Parsing at a Gigabyte per Second", 2021) otherwise. The rare inputs that
+// those cannot decide, subnormals and hexadecimal floats are left to strtod.
+//
+// Conversions with a precision and those of long double go through the C
+// library.
+
+namespace __charconv
+{
+namespace
+{
+
+template <class _Tp> struct __float_traits;
+
+template <>
+struct __float_traits<float>
+{
+    typedef uint32_t __bits_type;
+    static const int __mantissa_bits = 23;
+    static const int __exponent_bits = 8;
+    static const int __exponent_bias = 127;
+    // Decimal exponents beyond which every 19-digit mantissa underflows to
+    // zero or overflows to infinity.
+    static const int __min_pow10 = -65;
+    static const int __max_pow10 = 38;
+    // Clinger's fast path: both the mantissa and the power of ten are exact.
+    static const int __max_exact_pow10 = 10;
+    static const uint64_t __max_exact_mantissa = uint64_t(1) << 24;
+};
+
+template <>
+struct __float_traits<double>
+{
+    typedef uint64_t __bits_type;
+    static const int __mantissa_bits = 52;
+    static const int __exponent_bits = 11;
+    static const int __exponent_bias = 1023;
+    static const int __min_pow10 = -342;
+    static const int __max_pow10 = 308;
+    static const int __max_exact_pow10 = 22;
+    static const uint64_t __max_exact_mantissa = uint64_t(1) << 53;
+};
+
+static const char __hex_digits[] = "0123456789abcdef";
+
+inline uint64_t __umul128(uint64_t __a, uint64_t __b, uint64_t* __hi)
+{
+#ifndef _LIBCPP_HAS_NO_INT128
+    unsigned __int128 __p = static_cast<unsigned __int128>(__a) * __b;
+    *__hi = static_cast<uint64_t>(__p >> 64);
+    return static_cast<uint64_t>(__p);
+#else
+    const uint64_t __a_lo = static_cast<uint32_t>(__a), __a_hi = __a >> 32;
+    const uint64_t __b_lo = static_cast<uint32_t>(__b), __b_hi = __b >> 32;
+    const uint64_t __b00 = __a_lo * __b_lo;
+    const uint64_t __b01 = __a_lo * __b_hi;
+    const uint64_t __b10 = __a_hi * __b_lo;
+    const uint64_t __b11 = __a_hi * __b_hi;
+    const uint64_t __mid1 = __b10 + (__b00 >> 32);
+    const uint64_t __mid2 = __b01 + static_cast<uint32_t>(__mid1);
+    *__hi = __b11 + (__mid1 >> 32) + (__mid2 >> 32);
+    return (__mid2 << 32) | static_cast<uint32_t>(__b00);
+#endif
+}
+
+//===----------------------------------------------------------------------===//
+//                            Shortest to_chars
+//===----------------------------------------------------------------------===//
+
+// ceil(log2(5^__e)) for 0 < __e <= 3528, and 1 for __e == 0.
+inline int __pow5bits(int __e)
+{
+    return static_cast<int>((static_cast<uint32_t>(__e) * 1217359) >> 19) + 1;
+}
+
+// floor(log10(2^__e)) for 0 <= __e <= 1650.
+inline uint32_t __log10_pow2(int __e)
+{
+    return (static_cast<uint32_t>(__e) * 78913) >> 18;
+}
+
+// floor(log10(5^__e)) for 0 <= __e <= 2620.
+inline uint32_t __log10_pow5(int __e)
+{
+    return (static_cast<uint32_t>(__e) * 732923) >> 20;
+}
+
+inline bool __multiple_of_pow5(uint64_t __value, uint32_t __p)
+{
+    uint32_t __count = 0;
+    for (; __count < __p; ++__count)
+    {
+        const uint64_t __q = __value / 5;
+        if (__value != 5 * __q)
+            break;
+        __value = __q;
+    }
+    return __count >= __p;
+}
+
+inline bool __multiple_of_pow2(uint64_t __value, uint32_t __p)
+{
+    return (__value & ((uint64_t(1) << __p) - 1)) == 0;
+}
+
+// (__m * __mul) >> __j, where __mul is a 128-bit table entry, __m has at most
+// 55 bits and 64 < __j < 128.
+inline uint64_t __mul_shift64(uint64_t __m, const uint64_t* __mul, int __j)
+{
+    uint64_t __high1;
+    const uint64_t __low1 = __umul128(__m, __mul[1], &__high1);
+    uint64_t __high0;
+    __umul128(__m, __mul[0], &__high0);
+    const uint64_t __sum = __high0 + __low1;
+    if (__sum < __high0)
+        ++__high1;
+    const int __dist = __j - 64;
+    return (__high1 << (64 - __dist)) | (__sum >> __dist);
+}
+
+struct __decimal
+{
+    uint64_t __mantissa;
+    int __exponent;
+};
+
+// Returns the shortest decimal that rounds to the binary floating-point value
+// with the given fields, which must be finite and nonzero. Written for
+// double; float reuses the same tables, which are precise enough for it.
+template <class _Tp>
+__decimal __shortest(uint64_t __ieee_mantissa, uint32_t __ieee_exponent)
+{
+    typedef __float_traits<_Tp> _Traits;
+    int __e2;
+    uint64_t __m2;
+    if (__ieee_exponent == 0)
+    {
+        __e2 = 1 - _Traits::__exponent_bias - _Traits::__mantissa_bits - 2;
+        __m2 = __ieee_mantissa;
+    }
+    else
+    {
+        __e2 = static_cast<int>(__ieee_exponent) - _Traits::__exponent_bias -
+               _Traits::__mantissa_bits - 2;
+        __m2 = (uint64_t(1) << _Traits::__mantissa_bits) | __ieee_mantissa;
+    }
+    const bool __accept_bounds = (__m2 & 1) == 0;
+
+    // The value is __mv * 2^__e2, its rounding interval is (__mm, __mp).
+    const uint64_t __mv = 4 * __m2;
+    const uint32_t __mm_shift = __ieee_mantissa != 0 || __ieee_exponent <= 1;
+
+    // Scale __mv, __mp and __mm by a power of ten to get __vr, __vp and __vm.
+    uint64_t __vr, __vp, __vm;
+    int __e10;
+    bool __vm_is_trailing_zeros = false;
+    bool __vr_is_trailing_zeros = false;
+    if (__e2 >= 0)
+    {
+        const uint32_t __q = __log10_pow2(__e2) - (__e2 > 3);
+        __e10 = static_cast<int>(__q);
+        const int __k = __pow5_inv_bitcount + __pow5bits(__q) - 1;
+        const int __i = -__e2 + static_cast<int>(__q) + __k;
+        __vr = __mul_shift64(4 * __m2, __pow5_inv_split[__q], __i);
+        __vp = __mul_shift64(4 * __m2 + 2, __pow5_inv_split[__q], __i);
+        __vm = __mul_shift64(4 * __m2 - 1 - __mm_shift, __pow5_inv_split[__q],
+                             __i);
+        if (__q <= 21)
+        {
+            // Only one of __mp, __mv and __mm can be a multiple of 5.
+            if (__mv % 5 == 0)
+                __vr_is_trailing_zeros = __multiple_of_pow5(__mv, __q);
+            else if (__accept_bounds)
+                __vm_is_trailing_zeros =
+                    __multiple_of_pow5(__mv - 1 - __mm_shift, __q);
+            else
+                __vp -= __multiple_of_pow5(__mv + 2, __q);
+        }
+    }
+    else
+    {
+        const uint32_t __q = __log10_pow5(-__e2) - (-__e2 > 1);
+        __e10 = static_cast<int>(__q) + __e2;
+        const int __i = -__e2 - static_cast<int>(__q);
+        const int __k = __pow5bits(__i) - __pow5_bitcount;
+        const int __j = static_cast<int>(__q) - __k;
+        __vr = __mul_shift64(4 * __m2, __pow5_split[__i], __j);
+        __vp = __mul_shift64(4 * __m2 + 2, __pow5_split[__i], __j);
+        __vm = __mul_shift64(4 * __m2 - 1 - __mm_shift, __pow5_split[__i], __j);
+        if (__q <= 1)
+        {
+            // __mv has at least __q trailing zero bits.
+            __vr_is_trailing_zeros = true;
+            if (__accept_bounds)
+                __vm_is_trailing_zeros = __mm_shift == 1;
+            else
+                --__vp;
+        }
+        else if (__q < 63)
+            __vr_is_trailing_zeros = __multiple_of_pow2(__mv, __q);
+    }
+
+    // Remove the digits that __vp and __vm have in common with __vr.
+    int __removed = 0;
+    uint32_t __last_removed_digit = 0;
+    uint64_t __output;
+    if (__vm_is_trailing_zeros || __vr_is_trailing_zeros)
+    {
+        // The general case, which happens rarely.
+        for (;;)
+        {
+            const uint64_t __vp_div10 = __vp / 10;
+            const uint64_t __vm_div10 = __vm / 10;
+            if (__vp_div10 <= __vm_div10)
+                break;
+            const uint64_t __vr_div10 = __vr / 10;
+            __vm_is_trailing_zeros &= __vm == 10 * __vm_div10;
+            __vr_is_trailing_zeros &= __last_removed_digit == 0;
+            __last_removed_digit = static_cast<uint32_t>(__vr - 10 * __vr_div10);
+            __vr = __vr_div10;
+            __vp = __vp_div10;
+            __vm = __vm_div10;
+            ++__removed;
+        }
+        if (__vm_is_trailing_zeros)
+        {
+            for (;;)
+            {
+                const uint64_t __vm_div10 = __vm / 10;
+                if (__vm != 10 * __vm_div10)
+                    break;
+                const uint64_t __vr_div10 = __vr / 10;
+                __vr_is_trailing_zeros &= __last_removed_digit == 0;
+                __last_removed_digit =
+                    static_cast<uint32_t>(__vr - 10 * __vr_div10);
+                __vr = __vr_div10;
+                __vp /= 10;
+                __vm = __vm_div10;
+                ++__removed;
+            }
+        }
+        // Round half to even.
+        if (__vr_is_trailing_zeros && __last_removed_digit == 5 && __vr % 2 == 0)
+            __last_removed_digit = 4;
+        __output = __vr + ((__vr == __vm &&
+                            (!__accept_bounds || !__vm_is_trailing_zeros)) ||
+                           __last_removed_digit >= 5);
+    }
+    else
+    {
+        // The common case: no trailing zeros to track.
+        bool __round_up = false;
+        const uint64_t __vp_div100 = __vp / 100;
+        const uint64_t __vm_div100 = __vm / 100;
+        if (__vp_div100 > __vm_div100)
+        {
+            const uint64_t __vr_div100 = __vr / 100;
+            __round_up = __vr - 100 * __vr_div100 >= 50;
+            __vr = __vr_div100;
+            __vp = __vp_div100;
+            __vm = __vm_div100;
+            __removed += 2;
+        }
+        for (;;)
+        {
+            const uint64_t __vp_div10 = __vp / 10;
+            const uint64_t __vm_div10 = __vm / 10;
+            if (__vp_div10 <= __vm_div10)
+                break;
+            const uint64_t __vr_div10 = __vr / 10;
+            __round_up = __vr - 10 * __vr_div10 >= 5;
+            __vr = __vr_div10;
+            __vp = __vp_div10;
+            __vm = __vm_div10;
+            ++__removed;
+        }
+        __output = __vr + (__vr == __vm || __round_up);
+    }
+    __decimal __result = {__output, __e10 + __removed};
+    return __result;
+}
+
+inline char* __write_exponent(char* __p, char __marker, int __e, int __min_digits)
+{
+    *__p++ = __marker;
+    *__p++ = __e < 0 ? '-' : '+';
+    const uint32_t __abs = __e < 0 ? 0u - static_cast<uint32_t>(__e)
+                                   : static_cast<uint32_t>(__e);
+    if (__min_digits == 2 && __abs < 10)
+        *__p++ = '0';
+    return __itoa::__u32toa(__abs, __p);
+}
+
+inline int __count_digits(uint32_t __value)
+{
+    int __n = 1;
+    for (; __value >= 10; __value /= 10)
+        ++__n;
+    return __n;
+}
+
+inline to_chars_result __copy_result(char* __first, char* __last,
+                                     const char* __buf, size_t __n)
+{
+    if (static_cast<size_t>(__last - __first) < __n)
+        return {__last, errc::value_too_large};
+    memcpy(__first, __buf, __n);
+    return {__first + __n, errc{}};
+}
+
+inline to_chars_result __to_chars_special(char* __first, char* __last,
+                                          bool __negative, bool __nan)
+{
+    char __buf[4] = {'-'};
+    memcpy(__buf + 1, __nan ? "nan" : "inf", 3);
+    return __copy_result(__first, __last, __buf + !__negative, 3 + __negative);
+}
+
+// Writes the decimal digits of __m2 * 2^__e2, an integer, to __p.
+inline char* __write_exact_integer(char* __p, uint64_t __m2, int __e2)
+{
+    if (__e2 <= 0)
+        return __itoa::__u64toa(__m2 >> -__e2, __p);
+
+    // Base 10^9, least significant limb first. Shifting a limb by 29 bits
+    // fits in 64 bits, and up to 36 limbs hold the 309 digits of DBL_MAX.
+    const uint32_t __base = 1000000000;
+    uint32_t __limbs[36];
+    int __n = 0;
+    for (; __m2 != 0; __m2 /= __base)
+        __limbs[__n++] = static_cast<uint32_t>(__m2 % __base);
+    for (; __e2 > 0; __e2 -= 29)
+    {
+        const int __shift = __e2 < 29 ? __e2 : 29;
+        uint64_t __carry = 0;
+        for (int __i = 0; __i < __n; ++__i)
+        {
+            const uint64_t __v = (uint64_t(__limbs[__i]) << __shift) + __carry;
+            __limbs[__i] = static_cast<uint32_t>(__v % __base);
+            __carry = __v / __base;
+        }
+        if (__carry != 0)
+            __limbs[__n++] = static_cast<uint32_t>(__carry);
+    }
+
+    __p = __itoa::__u32toa(__limbs[--__n], __p);
+    while (__n-- > 0)
+    {
+        uint32_t __limb = __limbs[__n];
+        for (int __i = 8; __i >= 0; --__i, __limb /= 10)
+            __p[__i] = static_cast<char>('0' + __limb % 10);
+        __p += 9;
+    }
+    return __p;
+}
+
+// Writes __digits * 10^__exponent in fixed or scientific notation. Without a
+// format, picks the shorter of the two, preferring fixed; chars_format::general
+// picks between them like %g does with the default precision.
+//
+// Padding the digits with zeros would print another integer than the value
+// when __exponent > 0, so fixed notation then calls
+// __exact_integer(__first, __last) to print the exact value instead. It may
+// be one digit shorter, e.g. 99999999999999991611392 for 1e23.
+template <class _ExactInteger>
+to_chars_result __to_chars_decimal(char* __first, char* __last, bool __negative,
+                                   const char* __digits, int __ndigits,
+                                   int __exponent, chars_format __fmt,
+                                   bool __has_fmt,
+                                   _ExactInteger __exact_integer)
+{
+    const int __sci_exponent = __ndigits - 1 + __exponent;
+    const int __abs_sci_exponent =
+        __sci_exponent < 0 ? -__sci_exponent : __sci_exponent;
+    const ptrdiff_t __sci_length =
+        __negative + __ndigits + (__ndigits > 1) + 2 +
+        (__abs_sci_exponent < 10 ? 2 : __count_digits(__abs_sci_exponent));
+    ptrdiff_t __fixed_length;
+    if (__exponent >= 0)
+        __fixed_length = __negative + __ndigits + __exponent;
+    else if (__ndigits > -__exponent)
+        __fixed_length = __negative + __ndigits + 1;
+    else
+        __fixed_length = __negative + 2 - __exponent;
+
+    bool __fixed;
+    if (!__has_fmt)
+        __fixed = __fixed_length <= __sci_length;
+    else if (__fmt == chars_format::general)
+        __fixed = -4 <= __sci_exponent && __sci_exponent < 6;
+    else
+        __fixed = __fmt == chars_format::fixed;
+
+    if (__fixed && __exponent > 0)
+        return __exact_integer(__first, __last);
+
+    const ptrdiff_t __length = __fixed ? __fixed_length : __sci_length;
+    if (__last - __first < __length)
+        return {__last, errc::value_too_large};
+
+    char* __p = __first;
+    if (__negative)
+        *__p++ = '-';
+    if (!__fixed)
+    {
+        *__p++ = __digits[0];
+        if (__ndigits > 1)
+        {
+            *__p++ = '.';
+            memcpy(__p, __digits + 1, __ndigits - 1);
+            __p += __ndigits - 1;
+        }
+        __p = __write_exponent(__p, 'e', __sci_exponent, 2);
+    }
+    else if (__exponent == 0)
+    {
+        memcpy(__p, __digits, __ndigits);
+        __p += __ndigits;
+    }
+    else if (__ndigits > -__exponent)
+    {
+        const int __int_digits = __ndigits + __exponent;
+        memcpy(__p, __digits, __int_digits);
+        __p += __int_digits;
+        *__p++ = '.';
+        memcpy(__p, __digits + __int_digits, -__exponent);
+        __p += -__exponent;
+    }
+    else
+    {
+        *__p++ = '0';
+        *__p++ = '.';
+        memset(__p, '0', -__exponent - __ndigits);
+        __p += -__exponent - __ndigits;
+        memcpy(__p, __digits, __ndigits);
+        __p += __ndigits;
+    }
+    return {__p, errc{}};
+}
+
+// The shortest hexadecimal representation, like %a without the 0x prefix.
+template <class _Tp>
+to_chars_result __to_chars_hex(char* __first, char* __last, bool __negative,
+                               uint64_t __ieee_mantissa, uint32_t __ieee_exponent)
+{
+    typedef __float_traits<_Tp> _Traits;
+    char __buf[32];
+    char* __p = __buf;
+    if (__negative)
+        *__p++ = '-';
+    int __e = 0;
+    if (__ieee_exponent == 0 && __ieee_mantissa == 0)
+        *__p++ = '0';
+    else
+    {
+        *__p++ = __ieee_exponent != 0 ? '1' : '0';
+        __e = __ieee_exponent != 0
+                  ? static_cast<int>(__ieee_exponent) - _Traits::__exponent_bias
+                  : 1 - _Traits::__exponent_bias;
+        if (__ieee_mantissa != 0)
+        {
+            int __nibbles = (_Traits::__mantissa_bits + 3) / 4;
+            uint64_t __fraction = __ieee_mantissa
+                                  << (4 * __nibbles - _Traits::__mantissa_bits);
+            for (; (__fraction & 0xf) == 0; __fraction >>= 4)
+                --__nibbles;
+            *__p++ = '.';
+            while (__nibbles-- > 0)
+                *__p++ = __hex_digits[(__fraction >> (4 * __nibbles)) & 0xf];
+        }
+    }
+    __p = __write_exponent(__p, 'p', __e, 1);
+    return __copy_result(__first, __last, __buf, __p - __buf);
+}
+
+template <class _Tp>
+to_chars_result __to_chars_shortest(char* __first, char* __last, _Tp __value,
+                                    chars_format __fmt, bool __has_fmt)
+{
+    typedef __float_traits<_Tp> _Traits;
+    typedef typename _Traits::__bits_type _Bits;
+    _Bits __bits;
+    memcpy(&__bits, &__value, sizeof(__bits));
+    const bool __negative = (__bits >> (_Traits::__mantissa_bits +
+                                        _Traits::__exponent_bits)) != 0;
+    const uint64_t __ieee_mantissa =
+        __bits & ((_Bits(1) << _Traits::__mantissa_bits) - 1);
+    const uint32_t __ieee_exponent = static_cast<uint32_t>(
+        (__bits >> _Traits::__mantissa_bits) &
+        ((1u << _Traits::__exponent_bits) - 1));
+
+    if (__ieee_exponent == (1u << _Traits::__exponent_bits) - 1)
+        return __to_chars_special(__first, __last, __negative,
+                                  __ieee_mantissa != 0);
+    if (__has_fmt && __fmt == chars_format::hex)
+        return __to_chars_hex<_Tp>(__first, __last, __negative,
+                                   __ieee_mantissa, __ieee_exponent);
+
+    char __digits[24] = {'0'};
+    int __ndigits = 1;
+    int __exponent = 0;
+    if (__ieee_exponent != 0 || __ieee_mantissa != 0)
+    {
+        const __decimal __d = __shortest<_Tp>(__ieee_mantissa, __ieee_exponent);
+        __ndigits = static_cast<int>(__itoa::__u64toa(__d.__mantissa, __digits) -
+                                     __digits);
+        __exponent = __d.__exponent;
+    }
+    auto __exact_integer = [=](char* __f, char* __l) {
+        const uint64_t __m2 =
+            __ieee_mantissa | (uint64_t(1) << _Traits::__mantissa_bits);
+        const int __e2 = static_cast<int>(__ieee_exponent) -
+                         _Traits::__exponent_bias - _Traits::__mantissa_bits;
+        char __buf[320] = {'-'};
+        char* __p = __write_exact_integer(__buf + __negative, __m2, __e2);
+        return __copy_result(__f, __l, __buf, __p - __buf);
+    };
+    return __to_chars_decimal(__first, __last, __negative, __digits, __ndigits,
+                              __exponent, __fmt, __has_fmt, __exact_integer);
+}
+
+// Formats with snprintf in the "C" locale, for the conversions with a
+// precision and for long double.
+template <class _Tp>
+to_chars_result __to_chars_printf(char* __first, char* __last, _Tp __value,
+                                  chars_format __fmt, int __precision)
+{
+    char __spec[6] = {'%', '.', '*'};
+    char* __conv = __spec + 3;
+    if (is_same<_Tp, long double>::value)
+        *__conv++ = 'L';
+    switch (__fmt)
+    {
+    case chars_format::scientific: *__conv = 'e'; break;
+    case chars_format::fixed:      *__conv = 'f'; break;
+    case chars_format::hex:        *__conv = 'a'; break;
+    default:                       *__conv = 'g'; break;
+    }
+
+    char __stack_buf[512];
+    char* __buf = __stack_buf;
+    int __n = __libcpp_snprintf_l(__buf, sizeof(__stack_buf),
+                                  _LIBCPP_GET_C_LOCALE, __spec, __precision,
+                                  __value);
+    if (__n < 0)
+        return {__last, errc::value_too_large};
+    if (static_cast<size_t>(__n) >= sizeof(__stack_buf))
+    {
+        // Huge fixed notation.
+        if (__n > __last - __first + 2)
+            return {__last, errc::value_too_large};
+        __buf = static_cast<char*>(malloc(__n + 1));
+        if (__buf == nullptr)
+            return {__last, errc::value_too_large};
+        __libcpp_snprintf_l(__buf, __n + 1, _LIBCPP_GET_C_LOCALE, __spec,
+                            __precision, __value);
+    }
+
+    const char* __s = __buf;
+    size_t __len = __n;
+    to_chars_result __r;
+    if (__fmt == chars_format::hex && isfinite(__value))
+    {
+        // Drop the 0x prefix.
+        const bool __negative = __s[0] == '-';
+        if (__last - __first < 1 + __negative)
+            __r = {__last, errc::value_too_large};
+        else
+        {
+            __r = __copy_result(__first + __negative, __last, __s + 2 + __negative,
+                                __len - 2 - __negative);
+            if (__negative && __r.ec == errc{})
+                *__first = '-';
+        }
+    }
+    else
+        __r = __copy_result(__first, __last, __s, __len);
+    if (__buf != __stack_buf)
+        free(__buf);
+    return __r;
+}
+
+to_chars_result __to_chars_long_double(char* __first, char* __last,
+                                       long double __value, chars_format __fmt,
+                                       bool __has_fmt)
+{
+    if (isinf(__value) || isnan(__value))
+        return __to_chars_special(__first, __last, signbit(__value),
+                                  isnan(__value));
+    if (__has_fmt && __fmt == chars_format::hex)
+        return __to_chars_printf(__first, __last, __value, __fmt, -1);
+
+    // Find the shortest precision that round-trips.
+    char __buf[64];
+    char* __digits = __buf;
+    int __ndigits = 1;
+    int __exponent = 0;
+    if (__value == 0)
+        __buf[0] = '0';
+    else
+    {
+        const int __max_digits = numeric_limits<long double>::max_digits10;
+        for (__ndigits = 1; __ndigits < __max_digits; ++__ndigits)
+        {
+            __libcpp_snprintf_l(__buf, sizeof(__buf), _LIBCPP_GET_C_LOCALE,
+                                "%.*Le", __ndigits - 1, __value);
+            if (strtold_l(__buf, nullptr, _LIBCPP_GET_C_LOCALE) == __value)
+                break;
+        }
+        __libcpp_snprintf_l(__buf, sizeof(__buf), _LIBCPP_GET_C_LOCALE,
+                            "%.*Le", __ndigits - 1, __value);
+        // [-]d[.ddd]e[+-]dd
+        __digits += __buf[0] == '-';
+        char* __e = strchr(__digits, 'e');
+        __exponent = atoi(__e + 1) - (__ndigits - 1);
+        if (__ndigits > 1)
+            memmove(__digits + 1, __digits + 2, __ndigits - 1);
+    }
+    // printf prints integers exactly.
+    auto __exact_integer = [=](char* __f, char* __l) {
+        return __to_chars_printf(__f, __l, __value, chars_format::fixed, 0);
+    };
+    return __to_chars_decimal(__first, __last, signbit(__value), __digits,
+                              __ndigits, __exponent, __fmt, __has_fmt,
+                              __exact_integer);
+}
+
+//===----------------------------------------------------------------------===//
+//                               from_chars
+//===----------------------------------------------------------------------===//
+
+inline bool __is_digit(char __c) { return static_cast<unsigned>(__c - '0') < 10; }
+
+inline bool __is_xdigit(char __c)
+{
+    return __is_digit(__c) || static_cast<unsigned>((__c | 0x20) - 'a') < 6;
+}
+
+// Case-insensitive match of a lowercase __word at [__p, __last).
+inline bool __match(const char* __p, const char* __last, const char* __word)
+{
+    for (; *__word != '\0'; ++__p, ++__word)
+        if (__p == __last || (*__p | 0x20) != *__word)
+            return false;
+    return true;
+}
+
+// The parsed form of a floating-point string.
+struct __floating_decimal
+{
+    const char* __begin;  // the first character after the sign
+    const char* __end;
+    bool __negative;
+    bool __zero;          // all of the digits are zero
+    bool __truncated;     // nonzero digits after the first 19 were dropped
+    uint64_t __mantissa;  // the first 19 significant digits
+    int64_t __exponent;   // the power of ten that applies to __mantissa
+};
+
+// Parses the decimal or hexadecimal (then __mantissa and __exponent are not
+// set) syntax of from_chars. Returns false if there is no number.
+bool __parse_floating(const char* __first, const char* __last,
+                      chars_format __fmt, __floating_decimal& __d)
+{
+    const char* __p = __first;
+    __d.__negative = __p != __last && *__p == '-';
+    __p += __d.__negative;
+    __d.__begin = __p;
+    __d.__zero = true;
+    __d.__truncated = false;
+    __d.__mantissa = 0;
+    __d.__exponent = 0;
+
+    if (__fmt == chars_format::hex)
+    {
+        const char* __digits = __p;
+        for (; __p != __last && __is_xdigit(*__p); ++__p)
+            __d.__zero &= *__p == '0';
+        bool __any = __p != __digits;
+        if (__p != __last && *__p == '.')
+        {
+            const char* __fraction = ++__p;
+            for (; __p != __last && __is_xdigit(*__p); ++__p)
+                __d.__zero &= *__p == '0';
+            __any |= __p != __fraction;
+        }
+        if (!__any)
+            return false;
+        if (__p != __last && (*__p | 0x20) == 'p')
+        {
+            const char* __e = __p + 1;
+            if (__e != __last && (*__e == '+' || *__e == '-'))
+                ++__e;
+            if (__e != __last && __is_digit(*__e))
+            {
+                for (; __e != __last && __is_digit(*__e); ++__e)
+                    ;
+                __p = __e;
+            }
+        }
+        __d.__end = __p;
+        return true;
+    }
+
+    const int __max_digits = 19;
+    int __ndigits = 0;
+    int64_t __exponent = 0;
+    bool __any = false;
+    for (; __p != __last && *__p == '0'; ++__p)
+        __any = true;
+    for (; __p != __last && __is_digit(*__p); ++__p)
+    {
+        __any = true;
+        if (__ndigits < __max_digits)
+        {
+            __d.__mantissa = 10 * __d.__mantissa + (*__p - '0');
+            ++__ndigits;
+        }
+        else
+        {
+            ++__exponent;
+            __d.__truncated |= *__p != '0';
+        }
+    }
+    if (__p != __last && *__p == '.')
+    {
+        ++__p;
+        if (__ndigits == 0)
+            for (; __p != __last && *__p == '0'; ++__p)
+            {
+                __any = true;
+                --__exponent;
+            }
+        for (; __p != __last && __is_digit(*__p); ++__p)
+        {
+            __any = true;
+            if (__ndigits < __max_digits)
+            {
+                __d.__mantissa = 10 * __d.__mantissa + (*__p - '0');
+                ++__ndigits;
+                --__exponent;
+            }
+            else
+                __d.__truncated |= *__p != '0';
+        }
+    }
+    if (!__any)
+        return false;
+    __d.__zero = __ndigits == 0;
+
+    bool __has_exponent = false;
+    if ((static_cast<int>(__fmt) & static_cast<int>(chars_format::scientific)) &&
+        __p != __last && (*__p | 0x20) == 'e')
+    {
+        const char* __e = __p + 1;
+        bool __negative_exponent = false;
+        if (__e != __last && (*__e == '+' || *__e == '-'))
+            __negative_exponent = *__e++ == '-';
+        if (__e != __last && __is_digit(*__e))
+        {
+            int64_t __explicit_exponent = 0;
+            for (; __e != __last && __is_digit(*__e); ++__e)
+                if (__explicit_exponent < 100000)
+                    __explicit_exponent = 10 * __explicit_exponent + (*__e - '0');
+            __exponent += __negative_exponent ? -__explicit_exponent
+                                              : __explicit_exponent;
+            __has_exponent = true;
+            __p = __e;
+        }
+    }
+    if (__fmt == chars_format::scientific && !__has_exponent)
+        return false;
+
+    __d.__exponent = __exponent;
+    __d.__end = __p;
+    return true;
+}
+
+// Rounds __w * 10^__q to the nearest _Tp with the Eisel-Lemire algorithm and
+// stores the bits in __bits. Returns false when the product is too close to a
+// halfway point between two floats to decide, or if the result is subnormal.
+template <class _Tp>
+bool __eisel_lemire(uint64_t __w, int64_t __q, uint64_t& __bits)
+{
+    typedef __float_traits<_Tp> _Traits;
+    const uint64_t __inf = uint64_t((1 << _Traits::__exponent_bits) - 1)
+                           << _Traits::__mantissa_bits;
+    if (__q < _Traits::__min_pow10)
+    {
+        __bits = 0;
+        return true;
+    }
+    if (__q > _Traits::__max_pow10)
+    {
+        __bits = __inf;
+        return true;
+    }
+
+    // The table holds 5^__q truncated to 128 bits, so the exact product lies
+    // in [__hi:__mid:__lo, __hi:__mid:__lo + 2^64).
+    const int __lz = __libcpp_clz(__w);
+    __w <<= __lz;
+    const uint64_t* __t = __pow5_128[__q - __pow5_128_min];
+    uint64_t __hi, __mid;
+    const uint64_t __p1_lo = __umul128(__w, __t[0], &__hi);
+    const uint64_t __lo = __umul128(__w, __t[1], &__mid);
+    __mid += __p1_lo;
+    __hi += __mid < __p1_lo;
+
+    // 5^__q fits in 128 bits exactly for 0 <= __q <= 55.
+    const bool __exact = 0 <= __q && __q <= 55;
+    const int __upper = static_cast<int>(__hi >> 63);
+    const int __shift = __upper + 64 - _Traits::__mantissa_bits - 3;
+    const uint64_t __low_mask = (uint64_t(1) << __shift) - 1;
+    if (!__exact && (__hi & __low_mask) == __low_mask && __mid == ~uint64_t(0))
+        return false;
+
+    // The mantissa with one more bit to round.
+    uint64_t __m = __hi >> __shift;
+    int64_t __e = ((217706 * __q) >> 16) + 63 + __upper - __lz +
+                  _Traits::__exponent_bias;
+    if (__e <= 0)
+        return false;
+    const bool __sticky =
+        !__exact || (__hi & __low_mask) != 0 || __mid != 0 || __lo != 0;
+    if ((__m & 1) != 0 && (__sticky || (__m & 2) != 0))
+        __m += 2;
+    __m >>= 1;
+    if ((__m >> (_Traits::__mantissa_bits + 1)) != 0)
+    {
+        __m >>= 1;
+        ++__e;
+    }
+    if (__e >= (1 << _Traits::__exponent_bits) - 1)
+    {
+        __bits = __inf;
+        return true;
+    }
+    __bits = (uint64_t(__e) << _Traits::__mantissa_bits) |
+             (__m & ((uint64_t(1) << _Traits::__mantissa_bits) - 1));
+    return true;
+}
+
+// Converts with strtod, for the cases the fast paths do not handle.
+template <class _Tp>
+_Tp __strtod_fallback(const __floating_decimal& __d, chars_format __fmt)
+{
+    const size_t __n = __d.__end - __d.__begin;
+    char __stack_buf[128];
+    char* __buf = __stack_buf;
+    if (__n + 4 > sizeof(__stack_buf))
+        __buf = static_cast<char*>(malloc(__n + 4));
+    if (__buf == nullptr)
+        __throw_bad_alloc();
+    char* __p = __buf;
+    if (__d.__negative)
+        *__p++ = '-';
+    if (__fmt == chars_format::hex)
+    {
+        *__p++ = '0';
+        *__p++ = 'x';
+    }
+    memcpy(__p, __d.__begin, __n);
+    __p[__n] = '\0';
+    const _Tp __r = __do_strtod<_Tp>(__buf, nullptr);
+    if (__buf != __stack_buf)
+        free(__buf);
+    return __r;
+}
+
+template <class _Tp>
+_Tp __to_floating(const __floating_decimal& __d, chars_format __fmt)
+{
+    typedef __float_traits<_Tp> _Traits;
+    if (__fmt == chars_format::hex)
+        return __strtod_fallback<_Tp>(__d, __fmt);
+    if (__d.__zero)
+        return __d.__negative ? -_Tp(0) : _Tp(0);
+
+    const uint64_t __w = __d.__mantissa;
+    const int64_t __q = __d.__exponent;
+#if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD == 0
+    static const _Tp __pow10[] = {
+        1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+    if (!__d.__truncated && __w <= _Traits::__max_exact_mantissa &&
+        -_Traits::__max_exact_pow10 <= __q && __q <= _Traits::__max_exact_pow10)
+    {
+        _Tp __r = static_cast<_Tp>(__w);
+        __r = __q < 0 ? __r / __pow10[-__q] : __r * __pow10[__q];
+        return __d.__negative ? -__r : __r;
+    }
+#endif
+
+    uint64_t __bits;
+    if (!__eisel_lemire<_Tp>(__w, __q, __bits))
+        return __strtod_fallback<_Tp>(__d, __fmt);
+    if (__d.__truncated)
+    {
+        // The value is between __w and __w + 1 times 10^__q.
+        uint64_t __upper_bits;
+        if (!__eisel_lemire<_Tp>(__w + 1, __q, __upper_bits) ||
+            __upper_bits != __bits)
+            return __strtod_fallback<_Tp>(__d, __fmt);
+    }
+    __bits |= uint64_t(__d.__negative)
+              << (_Traits::__mantissa_bits + _Traits::__exponent_bits);
+    const typename _Traits::__bits_type __narrow_bits =
+        static_cast<typename _Traits::__bits_type>(__bits);
+    _Tp __r;
+    memcpy(&__r, &__narrow_bits, sizeof(__r));
+    return __r;
+}
+
+template <>
+long double __to_floating<long double>(const __floating_decimal& __d,
+                                       chars_format __fmt)
+{
+    if (__d.__zero && __fmt != chars_format::hex)
+        return __d.__negative ? -0.0L : 0.0L;
+    return __strtod_fallback<long double>(__d, __fmt);
+}
+
+template <class _Tp>
+from_chars_result __from_chars_floating(const char* __first, const char* __last,
+                                        _Tp& __value, chars_format __fmt)
+{
+    const char* __p = __first + (__first != __last && *__first == '-');
+    if (__match(__p, __last, "inf"))
+    {
+        __p += __match(__p + 3, __last, "inity") ? 8 : 3;
+        __value = *__first == '-' ? -numeric_limits<_Tp>::infinity()
+                                  : numeric_limits<_Tp>::infinity();
+        return {__p, errc{}};
+    }
+    if (__match(__p, __last, "nan"))
+    {
+        __p += 3;
+        if (__p != __last && *__p == '(')
+        {
+            const char* __q = __p + 1;
+            while (__q != __last && (__is_digit(*__q) || *__q == '_' ||
+                                     static_cast<unsigned>((*__q | 0x20) - 'a') < 26))
+                ++__q;
+            if (__q != __last && *__q == ')')
+                __p = __q + 1;
+        }
+        __value = *__first == '-' ? -numeric_limits<_Tp>::quiet_NaN()
+                                  : numeric_limits<_Tp>::quiet_NaN();
+        return {__p, errc{}};
+    }
+
+    __floating_decimal __d;
+    if (!__parse_floating(__first, __last, __fmt, __d))
+        return {__first, errc::invalid_argument};
+    const _Tp __r = __to_floating<_Tp>(__d, __fmt);
+    if (isinf(__r) || (__r == 0 && !__d.__zero))
+        return {__d.__end, errc::result_out_of_range};
+    __value = __r;
+    return {__d.__end, errc{}};
+}
+
+}  // namespace
+}  // namespace __charconv
+
+to_chars_result to_chars(char* __first, char* __last, float __value)
+{
+    return __charconv::__to_chars_shortest(__first, __last, __value,
+                                           chars_format::general, false);
+}
+
+to_chars_result to_chars(char* __first, char* __last, double __value)
+{
+    return __charconv::__to_chars_shortest(__first, __last, __value,
+                                           chars_format::general, false);
+}
+
+to_chars_result to_chars(char* __first, char* __last, long double __value)
+{
+#if LDBL_MANT_DIG == DBL_MANT_DIG
+    return to_chars(__first, __last, static_cast<double>(__value));
+#else
+    return __charconv::__to_chars_long_double(__first, __last, __value,
+                                              chars_format::general, false);
+#endif
+}
+
+to_chars_result to_chars(char* __first, char* __last, float __value,
+                         chars_format __fmt)
+{
+    return __charconv::__to_chars_shortest(__first, __last, __value, __fmt,
+                                           true);
+}
+
+to_chars_result to_chars(char* __first, char* __last, double __value,
+                         chars_format __fmt)
+{
+    return __charconv::__to_chars_shortest(__first, __last, __value, __fmt,
+                                           true);
+}
+
+to_chars_result to_chars(char* __first, char* __last, long double __value,
+                         chars_format __fmt)
+{
+#if LDBL_MANT_DIG == DBL_MANT_DIG
+    return to_chars(__first, __last, static_cast<double>(__value), __fmt);
+#else
+    return __charconv::__to_chars_long_double(__first, __last, __value, __fmt,
+                                              true);
+#endif
+}
+
+to_chars_result to_chars(char* __first, char* __last, float __value,
+                         chars_format __fmt, int __precision)
+{
+    return __charconv::__to_chars_printf(__first, __last, __value, __fmt,
+                                         __precision);
+}
+
+to_chars_result to_chars(char* __first, char* __last, double __value,
+                         chars_format __fmt, int __precision)
+{
+    return __charconv::__to_chars_printf(__first, __last, __value, __fmt,
+                                         __precision);
+}
+
+to_chars_result to_chars(char* __first, char* __last, long double __value,
+                         chars_format __fmt, int __precision)
+{
+    return __charconv::__to_chars_printf(__first, __last, __value, __fmt,
+                                         __precision);
+}
+
+from_chars_result from_chars(const char* __first, const char* __last,
+                             float& __value, chars_format __fmt)
+{
+    return __charconv::__from_chars_floating(__first, __last, __value, __fmt);
+}
+
+from_chars_result from_chars(const char* __first, const char* __last,
+                             double& __value, chars_format __fmt)
+{
+    return __charconv::__from_chars_floating(__first, __last, __value, __fmt);
+}
+
+from_chars_result from_chars(const char* __first, const char* __last,
+                             long double& __value, chars_format __fmt)
+{
+#if LDBL_MANT_DIG == DBL_MANT_DIG
+    double __d;
+    from_chars_result __r = from_chars(__first, __last, __d, __fmt);
+    if (__r.ec == errc{})
+        __value = __d;
+    return __r;
+#else
+    return __charconv::__from_chars_floating(__first, __last, __value, __fmt);
+#endif
+}
+
 _LIBCPP_END_NAMESPACE_STD
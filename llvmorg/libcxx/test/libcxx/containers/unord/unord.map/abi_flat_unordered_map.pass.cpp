@@ -0,0 +1,82 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// The test suite needs to define the ABI macros on the command line when
+// modules are enabled.
+// UNSUPPORTED: -fmodules
+// UNSUPPORTED: c++03
+
+// <unordered_map>
+
+// Test that _LIBCPP_ABI_FLAT_UNORDERED_MAP stores the elements of
+// unordered_map in an open-addressing table when they are trivially copyable,
+// and that the rest of the container keeps working with it.
+
+#define _LIBCPP_ABI_FLAT_UNORDERED_MAP
+
+#include <unordered_map>
+#include <memory>
+#include <type_traits>
+#include <cassert>
+
+#include "test_macros.h"
+
+typedef std::unordered_map<int, int> FlatMap;
+typedef std::unordered_map<int, std::unique_ptr<int> > NodeMap;
+
+static_assert((std::is_same<FlatMap::iterator,
+    std::__hash_map_iterator<std::__flat_hash_iterator<
+        std::__hash_value_type<int, int> > > >::value), "");
+static_assert((std::is_same<NodeMap::iterator,
+    std::__hash_map_iterator<std::__hash_iterator<
+        std::__hash_node<std::__hash_value_type<int, std::unique_ptr<int> >, void*>*> > >::value), "");
+static_assert((std::is_same<std::unordered_multimap<int, int>::iterator,
+    std::__hash_map_iterator<std::__hash_iterator<
+        std::__hash_node<std::__hash_value_type<int, int>, void*>*> > >::value), "");
+
+int main(int, char**)
+{
+    {
+        FlatMap m;
+        for (int i = 0; i < 1000; ++i)
+            m.emplace(i, -i);
+        for (int i = 0; i < 1000; i += 2)
+            m.erase(i);
+        FlatMap m2(m);
+        assert(m2 == m && m2.size() == 500);
+        for (int i = 0; i < 1000; ++i)
+            assert(m2.count(i) == size_t(i & 1));
+        FlatMap m3(std::move(m2), m.get_allocator());
+        assert(m3 == m);
+        m3 = {{1, 2}, {3, 4}};
+        assert(m3.size() == 2 && m3.at(3) == 4 && m3[5] == 0);
+        size_t n = 0;
+        for (size_t b = 0; b < m3.bucket_count(); ++b)
+            n += m3.bucket_size(b);
+        assert(n == 3);
+    }
+#if TEST_STD_VER > 14
+    {
+        FlatMap m = {{1, 1}, {2, 2}};
+        FlatMap::node_type nh = m.extract(1);
+        assert(nh.key() == 1 && nh.mapped() == 1);
+        nh.key() = 3;
+        assert(m.insert(std::move(nh)).inserted);
+        assert(m.at(3) == 1);
+
+        std::unordered_multimap<int, int> mm = {{2, 0}, {4, 4}, {4, 5}};
+        m.merge(mm);
+        assert(m.size() == 3 && (m.at(4) == 4 || m.at(4) == 5));
+        assert(mm.size() == 2 && mm.count(2) == 1);
+        mm.merge(m);
+        assert(m.empty() && mm.size() == 5);
+    }
+#endif
+
+    return 0;
+}
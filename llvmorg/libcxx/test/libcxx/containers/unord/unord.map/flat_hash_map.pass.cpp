@@ -0,0 +1,178 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// UNSUPPORTED: c++03
+
+// Not a portable test
+
+// <unordered_map>
+
+// class __flat_hash_map
+
+#include <unordered_map>
+#include <cassert>
+#include <memory>
+
+#include "test_macros.h"
+#include "test_allocator.h"
+
+// Inserting and erasing many elements crosses several resizes, reuses the
+// deleted slots, and fills every group of the table.
+void test_insert_erase()
+{
+    std::__flat_hash_map<int, int> m;
+    for (int i = 0; i < 10000; ++i)
+        m[i] = 2 * i;
+    assert(m.size() == 10000);
+    assert(m.load_factor() <= 0.875f);
+    for (int i = 0; i < 10000; ++i)
+        assert(m.at(i) == 2 * i);
+    assert(m.find(-1) == m.end());
+
+    size_t n = 0;
+    for (std::__flat_hash_map<int, int>::const_iterator i = m.begin();
+         i != m.end(); ++i, ++n)
+        assert(i->second == 2 * i->first);
+    assert(n == m.size());
+
+    for (int i = 0; i < 10000; i += 2)
+        assert(m.erase(i) == 1);
+    assert(m.size() == 5000);
+    for (int i = 0; i < 10000; ++i)
+        assert(m.count(i) == size_t(i & 1));
+
+    size_t bc = m.bucket_count();
+    for (int i = 0; i < 10000; i += 2)
+        assert(m.emplace(i, 2 * i).second);
+    assert(m.bucket_count() == bc);
+    assert(!m.emplace(0, 1).second);
+    assert(!m.try_emplace(0, 1).second);
+    assert(m.at(0) == 0);
+    assert(!m.insert_or_assign(0, 1).second);
+    assert(m.at(0) == 1);
+
+    for (std::__flat_hash_map<int, int>::iterator i = m.begin(); i != m.end();)
+        i = m.erase(i);
+    assert(m.empty());
+    m.rehash(0);
+    assert(m.bucket_count() == 0);
+    assert(m.begin() == m.end());
+}
+
+void test_move_only()
+{
+    typedef std::__flat_hash_map<long, std::unique_ptr<int> > M;
+    M m;
+    for (int i = 0; i < 1000; ++i)
+        m.try_emplace(i, new int(3 * i));
+    for (int i = 0; i < 1000; i += 3)
+        m.erase(i);
+    m.reserve(5000);
+    for (int i = 1000; i < 2000; ++i)
+        m.emplace(i, std::unique_ptr<int>(new int(3 * i)));
+    for (int i = 0; i < 2000; ++i)
+        assert(i < 1000 && i % 3 == 0 ? m.count(i) == 0 : *m.at(i) == 3 * i);
+
+    M m2(std::move(m));
+    assert(m.empty());
+    m = std::move(m2);
+    assert(*m[1] == 3);
+    assert(!m[-1]);
+}
+
+void test_copy_and_compare()
+{
+    typedef std::__flat_hash_map<int, int> M;
+    M m = {{1, 1}, {2, 4}, {3, 9}, {3, 0}};
+    assert(m.size() == 3);
+    M m2 = m;
+    assert(m2 == m);
+    m2[2] = 5;
+    assert(m2 != m);
+    m2 = m;
+    assert(m2 == m);
+    m2.clear();
+    swap(m, m2);
+    assert(m.empty() && m2.size() == 3);
+}
+
+void test_allocator_extended_move()
+{
+    typedef test_allocator<std::pair<const int, int> > A;
+    typedef std::__flat_hash_map<int, int, std::hash<int>, std::equal_to<int>, A> M;
+    M m(0, std::hash<int>(), std::equal_to<int>(), A(1));
+    for (int i = 0; i < 100; ++i)
+        m[i] = i;
+    M m2(std::move(m), A(2));
+    assert(m2.get_allocator() == A(2));
+    assert(m2.size() == 100 && m.empty());
+    for (int i = 0; i < 100; ++i)
+        assert(m2.at(i) == i);
+}
+
+// Every slot is a bucket of at most one element.
+void test_buckets()
+{
+    std::__flat_hash_map<int, int> m;
+    for (int i = 0; i < 100; ++i)
+        m[i] = i;
+    size_t n = 0;
+    for (size_t b = 0; b < m.bucket_count(); ++b)
+    {
+        assert(m.bucket_size(b) <= 1);
+        n += m.bucket_size(b);
+        for (std::__flat_hash_map<int, int>::local_iterator i = m.begin(b);
+             i != m.end(b); ++i)
+            assert(m.bucket(i->first) == b);
+    }
+    assert(n == m.size());
+    assert(m.max_load_factor() == 1.0f);
+    m.max_load_factor(0.25f);
+    assert(m.max_load_factor() == m.load_factor());
+    m.clear();
+    m.max_load_factor(0.25f);
+    for (int i = 0; i < 100; ++i)
+        m[i] = i;
+    assert(m.load_factor() <= 0.25f);
+    m.rehash(1);
+    assert(m.load_factor() <= 0.25f);
+    for (int i = 0; i < 100; ++i)
+        assert(m.at(i) == i);
+}
+
+void test_node_handles()
+{
+#if TEST_STD_VER > 14
+    typedef std::__flat_hash_map<int, int> M;
+    M m;
+    for (int i = 0; i < 10; ++i)
+        m[i] = i;
+    M::node_type nh = m.extract(5);
+    assert(!nh.empty() && nh.key() == 5 && nh.mapped() == 5);
+    assert(m.size() == 9 && m.count(5) == 0);
+    nh.key() = 50;
+    M::insert_return_type r = m.insert(std::move(nh));
+    assert(r.inserted && r.position->first == 50 && r.node.empty());
+    nh = m.extract(m.find(50));
+    nh.key() = 1;
+    r = m.insert(std::move(nh));
+    assert(!r.inserted && !r.node.empty() && r.position->second == 1);
+#endif
+}
+
+int main(int, char**)
+{
+    test_insert_erase();
+    test_move_only();
+    test_copy_and_compare();
+    test_allocator_extended_move();
+    test_buckets();
+    test_node_handles();
+
+    return 0;
+}
@@ -0,0 +1,65 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// UNSUPPORTED: c++03
+
+// Not a portable test
+
+// <unordered_set>
+
+// class __flat_hash_set
+
+#include <unordered_set>
+#include <cassert>
+
+#include "test_macros.h"
+
+int main(int, char**)
+{
+    typedef std::__flat_hash_set<long> S;
+    {
+        S s = {1, 2, 3, 3};
+        assert(s.size() == 3);
+        assert(s.count(2) == 1 && s.count(4) == 0);
+        // Erasing right behind the insertions keeps reusing the same slots.
+        for (long i = 0; i < 1000; ++i)
+        {
+            s.insert(i);
+            s.erase(i - 1);
+        }
+        assert(s.size() == 1 && *s.begin() == 999);
+    }
+    {
+        S s;
+        for (long i = 0; i < 5000; ++i)
+            assert(s.insert(i * 7).second);
+        assert(!s.insert(7).second);
+        S s2(s.begin(), s.end());
+        assert(s2 == s);
+        s2.erase(s2.find(7));
+        assert(s2 != s);
+        assert(s2.erase(7) == 0);
+        for (long i = 0; i < 5000; ++i)
+            assert(s.count(i) == (i % 7 == 0 ? 1u : 0u));
+        s.erase(s.begin(), s.end());
+        assert(s.empty());
+    }
+#if TEST_STD_VER > 14
+    {
+        S s = {1, 2, 3};
+        S::node_type nh = s.extract(2);
+        assert(!nh.empty() && nh.value() == 2 && s.size() == 2);
+        nh.value() = 4;
+        S::insert_return_type r = s.insert(std::move(nh));
+        assert(r.inserted && *r.position == 4);
+        assert(s.count(4) == 1 && s.count(2) == 0);
+    }
+#endif
+
+    return 0;
+}
@@ -0,0 +1,161 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// UNSUPPORTED: c++03, c++11, c++14
+
+// from_chars requires functions in the dylib that were introduced in Mac OS 10.15.
+//
+// XFAIL: with_system_cxx_lib=macosx10.14
+// XFAIL: with_system_cxx_lib=macosx10.13
+// XFAIL: with_system_cxx_lib=macosx10.12
+// XFAIL: with_system_cxx_lib=macosx10.11
+// XFAIL: with_system_cxx_lib=macosx10.10
+// XFAIL: with_system_cxx_lib=macosx10.9
+
+// <charconv>
+
+// from_chars_result from_chars(const char* first, const char* last,
+//                              Floating& value,
+//                              chars_format fmt = chars_format::general);
+
+#include <charconv>
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <random>
+
+#include "test_macros.h"
+
+template <class T>
+void test(const char* s, T expected, std::size_t length,
+          std::chars_format fmt = std::chars_format::general)
+{
+    T value = T(42);
+    std::from_chars_result r =
+        std::from_chars(s, s + std::strlen(s), value, fmt);
+    assert(r.ec == std::errc{});
+    assert(r.ptr == s + length);
+    if (std::isnan(expected))
+        assert(std::isnan(value));
+    else
+        assert(std::memcmp(&value, &expected, sizeof(value)) == 0);
+}
+
+template <class T>
+void test_error(const char* s, std::errc ec, std::size_t length,
+                std::chars_format fmt = std::chars_format::general)
+{
+    T value = T(42);
+    std::from_chars_result r =
+        std::from_chars(s, s + std::strlen(s), value, fmt);
+    assert(r.ec == ec);
+    assert(r.ptr == s + length);
+    assert(value == T(42));
+}
+
+// Agrees with strtod on random decimal strings, including long ones and
+// exact halfway points between two doubles.
+void test_strtod()
+{
+    std::mt19937_64 gen(42);
+    char buf[128];
+    for (int i = 0; i < 100000; ++i)
+    {
+        char* p = buf;
+        int digits = 1 + gen() % 25;
+        int point = gen() % (digits + 1);
+        for (int d = 0; d < digits; ++d)
+        {
+            if (d == point)
+                *p++ = '.';
+            *p++ = static_cast<char>('0' + (d == 0 ? 1 + gen() % 9 : gen() % 10));
+        }
+        std::sprintf(p, "e%d", static_cast<int>(gen() % 580) - 300);
+        double value;
+        std::from_chars_result r =
+            std::from_chars(buf, buf + std::strlen(buf), value);
+        assert(r.ec == std::errc{});
+        assert(value == std::strtod(buf, nullptr));
+    }
+
+    for (int i = 0; i < 10000; ++i)
+    {
+        uint64_t bits = gen() >> 2;
+        double low;
+        std::memcpy(&low, &bits, sizeof(low));
+        long double mid = (static_cast<long double>(low) +
+                           std::nextafter(low, 2 * low)) / 2;
+        std::snprintf(buf, sizeof(buf), "%.40Le", mid);
+        double value;
+        std::from_chars(buf, buf + std::strlen(buf), value);
+        assert(value == std::strtod(buf, nullptr));
+    }
+}
+
+int main(int, char**)
+{
+    test("0", 0.0, 1);
+    test("-0", -0.0, 2);
+    test("1", 1.0, 1);
+    test("0.1", 0.1, 3);
+    test(".5", 0.5, 2);
+    test("5.", 5.0, 2);
+    test("-1.5e3", -1500.0, 6);
+    test("1E-2", 0.01, 4);
+    test("1e", 1.0, 1);
+    test("1e+", 1.0, 1);
+    test("1.5x", 1.5, 3);
+    test("0x10", 0.0, 1);
+    test("9007199254740993", 9007199254740992.0, 16);
+    test("9007199254740993.0000000000000001", 9007199254740994.0, 33);
+    test("1.7976931348623157e308", 1.7976931348623157e308, 22);
+    test("4.9406564584124654e-324", 5e-324, 23);
+    test("2.2250738585072011e-308", 2.2250738585072011e-308, 23);
+    test("123456789012345678901234567890", 123456789012345678901234567890.0,
+         30);
+    test("0.000000000000000000000000000001", 1e-30, 32);
+    test("inf", std::numeric_limits<double>::infinity(), 3);
+    test("-INFINITY", -std::numeric_limits<double>::infinity(), 9);
+    test("infinit", std::numeric_limits<double>::infinity(), 3);
+    test("nan", std::numeric_limits<double>::quiet_NaN(), 3);
+    test("nan(0x1)", std::numeric_limits<double>::quiet_NaN(), 8);
+    test("nan(", std::numeric_limits<double>::quiet_NaN(), 3);
+    test("0.1", 0.1f, 3);
+    test("3.4028235e38", 3.4028235e38f, 12);
+    test("1e-45", 1e-45f, 5);
+    test("0.1", 0.1L, 3);
+
+    test("1e5", 1.0, 1, std::chars_format::fixed);
+    test("1.25", 1.25, 4, std::chars_format::fixed);
+    test("1e5", 1e5, 3, std::chars_format::scientific);
+    test("1.8p1", 3.0, 5, std::chars_format::hex);
+    test("-1.999999999999ap-4", -0.1, 19, std::chars_format::hex);
+    test("ff", 255.0, 2, std::chars_format::hex);
+    test("1p", 1.0, 1, std::chars_format::hex);
+
+    test_error<double>("", std::errc::invalid_argument, 0);
+    test_error<double>("-", std::errc::invalid_argument, 0);
+    test_error<double>(".", std::errc::invalid_argument, 0);
+    test_error<double>("+1", std::errc::invalid_argument, 0);
+    test_error<double>(" 1", std::errc::invalid_argument, 0);
+    test_error<double>("e5", std::errc::invalid_argument, 0);
+    test_error<double>("15", std::errc::invalid_argument, 0,
+                       std::chars_format::scientific);
+    test_error<double>("1e400", std::errc::result_out_of_range, 5);
+    test_error<double>("1e-400", std::errc::result_out_of_range, 6);
+    test_error<float>("1e39", std::errc::result_out_of_range, 4);
+    test_error<float>("1e-50", std::errc::result_out_of_range, 5);
+
+    test_strtod();
+
+    return 0;
+}
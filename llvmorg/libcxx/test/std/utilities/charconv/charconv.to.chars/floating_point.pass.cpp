@@ -0,0 +1,185 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// UNSUPPORTED: c++03, c++11, c++14
+
+// to_chars requires functions in the dylib that were introduced in Mac OS 10.15.
+//
+// XFAIL: with_system_cxx_lib=macosx10.14
+// XFAIL: with_system_cxx_lib=macosx10.13
+// XFAIL: with_system_cxx_lib=macosx10.12
+// XFAIL: with_system_cxx_lib=macosx10.11
+// XFAIL: with_system_cxx_lib=macosx10.10
+// XFAIL: with_system_cxx_lib=macosx10.9
+
+// <charconv>
+
+// to_chars_result to_chars(char* first, char* last, float value);
+// to_chars_result to_chars(char* first, char* last, double value);
+// to_chars_result to_chars(char* first, char* last, long double value);
+// to_chars_result to_chars(char* first, char* last, Floating value,
+//                          chars_format fmt);
+// to_chars_result to_chars(char* first, char* last, Floating value,
+//                          chars_format fmt, int precision);
+
+#include <charconv>
+#include <cassert>
+#include <cmath>
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <string>
+
+#include "test_macros.h"
+
+template <class T>
+void test(T value, const char* expected)
+{
+    char buf[400];
+    std::to_chars_result r = std::to_chars(buf, buf + sizeof(buf), value);
+    assert(r.ec == std::errc{});
+    assert(std::string(buf, r.ptr) == expected);
+
+    // Too small a buffer.
+    r = std::to_chars(buf, buf + std::strlen(expected) - 1, value);
+    assert(r.ec == std::errc::value_too_large);
+    assert(r.ptr == buf + std::strlen(expected) - 1);
+}
+
+template <class T>
+void test(T value, std::chars_format fmt, const char* expected)
+{
+    char buf[400];
+    std::to_chars_result r = std::to_chars(buf, buf + sizeof(buf), value, fmt);
+    assert(r.ec == std::errc{});
+    assert(std::string(buf, r.ptr) == expected);
+
+    r = std::to_chars(buf, buf + std::strlen(expected) - 1, value, fmt);
+    assert(r.ec == std::errc::value_too_large);
+}
+
+template <class T>
+void test(T value, std::chars_format fmt, int precision, const char* expected)
+{
+    char buf[400];
+    std::to_chars_result r =
+        std::to_chars(buf, buf + sizeof(buf), value, fmt, precision);
+    assert(r.ec == std::errc{});
+    assert(std::string(buf, r.ptr) == expected);
+
+    r = std::to_chars(buf, buf + std::strlen(expected) - 1, value, fmt,
+                      precision);
+    assert(r.ec == std::errc::value_too_large);
+}
+
+// The shortest representation round-trips through from_chars.
+template <class T, class Bits>
+void test_roundtrip()
+{
+    std::mt19937_64 gen(42);
+    for (int i = 0; i < 10000; ++i)
+    {
+        Bits bits = static_cast<Bits>(gen());
+        T value;
+        std::memcpy(&value, &bits, sizeof(value));
+        if (!std::isfinite(value))
+            continue;
+        const std::chars_format formats[] = {
+            std::chars_format::scientific, std::chars_format::fixed,
+            std::chars_format::general, std::chars_format::hex};
+        for (std::chars_format fmt : formats)
+        {
+            char buf[400];
+            std::to_chars_result r =
+                std::to_chars(buf, buf + sizeof(buf), value, fmt);
+            assert(r.ec == std::errc{});
+            T back;
+            std::from_chars_result fr = std::from_chars(buf, r.ptr, back, fmt);
+            assert(fr.ec == std::errc{});
+            assert(fr.ptr == r.ptr);
+            assert(std::memcmp(&back, &value, sizeof(value)) == 0);
+        }
+    }
+}
+
+int main(int, char**)
+{
+    test(0.0, "0");
+    test(-0.0, "-0");
+    test(1.0, "1");
+    test(0.1, "0.1");
+    test(0.3, "0.3");
+    test(-1.5, "-1.5");
+    test(123456.0, "123456");
+    test(1e22, "1e+22");
+    test(1e-7, "1e-07");
+    test(0.001, "0.001");
+    test(1.7976931348623157e308, "1.7976931348623157e+308");
+    test(5e-324, "5e-324");
+    test(2.2250738585072014e-308, "2.2250738585072014e-308");
+    test(9007199254740993.0, "9007199254740992");
+    // Fixed notation prints integers exactly, not the shortest digits padded
+    // with zeros.
+    test(123456789012345680000.0, "123456789012345683968");
+    test(-123456789012345680000.0, "-123456789012345683968");
+    test(1e23, "1e+23");
+    test(std::numeric_limits<double>::infinity(), "inf");
+    test(-std::numeric_limits<double>::infinity(), "-inf");
+    test(std::numeric_limits<double>::quiet_NaN(), "nan");
+    test(0.1f, "0.1");
+    test(3.4028235e38f, "3.4028235e+38");
+    test(1e-45f, "1e-45");
+    test(16777216.0f, "16777216");
+    test(1.0L, "1");
+    test(0.5L, "0.5");
+
+    test(0.0, std::chars_format::scientific, "0e+00");
+    test(1234.5, std::chars_format::scientific, "1.2345e+03");
+    test(1e-300, std::chars_format::scientific, "1e-300");
+    test(1e22, std::chars_format::fixed, "10000000000000000000000");
+    test(1e23, std::chars_format::fixed, "99999999999999991611392");
+    test(-1e23, std::chars_format::fixed, "-99999999999999991611392");
+    test(1.7976931348623157e308, std::chars_format::fixed,
+         "17976931348623157081452742373170435679807056752584499659891747680315"
+         "72607800285387605895586327668781715404589535143824642343213268894641"
+         "82768467546703537516986049910576551282076245490090389328944075868508"
+         "45513394230458323690322294816580855933212334827479782620414472316873"
+         "8177180919299881250404026184124858368");
+    test(3.4028235e38f, std::chars_format::fixed,
+         "340282346638528859811704183484516925440");
+    test(1e-5, std::chars_format::fixed, "0.00001");
+    test(1234.5, std::chars_format::fixed, "1234.5");
+    test(123456.0, std::chars_format::general, "123456");
+    test(1234567.0, std::chars_format::general, "1.234567e+06");
+    test(0.0001, std::chars_format::general, "0.0001");
+    test(0.00001, std::chars_format::general, "1e-05");
+    test(1.0, std::chars_format::hex, "1p+0");
+    test(-3.0, std::chars_format::hex, "-1.8p+1");
+    test(0.1, std::chars_format::hex, "1.999999999999ap-4");
+    test(0.0, std::chars_format::hex, "0p+0");
+    test(5e-324, std::chars_format::hex, "0.0000000000001p-1022");
+    test(0.1f, std::chars_format::hex, "1.99999ap-4");
+    test(-std::numeric_limits<float>::infinity(), std::chars_format::fixed,
+         "-inf");
+
+    test(3.14159, std::chars_format::fixed, 3, "3.142");
+    test(3.14159, std::chars_format::scientific, 2, "3.14e+00");
+    test(3.14159, std::chars_format::general, 3, "3.14");
+    test(1e-10, std::chars_format::general, 2, "1e-10");
+    test(1.5, std::chars_format::hex, 3, "1.800p+0");
+    test(-1.0, std::chars_format::fixed, 0, "-1");
+    test(0.5f, std::chars_format::scientific, 1, "5.0e-01");
+    test(2.5L, std::chars_format::fixed, 2, "2.50");
+
+    test_roundtrip<double, uint64_t>();
+    test_roundtrip<float, uint32_t>();
+
+    return 0;
+}
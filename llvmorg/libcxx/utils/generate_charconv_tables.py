@@ -0,0 +1,123 @@
+#!/usr/bin/env python
+#===----------------------------------------------------------------------===##
+#
+# Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+#
+#===----------------------------------------------------------------------===##
+
+"""Generates src/include/charconv_tables.h.
+
+The floating-point to_chars and from_chars in src/charconv.cpp need 128-bit
+approximations of powers of five:
+
+  __pow5_split[i]      5^i, normalized to 125 bits (Ryu).
+  __pow5_inv_split[i]  2^k / 5^i + 1 with 125 significant bits (Ryu).
+  __pow5_128[q + 342]  5^q for q in [-342, 308], truncated to 128 bits with
+                       the top bit set (Eisel-Lemire).
+
+Usage: generate_charconv_tables.py > src/include/charconv_tables.h
+"""
+
+from __future__ import print_function
+
+POW5_BITCOUNT = 125
+POW5_INV_BITCOUNT = 125
+POW5_SPLIT_SIZE = 326
+POW5_INV_SPLIT_SIZE = 342
+POW5_128_MIN = -342
+POW5_128_MAX = 308
+
+MASK64 = (1 << 64) - 1
+
+
+def split(value, first_low):
+    assert 0 <= value < (1 << 128)
+    lo, hi = value & MASK64, value >> 64
+    pair = (lo, hi) if first_low else (hi, lo)
+    return '    {UINT64_C(%d), UINT64_C(%d)},' % pair
+
+
+def pow5_split():
+    for i in range(POW5_SPLIT_SIZE):
+        p = 5 ** i
+        shift = p.bit_length() - POW5_BITCOUNT
+        yield split(p >> shift if shift >= 0 else p << -shift, True)
+
+
+def pow5_inv_split():
+    for i in range(POW5_INV_SPLIT_SIZE):
+        p = 5 ** i
+        j = p.bit_length() - 1 + POW5_INV_BITCOUNT
+        yield split((1 << j) // p + 1, True)
+
+
+def pow5_128():
+    for q in range(POW5_128_MIN, POW5_128_MAX + 1):
+        if q >= 0:
+            p = 5 ** q
+            shift = p.bit_length() - 128
+            v = p >> shift if shift >= 0 else p << -shift
+        else:
+            p = 5 ** -q
+            v = (1 << (p.bit_length() + 127)) // p
+            if v >= (1 << 128):
+                v >>= 1
+        assert (1 << 127) <= v < (1 << 128)
+        yield split(v, False)
+
+
+def main():
+    print('''//===------------------------ charconv_tables.h ---------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// This file is generated by utils/generate_charconv_tables.py. Do not edit.
+
+#ifndef _LIBCPP_CHARCONV_TABLES_H
+#define _LIBCPP_CHARCONV_TABLES_H
+
+#include <__config>
+#include <stdint.h>
+
+_LIBCPP_BEGIN_NAMESPACE_STD
+
+namespace __charconv
+{
+''')
+    print('static const int __pow5_bitcount = %d;' % POW5_BITCOUNT)
+    print('static const int __pow5_inv_bitcount = %d;' % POW5_INV_BITCOUNT)
+    print('static const int __pow5_128_min = %d;' % POW5_128_MIN)
+    print('static const int __pow5_128_max = %d;' % POW5_128_MAX)
+    print()
+    print('// {low, high}')
+    print('static const uint64_t __pow5_split[%d][2] = {' % POW5_SPLIT_SIZE)
+    print('\n'.join(pow5_split()))
+    print('};')
+    print()
+    print('// {low, high}')
+    print('static const uint64_t __pow5_inv_split[%d][2] = {' %
+          POW5_INV_SPLIT_SIZE)
+    print('\n'.join(pow5_inv_split()))
+    print('};')
+    print()
+    print('// {high, low}')
+    print('static const uint64_t __pow5_128[%d][2] = {' %
+          (POW5_128_MAX - POW5_128_MIN + 1))
+    print('\n'.join(pow5_128()))
+    print('};')
+    print('''
+}  // namespace __charconv
+
+_LIBCPP_END_NAMESPACE_STD
+
+#endif  // _LIBCPP_CHARCONV_TABLES_H''')
+
+
+if __name__ == '__main__':
+    main()
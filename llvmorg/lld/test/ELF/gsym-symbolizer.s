@@ -0,0 +1,211 @@
+# REQUIRES: x86
+## Check that llvm-symbolizer creates a GSYM file for an object with a build ID,
+## answers from it in later runs, inline frames included, and falls back to the
+## DWARF when the GSYM file found for a build ID was created for another one.
+## GSYM line entries carry no column, which tells the two sources apart.
+
+# RUN: llvm-mc -filetype=obj -triple=x86_64 %s -o %t.o
+# RUN: ld.lld %t.o -o %t --build-id=0x0123456789abcdef -e foo -Ttext=0x201000
+# RUN: rm -rf %t.gsym
+
+# RUN: llvm-symbolizer --obj=%t --gsym-directory=%t.gsym --create-gsym \
+# RUN:   0x201000 0x201006 | FileCheck --check-prefix=GSYM %s
+# RUN: ls %t.gsym/01/23456789abcdef.gsym
+
+## Without the DWARF, the answers can only come from the GSYM file.
+# RUN: llvm-objcopy --strip-debug %t %t.stripped
+# RUN: llvm-symbolizer --obj=%t.stripped --gsym-directory=%t.gsym \
+# RUN:   0x201000 0x201006 | FileCheck --check-prefix=GSYM %s
+
+# GSYM:      bar
+# GSYM-NEXT: /tmp/gsym.c:2:0
+# GSYM-NEXT: foo
+# GSYM-NEXT: /tmp/gsym.c:6:0
+# GSYM-EMPTY:
+# GSYM-NEXT: foo
+# GSYM-NEXT: /tmp/gsym.c:7:0
+
+## Give the GSYM file created above the name of another build ID: it is not
+## used, and it isn't replaced either.
+# RUN: ld.lld %t.o -o %t.other --build-id=0xfedcba9876543210 -e foo \
+# RUN:   -Ttext=0x201000
+# RUN: mkdir -p %t.gsym/fe
+# RUN: cp %t.gsym/01/23456789abcdef.gsym %t.gsym/fe/dcba9876543210.gsym
+# RUN: llvm-symbolizer --obj=%t.other --gsym-directory=%t.gsym --create-gsym \
+# RUN:   0x201000 0x201006 | FileCheck --check-prefix=DWARF %s
+# RUN: cmp %t.gsym/01/23456789abcdef.gsym %t.gsym/fe/dcba9876543210.gsym
+
+# DWARF:      bar
+# DWARF-NEXT: /tmp/gsym.c:2:3
+# DWARF-NEXT: foo
+# DWARF-NEXT: /tmp/gsym.c:6:3
+# DWARF-EMPTY:
+# DWARF-NEXT: foo
+# DWARF-NEXT: /tmp/gsym.c:7:3
+
+## Generated from:
+## static void bar(int x) {
+##   g = x;
+## }
+##
+## void foo(int x) {
+##   bar(x);
+##   g = 1;
+## }
+## where g is a volatile int declared in a header.
+
+	.text
+	.globl	foo
+	.p2align	4, 0x90
+	.type	foo,@function
+foo:
+.Lfunc_begin0:
+	.file	1 "/tmp/gsym.c"
+	.loc	1 5 0
+	.cfi_startproc
+	.loc	1 2 3 prologue_end
+	movl	%edi, g(%rip)
+.Ltmp0:
+	.loc	1 7 3
+	movl	$1, g(%rip)
+	.loc	1 8 1
+	retq
+.Ltmp1:
+.Lfunc_end0:
+	.size	foo, .Lfunc_end0-foo
+	.cfi_endproc
+
+	.type	g,@object
+	.bss
+	.globl	g
+	.p2align	2
+g:
+	.long	0
+	.size	g, 4
+
+	.section	.debug_abbrev,"",@progbits
+	.byte	1
+	.byte	17
+	.byte	1
+	.byte	37
+	.byte	14
+	.byte	19
+	.byte	5
+	.byte	3
+	.byte	14
+	.byte	16
+	.byte	23
+	.byte	27
+	.byte	14
+	.ascii	"\264B"
+	.byte	25
+	.byte	17
+	.byte	1
+	.byte	18
+	.byte	6
+	.byte	0
+	.byte	0
+	.byte	2
+	.byte	46
+	.byte	0
+	.byte	3
+	.byte	14
+	.byte	58
+	.byte	11
+	.byte	59
+	.byte	11
+	.byte	32
+	.byte	11
+	.byte	0
+	.byte	0
+	.byte	3
+	.byte	46
+	.byte	1
+	.byte	17
+	.byte	1
+	.byte	18
+	.byte	6
+	.byte	64
+	.byte	24
+	.byte	3
+	.byte	14
+	.byte	58
+	.byte	11
+	.byte	59
+	.byte	11
+	.byte	63
+	.byte	25
+	.byte	0
+	.byte	0
+	.byte	4
+	.byte	29
+	.byte	0
+	.byte	49
+	.byte	19
+	.byte	17
+	.byte	1
+	.byte	18
+	.byte	6
+	.byte	88
+	.byte	11
+	.byte	89
+	.byte	11
+	.byte	87
+	.byte	11
+	.byte	0
+	.byte	0
+	.byte	0
+	.section	.debug_info,"",@progbits
+.Lcu_begin0:
+	.long	.Ldebug_info_end0-.Ldebug_info_start0
+.Ldebug_info_start0:
+	.short	4
+	.long	.debug_abbrev
+	.byte	8
+	.byte	1
+	.long	.Linfo_string0
+	.short	12
+	.long	.Linfo_string1
+	.long	.Lline_table_start0
+	.long	.Linfo_string2
+
+	.quad	.Lfunc_begin0
+	.long	.Lfunc_end0-.Lfunc_begin0
+	.byte	2
+	.long	.Linfo_string3
+	.byte	1
+	.byte	1
+	.byte	1
+	.byte	3
+	.quad	.Lfunc_begin0
+	.long	.Lfunc_end0-.Lfunc_begin0
+	.byte	1
+	.byte	87
+	.long	.Linfo_string4
+	.byte	1
+	.byte	5
+
+	.byte	4
+	.long	42
+	.quad	.Lfunc_begin0
+	.long	.Ltmp0-.Lfunc_begin0
+	.byte	1
+	.byte	6
+	.byte	3
+	.byte	0
+	.byte	0
+.Ldebug_info_end0:
+	.section	.debug_str,"MS",@progbits,1
+.Linfo_string0:
+	.asciz	"hand written"
+.Linfo_string1:
+	.asciz	"gsym.c"
+.Linfo_string2:
+	.asciz	"/tmp"
+.Linfo_string3:
+	.asciz	"bar"
+.Linfo_string4:
+	.asciz	"foo"
+	.section	".note.GNU-stack","",@progbits
+	.section	.debug_line,"",@progbits
+.Lline_table_start0:
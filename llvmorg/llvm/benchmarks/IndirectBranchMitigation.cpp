@@ -0,0 +1,104 @@
+#include "InterpreterBenchmark.h"
+#include "benchmark/benchmark.h"
+#include <vector>
+
+using namespace llvm;
+
+// Measures the cost of the dispatch of an interpreter of barebone handlers,
+// which tail call the handler of the next opcode through the dispatch table,
+// with no mitigation, with retpolines, and with the
+// "indirect-branch-mitigation"="lfence" alternative.
+
+static const char *DispatchIR = R"(
+@handlers = constant [5 x i8*] [
+  i8* bitcast (void (i8**, i8*, i64)* @inc to i8*),
+  i8* bitcast (void (i8**, i8*, i64)* @dbl to i8*),
+  i8* bitcast (void (i8**, i8*, i64)* @neg to i8*),
+  i8* bitcast (void (i8**, i8*, i64)* @xor to i8*),
+  i8* bitcast (void (i8**, i8*, i64)* @barebone_return to i8*)
+]
+
+declare barebonecc void @barebone_return(i8**, i8*, i64)
+
+define internal barebonecc void @inc(i8** %table, i8* %pc, i64 %acc) #0 {
+  %acc.next = add i64 %acc, 1
+  %pc.next = getelementptr i8, i8* %pc, i64 1
+  %op = load i8, i8* %pc.next
+  %idx = zext i8 %op to i64
+  %slot = getelementptr i8*, i8** %table, i64 %idx
+  %raw = load i8*, i8** %slot
+  %handler = bitcast i8* %raw to void (i8**, i8*, i64)*
+  musttail call barebonecc void %handler(i8** %table, i8* %pc.next,
+                                         i64 %acc.next) #1
+  ret void
+}
+
+define internal barebonecc void @dbl(i8** %table, i8* %pc, i64 %acc) #0 {
+  %acc.next = shl i64 %acc, 1
+  %pc.next = getelementptr i8, i8* %pc, i64 1
+  %op = load i8, i8* %pc.next
+  %idx = zext i8 %op to i64
+  %slot = getelementptr i8*, i8** %table, i64 %idx
+  %raw = load i8*, i8** %slot
+  %handler = bitcast i8* %raw to void (i8**, i8*, i64)*
+  musttail call barebonecc void %handler(i8** %table, i8* %pc.next,
+                                         i64 %acc.next) #1
+  ret void
+}
+
+define internal barebonecc void @neg(i8** %table, i8* %pc, i64 %acc) #0 {
+  %acc.next = sub i64 0, %acc
+  %pc.next = getelementptr i8, i8* %pc, i64 1
+  %op = load i8, i8* %pc.next
+  %idx = zext i8 %op to i64
+  %slot = getelementptr i8*, i8** %table, i64 %idx
+  %raw = load i8*, i8** %slot
+  %handler = bitcast i8* %raw to void (i8**, i8*, i64)*
+  musttail call barebonecc void %handler(i8** %table, i8* %pc.next,
+                                         i64 %acc.next) #1
+  ret void
+}
+
+define internal barebonecc void @xor(i8** %table, i8* %pc, i64 %acc) #0 {
+  %acc.next = xor i64 %acc, 1431655765
+  %pc.next = getelementptr i8, i8* %pc, i64 1
+  %op = load i8, i8* %pc.next
+  %idx = zext i8 %op to i64
+  %slot = getelementptr i8*, i8** %table, i64 %idx
+  %raw = load i8*, i8** %slot
+  %handler = bitcast i8* %raw to void (i8**, i8*, i64)*
+  musttail call barebonecc void %handler(i8** %table, i8* %pc.next,
+                                         i64 %acc.next) #1
+  ret void
+}
+
+attributes #0 = { nounwind "frame-pointer"="none" "hwreg"="r15,rbx,rax" ATTRS }
+attributes #1 = { "hwreg"="r15,rbx,rax" }
+)";
+
+static void BM_Dispatch(benchmark::State &State, const char *Attrs) {
+  if (!canRunBarebone()) {
+    State.SkipWithError("barebone handlers cannot run on this host");
+    return;
+  }
+  InterpreterJIT J(DispatchIR, Attrs);
+  const void *Handlers = J.lookupData("handlers");
+  std::vector<unsigned char> Code = getRandomProgram(State.range(0), 4);
+  for (auto _ : State)
+    benchmark::DoNotOptimize(runBarebone(Handlers, Code.data(), 1));
+  State.SetItemsProcessed(State.iterations() * State.range(0));
+}
+
+// The thunk is the one of InterpreterJIT: the JIT cannot link those that the
+// code generator emits.
+#define RETPOLINE                                                              \
+  "\"target-features\"=\"+retpoline-indirect-calls,"                          \
+  "+retpoline-indirect-branches,+retpoline-external-thunk\""
+
+BENCHMARK_CAPTURE(BM_Dispatch, unmitigated, "")->Arg(1 << 16);
+BENCHMARK_CAPTURE(BM_Dispatch, retpoline, RETPOLINE)->Arg(1 << 16);
+BENCHMARK_CAPTURE(BM_Dispatch, lfence,
+                  RETPOLINE " \"indirect-branch-mitigation\"=\"lfence\"")
+    ->Arg(1 << 16);
+
+BENCHMARK_MAIN();
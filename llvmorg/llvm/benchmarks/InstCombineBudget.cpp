@@ -0,0 +1,93 @@
+#include "benchmark/benchmark.h"
+#include "llvm/AsmParser/Parser.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/LegacyPassManager.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/SourceMgr.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Transforms/InstCombine/InstCombine.h"
+#include <random>
+#include <string>
+
+using namespace llvm;
+
+// Measures the compile time of instcombine run to a fixpoint, with a visit
+// budget of 4 visits per instruction, and in the one-shot mode meant for JIT
+// pipelines, on a module of generated functions mixing arithmetic chains,
+// compares and selects.
+
+static std::string getModuleIR(unsigned NumFunctions, unsigned NumInsts) {
+  std::mt19937 Gen(42);
+  std::uniform_int_distribution<int> Kind(0, 5);
+  std::uniform_int_distribution<int> Imm(1, 16);
+  std::string IR;
+  raw_string_ostream OS(IR);
+  for (unsigned F = 0; F < NumFunctions; ++F) {
+    OS << "define i32 @f" << F << "(i32 %v0, i32 %a) {\n";
+    for (unsigned I = 1; I <= NumInsts; ++I) {
+      unsigned Prev = I - 1;
+      switch (Kind(Gen)) {
+      case 0:
+        OS << "  %v" << I << " = add i32 %v" << Prev << ", " << Imm(Gen)
+           << "\n";
+        break;
+      case 1:
+        OS << "  %v" << I << " = sub i32 %v" << Prev << ", %a\n";
+        break;
+      case 2:
+        OS << "  %v" << I << " = shl i32 %v" << Prev << ", " << Imm(Gen) % 4
+           << "\n";
+        break;
+      case 3:
+        OS << "  %v" << I << " = xor i32 %v" << Prev << ", -1\n";
+        break;
+      case 4:
+        OS << "  %c" << I << " = icmp eq i32 %v" << Prev << ", 0\n"
+           << "  %v" << I << " = select i1 %c" << I << ", i32 %a, i32 %v"
+           << Prev << "\n";
+        break;
+      default:
+        OS << "  %t" << I << " = and i32 %v" << Prev << ", " << Imm(Gen)
+           << "\n"
+           << "  %v" << I << " = or i32 %t" << I << ", %v" << Prev << "\n";
+        break;
+      }
+    }
+    OS << "  ret i32 %v" << NumInsts << "\n}\n\n";
+  }
+  return OS.str();
+}
+
+static void BM_InstCombine(benchmark::State &State, unsigned MaxIterations,
+                           unsigned MaxVisitsPerInst) {
+  std::string IR = getModuleIR(64, State.range(0));
+  for (auto _ : State) {
+    State.PauseTiming();
+    LLVMContext Ctx;
+    SMDiagnostic Err;
+    std::unique_ptr<Module> M = parseAssemblyString(IR, Err, Ctx);
+    if (!M) {
+      Err.print("InstCombineBudget", errs());
+      exit(1);
+    }
+    legacy::FunctionPassManager FPM(M.get());
+    FPM.add(createInstructionCombiningPass(MaxIterations, MaxVisitsPerInst));
+    FPM.doInitialization();
+    State.ResumeTiming();
+
+    for (Function &F : *M)
+      FPM.run(F);
+
+    State.PauseTiming();
+    FPM.doFinalization();
+    M.reset();
+    State.ResumeTiming();
+  }
+  State.SetItemsProcessed(State.iterations() * 64 * State.range(0));
+}
+
+BENCHMARK_CAPTURE(BM_InstCombine, fixpoint, 1000, 0)->Arg(256)->Arg(2048);
+BENCHMARK_CAPTURE(BM_InstCombine, budget4, 1000, 4)->Arg(256)->Arg(2048);
+BENCHMARK_CAPTURE(BM_InstCombine, oneshot, 1, 1)->Arg(256)->Arg(2048);
+
+BENCHMARK_MAIN();
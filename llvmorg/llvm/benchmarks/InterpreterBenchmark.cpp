@@ -0,0 +1,128 @@
+//===- InterpreterBenchmark.cpp -------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "InterpreterBenchmark.h"
+#include "llvm/ExecutionEngine/Orc/LLJIT.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IRReader/IRReader.h"
+#include "llvm/Support/SourceMgr.h"
+#include "llvm/Support/TargetSelect.h"
+#include <random>
+#include <string>
+
+using namespace llvm;
+using namespace llvm::orc;
+
+static ExitOnError ExitOnErr;
+
+#if defined(__x86_64__) && defined(__ELF__)
+// The barebone handlers preserve no registers, so the entry saves all the
+// callee-saved ones. The handlers do not move the stack pointer either, so the
+// return address pushed by the call to the first handler is still on top of
+// the stack when the last one jumps to barebone_return. The JIT cannot link the
+// retpoline thunks that the code generator adds to the module, so the
+// retpoline runs use the external thunk defined here.
+asm(".text\n"
+    ".p2align 4\n"
+    "llvm_enter_barebone:\n"
+    "  pushq %rbp\n"
+    "  pushq %rbx\n"
+    "  pushq %r12\n"
+    "  pushq %r13\n"
+    "  pushq %r14\n"
+    "  pushq %r15\n"
+    "  movq %rdi, %r15\n"
+    "  movq %rsi, %rbx\n"
+    "  movq %rdx, %rax\n"
+    "  movzbl (%rbx), %ecx\n"
+    "  callq *(%r15,%rcx,8)\n"
+    "  popq %r15\n"
+    "  popq %r14\n"
+    "  popq %r13\n"
+    "  popq %r12\n"
+    "  popq %rbx\n"
+    "  popq %rbp\n"
+    "  retq\n"
+    ".p2align 4\n"
+    "llvm_barebone_return:\n"
+    "  retq\n"
+    ".p2align 4\n"
+    "llvm_retpoline_r11:\n"
+    "  callq 1f\n"
+    "0:\n"
+    "  pause\n"
+    "  lfence\n"
+    "  jmp 0b\n"
+    "1:\n"
+    "  movq %r11, (%rsp)\n"
+    "  retq\n");
+
+extern "C" uint64_t llvm_enter_barebone(const void *, const unsigned char *,
+                                        uint64_t);
+extern "C" void llvm_barebone_return();
+extern "C" void llvm_retpoline_r11();
+
+bool llvm::canRunBarebone() { return true; }
+
+uint64_t llvm::runBarebone(const void *Table, const unsigned char *Code,
+                           uint64_t Acc) {
+  return llvm_enter_barebone(Table, Code, Acc);
+}
+#else
+bool llvm::canRunBarebone() { return false; }
+
+uint64_t llvm::runBarebone(const void *, const unsigned char *, uint64_t) {
+  report_fatal_error("barebone handlers can only run on x86-64 ELF hosts");
+}
+#endif
+
+InterpreterJIT::InterpreterJIT(StringRef IR, StringRef Attrs) {
+  InitializeNativeTarget();
+  InitializeNativeTargetAsmPrinter();
+  J = ExitOnErr(LLJITBuilder().create());
+
+  std::string Source = IR.str();
+  size_t Pos = Source.find("ATTRS");
+  if (Pos != std::string::npos)
+    Source.replace(Pos, 5, Attrs.str());
+
+  auto Ctx = std::make_unique<LLVMContext>();
+  SMDiagnostic Err;
+  std::unique_ptr<Module> M =
+      parseIR(MemoryBufferRef(Source, "interp"), Err, *Ctx);
+  if (!M) {
+    Err.print("InterpreterJIT", errs());
+    exit(1);
+  }
+  ExitOnErr(J->addIRModule(ThreadSafeModule(std::move(M), std::move(Ctx))));
+
+#if defined(__x86_64__) && defined(__ELF__)
+  ExitOnErr(J->getMainJITDylib().define(absoluteSymbols(
+      {{J->mangleAndIntern("barebone_return"),
+        JITEvaluatedSymbol::fromPointer(&llvm_barebone_return)},
+       {J->mangleAndIntern("__x86_indirect_thunk_r11"),
+        JITEvaluatedSymbol::fromPointer(&llvm_retpoline_r11)}})));
+#endif
+}
+
+InterpreterJIT::~InterpreterJIT() = default;
+
+JITTargetAddress InterpreterJIT::getAddress(StringRef Name) {
+  return ExitOnErr(J->lookup(Name)).getAddress();
+}
+
+std::vector<unsigned char> llvm::getRandomProgram(size_t N, unsigned NumOps) {
+  std::mt19937 Gen(42);
+  std::uniform_int_distribution<unsigned> Op(0, NumOps - 1);
+  std::vector<unsigned char> Code;
+  Code.reserve(N + 1);
+  for (size_t I = 0; I < N; ++I)
+    Code.push_back(Op(Gen));
+  Code.push_back(NumOps);
+  return Code;
+}
@@ -0,0 +1,66 @@
+//===-- InterpreterBenchmark.h ----------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+// Helpers for the benchmarks that JIT-compile a small bytecode interpreter and
+// run a random program with it.
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_BENCHMARKS_INTERPRETERBENCHMARK_H
+#define LLVM_BENCHMARKS_INTERPRETERBENCHMARK_H
+
+#include "llvm/ADT/StringRef.h"
+#include "llvm/ExecutionEngine/JITSymbol.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace llvm {
+namespace orc {
+class LLJIT;
+} // end namespace orc
+
+/// A JIT for the host holding one interpreter module. Errors are fatal.
+class InterpreterJIT {
+public:
+  /// Compiles \p IR, with its first "ATTRS", if any, replaced by \p Attrs.
+  InterpreterJIT(StringRef IR, StringRef Attrs = "");
+  ~InterpreterJIT();
+
+  template <typename FnT> FnT lookup(StringRef Name) {
+    return jitTargetAddressToFunction<FnT>(getAddress(Name));
+  }
+
+  const void *lookupData(StringRef Name) {
+    return jitTargetAddressToPointer<const void *>(getAddress(Name));
+  }
+
+private:
+  JITTargetAddress getAddress(StringRef Name);
+
+  std::unique_ptr<orc::LLJIT> J;
+};
+
+/// Returns true if the host can run barebone handlers with runBarebone.
+bool canRunBarebone();
+
+/// Runs an interpreter of barebone handlers that take the dispatch table in
+/// r15, the program counter in rbx and the accumulator in rax, that is with
+/// "hwreg"="r15,rbx,rax", and returns the accumulator. Each handler tail calls
+/// the handler of the next opcode through \p Table; the interpreter stops at
+/// the opcode whose handler is @barebone_return, which InterpreterJIT defines.
+/// InterpreterJIT also defines the retpoline thunk that handlers compiled with
+/// +retpoline-external-thunk call, __x86_indirect_thunk_r11.
+uint64_t runBarebone(const void *Table, const unsigned char *Code,
+                     uint64_t Acc);
+
+/// Returns N random opcodes in [0, NumOps), followed by the opcode NumOps,
+/// which the interpreters use to halt. The program is the same on every run.
+std::vector<unsigned char> getRandomProgram(size_t N, unsigned NumOps);
+
+} // end namespace llvm
+
+#endif
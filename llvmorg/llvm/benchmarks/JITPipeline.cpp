@@ -0,0 +1,270 @@
+#include "benchmark/benchmark.h"
+#include "llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/LegacyPassManager.h"
+#include "llvm/IR/Module.h"
+#include "llvm/IRReader/IRReader.h"
+#include "llvm/Object/ObjectFile.h"
+#include "llvm/Passes/PassBuilder.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/SourceMgr.h"
+#include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Target/TargetMachine.h"
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace llvm;
+using namespace llvm::orc;
+
+// Measures the latency of compiling modules to objects, with the pipelines of
+// the JIT tiers, with and without a time budget, and with default<O2> as the
+// ahead-of-time reference.
+//
+// Each repetition compiles one module of the corpus, so the p50, p90, p99 and
+// max statistics are the latency percentiles over the corpus; run with
+// --benchmark_repetitions set to a multiple of the corpus size. The text_bytes
+// and ir_insts counters, the text size of the object and the number of IR
+// instructions after the pipeline, are only proxies of the quality of the
+// code: the code is not run. The budgets are in wall-clock time, so the
+// budgeted runs are only comparable between optimized builds of LLVM; in
+// others most functions run out of budget. The corpus is the .ll and .bc files
+// given on the command line, or by default a generated set of
+// interpreter-like functions of very different sizes:
+//
+//   JITPipeline --benchmark_repetitions=400 interp/*.bc
+
+static std::vector<std::unique_ptr<MemoryBuffer>> Corpus;
+
+// Returns a module of a loop over NumOps operations, the i-th operation
+// selecting one of a few helpers with the i-th bytecode.
+static std::string getModuleIR(unsigned NumOps, std::mt19937 &Gen) {
+  std::uniform_int_distribution<int> Imm(1, 64);
+  std::string IR;
+  raw_string_ostream OS(IR);
+  OS << "define internal i64 @add(i64 %a, i64 %b) {\n"
+        "  %s = alloca i64\n"
+        "  %r = add i64 %a, %b\n"
+        "  store i64 %r, i64* %s\n"
+        "  %v = load i64, i64* %s\n"
+        "  ret i64 %v\n"
+        "}\n\n"
+        "define internal i64 @mix(i64 %a, i64 %b) {\n"
+        "  %x = xor i64 %a, %b\n"
+        "  %m = mul i64 %x, -7046029254386353131\n"
+        "  %r = lshr i64 %m, 29\n"
+        "  ret i64 %r\n"
+        "}\n\n"
+        "define i64 @run(i8* %code, i64* %regs, i64 %n) {\n"
+        "entry:\n"
+        "  %acc.addr = alloca i64\n"
+        "  store i64 0, i64* %acc.addr\n"
+        "  br label %loop\n"
+        "loop:\n"
+        "  %i = phi i64 [ 0, %entry ], [ %i.next, %latch ]\n"
+        "  %base = mul i64 %i, "
+     << NumOps << "\n  br label %op0\n";
+  for (unsigned Op = 0; Op < NumOps; ++Op) {
+    OS << "op" << Op << ":\n"
+       << "  %pc" << Op << " = add i64 %base, " << Op << "\n"
+       << "  %p" << Op << " = getelementptr i8, i8* %code, i64 %pc" << Op
+       << "\n"
+       << "  %b" << Op << " = load i8, i8* %p" << Op << "\n"
+       << "  %r" << Op << " = getelementptr i64, i64* %regs, i64 "
+       << Imm(Gen) % 16 << "\n"
+       << "  %x" << Op << " = load i64, i64* %r" << Op << "\n"
+       << "  %acc" << Op << " = load i64, i64* %acc.addr\n"
+       << "  %c" << Op << " = icmp ult i8 %b" << Op << ", " << Imm(Gen) << "\n"
+       << "  br i1 %c" << Op << ", label %add" << Op << ", label %mix" << Op
+       << "\n"
+       << "add" << Op << ":\n"
+       << "  %ya" << Op << " = call i64 @add(i64 %acc" << Op << ", i64 %x"
+       << Op << ")\n"
+       << "  br label %join" << Op << "\n"
+       << "mix" << Op << ":\n"
+       << "  %ym" << Op << " = call i64 @mix(i64 %acc" << Op << ", i64 %x"
+       << Op << ")\n"
+       << "  br label %join" << Op << "\n"
+       << "join" << Op << ":\n"
+       << "  %y" << Op << " = phi i64 [ %ya" << Op << ", %add" << Op
+       << " ], [ %ym" << Op << ", %mix" << Op << " ]\n"
+       << "  store i64 %y" << Op << ", i64* %acc.addr\n"
+       << "  br label %" << (Op + 1 == NumOps ? std::string("latch")
+                                               : "op" + std::to_string(Op + 1))
+       << "\n";
+  }
+  OS << "latch:\n"
+        "  %i.next = add i64 %i, 1\n"
+        "  %done = icmp eq i64 %i.next, %n\n"
+        "  br i1 %done, label %exit, label %loop\n"
+        "exit:\n"
+        "  %res = load i64, i64* %acc.addr\n"
+        "  ret i64 %res\n"
+        "}\n";
+  return OS.str();
+}
+
+// Sizes spread over three orders of magnitude, most of them small, as in the
+// traces of a JIT, so that the tail latency comes from the few large ones.
+static void generateCorpus() {
+  std::mt19937 Gen(42);
+  std::lognormal_distribution<double> Size(3.0, 1.2);
+  for (unsigned I = 0; I < 100; ++I) {
+    unsigned NumOps = std::min(2000u, 1 + static_cast<unsigned>(Size(Gen)));
+    Corpus.push_back(MemoryBuffer::getMemBufferCopy(
+        getModuleIR(NumOps, Gen), "gen" + std::to_string(I)));
+  }
+}
+
+static double percentile(const std::vector<double> &V, double P) {
+  std::vector<double> Sorted(V);
+  std::sort(Sorted.begin(), Sorted.end());
+  size_t Index = static_cast<size_t>(P * (Sorted.size() - 1) + 0.5);
+  return Sorted.empty() ? 0 : Sorted[Index];
+}
+
+static uint64_t getTextSize(StringRef Object) {
+  auto ObjOrErr = object::ObjectFile::createObjectFile(
+      MemoryBufferRef(Object, "jit-pipeline"));
+  if (!ObjOrErr) {
+    consumeError(ObjOrErr.takeError());
+    return 0;
+  }
+  uint64_t Size = 0;
+  for (const object::SectionRef &Section : (*ObjOrErr)->sections())
+    if (Section.isText())
+      Size += Section.getSize();
+  return Size;
+}
+
+static void BM_Compile(benchmark::State &State,
+                       std::function<ModulePassManager(PassBuilder &)> Build,
+                       unsigned Budget, CodeGenOpt::Level CGLevel,
+                       std::shared_ptr<size_t> NextModule) {
+  // Each repetition moves on to the next module of the corpus, so that every
+  // benchmark compiles the modules in the same order.
+  MemoryBufferRef Buffer =
+      Corpus[(*NextModule)++ % Corpus.size()]->getMemBufferRef();
+
+  auto JTMB = cantFail(JITTargetMachineBuilder::detectHost());
+  JTMB.setCodeGenOptLevel(CGLevel);
+  std::unique_ptr<TargetMachine> TM = cantFail(JTMB.createTargetMachine());
+
+  uint64_t TextBytes = 0, IRInsts = 0;
+  for (auto _ : State) {
+    LLVMContext Ctx;
+    SMDiagnostic Err;
+    std::unique_ptr<Module> M = parseIR(Buffer, Err, Ctx);
+    if (!M) {
+      Err.print("JITPipeline", errs());
+      exit(1);
+    }
+    M->setDataLayout(TM->createDataLayout());
+    M->setTargetTriple(TM->getTargetTriple().str());
+
+    auto Start = std::chrono::steady_clock::now();
+
+    PipelineTuningOptions PTO;
+    PTO.JITFunctionBudget = Budget;
+    PassBuilder PB(TM.get(), PTO);
+    LoopAnalysisManager LAM;
+    FunctionAnalysisManager FAM;
+    CGSCCAnalysisManager CGAM;
+    ModuleAnalysisManager MAM;
+    FAM.registerPass([&] { return PB.buildDefaultAAPipeline(); });
+    PB.registerModuleAnalyses(MAM);
+    PB.registerCGSCCAnalyses(CGAM);
+    PB.registerFunctionAnalyses(FAM);
+    PB.registerLoopAnalyses(LAM);
+    PB.crossRegisterProxies(LAM, FAM, CGAM, MAM);
+    Build(PB).run(*M, MAM);
+
+    IRInsts = M->getInstructionCount();
+    SmallString<0> Object;
+    raw_svector_ostream OS(Object);
+    legacy::PassManager CodeGen;
+    if (TM->addPassesToEmitFile(CodeGen, OS, nullptr, CGFT_ObjectFile)) {
+      errs() << "JITPipeline: target cannot emit objects\n";
+      exit(1);
+    }
+    CodeGen.run(*M);
+
+    State.SetIterationTime(std::chrono::duration<double>(
+                               std::chrono::steady_clock::now() - Start)
+                               .count());
+    TextBytes = getTextSize(Object);
+  }
+  State.counters["text_bytes"] = TextBytes;
+  State.counters["ir_insts"] = IRInsts;
+}
+
+static void registerBenchmark(const char *Name,
+                              std::function<ModulePassManager(PassBuilder &)>
+                                  Build,
+                              unsigned Budget, CodeGenOpt::Level CGLevel) {
+  benchmark::RegisterBenchmark(Name, BM_Compile, Build, Budget, CGLevel,
+                              std::make_shared<size_t>(0))
+      ->Iterations(1)
+      ->UseManualTime()
+      ->Unit(benchmark::kMicrosecond)
+      ->ComputeStatistics("p50",
+                          [](const std::vector<double> &V) {
+                            return percentile(V, 0.5);
+                          })
+      ->ComputeStatistics("p90",
+                          [](const std::vector<double> &V) {
+                            return percentile(V, 0.9);
+                          })
+      ->ComputeStatistics("p99",
+                          [](const std::vector<double> &V) {
+                            return percentile(V, 0.99);
+                          })
+      ->ComputeStatistics("max", [](const std::vector<double> &V) {
+        return percentile(V, 1.0);
+      });
+}
+
+int main(int argc, char **argv) {
+  InitializeNativeTarget();
+  InitializeNativeTargetAsmPrinter();
+
+  // The arguments left by the benchmark library are the corpus.
+  benchmark::Initialize(&argc, argv);
+  for (int I = 1; I < argc; ++I) {
+    auto BufferOrErr = MemoryBuffer::getFile(argv[I]);
+    if (!BufferOrErr) {
+      errs() << "JITPipeline: cannot read " << argv[I] << ": "
+             << BufferOrErr.getError().message() << "\n";
+      return 1;
+    }
+    Corpus.push_back(std::move(*BufferOrErr));
+  }
+  if (Corpus.empty())
+    generateCorpus();
+
+  using JITTier = PassBuilder::JITTier;
+  auto JIT = [](JITTier Tier) {
+    return [Tier](PassBuilder &PB) { return PB.buildJITPipeline(Tier); };
+  };
+  registerBenchmark("baseline", JIT(JITTier::Baseline), 0, CodeGenOpt::None);
+  registerBenchmark("optimizing", JIT(JITTier::Optimizing), 0,
+                    CodeGenOpt::Less);
+  registerBenchmark("optimizing/budget1ms", JIT(JITTier::Optimizing), 1000,
+                    CodeGenOpt::Less);
+  registerBenchmark("peak", JIT(JITTier::Peak), 0, CodeGenOpt::Default);
+  registerBenchmark("peak/budget5ms", JIT(JITTier::Peak), 5000,
+                    CodeGenOpt::Default);
+  registerBenchmark(
+      "default<O2>",
+      [](PassBuilder &PB) {
+        return PB.buildPerModuleDefaultPipeline(
+            PassBuilder::OptimizationLevel::O2);
+      },
+      0, CodeGenOpt::Default);
+
+  benchmark::RunSpecifiedBenchmarks();
+}
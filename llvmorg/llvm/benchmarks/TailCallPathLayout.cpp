@@ -0,0 +1,213 @@
+#include "InterpreterBenchmark.h"
+#include "benchmark/benchmark.h"
+#include "llvm/Support/CommandLine.h"
+#include <vector>
+
+#if defined(__linux__) && defined(__x86_64__)
+#include <cpuid.h>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace llvm;
+
+// Runs an interpreter of barebone handlers, which tail call the handler of the
+// next opcode through the dispatch table, with and without
+// -block-placement-tail-call-path, and counts the taken branches per
+// instruction when the host has a counter for them.
+//
+// Each handler goes down one of two paths, three times out of four the first
+// one, and each path checks for a practically impossible error that tail calls
+// a cold block of its own. The greedy layout puts the error block of the first
+// path between it and the dispatch, so the likely path takes a branch over it;
+// with the tail call path layout it falls through to the dispatch and only the
+// unlikely path jumps back to it.
+
+static const char *InterpreterIR = R"(
+@handlers = constant [3 x i8*] [
+  i8* bitcast (void (i8**, i8*, i64)* @lcg to i8*),
+  i8* bitcast (void (i8**, i8*, i64)* @lcg2 to i8*),
+  i8* bitcast (void (i8**, i8*, i64)* @barebone_return to i8*)
+]
+
+declare barebonecc void @barebone_return(i8**, i8*, i64)
+
+define internal barebonecc void @lcg(i8** %table, i8* %pc, i64 %acc) #0 {
+entry:
+  %m = mul i64 %acc, 6364136223846793005
+  %x = add i64 %m, 1442695040888963407
+  %top = lshr i64 %x, 62
+  %likely = icmp ne i64 %top, 0
+  br i1 %likely, label %a, label %b, !prof !0
+
+a:
+  %a.v = xor i64 %x, 11400714819323198485
+  %a.bad = icmp eq i64 %a.v, 0
+  br i1 %a.bad, label %error.a, label %next, !prof !1
+
+b:
+  %b.v = add i64 %x, 7046029254386353131
+  %b.bad = icmp eq i64 %b.v, 0
+  br i1 %b.bad, label %error.b, label %next, !prof !1
+
+error.a:
+  musttail call barebonecc void @barebone_return(i8** %table, i8* %pc,
+                                                 i64 1) #1
+  ret void
+
+error.b:
+  musttail call barebonecc void @barebone_return(i8** %table, i8* %pc,
+                                                 i64 2) #1
+  ret void
+
+next:
+  %acc.next = phi i64 [ %a.v, %a ], [ %b.v, %b ]
+  %pc.next = getelementptr i8, i8* %pc, i64 1
+  %op = load i8, i8* %pc.next
+  %idx = zext i8 %op to i64
+  %slot = getelementptr i8*, i8** %table, i64 %idx
+  %raw = load i8*, i8** %slot
+  %handler = bitcast i8* %raw to void (i8**, i8*, i64)*
+  musttail call barebonecc void %handler(i8** %table, i8* %pc.next,
+                                         i64 %acc.next) #1
+  ret void
+}
+
+define internal barebonecc void @lcg2(i8** %table, i8* %pc, i64 %acc) #0 {
+entry:
+  %m = mul i64 %acc, 2862933555777941757
+  %x = add i64 %m, 3037000493
+  %top = lshr i64 %x, 62
+  %likely = icmp ne i64 %top, 0
+  br i1 %likely, label %a, label %b, !prof !0
+
+a:
+  %a.v = xor i64 %x, 6148914691236517205
+  %a.bad = icmp eq i64 %a.v, 0
+  br i1 %a.bad, label %error.a, label %next, !prof !1
+
+b:
+  %b.v = add i64 %x, 3074457345618258602
+  %b.bad = icmp eq i64 %b.v, 0
+  br i1 %b.bad, label %error.b, label %next, !prof !1
+
+error.a:
+  musttail call barebonecc void @barebone_return(i8** %table, i8* %pc,
+                                                 i64 3) #1
+  ret void
+
+error.b:
+  musttail call barebonecc void @barebone_return(i8** %table, i8* %pc,
+                                                 i64 4) #1
+  ret void
+
+next:
+  %acc.next = phi i64 [ %a.v, %a ], [ %b.v, %b ]
+  %pc.next = getelementptr i8, i8* %pc, i64 1
+  %op = load i8, i8* %pc.next
+  %idx = zext i8 %op to i64
+  %slot = getelementptr i8*, i8** %table, i64 %idx
+  %raw = load i8*, i8** %slot
+  %handler = bitcast i8* %raw to void (i8**, i8*, i64)*
+  musttail call barebonecc void %handler(i8** %table, i8* %pc.next,
+                                         i64 %acc.next) #1
+  ret void
+}
+
+attributes #0 = { nounwind "frame-pointer"="none" "hwreg"="r15,rbx,rax" }
+attributes #1 = { "hwreg"="r15,rbx,rax" }
+
+!0 = !{!"branch_weights", i32 3, i32 1}
+!1 = !{!"branch_weights", i32 1, i32 2000}
+)";
+
+namespace {
+
+// Counts the taken branches retired in user mode by this thread:
+// BR_INST_RETIRED.NEAR_TAKEN on Intel, the retired taken branch instructions
+// on AMD. Invalid if the host does not let us open the counter.
+class TakenBranchCounter {
+  int FD = -1;
+
+public:
+  TakenBranchCounter() {
+#if defined(__linux__) && defined(__x86_64__)
+    unsigned MaxLeaf, Vendor1, Vendor2, Vendor3;
+    if (!__get_cpuid(0, &MaxLeaf, &Vendor1, &Vendor3, &Vendor2))
+      return;
+    perf_event_attr Attr = {};
+    Attr.size = sizeof(Attr);
+    Attr.type = PERF_TYPE_RAW;
+    if (Vendor1 == 0x756e6547) // "GenuineIntel"
+      Attr.config = 0x20c4;
+    else if (Vendor1 == 0x68747541) // "AuthenticAMD"
+      Attr.config = 0xc4;
+    else
+      return;
+    Attr.disabled = 1;
+    Attr.exclude_kernel = 1;
+    Attr.exclude_hv = 1;
+    FD = syscall(__NR_perf_event_open, &Attr, 0, -1, -1, 0);
+#endif
+  }
+
+  ~TakenBranchCounter() {
+#if defined(__linux__) && defined(__x86_64__)
+    if (FD >= 0)
+      close(FD);
+#endif
+  }
+
+  bool isValid() const { return FD >= 0; }
+
+  // Returns the number of taken branches retired while running \p Fn.
+  template <typename FnT> uint64_t count(FnT Fn) {
+    uint64_t Count = 0;
+#if defined(__linux__) && defined(__x86_64__)
+    ioctl(FD, PERF_EVENT_IOC_RESET, 0);
+    ioctl(FD, PERF_EVENT_IOC_ENABLE, 0);
+    Fn();
+    ioctl(FD, PERF_EVENT_IOC_DISABLE, 0);
+    if (::read(FD, &Count, sizeof(Count)) != sizeof(Count))
+      Count = 0;
+#endif
+    return Count;
+  }
+};
+
+} // end anonymous namespace
+
+// A random program of lcg and lcg2. The error paths are never taken.
+static void BM_Interpreter(benchmark::State &State, bool PathLayout) {
+  if (!canRunBarebone()) {
+    State.SkipWithError("barebone handlers cannot run on this host");
+    return;
+  }
+  static_cast<cl::opt<bool> *>(
+      cl::getRegisteredOptions()["block-placement-tail-call-path"])
+      ->setValue(PathLayout);
+  InterpreterJIT J(InterpreterIR);
+  const void *Handlers = J.lookupData("handlers");
+  std::vector<unsigned char> Code = getRandomProgram(State.range(0), 2);
+  for (auto _ : State)
+    benchmark::DoNotOptimize(runBarebone(Handlers, Code.data(), 1));
+  State.SetItemsProcessed(State.iterations() * State.range(0));
+
+  TakenBranchCounter Counter;
+  if (!Counter.isValid()) {
+    State.SetLabel("no taken branch counter");
+    return;
+  }
+  uint64_t Taken = Counter.count([&] {
+    benchmark::DoNotOptimize(runBarebone(Handlers, Code.data(), 1));
+  });
+  State.counters["taken_branches_per_inst"] =
+      double(Taken) / State.range(0);
+}
+
+BENCHMARK_CAPTURE(BM_Interpreter, greedy, false)->Arg(1 << 16);
+BENCHMARK_CAPTURE(BM_Interpreter, tail_call_path, true)->Arg(1 << 16);
+
+BENCHMARK_MAIN();
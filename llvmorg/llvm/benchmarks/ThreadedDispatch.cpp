@@ -0,0 +1,93 @@
+#include "InterpreterBenchmark.h"
+#include "benchmark/benchmark.h"
+#include <vector>
+
+using namespace llvm;
+
+// Runs a small switch-based bytecode interpreter compiled with and without the
+// "threaded-dispatch" attribute, which replicates the jump table dispatch into
+// the tail of every case.
+
+static const char *InterpreterIR = R"(
+define i32 @interp(i8* %code, i32 %acc0) ATTRS {
+entry:
+  br label %dispatch
+
+dispatch:
+  %pc = phi i8* [ %code, %entry ], [ %pc.next, %inc ], [ %pc.next, %dec ],
+                [ %pc.next, %dbl ], [ %pc.next, %neg ], [ %pc.next, %xor ],
+                [ %pc.next, %shr ], [ %pc.next, %rot ], [ %pc.next, %mul ]
+  %acc = phi i32 [ %acc0, %entry ], [ %acc.inc, %inc ], [ %acc.dec, %dec ],
+                 [ %acc.dbl, %dbl ], [ %acc.neg, %neg ], [ %acc.xor, %xor ],
+                 [ %acc.shr, %shr ], [ %acc.rot, %rot ], [ %acc.mul, %mul ]
+  %op = load i8, i8* %pc
+  %pc.next = getelementptr i8, i8* %pc, i64 1
+  switch i8 %op, label %exit [
+    i8 0, label %inc
+    i8 1, label %dec
+    i8 2, label %dbl
+    i8 3, label %neg
+    i8 4, label %xor
+    i8 5, label %shr
+    i8 6, label %rot
+    i8 7, label %mul
+  ]
+
+inc:
+  %acc.inc = add i32 %acc, 1
+  br label %dispatch
+
+dec:
+  %acc.dec = add i32 %acc, -1
+  br label %dispatch
+
+dbl:
+  %acc.dbl = shl i32 %acc, 1
+  br label %dispatch
+
+neg:
+  %acc.neg = sub i32 0, %acc
+  br label %dispatch
+
+xor:
+  %acc.xor = xor i32 %acc, 1431655765
+  br label %dispatch
+
+shr:
+  %acc.shr = lshr i32 %acc, 3
+  br label %dispatch
+
+rot:
+  %rot.hi = shl i32 %acc, 7
+  %rot.lo = lshr i32 %acc, 25
+  %acc.rot = or i32 %rot.hi, %rot.lo
+  br label %dispatch
+
+mul:
+  %acc.mul = mul i32 %acc, -1640531535
+  br label %dispatch
+
+exit:
+  ret i32 %acc
+}
+
+attributes #0 = { "threaded-dispatch" }
+)";
+
+using InterpFn = int (*)(const unsigned char *, int);
+
+// A random program: the opcodes are unpredictable, which is the case the
+// replicated dispatch helps the branch predictor with.
+static void BM_Interpreter(benchmark::State &State, const char *Attrs) {
+  InterpreterJIT J(InterpreterIR, Attrs);
+  InterpFn Interp = J.lookup<InterpFn>("interp");
+  std::vector<unsigned char> Code = getRandomProgram(State.range(0), 8);
+  for (auto _ : State)
+    benchmark::DoNotOptimize(Interp(Code.data(), 1));
+  State.SetItemsProcessed(State.iterations() * State.range(0));
+}
+
+BENCHMARK_CAPTURE(BM_Interpreter, switch, "")->Arg(1 << 16);
+BENCHMARK_CAPTURE(BM_Interpreter, threaded, "#0")->Arg(1 << 16);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,61 @@
+//===- EmbeddedModelRunner.h ---- Dependency-free model runner --*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+
+#ifndef LLVM_ANALYSIS_EMBEDDEDMODELRUNNER_H
+#define LLVM_ANALYSIS_EMBEDDEDMODELRUNNER_H
+
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Analysis/MLModelRunner.h"
+#include "llvm/Support/Error.h"
+#include <array>
+#include <memory>
+
+namespace llvm {
+
+/// MLModelRunner evaluating a small linear model with plain C++, so that the
+/// ML inline advisor can be used without TensorFlow.
+///
+/// Each feature F is scaled to sign(F) * log(1 + |F|), and inlining is
+/// recommended when the bias plus the weighted sum of the scaled features is
+/// positive. The weights are either built into the compiler, from
+/// lib/Analysis/models/EmbeddedInlinerModel.def, or read from a model file
+/// with one "<name> <weight>" pair per line, where the name is "bias" or one
+/// of the feature names of InlineModelFeatureMaps.h. Lines starting with '#'
+/// are comments, and missing weights are 0. Both are produced by
+/// utils/train_embedded_inliner.py.
+class EmbeddedModelRunner final : public MLModelRunner {
+public:
+  /// Creates a runner with the built-in weights.
+  EmbeddedModelRunner(LLVMContext &Ctx);
+
+  /// Creates a runner with the weights of the model file in \p Buffer.
+  static Expected<std::unique_ptr<EmbeddedModelRunner>>
+  create(LLVMContext &Ctx, StringRef Buffer);
+
+  bool run() override;
+  void setFeature(FeatureIndex Index, int64_t Value) override;
+  int64_t getFeature(int Index) const override;
+
+  /// Returns the score of the current features, inlining being recommended
+  /// when it is positive.
+  double getScore() const;
+
+private:
+  EmbeddedModelRunner(LLVMContext &Ctx, std::nullptr_t) : MLModelRunner(Ctx) {}
+
+  Error setWeight(StringRef Name, double Weight);
+
+  double Bias = 0;
+  std::array<double, NumberOfFeatures> Weights{};
+  std::array<int64_t, NumberOfFeatures> Features{};
+};
+
+} // namespace llvm
+
+#endif // LLVM_ANALYSIS_EMBEDDEDMODELRUNNER_H
@@ -23,7 +23,7 @@ class Function;
 class Module;
 class OptimizationRemarkEmitter;
 
-/// There are 3 scenarios we can use the InlineAdvisor:
+/// There are 4 scenarios we can use the InlineAdvisor:
 /// - Default - use manual heuristics.
 ///
 /// - Release mode, the expected mode for production, day to day deployments.
@@ -36,7 +36,17 @@ class OptimizationRemarkEmitter;
 /// requires the full C Tensorflow API library, and evaluates models
 /// dynamically. This mode also permits generating training logs, for offline
 /// training.
-enum class InliningAdvisorMode : int { Default, Release, Development };
+///
+/// - Embedded mode, for tuning without TensorFlow.
+/// In this mode, a small linear model is evaluated with plain C++, see
+/// EmbeddedModelRunner. It is always available, and its model can be trained
+/// on a local corpus with utils/train_embedded_inliner.py.
+enum class InliningAdvisorMode : int {
+  Default,
+  Release,
+  Development,
+  Embedded
+};
 
 class InlineAdvisor;
 /// Capture state between an inlining decision having had been made, and
@@ -208,6 +218,9 @@ std::unique_ptr<InlineAdvisor>
 getReleaseModeAdvisor(Module &M, ModuleAnalysisManager &MAM);
 #endif
 
+std::unique_ptr<InlineAdvisor>
+getEmbeddedModeAdvisor(Module &M, ModuleAnalysisManager &MAM);
+
 // Default (manual policy) decision making helper APIs. Shared with the legacy
 // pass manager inliner.
 
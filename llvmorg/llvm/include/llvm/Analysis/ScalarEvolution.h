@@ -24,6 +24,7 @@
 #include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/DenseMapInfo.h"
+#include "llvm/ADT/DenseSet.h"
 #include "llvm/ADT/FoldingSet.h"
 #include "llvm/ADT/Hashing.h"
 #include "llvm/ADT/Optional.h"
@@ -1180,6 +1181,38 @@ private:
   /// This is a cache of the values we have analyzed so far.
   ValueExprMapType ValueExprMap;
 
+  /// The number of getSCEV, getSCEVAtScope, getBackedgeTakenInfo and
+  /// getPredicatedBackedgeTakenInfo computations in progress. The size-bounded
+  /// caches are only evicted when this is zero, because the computations insert
+  /// placeholders into them to break cycles.
+  unsigned CacheComputationDepth = 0;
+
+  /// Counts a computation in CacheComputationDepth for its lifetime.
+  class CacheComputationScope {
+    unsigned &Depth;
+
+  public:
+    CacheComputationScope(ScalarEvolution &SE)
+        : Depth(SE.CacheComputationDepth) {
+      ++Depth;
+    }
+    ~CacheComputationScope() { --Depth; }
+  };
+
+  /// Values and loops whose cache entries were evicted, so that their
+  /// recomputation can be counted. Only populated when statistics are
+  /// enabled.
+  DenseSet<const Value *> EvictedValues;
+  DenseSet<const Loop *> EvictedLoops;
+
+  /// Clear ValueExprMap and ExprValueMap once they grow past the size limit,
+  /// together with every cache keyed by the SCEVs they map to.
+  void evictValueExprMap();
+
+  /// Clear the backedge-taken count caches once they grow past the size
+  /// limit.
+  void evictBackedgeTakenCounts();
+
   /// Mark predicate values currently being processed by isImpliedCond.
   SmallPtrSet<Value *, 6> PendingLoopPredicates;
 
@@ -14,6 +14,7 @@
 #ifndef LLVM_CODEGEN_TAILDUPLICATOR_H
 #define LLVM_CODEGEN_TAILDUPLICATOR_H
 
+#include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/DenseSet.h"
 #include "llvm/ADT/SetVector.h"
@@ -47,6 +48,7 @@ class TailDuplicator {
   ProfileSummaryInfo *PSI;
   bool PreRegAlloc;
   bool LayoutMode;
+  bool ThreadedDispatch;
   unsigned TailDupSize;
 
   // A list of virtual registers for which to update SSA form.
@@ -113,6 +115,9 @@ private:
                             SmallVectorImpl<MachineBasicBlock *> &TDBBs,
                             SmallSetVector<MachineBasicBlock *, 8> &Succs);
   bool canCompletelyDuplicateBB(MachineBasicBlock &BB);
+  MachineBasicBlock *getJumpTableDispatch(MachineBasicBlock &MBB);
+  void threadJumpTableDispatch(MachineBasicBlock *JumpTableBB,
+                               ArrayRef<MachineBasicBlock *> RangeCheckBBs);
   bool duplicateSimpleBB(MachineBasicBlock *TailBB,
                          SmallVectorImpl<MachineBasicBlock *> &TDBBs,
                          const DenseSet<Register> &RegsUsedByPhi,
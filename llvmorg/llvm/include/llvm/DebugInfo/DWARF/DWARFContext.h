@@ -36,6 +36,7 @@
 #include "llvm/Support/DataExtractor.h"
 #include "llvm/Support/Error.h"
 #include "llvm/Support/Host.h"
+#include "llvm/Support/Threading.h"
 #include <cstdint>
 #include <deque>
 #include <map>
@@ -236,6 +237,15 @@ public:
     return DWOUnits[index].get();
   }
 
+  /// Extract the DIEs of all normal units, and the line tables of all compile
+  /// units, using a pool of threads. Each unit is extracted by a single task;
+  /// shared parser state (the unit list, abbreviation sets) is set up before
+  /// any task starts and the error handlers are serialized meanwhile.
+  ///
+  /// Once this returns, DIE and line table queries for these units only read
+  /// already parsed data, so clients may walk different units concurrently.
+  void extractAllUnits(ThreadPoolStrategy S = hardware_concurrency());
+
   DWARFCompileUnit *getDWOCompileUnitForHash(uint64_t Hash);
 
   /// Return the compile unit that includes an offset (relative to .debug_info).
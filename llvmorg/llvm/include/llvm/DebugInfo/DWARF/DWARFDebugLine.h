@@ -21,6 +21,7 @@
 #include "llvm/Support/Path.h"
 #include <cstdint>
 #include <map>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -411,6 +412,9 @@ private:
   using LineTableIter = LineTableMapTy::iterator;
   using LineTableConstIter = LineTableMapTy::const_iterator;
 
+  /// Guards LineTableMap so that line tables of different units may be parsed
+  /// concurrently. Tables are parsed outside of the lock.
+  mutable std::mutex LineTableMutex;
   LineTableMapTy LineTableMap;
 };
 
@@ -0,0 +1,79 @@
+//===- GsymContext.h --------------------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_DEBUGINFO_GSYM_GSYMCONTEXT_H
+#define LLVM_DEBUGINFO_GSYM_GSYMCONTEXT_H
+
+#include "llvm/DebugInfo/DIContext.h"
+#include "llvm/DebugInfo/GSYM/GsymReader.h"
+#include "llvm/Support/Error.h"
+
+namespace llvm {
+
+namespace object {
+class ObjectFile;
+} // namespace object
+
+namespace gsym {
+
+/// A DIContext that answers address queries from a GSYM file.
+///
+/// GSYM files contain function address ranges, line tables and inline call
+/// chains, which is everything needed to symbolize code addresses. Lookups
+/// touch only the data for the containing function, so a GSYM file that has
+/// been created once can be memory mapped and queried by many short-lived
+/// processes without re-parsing the DWARF it was created from.
+///
+/// Variable locations are not part of GSYM, so getLocalsForAddress() always
+/// returns an empty list.
+class GsymContext : public DIContext {
+public:
+  GsymContext(GsymReader Reader);
+
+  GsymContext(GsymContext &) = delete;
+  GsymContext &operator=(GsymContext &) = delete;
+
+  static bool classof(const DIContext *DICtx) {
+    return DICtx->getKind() == CK_GSYM;
+  }
+
+  void dump(raw_ostream &OS, DIDumpOptions DIDumpOpts) override;
+
+  DILineInfo getLineInfoForAddress(
+      object::SectionedAddress Address,
+      DILineInfoSpecifier Specifier = DILineInfoSpecifier()) override;
+  DILineInfoTable getLineInfoForAddressRange(
+      object::SectionedAddress Address, uint64_t Size,
+      DILineInfoSpecifier Specifier = DILineInfoSpecifier()) override;
+  DIInliningInfo getInliningInfoForAddress(
+      object::SectionedAddress Address,
+      DILineInfoSpecifier Specifier = DILineInfoSpecifier()) override;
+
+  std::vector<DILocal>
+  getLocalsForAddress(object::SectionedAddress Address) override;
+
+  const GsymReader &getReader() const { return Reader; }
+
+private:
+  GsymReader Reader;
+};
+
+/// Convert the debug info and symbol table of \p Obj to GSYM and save the
+/// result to \p Path.
+///
+/// The file is written to a temporary next to \p Path and renamed into place,
+/// so processes racing to create the same file never observe a partial one.
+/// \p NumThreads is the number of threads used to convert DWARF, zero means
+/// the number of cores.
+llvm::Error createGsymFile(const object::ObjectFile &Obj, StringRef Path,
+                           unsigned NumThreads = 0);
+
+} // namespace gsym
+} // namespace llvm
+
+#endif // LLVM_DEBUGINFO_GSYM_GSYMCONTEXT_H
@@ -49,6 +49,12 @@ public:
     std::string FallbackDebugPath;
     std::string DWPName;
     std::vector<std::string> DebugFileDirectory;
+    /// Directory holding GSYM files named after the build ID of the ELF
+    /// object they describe. When a matching file exists it is used instead
+    /// of parsing the object's DWARF.
+    std::string GsymDirectory;
+    /// Create missing GSYM files in GsymDirectory from the object's DWARF.
+    bool CreateGsym = false;
   };
 
   LLVMSymbolizer() = default;
@@ -107,6 +113,13 @@ private:
                                   const ELFObjectFileBase *Obj,
                                   const std::string &ArchName);
 
+  /// Returns a DIContext backed by the GSYM file for Obj in
+  /// Options::GsymDirectory, or nullptr if there is none. If
+  /// Options::CreateGsym is set, a missing file is created from the debug
+  /// info in DbgObj first.
+  std::unique_ptr<DIContext> lookUpGsymContext(const ObjectFile *Obj,
+                                               const ObjectFile *DbgObj);
+
   /// Returns pair of pointers to object and debug object.
   Expected<ObjectPair> getOrCreateObjectPair(const std::string &Path,
                                             const std::string &ArchName);
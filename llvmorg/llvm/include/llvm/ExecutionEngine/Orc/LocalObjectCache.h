@@ -0,0 +1,85 @@
+//===- LocalObjectCache.h - On-disk ObjectCache for ORC ---------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// An ObjectCache that keeps compiled objects in a content-addressed directory
+// on the local file system, so that several processes JITing the same IR can
+// share the result of code generation.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_EXECUTIONENGINE_ORC_LOCALOBJECTCACHE_H
+#define LLVM_EXECUTIONENGINE_ORC_LOCALOBJECTCACHE_H
+
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/ExecutionEngine/ObjectCache.h"
+#include "llvm/Support/CachePruning.h"
+#include "llvm/Support/Error.h"
+
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace llvm {
+namespace orc {
+
+/// An ObjectCache backed by a directory on the local file system.
+///
+/// Entries are keyed on a SHA1 hash of the module's bitcode combined with a
+/// client supplied context key. The context key should capture everything
+/// that affects code generation but is not recorded in the module itself,
+/// e.g. the target CPU, features and optimization level.
+///
+/// New entries are written to a temporary file and atomically renamed into
+/// place, so the cache directory can be shared by concurrently running
+/// processes: readers either see a complete object or no object at all.
+/// Entry names use the "llvmcache-" prefix expected by pruneCache(), and the
+/// directory is pruned according to the given CachePruningPolicy when the
+/// cache is created and whenever prune() is called.
+class LocalObjectCache : public ObjectCache {
+public:
+  /// Create a LocalObjectCache rooted at CacheDir, creating the directory if
+  /// it does not exist yet.
+  static Expected<std::unique_ptr<LocalObjectCache>>
+  Create(StringRef CacheDir, StringRef ContextKey = "",
+         CachePruningPolicy Policy = CachePruningPolicy());
+
+  void notifyObjectCompiled(const Module *M, MemoryBufferRef Obj) override;
+
+  std::unique_ptr<MemoryBuffer> getObject(const Module *M) override;
+
+  /// Prune the cache directory according to the policy this cache was created
+  /// with. Returns true if pruning took place.
+  bool prune();
+
+  /// Returns the directory this cache stores its entries in.
+  StringRef getCacheDir() const { return CacheDir; }
+
+private:
+  LocalObjectCache(std::string CacheDir, std::string ContextKey,
+                   CachePruningPolicy Policy)
+      : CacheDir(std::move(CacheDir)), ContextKey(std::move(ContextKey)),
+        Policy(std::move(Policy)) {}
+
+  std::string computeKey(const Module &M) const;
+  std::string getEntryPath(StringRef Key) const;
+
+  std::string CacheDir;
+  std::string ContextKey;
+  CachePruningPolicy Policy;
+
+  // Code generation mutates the module, so the key computed on lookup is
+  // remembered until the compiled object is reported back to us.
+  std::mutex PendingKeysMutex;
+  DenseMap<const Module *, std::string> PendingKeys;
+};
+
+} // end namespace orc
+} // end namespace llvm
+
+#endif // LLVM_EXECUTIONENGINE_ORC_LOCALOBJECTCACHE_H
@@ -29,6 +29,7 @@ class StringRef;
 class AAManager;
 class TargetMachine;
 class ModuleSummaryIndex;
+class FunctionTimeBudget;
 
 /// A struct capturing PGO tunables.
 struct PGOOptions {
@@ -109,6 +110,21 @@ public:
   /// Tuning option to enable/disable call graph profile. Its default value is
   /// that of the flag: `-enable-npm-call-graph-profile`.
   bool CallGraphProfile;
+
+  /// Tuning option to run the function passes of the module optimization
+  /// pipeline with ParallelModuleToFunctionPassAdaptor on this many threads,
+  /// 0 running them in place. The output does not depend on the number of
+  /// threads. The threads use the default alias analysis pipeline, and the
+  /// PassBuilder must outlive the pipeline. Its default value is that of the
+  /// flag: `-parallel-function-passes`.
+  unsigned ParallelFunctionPasses;
+
+  /// Tuning option to bound the time, in microseconds, that one run of a
+  /// pipeline of buildJITPipeline spends in the function passes of one
+  /// function: once it is exceeded, the remaining optional stages are skipped
+  /// for that function. The inliner of the peak tier is not budgeted. 0 means
+  /// no limit. Its default value is that of the flag: `-jit-function-budget-us`.
+  unsigned JITFunctionBudget;
 };
 
 /// This class provides access to building LLVM's passes.
@@ -149,6 +165,22 @@ public:
     PostLink
   };
 
+  /// JIT compilation tier.
+  ///
+  /// This enumerates the pipelines of buildJITPipeline, from the cheapest to
+  /// the most thorough.
+  enum class JITTier {
+    /// Cleanup only: promote allocas, fold the obvious and simplify the CFG,
+    /// for code that runs a few times.
+    Baseline,
+    /// Baseline plus the cheap scalar and loop-invariant optimizations, for
+    /// warm code.
+    Optimizing,
+    /// Optimizing plus inlining, GVN, full unrolling and vectorization, for
+    /// hot code.
+    Peak
+  };
+
   /// LLVM-provided high-level optimization levels.
   ///
   /// This enumerates the LLVM-provided high-level optimization levels. Each
@@ -443,6 +475,20 @@ public:
                                             bool DebugLogging,
                                             ModuleSummaryIndex *ExportSummary);
 
+  /// Build a JIT optimization pipeline for the given tier.
+  ///
+  /// Unlike the default pipelines, which are built for ahead-of-time
+  /// compilation, these pipelines pick passes for their compile time as much
+  /// as for the code they produce, and bound the time spent on one function:
+  /// the function passes run in stages, and once a function has used up
+  /// \c PipelineTuningOptions::JITFunctionBudget the remaining stages are
+  /// skipped for it. The budget covers all the stages run on the function
+  /// during one run of the pipeline, including those the peak tier runs while
+  /// inlining, but not the inliner itself. The first stage always runs. The
+  /// same pipelines are available as `jit<baseline>`, `jit<optimizing>` and
+  /// `jit<peak>` in textual pipelines.
+  ModulePassManager buildJITPipeline(JITTier Tier, bool DebugLogging = false);
+
   /// Build the default `AAManager` with the default alias analysis pipeline
   /// registered.
   AAManager buildDefaultAAPipeline();
@@ -693,6 +739,17 @@ private:
   FunctionPassManager buildO1FunctionSimplificationPipeline(
       OptimizationLevel Level, ThinLTOPhase Phase, bool DebugLogging = false);
 
+  // The function passes of buildModuleOptimizationPipeline.
+  FunctionPassManager
+  buildFunctionOptimizationPipeline(OptimizationLevel Level,
+                                    bool DebugLogging = false);
+
+  // The staged function passes of buildJITPipeline.
+  FunctionPassManager
+  buildJITFunctionPipeline(JITTier Tier,
+                           std::shared_ptr<FunctionTimeBudget> Budget,
+                           bool DebugLogging = false);
+
   static Optional<std::vector<PipelineElement>>
   parsePipelineText(StringRef Text);
 
@@ -158,6 +158,18 @@ inline StringRef getInstrProfCounterBiasVarName() {
   return "__llvm_profile_counter_bias";
 }
 
+/// Return the name of the thread local variable counting down the counter
+/// updates left until the next sampled update.
+inline StringRef getInstrProfSampleCountdownVarName() {
+  return "__llvm_profile_sample_countdown";
+}
+
+/// Return the name of the runtime function called when a sampled counter
+/// update is taken.
+inline StringRef getInstrProfSampleHitFuncName() {
+  return "__llvm_profile_sample_hit";
+}
+
 /// Return the marker used to separate PGO names during serialization.
 inline StringRef getInstrProfNameSeparator() { return "\01"; }
 
@@ -25,6 +25,7 @@ namespace llvm {
 class InstCombinePass : public PassInfoMixin<InstCombinePass> {
   InstCombineWorklist Worklist;
   const unsigned MaxIterations;
+  const unsigned MaxVisitsPerInst;
 
 public:
   static StringRef name() { return "InstCombinePass"; }
@@ -32,6 +33,13 @@ public:
   explicit InstCombinePass();
   explicit InstCombinePass(unsigned MaxIterations);
 
+  /// Stops combining a function once this many times its instruction count
+  /// instructions have been visited, over all iterations, even if no fixpoint
+  /// has been reached. 0 means no limit. InstCombinePass(1, 1) is a cheap
+  /// one-shot mode for JIT pipelines, which visits each instruction about
+  /// once.
+  InstCombinePass(unsigned MaxIterations, unsigned MaxVisitsPerInst);
+
   PreservedAnalyses run(Function &F, FunctionAnalysisManager &AM);
 };
 
@@ -42,12 +50,14 @@ public:
 class InstructionCombiningPass : public FunctionPass {
   InstCombineWorklist Worklist;
   const unsigned MaxIterations;
+  const unsigned MaxVisitsPerInst;
 
 public:
   static char ID; // Pass identification, replacement for typeid
 
   explicit InstructionCombiningPass();
   explicit InstructionCombiningPass(unsigned MaxIterations);
+  InstructionCombiningPass(unsigned MaxIterations, unsigned MaxVisitsPerInst);
 
   void getAnalysisUsage(AnalysisUsage &AU) const override;
   bool runOnFunction(Function &F) override;
@@ -67,6 +77,8 @@ public:
 //
 FunctionPass *createInstructionCombiningPass();
 FunctionPass *createInstructionCombiningPass(unsigned MaxIterations);
+FunctionPass *createInstructionCombiningPass(unsigned MaxIterations,
+                                             unsigned MaxVisitsPerInst);
 }
 
 #endif
@@ -103,6 +103,13 @@ public:
     return I;
   }
 
+  /// Drop all pending instructions without visiting them.
+  void clear() {
+    Worklist.clear();
+    WorklistMap.clear();
+    Deferred.clear();
+  }
+
   /// When an instruction is simplified, add all users of the instruction
   /// to the work lists because they might get more simplified now.
   void pushUsersToWorkList(Instruction &I) {
@@ -88,6 +88,9 @@ private:
   /// Returns true if profile counter update register promotion is enabled.
   bool isCounterPromotionEnabled() const;
 
+  /// Returns true if counter updates are sampled rather than precise.
+  bool isCounterSamplingEnabled() const;
+
   /// Count the number of instrumented value sites for the function.
   void computeNumValueSiteCounts(InstrProfValueProfileInst *Ins);
 
@@ -97,6 +100,10 @@ private:
   /// Replace instrprof_increment with an increment of the appropriate value.
   void lowerIncrement(InstrProfIncrementInst *Inc);
 
+  /// Emit a sampled update of the counter at \p Addr in place of \p Inc. This
+  /// splits the block containing \p Inc.
+  void lowerSampledIncrement(InstrProfIncrementInst *Inc, Value *Addr);
+
   /// Force emitting of name vars for unused functions.
   void lowerCoverageData(GlobalVariable *CoverageNamesVar);
 
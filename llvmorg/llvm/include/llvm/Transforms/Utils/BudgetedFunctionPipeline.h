@@ -0,0 +1,112 @@
+//===- BudgetedFunctionPipeline.h - Time-bounded function pipeline --------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// A function pass running a sequence of pipeline stages, which skips the
+// remaining stages of a function once the time spent on it exceeds a budget.
+// JIT pipelines use it to bound the optimization latency of large functions:
+// the first stage always runs and leaves valid, if little optimized, code, and
+// each later stage only improves on it.
+//
+// The time is tracked per function by a FunctionTimeBudget, which all the
+// BudgetedFunctionPipelines of a pipeline share: a function visited several
+// times, e.g. during the inliner's walk of the call graph and once more
+// afterwards, gets a single budget. Only the time of the stages counts, the
+// passes outside of them are not budgeted.
+//
+// The budget is checked between stages, so a single stage may still overrun
+// it; stages should be small enough that this does not matter.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_TRANSFORMS_UTILS_BUDGETEDFUNCTIONPIPELINE_H
+#define LLVM_TRANSFORMS_UTILS_BUDGETEDFUNCTIONPIPELINE_H
+
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/IR/PassManager.h"
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace llvm {
+
+class Function;
+class Module;
+
+/// The time spent on each function by the BudgetedFunctionPipelines sharing
+/// it. Functions are identified by name, which the copies made by
+/// ParallelModuleToFunctionPassAdaptor keep, and unnamed functions by their
+/// position in the module, which the copies keep as well. The pipelines may
+/// run on several threads at once.
+class FunctionTimeBudget {
+public:
+  using Clock = std::chrono::steady_clock;
+
+  /// A limit of 0 never runs out.
+  explicit FunctionTimeBudget(std::chrono::microseconds Limit) : Limit(Limit) {}
+
+  /// Returns true if the time spent on \p F exceeds the limit.
+  bool isExhausted(const Function &F) const;
+
+  /// Adds \p Time to the time spent on \p F.
+  void charge(const Function &F, Clock::duration Time);
+
+  /// Forgets the time spent on all the functions.
+  void reset();
+
+private:
+  /// Returns the position of the unnamed function \p F in its module.
+  static unsigned getUnnamedKey(const Function &F);
+
+  const std::chrono::microseconds Limit;
+  mutable std::mutex Lock;
+  StringMap<Clock::duration> Spent;
+  DenseMap<unsigned, Clock::duration> SpentUnnamed;
+};
+
+/// Gives a new budget to every function of the module. Pipelines reusing a
+/// FunctionTimeBudget for several modules run it first, so that functions of
+/// the same name in another module do not inherit a spent budget.
+class ResetFunctionTimeBudgetPass
+    : public PassInfoMixin<ResetFunctionTimeBudgetPass> {
+public:
+  explicit ResetFunctionTimeBudgetPass(
+      std::shared_ptr<FunctionTimeBudget> Budget)
+      : Budget(std::move(Budget)) {}
+
+  PreservedAnalyses run(Module &M, ModuleAnalysisManager &AM);
+
+private:
+  std::shared_ptr<FunctionTimeBudget> Budget;
+};
+
+/// Runs the stages added with addStage() in order, skipping the remaining ones
+/// once the function has used up its \c Budget.
+class BudgetedFunctionPipeline
+    : public PassInfoMixin<BudgetedFunctionPipeline> {
+public:
+  explicit BudgetedFunctionPipeline(std::shared_ptr<FunctionTimeBudget> Budget)
+      : Budget(std::move(Budget)) {}
+
+  /// Adds a stage to run if the budget allows it. The first stage always
+  /// runs.
+  void addStage(FunctionPassManager Stage) {
+    Stages.push_back(std::move(Stage));
+  }
+
+  PreservedAnalyses run(Function &F, FunctionAnalysisManager &AM);
+
+private:
+  std::shared_ptr<FunctionTimeBudget> Budget;
+  std::vector<FunctionPassManager> Stages;
+};
+
+} // end namespace llvm
+
+#endif // LLVM_TRANSFORMS_UTILS_BUDGETEDFUNCTIONPIPELINE_H
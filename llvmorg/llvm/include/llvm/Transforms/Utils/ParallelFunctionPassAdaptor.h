@@ -0,0 +1,94 @@
+//===- ParallelFunctionPassAdaptor.h - Run function passes in parallel ----===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// A module-to-function adaptor of the new pass manager that runs a function
+// pipeline on several functions of the module at once, on a thread pool.
+//
+// The IR is never shared between threads. The definitions are split into
+// contiguous partitions, one per thread, and every thread reads its own copy
+// of the module, through bitcode, into its own LLVMContext, with its own
+// pipeline and analysis managers. A function pass is free to read and modify
+// anything it could with the sequential adaptor: the use lists of constants
+// and globals, the declarations of library functions, or the initializers of
+// globals, only in its copy. Once the threads are done, the bodies of the
+// functions that ran, the declarations and globals that were added and the
+// attributes added to existing declarations are moved back into the module, in
+// the order of the partitions.
+//
+// The output does not depend on the number of threads. It is the same as that
+// of the sequential adaptor when the passes only depend on the function they
+// run on and on the module as it was before the pipeline, which is the case
+// for the function passes of the default pipelines. It differs when a pass
+// looks at the effects of the pipeline on another function, e.g. at a global
+// or declaration that was added for another function, or at the body of an
+// already optimized callee.
+//
+// Other changes to the module-level IR are dropped: function passes must not
+// remove, rename or redefine globals, nor add aliases. Module analyses are
+// only available to the threads when the module already had them cached:
+// GlobalsAA and ProfileSummaryAnalysis are recomputed on every copy, the other
+// ones are not. Memory use grows with one copy of the module per thread.
+//
+// The copies are read back into the context of the module, which keeps what
+// they create until it is destroyed: every run adds to the context a copy of
+// the struct types of the module, and of the constants of those types, per
+// partition. A context that is reused for many modules, e.g. by a JIT, grows
+// with every run. IR cannot be moved from one context to another, so the
+// copies cannot be read into a scratch context instead: such a context has to
+// be replaced from time to time.
+//
+// The pass instrumentation callbacks only see the pipeline as a whole, and
+// are run on the calling thread.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_TRANSFORMS_UTILS_PARALLELFUNCTIONPASSADAPTOR_H
+#define LLVM_TRANSFORMS_UTILS_PARALLELFUNCTIONPASSADAPTOR_H
+
+#include "llvm/Analysis/LoopAnalysisManager.h"
+#include "llvm/IR/PassManager.h"
+#include <functional>
+
+namespace llvm {
+
+class Module;
+
+/// Runs a function pipeline on the definitions of a module, on up to
+/// \c NumThreads threads.
+class ParallelModuleToFunctionPassAdaptor
+    : public PassInfoMixin<ParallelModuleToFunctionPassAdaptor> {
+public:
+  /// Builds the pipeline run by one thread.
+  using PipelineBuilderT = std::function<FunctionPassManager()>;
+
+  /// Registers the analyses available to the pipeline of one thread. The
+  /// proxies between the managers and PassInstrumentationAnalysis are already
+  /// registered.
+  using AnalysisRegistrationT =
+      std::function<void(ModuleAnalysisManager &, FunctionAnalysisManager &,
+                         LoopAnalysisManager &)>;
+
+  /// \p NumThreads of 0 uses all the hardware threads.
+  ParallelModuleToFunctionPassAdaptor(PipelineBuilderT BuildPipeline,
+                                      AnalysisRegistrationT RegisterAnalyses,
+                                      unsigned NumThreads = 0)
+      : BuildPipeline(std::move(BuildPipeline)),
+        RegisterAnalyses(std::move(RegisterAnalyses)), NumThreads(NumThreads) {
+  }
+
+  PreservedAnalyses run(Module &M, ModuleAnalysisManager &AM);
+
+private:
+  PipelineBuilderT BuildPipeline;
+  AnalysisRegistrationT RegisterAnalyses;
+  unsigned NumThreads;
+};
+
+} // end namespace llvm
+
+#endif // LLVM_TRANSFORMS_UTILS_PARALLELFUNCTIONPASSADAPTOR_H
@@ -0,0 +1,116 @@
+//===- EmbeddedModelRunner.cpp - Dependency-free model runner -------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements a model runner evaluating a small linear model with
+// plain C++, and the 'embedded' mode of the ML inline advisor built on it.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Analysis/EmbeddedModelRunner.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/ADT/Twine.h"
+#include "llvm/Analysis/MLInlineAdvisor.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include <cmath>
+
+using namespace llvm;
+
+static cl::opt<std::string> EmbeddedModelPath(
+    "ml-inliner-embedded-model", cl::Hidden,
+    cl::desc("Path to the model file used by -enable-ml-inliner=embedded "
+             "instead of the built-in model"));
+
+EmbeddedModelRunner::EmbeddedModelRunner(LLVMContext &Ctx)
+    : MLModelRunner(Ctx) {
+#define EMBEDDED_INLINER_WEIGHT(NAME, WEIGHT)                                  \
+  cantFail(setWeight(NAME, WEIGHT));
+#include "models/EmbeddedInlinerModel.def"
+}
+
+Expected<std::unique_ptr<EmbeddedModelRunner>>
+EmbeddedModelRunner::create(LLVMContext &Ctx, StringRef Buffer) {
+  std::unique_ptr<EmbeddedModelRunner> Runner(
+      new EmbeddedModelRunner(Ctx, nullptr));
+  SmallVector<StringRef, 16> Lines;
+  Buffer.split(Lines, '\n', /*MaxSplit=*/-1, /*KeepEmpty=*/false);
+  for (StringRef Line : Lines) {
+    Line = Line.trim();
+    if (Line.empty() || Line.startswith("#"))
+      continue;
+    StringRef Name, Value;
+    std::tie(Name, Value) = getToken(Line);
+    double Weight;
+    if (Value.trim().getAsDouble(Weight))
+      return createStringError(inconvertibleErrorCode(),
+                               "invalid weight in model line '" + Line + "'");
+    if (Error E = Runner->setWeight(Name, Weight))
+      return std::move(E);
+  }
+  return std::move(Runner);
+}
+
+Error EmbeddedModelRunner::setWeight(StringRef Name, double Weight) {
+  if (Name == "bias") {
+    Bias = Weight;
+    return Error::success();
+  }
+  for (size_t I = 0; I < NumberOfFeatures; ++I)
+    if (Name == FeatureNameMap[I]) {
+      Weights[I] = Weight;
+      return Error::success();
+    }
+  return createStringError(inconvertibleErrorCode(),
+                           "unknown feature '" + Name + "' in model");
+}
+
+void EmbeddedModelRunner::setFeature(FeatureIndex Index, int64_t Value) {
+  Features[static_cast<size_t>(Index)] = Value;
+}
+
+int64_t EmbeddedModelRunner::getFeature(int Index) const {
+  return Features[Index];
+}
+
+double EmbeddedModelRunner::getScore() const {
+  double Score = Bias;
+  for (size_t I = 0; I < NumberOfFeatures; ++I) {
+    double F = static_cast<double>(Features[I]);
+    Score += Weights[I] * std::copysign(std::log1p(std::abs(F)), F);
+  }
+  return Score;
+}
+
+bool EmbeddedModelRunner::run() { return getScore() > 0; }
+
+std::unique_ptr<InlineAdvisor>
+llvm::getEmbeddedModeAdvisor(Module &M, ModuleAnalysisManager &MAM) {
+  LLVMContext &Ctx = M.getContext();
+  std::unique_ptr<EmbeddedModelRunner> Runner;
+  if (EmbeddedModelPath.empty()) {
+    Runner = std::make_unique<EmbeddedModelRunner>(Ctx);
+  } else {
+    auto BufferOrErr = MemoryBuffer::getFile(EmbeddedModelPath);
+    if (!BufferOrErr) {
+      Ctx.emitError("could not open inliner model '" + EmbeddedModelPath +
+                    "': " + BufferOrErr.getError().message());
+      return nullptr;
+    }
+    auto RunnerOrErr =
+        EmbeddedModelRunner::create(Ctx, (*BufferOrErr)->getBuffer());
+    if (!RunnerOrErr) {
+      Ctx.emitError("could not load inliner model '" + EmbeddedModelPath +
+                    "': " + toString(RunnerOrErr.takeError()));
+      return nullptr;
+    }
+    Runner = std::move(*RunnerOrErr);
+  }
+  return std::make_unique<MLInlineAdvisor>(M, MAM, std::move(Runner));
+}
@@ -167,6 +167,9 @@ bool InlineAdvisorAnalysis::Result::tryCreate(InlineParams Params,
     Advisor = llvm::getReleaseModeAdvisor(M, MAM);
 #endif
     break;
+  case InliningAdvisorMode::Embedded:
+    Advisor = llvm::getEmbeddedModeAdvisor(M, MAM);
+    break;
   }
   return !!Advisor;
 }
@@ -146,6 +146,23 @@ STATISTIC(NumTripCountsNotComputed,
           "Number of loops without predictable loop counts");
 STATISTIC(NumBruteForceTripCountsComputed,
           "Number of loops with trip counts computed by force");
+STATISTIC(NumValueExprCacheHits, "Number of getSCEV queries found in the cache");
+STATISTIC(NumValueExprCacheMisses,
+          "Number of getSCEV queries that created a new SCEV");
+STATISTIC(NumValueExprEvictions,
+          "Number of values evicted from the SCEV cache");
+STATISTIC(NumValueExprRecomputations,
+          "Number of SCEVs recomputed for values after their eviction");
+STATISTIC(PeakValueExprCacheSize, "Largest size of the SCEV cache");
+STATISTIC(NumBackedgeTakenCacheHits,
+          "Number of backedge-taken count queries found in the cache");
+STATISTIC(NumBackedgeTakenCacheMisses,
+          "Number of backedge-taken count queries that computed a new count");
+STATISTIC(NumBackedgeTakenEvictions,
+          "Number of loops evicted from the backedge-taken count cache");
+STATISTIC(NumBackedgeTakenRecomputations,
+          "Number of backedge-taken counts recomputed after their eviction");
+STATISTIC(MaxUniqueSCEVs, "Largest number of unique SCEVs in a function");
 
 static cl::opt<unsigned>
 MaxBruteForceIterations("scalar-evolution-max-iterations", cl::ReallyHidden,
@@ -226,6 +243,18 @@ ClassifyExpressions("scalar-evolution-classify-expressions",
     cl::Hidden, cl::init(true),
     cl::desc("When printing analysis, include information on every instruction"));
 
+static cl::opt<unsigned> MaxValueExprCacheSize(
+    "scalar-evolution-max-value-cache-size", cl::Hidden,
+    cl::desc("Maximum number of values whose SCEVs are cached before the "
+             "cache is cleared (0 = unlimited)"),
+    cl::init(65536));
+
+static cl::opt<unsigned> MaxBackedgeTakenCacheSize(
+    "scalar-evolution-max-backedge-taken-cache-size", cl::Hidden,
+    cl::desc("Maximum number of loops whose backedge-taken counts are cached "
+             "before the cache is cleared (0 = unlimited)"),
+    cl::init(4096));
+
 
 //===----------------------------------------------------------------------===//
 //                           SCEV class definitions
@@ -3694,7 +3723,19 @@ const SCEV *ScalarEvolution::getSCEV(Value *V) {
 
   const SCEV *S = getExistingSCEV(V);
   if (S == nullptr) {
-    S = createSCEV(V);
+    ++NumValueExprCacheMisses;
+    if (CacheComputationDepth == 0 && MaxValueExprCacheSize &&
+        ValueExprMap.size() >= MaxValueExprCacheSize)
+      evictValueExprMap();
+#if LLVM_ENABLE_STATS || !defined(NDEBUG)
+    if (!EvictedValues.empty() && EvictedValues.erase(V))
+      ++NumValueExprRecomputations;
+#endif
+
+    {
+      CacheComputationScope Scope(*this);
+      S = createSCEV(V);
+    }
     // During PHI resolution, it is possible to create two SCEVs for the same
     // V, so it is needed to double check whether V->S is inserted into
     // ValueExprMap before insert S->{V, 0} into ExprValueMap.
@@ -3717,10 +3758,43 @@ const SCEV *ScalarEvolution::getSCEV(Value *V) {
           !isa<GetElementPtrInst>(V))
         ExprValueMap[Stripped].insert({V, Offset});
     }
+  } else {
+    ++NumValueExprCacheHits;
   }
   return S;
 }
 
+void ScalarEvolution::evictValueExprMap() {
+  assert(CacheComputationDepth == 0 &&
+         "Evicting the SCEV cache while a SCEV is being created!");
+  PeakValueExprCacheSize.updateMax(ValueExprMap.size());
+  NumValueExprEvictions += ValueExprMap.size();
+#if LLVM_ENABLE_STATS || !defined(NDEBUG)
+  if (AreStatisticsEnabled())
+    for (auto &Entry : ValueExprMap)
+      EvictedValues.insert(Entry.first);
+#endif
+  // Every SCEV stays alive in UniqueSCEVs, so the expressions handed out
+  // before the eviction remain valid; only the value to SCEV mapping has to
+  // be recomputed.
+  ValueExprMap.clear();
+  ExprValueMap.clear();
+
+  // forgetValue and forgetLoop reach the caches keyed by a SCEV only through
+  // ValueExprMap. Once a value is gone from it, nothing could invalidate the
+  // results memoized for its SCEV any more, so drop all of them as well.
+  ValuesAtScopes.clear();
+  LoopDispositions.clear();
+  BlockDispositions.clear();
+  UnsignedRanges.clear();
+  SignedRanges.clear();
+  HasRecMap.clear();
+  MinTrailingZerosCache.clear();
+  PredicatedSCEVRewrites.clear();
+  ConstantEvolutionLoopExitValue.clear();
+  evictBackedgeTakenCounts();
+}
+
 const SCEV *ScalarEvolution::getExistingSCEV(Value *V) {
   assert(isSCEVable(V->getType()) && "Value is not SCEVable!");
 
@@ -6493,8 +6567,10 @@ ScalarEvolution::getPredicatedBackedgeTakenInfo(const Loop *L) {
   if (!Pair.second)
     return Pair.first->second;
 
-  BackedgeTakenInfo Result =
-      computeBackedgeTakenCount(L, /*AllowPredicates=*/true);
+  BackedgeTakenInfo Result = [&] {
+    CacheComputationScope Scope(*this);
+    return computeBackedgeTakenCount(L, /*AllowPredicates=*/true);
+  }();
 
   return PredicatedBackedgeTakenCounts.find(L)->second = std::move(Result);
 }
@@ -6508,13 +6584,30 @@ ScalarEvolution::getBackedgeTakenInfo(const Loop *L) {
   // backedge-taken count, which could result in infinite recursion.
   std::pair<DenseMap<const Loop *, BackedgeTakenInfo>::iterator, bool> Pair =
       BackedgeTakenCounts.insert({L, BackedgeTakenInfo()});
-  if (!Pair.second)
+  if (!Pair.second) {
+    ++NumBackedgeTakenCacheHits;
     return Pair.first->second;
+  }
+
+  ++NumBackedgeTakenCacheMisses;
+  if (CacheComputationDepth == 0 && MaxBackedgeTakenCacheSize &&
+      BackedgeTakenCounts.size() > MaxBackedgeTakenCacheSize) {
+    BackedgeTakenCounts.erase(Pair.first);
+    evictBackedgeTakenCounts();
+    BackedgeTakenCounts.insert({L, BackedgeTakenInfo()});
+  }
+#if LLVM_ENABLE_STATS || !defined(NDEBUG)
+  if (!EvictedLoops.empty() && EvictedLoops.erase(L))
+    ++NumBackedgeTakenRecomputations;
+#endif
 
   // computeBackedgeTakenCount may allocate memory for its result. Inserting it
   // into the BackedgeTakenCounts map transfers ownership. Otherwise, the result
   // must be cleared in this scope.
-  BackedgeTakenInfo Result = computeBackedgeTakenCount(L);
+  BackedgeTakenInfo Result = [&] {
+    CacheComputationScope Scope(*this);
+    return computeBackedgeTakenCount(L);
+  }();
 
   // In product build, there are no usage of statistic.
   (void)NumTripCountsComputed;
@@ -6602,6 +6695,23 @@ ScalarEvolution::getBackedgeTakenInfo(const Loop *L) {
   return BackedgeTakenCounts.find(L)->second = std::move(Result);
 }
 
+void ScalarEvolution::evictBackedgeTakenCounts() {
+  assert(CacheComputationDepth == 0 &&
+         "Evicting backedge-taken counts while one is being computed!");
+  NumBackedgeTakenEvictions += BackedgeTakenCounts.size();
+  for (auto &BTCI : BackedgeTakenCounts) {
+#if LLVM_ENABLE_STATS || !defined(NDEBUG)
+    if (AreStatisticsEnabled())
+      EvictedLoops.insert(BTCI.first);
+#endif
+    BTCI.second.clear();
+  }
+  for (auto &BTCI : PredicatedBackedgeTakenCounts)
+    BTCI.second.clear();
+  BackedgeTakenCounts.clear();
+  PredicatedBackedgeTakenCounts.clear();
+}
+
 void ScalarEvolution::forgetAllLoops() {
   // This method is intended to forget all info about loops. It should
   // invalidate caches as if the following happened:
@@ -7897,7 +8007,10 @@ const SCEV *ScalarEvolution::getSCEVAtScope(const SCEV *V, const Loop *L) {
   Values.emplace_back(L, nullptr);
 
   // Otherwise compute it.
-  const SCEV *C = computeSCEVAtScope(V, L);
+  const SCEV *C = [&] {
+    CacheComputationScope Scope(*this);
+    return computeSCEVAtScope(V, L);
+  }();
   for (auto &LS : reverse(ValuesAtScopes[V]))
     if (LS.first == L) {
       LS.second = C;
@@ -11336,6 +11449,8 @@ ScalarEvolution::ScalarEvolution(ScalarEvolution &&Arg)
     : F(Arg.F), HasGuards(Arg.HasGuards), TLI(Arg.TLI), AC(Arg.AC), DT(Arg.DT),
       LI(Arg.LI), CouldNotCompute(std::move(Arg.CouldNotCompute)),
       ValueExprMap(std::move(Arg.ValueExprMap)),
+      EvictedValues(std::move(Arg.EvictedValues)),
+      EvictedLoops(std::move(Arg.EvictedLoops)),
       PendingLoopPredicates(std::move(Arg.PendingLoopPredicates)),
       PendingPhiRanges(std::move(Arg.PendingPhiRanges)),
       PendingMerges(std::move(Arg.PendingMerges)),
@@ -11370,6 +11485,9 @@ ScalarEvolution::~ScalarEvolution() {
   }
   FirstUnknown = nullptr;
 
+  PeakValueExprCacheSize.updateMax(ValueExprMap.size());
+  MaxUniqueSCEVs.updateMax(UniqueSCEVs.size());
+
   ExprValueMap.clear();
   ValueExprMap.clear();
   HasRecMap.clear();
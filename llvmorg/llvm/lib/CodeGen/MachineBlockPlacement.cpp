@@ -50,6 +50,7 @@
 #include "llvm/CodeGen/TargetSubtargetInfo.h"
 #include "llvm/IR/DebugLoc.h"
 #include "llvm/IR/Function.h"
+#include "llvm/IR/Instructions.h"
 #include "llvm/InitializePasses.h"
 #include "llvm/Pass.h"
 #include "llvm/Support/Allocator.h"
@@ -81,6 +82,8 @@ STATISTIC(CondBranchTakenFreq,
           "Potential frequency of taking conditional branches");
 STATISTIC(UncondBranchTakenFreq,
           "Potential frequency of taking unconditional branches");
+STATISTIC(NumTailCallPathBlocks,
+          "Number of blocks placed on the hot path to a tail call exit");
 
 static cl::opt<unsigned> AlignAllBlock(
     "align-all-blocks",
@@ -177,6 +180,13 @@ static cl::opt<unsigned> TailDupPlacementPenalty(
     cl::init(2),
     cl::Hidden);
 
+static cl::opt<bool> TailCallPathLayout(
+    "block-placement-tail-call-path",
+    cl::desc("In functions that only exit through musttail calls, one of "
+             "them indirect, lay out the most probable path from the entry to "
+             "a tail call contiguously before all other blocks."),
+    cl::init(true), cl::Hidden);
+
 // Heuristic for triangle chains.
 static cl::opt<unsigned> TriangleChainCount(
     "triangle-chain-count",
@@ -494,6 +504,8 @@ class MachineBlockPlacement : public MachineFunctionPass {
   void rotateLoopWithProfile(
       BlockChain &LoopChain, const MachineLoop &L,
       const BlockFilterSet &LoopBlockSet);
+  bool isTailCallDispatcher() const;
+  void buildTailCallPathChain();
   void buildCFGChains();
   void optimizeBranches();
   void alignBlocks();
@@ -2626,6 +2638,77 @@ void MachineBlockPlacement::buildLoopChains(const MachineLoop &L) {
   EHPadWorkList.clear();
 }
 
+/// Returns true if the function ends like the handler of a threaded
+/// interpreter: every exit is a musttail call, at least one of them through a
+/// function pointer.
+///
+/// Such functions (e.g. the barebone handlers of an interpreter, which end in
+/// a musttail call to the next handler) have no return block for the layout to
+/// gravitate towards, so the greedy chain building may place cold blocks
+/// between the entry and the dispatch.
+bool MachineBlockPlacement::isTailCallDispatcher() const {
+  bool HasIndirectTailCall = false;
+  for (const BasicBlock &BB : F->getFunction()) {
+    if (!isa<ReturnInst>(BB.getTerminator()))
+      continue;
+    const CallInst *CI = BB.getTerminatingMustTailCall();
+    if (!CI)
+      return false;
+    HasIndirectTailCall |= CI->isIndirectCall();
+  }
+  if (!HasIndirectTailCall)
+    return false;
+  return llvm::all_of(*F, [](const MachineBasicBlock &MBB) {
+    return !MBB.isReturnBlock() || MBB.back().isCall();
+  });
+}
+
+/// Chain the most probable path from the entry block to a tail call exit.
+///
+/// The path follows the most probable successor of each block, as given by
+/// the profile or by llvm.expect, and stops at the first block that cannot be
+/// appended: one that is already on the path, is not the head of its chain,
+/// is an EH pad, or belongs to a loop. The path is only committed if it ends
+/// in a tail call; the blocks left off it are then placed after the path by
+/// the normal chain building, which continues from the end of the entry
+/// chain.
+void MachineBlockPlacement::buildTailCallPathChain() {
+  BlockChain &EntryChain = *BlockToChain[&F->front()];
+  SmallVector<MachineBasicBlock *, 8> Path;
+  SmallPtrSet<BlockChain *, 8> PathChains;
+  PathChains.insert(&EntryChain);
+
+  MachineBasicBlock *BB = *std::prev(EntryChain.end());
+  while (!BB->succ_empty()) {
+    MachineBasicBlock *BestSucc = nullptr;
+    auto BestProb = BranchProbability::getZero();
+    for (MachineBasicBlock *Succ : BB->successors()) {
+      auto Prob = MBPI->getEdgeProbability(BB, Succ);
+      if (!BestSucc || Prob > BestProb) {
+        BestSucc = Succ;
+        BestProb = Prob;
+      }
+    }
+
+    BlockChain *SuccChain = BlockToChain[BestSucc];
+    if (PathChains.count(SuccChain) || *SuccChain->begin() != BestSucc ||
+        BestSucc->isEHPad() || MLI->getLoopFor(BestSucc))
+      return;
+    PathChains.insert(SuccChain);
+    Path.push_back(BestSucc);
+    BB = *std::prev(SuccChain->end());
+  }
+  if (!BB->isReturnBlock())
+    return;
+
+  for (MachineBasicBlock *PathBB : Path) {
+    LLVM_DEBUG(dbgs() << "Merging " << getBlockName(PathBB)
+                      << " into the tail call path\n");
+    EntryChain.merge(PathBB, BlockToChain[PathBB]);
+    ++NumTailCallPathBlocks;
+  }
+}
+
 void MachineBlockPlacement::buildCFGChains() {
   // Ensure that every BB in the function has an associated chain to simplify
   // the assumptions of the remaining algorithm.
@@ -2660,6 +2743,9 @@ void MachineBlockPlacement::buildCFGChains() {
     }
   }
 
+  if (TailCallPathLayout && isTailCallDispatcher())
+    buildTailCallPathChain();
+
   // Build any loop-based chains.
   PreferredLoopExit = nullptr;
   for (MachineLoop *L : *MLI)
@@ -70,6 +70,12 @@ static cl::opt<unsigned> TailDupIndirectBranchSize(
              "end with indirect branches."), cl::init(20),
     cl::Hidden);
 
+static cl::opt<bool> TailDupThreadedDispatch(
+    "tail-dup-threaded-dispatch",
+    cl::desc("Replicate the jump table dispatch of switch loops into every "
+             "case, as in functions with the threaded-dispatch attribute"),
+    cl::init(false), cl::Hidden);
+
 static cl::opt<bool>
     TailDupVerify("tail-dup-verify",
                   cl::desc("Verify sanity of PHI instructions during taildup"),
@@ -97,6 +103,10 @@ void TailDuplicator::initMF(MachineFunction &MFin, bool PreRegAlloc,
 
   LayoutMode = LayoutModeIn;
   this->PreRegAlloc = PreRegAlloc;
+  ThreadedDispatch =
+      PreRegAlloc && !LayoutMode &&
+      (TailDupThreadedDispatch ||
+       MF->getFunction().hasFnAttribute("threaded-dispatch"));
 }
 
 static void VerifyPHIs(MachineFunction &MF, bool CheckExtra) {
@@ -285,7 +295,18 @@ bool TailDuplicator::tailDuplicateBlocks() {
     if (!shouldTailDuplicate(IsSimple, *MBB))
       continue;
 
-    MadeChange |= tailDuplicateAndUpdate(IsSimple, MBB, nullptr);
+    MachineBasicBlock *JumpTableBB = getJumpTableDispatch(*MBB);
+    SmallVector<MachineBasicBlock *, 8> DuplicatedPreds;
+    if (!tailDuplicateAndUpdate(IsSimple, MBB, nullptr, &DuplicatedPreds))
+      continue;
+    MadeChange = true;
+
+    if (JumpTableBB) {
+      // The jump table block may be deleted once it has been duplicated.
+      if (I != E && &*I == JumpTableBB)
+        ++I;
+      threadJumpTableDispatch(JumpTableBB, DuplicatedPreds);
+    }
   }
 
   if (PreRegAlloc && TailDupVerify)
@@ -553,7 +574,10 @@ bool TailDuplicator::shouldTailDuplicate(bool IsSimple,
   // When doing tail-duplication during layout, the block ordering is in flux,
   // so canFallThrough returns a result based on incorrect information and
   // should just be ignored.
-  if (!LayoutMode && TailBB.canFallThrough())
+  // The range check of a switch dispatch falls through to the jump table
+  // block, see threadJumpTableDispatch.
+  MachineBasicBlock *JumpTableBB = getJumpTableDispatch(TailBB);
+  if (!LayoutMode && TailBB.canFallThrough() && !JumpTableBB)
     return false;
 
   // Don't try to tail-duplicate single-block loops.
@@ -591,7 +615,7 @@ bool TailDuplicator::shouldTailDuplicate(bool IsSimple,
 
   bool HasIndirectbr = false;
   if (!TailBB.empty())
-    HasIndirectbr = TailBB.back().isIndirectBranch();
+    HasIndirectbr = TailBB.back().isIndirectBranch() || JumpTableBB != nullptr;
 
   if (HasIndirectbr && PreRegAlloc)
     MaxDuplicateCount = TailDupIndirectBranchSize;
@@ -677,6 +701,63 @@ bool TailDuplicator::shouldTailDuplicate(bool IsSimple,
   return canCompletelyDuplicateBB(TailBB);
 }
 
+/// In a function with threaded dispatch, if \p MBB is the dispatch block of a
+/// switch loop, i.e. it is entered from several blocks, checks the range of
+/// the switch condition and then branches to a block of its own that jumps
+/// through a jump table, return that block.
+MachineBasicBlock *
+TailDuplicator::getJumpTableDispatch(MachineBasicBlock &MBB) {
+  if (!ThreadedDispatch || MBB.pred_size() < 2 || MBB.succ_size() != 2)
+    return nullptr;
+  MachineBasicBlock *TBB = nullptr, *FBB = nullptr;
+  SmallVector<MachineOperand, 4> Cond;
+  if (TII->analyzeBranch(MBB, TBB, FBB, Cond) || Cond.empty())
+    return nullptr;
+
+  for (MachineBasicBlock *Succ : MBB.successors()) {
+    if (Succ == &MBB || Succ->pred_size() != 1 || Succ->empty() ||
+        !Succ->back().isIndirectBranch())
+      continue;
+    for (const MachineInstr &MI : *Succ)
+      for (const MachineOperand &MO : MI.operands())
+        if (MO.isJTI())
+          return shouldTailDuplicate(false, *Succ) ? Succ : nullptr;
+  }
+  return nullptr;
+}
+
+/// Once the range check of a switch dispatch has been duplicated into
+/// \p RangeCheckBBs, give each copy a copy of the jump table branch as well,
+/// so that every case ends with an indirect branch of its own like with
+/// computed gotos. The branch predictor can then tell the cases apart by the
+/// address of the branch and learn the common sequences of cases.
+void TailDuplicator::threadJumpTableDispatch(
+    MachineBasicBlock *JumpTableBB,
+    ArrayRef<MachineBasicBlock *> RangeCheckBBs) {
+  // Tail duplication only copies blocks into predecessors with a single
+  // successor, so split the edges to the jump table block first.
+  SmallVector<MachineBasicBlock *, 8> EdgeBBs;
+  for (MachineBasicBlock *PredBB : RangeCheckBBs) {
+    if (!PredBB->isSuccessor(JumpTableBB))
+      continue;
+    MachineBasicBlock *PrevLayoutSucc = PredBB->getNextNode();
+    MachineBasicBlock *EdgeBB =
+        MF->CreateMachineBasicBlock(PredBB->getBasicBlock());
+    MF->insert(std::next(PredBB->getIterator()), EdgeBB);
+    PredBB->ReplaceUsesOfBlockWith(JumpTableBB, EdgeBB);
+    PredBB->updateTerminator(PrevLayoutSucc);
+    EdgeBB->addSuccessor(JumpTableBB);
+    TII->insertBranch(*EdgeBB, JumpTableBB, nullptr, {},
+                      PredBB->findBranchDebugLoc());
+    JumpTableBB->replacePhiUsesWith(PredBB, EdgeBB);
+    EdgeBBs.push_back(EdgeBB);
+  }
+
+  if (!EdgeBBs.empty())
+    tailDuplicateAndUpdate(false, JumpTableBB, nullptr, nullptr, nullptr,
+                           &EdgeBBs);
+}
+
 /// True if this BB has only one unconditional jump.
 bool TailDuplicator::isSimpleBB(MachineBasicBlock *TailBB) {
   if (TailBB->succ_size() != 1)
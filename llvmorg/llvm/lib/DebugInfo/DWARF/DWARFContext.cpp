@@ -45,11 +45,13 @@
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/TargetRegistry.h"
+#include "llvm/Support/ThreadPool.h"
 #include "llvm/Support/raw_ostream.h"
 #include <algorithm>
 #include <cstdint>
 #include <deque>
 #include <map>
+#include <mutex>
 #include <string>
 #include <utility>
 #include <vector>
@@ -976,6 +978,46 @@ void DWARFContext::parseNormalUnits() {
   });
 }
 
+void DWARFContext::extractAllUnits(ThreadPoolStrategy S) {
+  parseNormalUnits();
+
+  // Abbreviation sets are found through DWARFDebugAbbrev, which caches its
+  // most recent lookup. Resolve the set of every unit up front so that the
+  // tasks below only consult the set cached in their own unit.
+  for (const auto &U : NormalUnits)
+    U->getAbbreviations();
+  if (!Line)
+    Line.reset(new DWARFDebugLine);
+
+  // Clients install handlers that are not expected to be reentrant.
+  std::mutex HandlerMutex;
+  std::function<void(Error)> SavedRecoverableErrorHandler =
+      RecoverableErrorHandler;
+  std::function<void(Error)> SavedWarningHandler = WarningHandler;
+  RecoverableErrorHandler = [&](Error E) {
+    std::lock_guard<std::mutex> Lock(HandlerMutex);
+    SavedRecoverableErrorHandler(std::move(E));
+  };
+  WarningHandler = [&](Error E) {
+    std::lock_guard<std::mutex> Lock(HandlerMutex);
+    SavedWarningHandler(std::move(E));
+  };
+
+  {
+    ThreadPool Pool(S);
+    for (const auto &U : NormalUnits)
+      Pool.async([this, &U]() {
+        U->getUnitDIE(/*ExtractUnitDIEOnly=*/false);
+        if (isa<DWARFCompileUnit>(U.get()))
+          getLineTableForUnit(U.get());
+      });
+    Pool.wait();
+  }
+
+  RecoverableErrorHandler = std::move(SavedRecoverableErrorHandler);
+  WarningHandler = std::move(SavedWarningHandler);
+}
+
 void DWARFContext::parseDWOUnits(bool Lazy) {
   if (!DWOUnits.empty())
     return;
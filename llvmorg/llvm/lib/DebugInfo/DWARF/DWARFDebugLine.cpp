@@ -559,6 +559,7 @@ void DWARFDebugLine::ParsingState::appendRowToMatrix() {
 
 const DWARFDebugLine::LineTable *
 DWARFDebugLine::getLineTable(uint64_t Offset) const {
+  std::lock_guard<std::mutex> Lock(LineTableMutex);
   LineTableConstIter Pos = LineTableMap.find(Offset);
   if (Pos != LineTableMap.end())
     return &Pos->second;
@@ -573,16 +574,25 @@ Expected<const DWARFDebugLine::LineTable *> DWARFDebugLine::getOrParseLineTable(
                        " is not a valid debug line section offset",
                        Offset);
 
-  std::pair<LineTableIter, bool> Pos =
-      LineTableMap.insert(LineTableMapTy::value_type(Offset, LineTable()));
-  LineTable *LT = &Pos.first->second;
-  if (Pos.second) {
-    if (Error Err =
-            LT->parse(DebugLineData, &Offset, Ctx, U, RecoverableErrorHandler))
-      return std::move(Err);
+  if (const LineTable *LT = getLineTable(Offset))
     return LT;
+
+  // Parse without holding the lock. If another thread got to the same table
+  // first, its result wins and ours is dropped.
+  LineTable NewLT;
+  Error Err =
+      NewLT.parse(DebugLineData, &Offset, Ctx, U, RecoverableErrorHandler);
+
+  std::lock_guard<std::mutex> Lock(LineTableMutex);
+  std::pair<LineTableIter, bool> Pos = LineTableMap.insert(
+      LineTableMapTy::value_type(Offset, std::move(NewLT)));
+  if (!Pos.second) {
+    consumeError(std::move(Err));
+    return &Pos.first->second;
   }
-  return LT;
+  if (Err)
+    return std::move(Err);
+  return &Pos.first->second;
 }
 
 static StringRef getOpcodeName(uint8_t Opcode, uint8_t OpcodeBase) {
@@ -437,18 +437,9 @@ Error DwarfTransformer::convert(uint32_t NumThreads) {
     // front before we start accessing any DIEs since there might be
     // cross compile unit references in the DWARF. If we don't do this we can
     // end up crashing.
+    DICtx.extractAllUnits(hardware_concurrency(NumThreads));
 
-    // We need to call getAbbreviations sequentially first so that getUnitDIE()
-    // only works with its local data.
-    for (const auto &CU : DICtx.compile_units())
-      CU->getAbbreviations();
-
-    // Now parse all DIEs in case we have cross compile unit references in a
-    // thread pool.
     ThreadPool pool(hardware_concurrency(NumThreads));
-    for (const auto &CU : DICtx.compile_units())
-      pool.async([&CU]() { CU->getUnitDIE(false /*CUDieOnly*/); });
-    pool.wait();
 
     // Now convert all DWARF to GSYM in a thread pool.
     std::mutex LogMutex;
@@ -0,0 +1,176 @@
+//===- GsymContext.cpp ----------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/DebugInfo/GSYM/GsymContext.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/DebugInfo/DWARF/DWARFContext.h"
+#include "llvm/DebugInfo/GSYM/DwarfTransformer.h"
+#include "llvm/DebugInfo/GSYM/GsymCreator.h"
+#include "llvm/DebugInfo/GSYM/ObjectFileTransformer.h"
+#include "llvm/Object/ObjectFile.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/raw_ostream.h"
+
+using namespace llvm;
+using namespace llvm::gsym;
+
+GsymContext::GsymContext(GsymReader Reader)
+    : DIContext(CK_GSYM), Reader(std::move(Reader)) {}
+
+void GsymContext::dump(raw_ostream &OS, DIDumpOptions DIDumpOpts) {
+  Reader.dump(OS);
+}
+
+/// Build the file name for a line entry according to \p Kind. Returns an empty
+/// string if the name was not requested or is not known.
+static std::string getFileName(StringRef Dir, StringRef Base,
+                               DILineInfoSpecifier::FileLineInfoKind Kind) {
+  using FileLineInfoKind = DILineInfoSpecifier::FileLineInfoKind;
+  if (Kind == FileLineInfoKind::None)
+    return std::string();
+  // GSYM only records the directory and base name of each file, the rest of
+  // the kinds all map to the joined path.
+  if (Kind == FileLineInfoKind::BaseNameOnly || Dir.empty())
+    return std::string(Base);
+  if (Base.empty())
+    return std::string(Dir);
+  SmallString<64> Path;
+  sys::path::append(Path, Dir, Base);
+  return std::string(Path.str());
+}
+
+static DILineInfo getLineInfo(const SourceLocation &Loc,
+                              DILineInfoSpecifier Specifier) {
+  DILineInfo Info;
+  if (Specifier.FNKind != DINameKind::None && !Loc.Name.empty())
+    Info.FunctionName = std::string(Loc.Name);
+  std::string FileName = getFileName(Loc.Dir, Loc.Base, Specifier.FLIKind);
+  if (!FileName.empty())
+    Info.FileName = std::move(FileName);
+  Info.Line = Loc.Line;
+  return Info;
+}
+
+DILineInfo GsymContext::getLineInfoForAddress(object::SectionedAddress Address,
+                                              DILineInfoSpecifier Specifier) {
+  Expected<LookupResult> LR = Reader.lookup(Address.Address);
+  if (!LR) {
+    consumeError(LR.takeError());
+    return DILineInfo();
+  }
+  // Functions converted from the symbol table have no line information.
+  if (LR->Locations.empty()) {
+    DILineInfo Info;
+    if (Specifier.FNKind != DINameKind::None && !LR->FuncName.empty())
+      Info.FunctionName = std::string(LR->FuncName);
+    return Info;
+  }
+  // The innermost (possibly inlined) function comes first.
+  return getLineInfo(LR->Locations.front(), Specifier);
+}
+
+DILineInfoTable
+GsymContext::getLineInfoForAddressRange(object::SectionedAddress Address,
+                                        uint64_t Size,
+                                        DILineInfoSpecifier Specifier) {
+  DILineInfoTable Table;
+  Expected<FunctionInfo> FI = Reader.getFunctionInfo(Address.Address);
+  if (!FI) {
+    consumeError(FI.takeError());
+    return Table;
+  }
+  if (!FI->OptLineTable)
+    return Table;
+
+  const uint64_t EndAddr = Address.Address + Size;
+  for (const LineEntry &LE : *FI->OptLineTable) {
+    if (LE.Addr < Address.Address || LE.Addr >= EndAddr)
+      continue;
+    DILineInfo Info;
+    if (Specifier.FNKind != DINameKind::None)
+      Info.FunctionName = std::string(Reader.getString(FI->Name));
+    if (Optional<FileEntry> File = Reader.getFile(LE.File)) {
+      std::string FileName =
+          getFileName(Reader.getString(File->Dir), Reader.getString(File->Base),
+                      Specifier.FLIKind);
+      if (!FileName.empty())
+        Info.FileName = std::move(FileName);
+    }
+    Info.Line = LE.Line;
+    Table.push_back(std::make_pair(LE.Addr, Info));
+  }
+  return Table;
+}
+
+DIInliningInfo
+GsymContext::getInliningInfoForAddress(object::SectionedAddress Address,
+                                       DILineInfoSpecifier Specifier) {
+  DIInliningInfo InliningInfo;
+  Expected<LookupResult> LR = Reader.lookup(Address.Address);
+  if (!LR) {
+    consumeError(LR.takeError());
+    return InliningInfo;
+  }
+  for (const SourceLocation &Loc : LR->Locations)
+    InliningInfo.addFrame(getLineInfo(Loc, Specifier));
+  return InliningInfo;
+}
+
+std::vector<DILocal>
+GsymContext::getLocalsForAddress(object::SectionedAddress Address) {
+  return std::vector<DILocal>();
+}
+
+llvm::Error gsym::createGsymFile(const object::ObjectFile &Obj, StringRef Path,
+                                 unsigned NumThreads) {
+  GsymCreator Gsym;
+  raw_ostream &Log = nulls();
+
+  // Only keep functions that live in sections containing instructions, see
+  // GsymCreator::SetValidTextRanges().
+  AddressRanges TextRanges;
+  for (const object::SectionRef &Sect : Obj.sections()) {
+    if (!Sect.isText() || Sect.getSize() == 0)
+      continue;
+    const uint64_t StartAddr = Sect.getAddress();
+    TextRanges.insert(AddressRange(StartAddr, StartAddr + Sect.getSize()));
+  }
+  if (!TextRanges.empty())
+    Gsym.SetValidTextRanges(TextRanges);
+
+  std::unique_ptr<DWARFContext> DICtx = DWARFContext::create(Obj);
+  if (!DICtx)
+    return createStringError(std::errc::invalid_argument,
+                             "unable to create DWARF context");
+  DwarfTransformer DT(*DICtx, Log, Gsym);
+  if (NumThreads == 0)
+    NumThreads = hardware_concurrency().compute_thread_count();
+  if (Error Err = DT.convert(NumThreads))
+    return Err;
+  if (Error Err = ObjectFileTransformer::convert(Obj, Log, Gsym))
+    return Err;
+  if (Error Err = Gsym.finalize(Log))
+    return Err;
+
+  SmallString<128> TempPath;
+  if (std::error_code EC =
+          sys::fs::createUniqueFile(Path + ".tmp%%%%%%", TempPath))
+    return createFileError(Path, EC);
+  support::endianness Endian =
+      Obj.makeTriple().isLittleEndian() ? support::little : support::big;
+  if (Error Err = Gsym.save(TempPath, Endian)) {
+    sys::fs::remove(TempPath);
+    return Err;
+  }
+  if (std::error_code EC = sys::fs::rename(TempPath, Path)) {
+    sys::fs::remove(TempPath);
+    return createFileError(Path, EC);
+  }
+  return Error::success();
+}
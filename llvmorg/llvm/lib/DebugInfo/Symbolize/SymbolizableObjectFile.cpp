@@ -16,6 +16,7 @@
 #include "llvm/ADT/Triple.h"
 #include "llvm/BinaryFormat/COFF.h"
 #include "llvm/DebugInfo/DWARF/DWARFContext.h"
+#include "llvm/DebugInfo/GSYM/GsymContext.h"
 #include "llvm/DebugInfo/Symbolize/SymbolizableModule.h"
 #include "llvm/Object/COFF.h"
 #include "llvm/Object/ObjectFile.h"
@@ -240,9 +241,11 @@ bool SymbolizableObjectFile::shouldOverrideWithSymbolTable(
   // When DWARF is used with -gline-tables-only / -gmlt, the symbol table gives
   // better answers for linkage names than the DIContext. Otherwise, we are
   // probably using PEs and PDBs, and we shouldn't do the override. PE files
-  // generally only contain the names of exported symbols.
+  // generally only contain the names of exported symbols. GSYM files created
+  // from DWARF inherit the same limitation.
   return FNKind == FunctionNameKind::LinkageName && UseSymbolTable &&
-         isa<DWARFContext>(DebugInfoContext.get());
+         (isa<DWARFContext>(DebugInfoContext.get()) ||
+          isa<gsym::GsymContext>(DebugInfoContext.get()));
 }
 
 DILineInfo
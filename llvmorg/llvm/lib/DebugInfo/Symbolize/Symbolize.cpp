@@ -17,6 +17,7 @@
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/BinaryFormat/COFF.h"
 #include "llvm/DebugInfo/DWARF/DWARFContext.h"
+#include "llvm/DebugInfo/GSYM/GsymContext.h"
 #include "llvm/DebugInfo/PDB/PDB.h"
 #include "llvm/DebugInfo/PDB/PDBContext.h"
 #include "llvm/Demangle/Demangle.h"
@@ -431,6 +432,46 @@ ObjectFile *LLVMSymbolizer::lookUpBuildIDObject(const std::string &Path,
   return DbgObjOrErr.get();
 }
 
+std::unique_ptr<DIContext>
+LLVMSymbolizer::lookUpGsymContext(const ObjectFile *Obj,
+                                  const ObjectFile *DbgObj) {
+  // GSYM files are only looked up by build ID, which identifies the exact
+  // build of an object independently of where it was installed.
+  const auto *ELFObj = dyn_cast<ELFObjectFileBase>(Obj);
+  if (!ELFObj)
+    return nullptr;
+  auto BuildID = getBuildID(ELFObj);
+  if (!BuildID || BuildID->size() < 2)
+    return nullptr;
+
+  // Use the same <xx>/<yyyy> layout as .build-id directories.
+  SmallString<128> GsymPath{Opts.GsymDirectory};
+  sys::path::append(GsymPath, toHex((*BuildID)[0], /*LowerCase=*/true),
+                    toHex(BuildID->slice(1), /*LowerCase=*/true) + ".gsym");
+  if (!sys::fs::exists(GsymPath)) {
+    if (!Opts.CreateGsym)
+      return nullptr;
+    // Failing to create the file is not an error, the DWARF is still there.
+    if (sys::fs::create_directories(sys::path::parent_path(GsymPath)))
+      return nullptr;
+    if (Error Err = gsym::createGsymFile(*DbgObj, GsymPath)) {
+      consumeError(std::move(Err));
+      return nullptr;
+    }
+  }
+
+  auto ReaderOrErr = gsym::GsymReader::openFile(GsymPath);
+  if (!ReaderOrErr) {
+    consumeError(ReaderOrErr.takeError());
+    return nullptr;
+  }
+  // Don't trust a file whose recorded UUID doesn't match the object.
+  const gsym::Header &Hdr = ReaderOrErr->getHeader();
+  if (ArrayRef<uint8_t>(Hdr.UUID, Hdr.UUIDSize) != *BuildID)
+    return nullptr;
+  return std::make_unique<gsym::GsymContext>(std::move(*ReaderOrErr));
+}
+
 Expected<LLVMSymbolizer::ObjectPair>
 LLVMSymbolizer::getOrCreateObjectPair(const std::string &Path,
                                       const std::string &ArchName) {
@@ -567,6 +608,8 @@ LLVMSymbolizer::getOrCreateModuleInfo(const std::string &ModuleName) {
       Context.reset(new PDBContext(*CoffObject, std::move(Session)));
     }
   }
+  if (!Context && !Opts.GsymDirectory.empty())
+    Context = lookUpGsymContext(Objects.first, Objects.second);
   if (!Context)
     Context = DWARFContext::create(*Objects.second, nullptr, Opts.DWPName);
   return createModuleInfo(Objects.first, std::move(Context), ModuleName);
@@ -0,0 +1,153 @@
+//===------- LocalObjectCache.cpp - On-disk ObjectCache for ORC -----------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ExecutionEngine/Orc/LocalObjectCache.h"
+
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Bitcode/BitcodeWriter.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/Debug.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/SHA1.h"
+#include "llvm/Support/raw_ostream.h"
+
+#define DEBUG_TYPE "orc"
+
+namespace llvm {
+namespace orc {
+
+Expected<std::unique_ptr<LocalObjectCache>>
+LocalObjectCache::Create(StringRef CacheDir, StringRef ContextKey,
+                         CachePruningPolicy Policy) {
+  if (auto EC = sys::fs::create_directories(CacheDir))
+    return createFileError(CacheDir, EC);
+
+  std::unique_ptr<LocalObjectCache> Cache(new LocalObjectCache(
+      CacheDir.str(), ContextKey.str(), std::move(Policy)));
+  Cache->prune();
+  return std::move(Cache);
+}
+
+bool LocalObjectCache::prune() { return pruneCache(CacheDir, Policy); }
+
+std::string LocalObjectCache::computeKey(const Module &M) const {
+  SmallVector<char, 0> Bitcode;
+  {
+    raw_svector_ostream BCStream(Bitcode);
+    WriteBitcodeToFile(M, BCStream);
+  }
+
+  SHA1 Hasher;
+  Hasher.update(ContextKey);
+  // Keep the context key and the bitcode apart in the hashed stream.
+  Hasher.update(StringRef("\0", 1));
+  Hasher.update(StringRef(Bitcode.data(), Bitcode.size()));
+  return toHex(Hasher.final());
+}
+
+std::string LocalObjectCache::getEntryPath(StringRef Key) const {
+  // This choice of file name allows the cache to be pruned (see pruneCache()
+  // in include/llvm/Support/CachePruning.h).
+  SmallString<128> EntryPath;
+  sys::path::append(EntryPath, CacheDir, "llvmcache-" + Key);
+  return std::string(EntryPath.str());
+}
+
+std::unique_ptr<MemoryBuffer> LocalObjectCache::getObject(const Module *M) {
+  std::string Key = computeKey(*M);
+  std::string EntryPath = getEntryPath(Key);
+
+  // Update the access time so that the pruner sees this entry as recently
+  // used.
+  Expected<sys::fs::file_t> FDOrErr =
+      sys::fs::openNativeFileForRead(EntryPath, sys::fs::OF_UpdateAtime);
+  if (FDOrErr) {
+    ErrorOr<std::unique_ptr<MemoryBuffer>> MBOrErr =
+        MemoryBuffer::getOpenFile(*FDOrErr, EntryPath,
+                                  /*FileSize=*/-1,
+                                  /*RequiresNullTerminator=*/false);
+    sys::fs::closeFile(*FDOrErr);
+    if (MBOrErr) {
+      LLVM_DEBUG(dbgs() << "LocalObjectCache: hit " << EntryPath << "\n");
+      std::lock_guard<std::mutex> Lock(PendingKeysMutex);
+      PendingKeys.erase(M);
+      return std::move(*MBOrErr);
+    }
+  } else
+    consumeError(FDOrErr.takeError());
+
+  // A missing or unreadable entry (e.g. one being deleted by a concurrent
+  // pruner) is treated as a miss: the object will be recompiled and
+  // republished.
+  LLVM_DEBUG(dbgs() << "LocalObjectCache: miss " << EntryPath << "\n");
+  std::lock_guard<std::mutex> Lock(PendingKeysMutex);
+  PendingKeys[M] = std::move(Key);
+  return nullptr;
+}
+
+void LocalObjectCache::notifyObjectCompiled(const Module *M,
+                                            MemoryBufferRef Obj) {
+  std::string Key;
+  {
+    std::lock_guard<std::mutex> Lock(PendingKeysMutex);
+    auto I = PendingKeys.find(M);
+    if (I != PendingKeys.end()) {
+      Key = std::move(I->second);
+      PendingKeys.erase(I);
+    }
+  }
+  if (Key.empty())
+    Key = computeKey(*M);
+  std::string EntryPath = getEntryPath(Key);
+
+  // Write to a temporary file first so that other processes never observe a
+  // partially written entry. The temporary name deliberately lacks the
+  // "llvmcache-" prefix so that the pruner leaves it alone.
+  SmallString<128> TempFileModel;
+  sys::path::append(TempFileModel, CacheDir, "Orc-%%%%%%.tmp.o");
+  Expected<sys::fs::TempFile> Temp = sys::fs::TempFile::create(
+      TempFileModel, sys::fs::owner_read | sys::fs::owner_write);
+  if (!Temp) {
+    // Failing to populate the cache is not fatal: the object was compiled and
+    // will be used by this process regardless.
+    Error E = Temp.takeError();
+    LLVM_DEBUG(dbgs() << "LocalObjectCache: can't create temporary file: "
+                      << E << "\n");
+    consumeError(std::move(E));
+    return;
+  }
+
+  {
+    raw_fd_ostream OS(Temp->FD, /*shouldClose=*/false);
+    OS << Obj.getBuffer();
+    OS.flush();
+    if (OS.has_error()) {
+      OS.clear_error();
+      consumeError(Temp->discard());
+      return;
+    }
+  }
+
+  // On POSIX systems this atomically replaces an existing entry, which is
+  // harmless since another process compiling the same key produced an
+  // equivalent object.
+  if (Error E = Temp->keep(EntryPath)) {
+    LLVM_DEBUG(dbgs() << "LocalObjectCache: can't publish " << EntryPath
+                      << ": " << E << "\n");
+    consumeError(std::move(E));
+    consumeError(Temp->discard());
+    return;
+  }
+  LLVM_DEBUG(dbgs() << "LocalObjectCache: stored " << EntryPath << "\n");
+}
+
+} // end namespace orc
+} // end namespace llvm
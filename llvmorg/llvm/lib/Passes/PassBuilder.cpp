@@ -178,6 +178,7 @@
 #include "llvm/Transforms/Utils/AddDiscriminators.h"
 #include "llvm/Transforms/Utils/AssumeBundleBuilder.h"
 #include "llvm/Transforms/Utils/BreakCriticalEdges.h"
+#include "llvm/Transforms/Utils/BudgetedFunctionPipeline.h"
 #include "llvm/Transforms/Utils/CanonicalizeAliases.h"
 #include "llvm/Transforms/Utils/CanonicalizeFreezeInLoops.h"
 #include "llvm/Transforms/Utils/EntryExitInstrumenter.h"
@@ -188,6 +189,7 @@
 #include "llvm/Transforms/Utils/LowerInvoke.h"
 #include "llvm/Transforms/Utils/Mem2Reg.h"
 #include "llvm/Transforms/Utils/NameAnonGlobals.h"
+#include "llvm/Transforms/Utils/ParallelFunctionPassAdaptor.h"
 #include "llvm/Transforms/Utils/SymbolRewriter.h"
 #include "llvm/Transforms/Vectorize/LoadStoreVectorizer.h"
 #include "llvm/Transforms/Vectorize/LoopVectorize.h"
@@ -225,7 +227,10 @@ static cl::opt<InliningAdvisorMode> UseInlineAdvisor(
                clEnumValN(InliningAdvisorMode::Development, "development",
                           "Use development mode (runtime-loadable model)."),
                clEnumValN(InliningAdvisorMode::Release, "release",
-                          "Use release mode (AOT-compiled model).")));
+                          "Use release mode (AOT-compiled model)."),
+               clEnumValN(InliningAdvisorMode::Embedded, "embedded",
+                          "Use embedded mode (built-in or loaded linear "
+                          "model).")));
 
 static cl::opt<bool> EnableGVNSink(
     "enable-npm-gvn-sink", cl::init(false), cl::Hidden,
@@ -243,6 +248,8 @@ static cl::opt<bool> EnableSyntheticCounts(
 static const Regex DefaultAliasRegex(
     "^(default|thinlto-pre-link|thinlto|lto-pre-link|lto)<(O[0123sz])>$");
 
+static const Regex JITAliasRegex("^jit<(baseline|optimizing|peak)>$");
+
 // This option is used in simplifying testing SampleFDO optimizations for
 // profile loading.
 static cl::opt<bool>
@@ -255,6 +262,16 @@ static cl::opt<bool>
                             cl::Hidden,
                             cl::desc("Enable inline deferral during PGO"));
 
+static cl::opt<unsigned> ParallelFunctionPassThreads(
+    "parallel-function-passes", cl::init(0), cl::Hidden,
+    cl::desc("Run the function passes of the module optimization pipeline "
+             "on copies of the module on this many threads (0 = in place)"));
+
+static cl::opt<unsigned> JITFunctionBudgetUs(
+    "jit-function-budget-us", cl::init(0), cl::Hidden,
+    cl::desc("Skip the remaining stages of the JIT pipelines for a function "
+             "once this many microseconds were spent on it (0 = no limit)"));
+
 PipelineTuningOptions::PipelineTuningOptions() {
   LoopInterleaving = true;
   LoopVectorization = true;
@@ -265,6 +282,8 @@ PipelineTuningOptions::PipelineTuningOptions() {
   LicmMssaOptCap = SetLicmMssaOptCap;
   LicmMssaNoAccForPromotionCap = SetLicmMssaNoAccForPromotionCap;
   CallGraphProfile = true;
+  ParallelFunctionPasses = ParallelFunctionPassThreads;
+  JITFunctionBudget = JITFunctionBudgetUs;
 }
 
 extern cl::opt<bool> EnableHotColdSplit;
@@ -1032,63 +1051,9 @@ ModulePassManager PassBuilder::buildModuleSimplificationPipeline(
   return MPM;
 }
 
-ModulePassManager PassBuilder::buildModuleOptimizationPipeline(
-    OptimizationLevel Level, bool DebugLogging, bool LTOPreLink) {
-  ModulePassManager MPM(DebugLogging);
-
-  // Optimize globals now that the module is fully simplified.
-  MPM.addPass(GlobalOptPass());
-  MPM.addPass(GlobalDCEPass());
-
-  // Run partial inlining pass to partially inline functions that have
-  // large bodies.
-  if (RunPartialInlining)
-    MPM.addPass(PartialInlinerPass());
-
-  // Remove avail extern fns and globals definitions since we aren't compiling
-  // an object file for later LTO. For LTO we want to preserve these so they
-  // are eligible for inlining at link-time. Note if they are unreferenced they
-  // will be removed by GlobalDCE later, so this only impacts referenced
-  // available externally globals. Eventually they will be suppressed during
-  // codegen, but eliminating here enables more opportunity for GlobalDCE as it
-  // may make globals referenced by available external functions dead and saves
-  // running remaining passes on the eliminated functions. These should be
-  // preserved during prelinking for link-time inlining decisions.
-  if (!LTOPreLink)
-    MPM.addPass(EliminateAvailableExternallyPass());
-
-  if (EnableOrderFileInstrumentation)
-    MPM.addPass(InstrOrderFilePass());
-
-  // Do RPO function attribute inference across the module to forward-propagate
-  // attributes where applicable.
-  // FIXME: Is this really an optimization rather than a canonicalization?
-  MPM.addPass(ReversePostOrderFunctionAttrsPass());
-
-  // Do a post inline PGO instrumentation and use pass. This is a context
-  // sensitive PGO pass. We don't want to do this in LTOPreLink phrase as
-  // cross-module inline has not been done yet. The context sensitive
-  // instrumentation is after all the inlines are done.
-  if (!LTOPreLink && PGOOpt) {
-    if (PGOOpt->CSAction == PGOOptions::CSIRInstr)
-      addPGOInstrPasses(MPM, DebugLogging, Level, /* RunProfileGen */ true,
-                        /* IsCS */ true, PGOOpt->CSProfileGenFile,
-                        PGOOpt->ProfileRemappingFile);
-    else if (PGOOpt->CSAction == PGOOptions::CSIRUse)
-      addPGOInstrPasses(MPM, DebugLogging, Level, /* RunProfileGen */ false,
-                        /* IsCS */ true, PGOOpt->ProfileFile,
-                        PGOOpt->ProfileRemappingFile);
-  }
-
-  // Re-require GloblasAA here prior to function passes. This is particularly
-  // useful as the above will have inlined, DCE'ed, and function-attr
-  // propagated everything. We should at this point have a reasonably minimal
-  // and richly annotated call graph. By computing aliasing and mod/ref
-  // information for all local globals here, the late loop passes and notably
-  // the vectorizer will be able to use them to help recognize vectorizable
-  // memory operations.
-  MPM.addPass(RequireAnalysisPass<GlobalsAA, Module>());
-
+FunctionPassManager
+PassBuilder::buildFunctionOptimizationPipeline(OptimizationLevel Level,
+                                               bool DebugLogging) {
   FunctionPassManager OptimizePM(DebugLogging);
   OptimizePM.addPass(Float2IntPass());
   OptimizePM.addPass(LowerConstantIntrinsicsPass());
@@ -1175,12 +1140,6 @@ ModulePassManager PassBuilder::buildModuleOptimizationPipeline(
   // alignment information, try to re-derive it here.
   OptimizePM.addPass(AlignmentFromAssumptionsPass());
 
-  // Split out cold code. Splitting is done late to avoid hiding context from
-  // other optimizations and inadvertently regressing performance. The tradeoff
-  // is that this has a higher code size cost than splitting early.
-  if (EnableHotColdSplit && !LTOPreLink)
-    MPM.addPass(HotColdSplittingPass());
-
   // LoopSink pass sinks instructions hoisted by LICM, which serves as a
   // canonicalization pass that enables other optimizations. As a result,
   // LoopSink pass needs to be a very late IR pass to avoid undoing LICM
@@ -1207,8 +1166,89 @@ ModulePassManager PassBuilder::buildModuleOptimizationPipeline(
   if (PTO.Coroutines)
     OptimizePM.addPass(CoroCleanupPass());
 
+  return OptimizePM;
+}
+
+ModulePassManager PassBuilder::buildModuleOptimizationPipeline(
+    OptimizationLevel Level, bool DebugLogging, bool LTOPreLink) {
+  ModulePassManager MPM(DebugLogging);
+
+  // Optimize globals now that the module is fully simplified.
+  MPM.addPass(GlobalOptPass());
+  MPM.addPass(GlobalDCEPass());
+
+  // Run partial inlining pass to partially inline functions that have
+  // large bodies.
+  if (RunPartialInlining)
+    MPM.addPass(PartialInlinerPass());
+
+  // Remove avail extern fns and globals definitions since we aren't compiling
+  // an object file for later LTO. For LTO we want to preserve these so they
+  // are eligible for inlining at link-time. Note if they are unreferenced they
+  // will be removed by GlobalDCE later, so this only impacts referenced
+  // available externally globals. Eventually they will be suppressed during
+  // codegen, but eliminating here enables more opportunity for GlobalDCE as it
+  // may make globals referenced by available external functions dead and saves
+  // running remaining passes on the eliminated functions. These should be
+  // preserved during prelinking for link-time inlining decisions.
+  if (!LTOPreLink)
+    MPM.addPass(EliminateAvailableExternallyPass());
+
+  if (EnableOrderFileInstrumentation)
+    MPM.addPass(InstrOrderFilePass());
+
+  // Do RPO function attribute inference across the module to forward-propagate
+  // attributes where applicable.
+  // FIXME: Is this really an optimization rather than a canonicalization?
+  MPM.addPass(ReversePostOrderFunctionAttrsPass());
+
+  // Do a post inline PGO instrumentation and use pass. This is a context
+  // sensitive PGO pass. We don't want to do this in LTOPreLink phrase as
+  // cross-module inline has not been done yet. The context sensitive
+  // instrumentation is after all the inlines are done.
+  if (!LTOPreLink && PGOOpt) {
+    if (PGOOpt->CSAction == PGOOptions::CSIRInstr)
+      addPGOInstrPasses(MPM, DebugLogging, Level, /* RunProfileGen */ true,
+                        /* IsCS */ true, PGOOpt->CSProfileGenFile,
+                        PGOOpt->ProfileRemappingFile);
+    else if (PGOOpt->CSAction == PGOOptions::CSIRUse)
+      addPGOInstrPasses(MPM, DebugLogging, Level, /* RunProfileGen */ false,
+                        /* IsCS */ true, PGOOpt->ProfileFile,
+                        PGOOpt->ProfileRemappingFile);
+  }
+
+  // Re-require GloblasAA here prior to function passes. This is particularly
+  // useful as the above will have inlined, DCE'ed, and function-attr
+  // propagated everything. We should at this point have a reasonably minimal
+  // and richly annotated call graph. By computing aliasing and mod/ref
+  // information for all local globals here, the late loop passes and notably
+  // the vectorizer will be able to use them to help recognize vectorizable
+  // memory operations.
+  MPM.addPass(RequireAnalysisPass<GlobalsAA, Module>());
+
+  // Split out cold code. Splitting is done late to avoid hiding context from
+  // other optimizations and inadvertently regressing performance. The tradeoff
+  // is that this has a higher code size cost than splitting early.
+  if (EnableHotColdSplit && !LTOPreLink)
+    MPM.addPass(HotColdSplittingPass());
+
   // Add the core optimizing pipeline.
-  MPM.addPass(createModuleToFunctionPassAdaptor(std::move(OptimizePM)));
+  if (PTO.ParallelFunctionPasses)
+    MPM.addPass(ParallelModuleToFunctionPassAdaptor(
+        [this, Level, DebugLogging] {
+          return buildFunctionOptimizationPipeline(Level, DebugLogging);
+        },
+        [this](ModuleAnalysisManager &MAM, FunctionAnalysisManager &FAM,
+               LoopAnalysisManager &LAM) {
+          FAM.registerPass([&] { return buildDefaultAAPipeline(); });
+          registerModuleAnalyses(MAM);
+          registerFunctionAnalyses(FAM);
+          registerLoopAnalyses(LAM);
+        },
+        PTO.ParallelFunctionPasses));
+  else
+    MPM.addPass(createModuleToFunctionPassAdaptor(
+        buildFunctionOptimizationPipeline(Level, DebugLogging)));
 
   for (auto &C : OptimizerLastEPCallbacks)
     C(MPM, Level);
@@ -1584,6 +1624,142 @@ PassBuilder::buildLTODefaultPipeline(OptimizationLevel Level, bool DebugLogging,
   return MPM;
 }
 
+FunctionPassManager
+PassBuilder::buildJITFunctionPipeline(JITTier Tier,
+                                      std::shared_ptr<FunctionTimeBudget> Budget,
+                                      bool DebugLogging) {
+  // Each stage is cheap enough for the budget to be checked often, and leaves
+  // code that is better than after the previous one, so that stopping after
+  // any of them is fine.
+  BudgetedFunctionPipeline Stages(std::move(Budget));
+
+  // Cleanup: form SSA and fold what the frontend left behind, visiting each
+  // instruction about once.
+  FunctionPassManager CleanupPM(DebugLogging);
+  CleanupPM.addPass(SROA());
+  CleanupPM.addPass(EarlyCSEPass());
+  CleanupPM.addPass(InstCombinePass(/*MaxIterations=*/1,
+                                    /*MaxVisitsPerInst=*/1));
+  CleanupPM.addPass(SimplifyCFGPass());
+  Stages.addStage(std::move(CleanupPM));
+
+  if (Tier != JITTier::Baseline) {
+    // Scalar optimizations with a bounded cost per instruction.
+    FunctionPassManager ScalarPM(DebugLogging);
+    ScalarPM.addPass(EarlyCSEPass(/*UseMemorySSA=*/true));
+    ScalarPM.addPass(CorrelatedValuePropagationPass());
+    ScalarPM.addPass(ReassociatePass());
+    ScalarPM.addPass(InstCombinePass(/*MaxIterations=*/2,
+                                     /*MaxVisitsPerInst=*/4));
+    ScalarPM.addPass(SimplifyCFGPass());
+    Stages.addStage(std::move(ScalarPM));
+
+    // Hoist the loop invariants, which matters most for the dispatch loops of
+    // interpreters. Rotation lets LICM hoist out of while loops.
+    FunctionPassManager LoopPM(DebugLogging);
+    LoopPassManager LPM(DebugLogging);
+    LPM.addPass(LoopRotatePass());
+    LPM.addPass(
+        LICMPass(PTO.LicmMssaOptCap, PTO.LicmMssaNoAccForPromotionCap));
+    LoopPM.addPass(
+        RequireAnalysisPass<OptimizationRemarkEmitterAnalysis, Function>());
+    LoopPM.addPass(createFunctionToLoopPassAdaptor(
+        std::move(LPM), EnableMSSALoopDependency, DebugLogging));
+    LoopPM.addPass(InstCombinePass(/*MaxIterations=*/1,
+                                   /*MaxVisitsPerInst=*/1));
+    LoopPM.addPass(SimplifyCFGPass());
+    Stages.addStage(std::move(LoopPM));
+  }
+
+  if (Tier == JITTier::Peak) {
+    // Redundancy and dead code elimination across the whole function.
+    FunctionPassManager RedundancyPM(DebugLogging);
+    RedundancyPM.addPass(GVN());
+    RedundancyPM.addPass(MemCpyOptPass());
+    RedundancyPM.addPass(SCCPPass());
+    RedundancyPM.addPass(DSEPass());
+    RedundancyPM.addPass(ADCEPass());
+    RedundancyPM.addPass(InstCombinePass());
+    RedundancyPM.addPass(SimplifyCFGPass());
+    Stages.addStage(std::move(RedundancyPM));
+
+    // Loop transforms last: the most expensive, and the least often
+    // profitable.
+    FunctionPassManager VectorizePM(DebugLogging);
+    VectorizePM.addPass(createFunctionToLoopPassAdaptor(
+        LoopFullUnrollPass(/*OptLevel=*/2,
+                           /*OnlyWhenForced=*/!PTO.LoopUnrolling,
+                           PTO.ForgetAllSCEVInLoopUnroll),
+        /*UseMemorySSA=*/false, DebugLogging));
+    VectorizePM.addPass(SROA());
+    VectorizePM.addPass(LoopVectorizePass(
+        LoopVectorizeOptions(!PTO.LoopInterleaving, !PTO.LoopVectorization)));
+    if (PTO.SLPVectorization)
+      VectorizePM.addPass(SLPVectorizerPass());
+    VectorizePM.addPass(VectorCombinePass());
+    VectorizePM.addPass(InstCombinePass(/*MaxIterations=*/1,
+                                        /*MaxVisitsPerInst=*/1));
+    VectorizePM.addPass(SimplifyCFGPass());
+    Stages.addStage(std::move(VectorizePM));
+  }
+
+  FunctionPassManager FPM(DebugLogging);
+  FPM.addPass(std::move(Stages));
+  return FPM;
+}
+
+ModulePassManager PassBuilder::buildJITPipeline(JITTier Tier,
+                                                bool DebugLogging) {
+  ModulePassManager MPM(DebugLogging);
+
+  // One budget per function for the whole pipeline, whichever stages of the
+  // CGSCC walk and of the function pipeline run on it.
+  auto Budget = std::make_shared<FunctionTimeBudget>(
+      std::chrono::microseconds(PTO.JITFunctionBudget));
+  MPM.addPass(ResetFunctionTimeBudgetPass(Budget));
+
+  // always_inline is a request of the frontend, honour it at every tier.
+  MPM.addPass(AlwaysInlinerPass(/*InsertLifetimeIntrinsics=*/false));
+
+  if (Tier == JITTier::Peak) {
+    ModuleInlinerWrapperPass MIWP(
+        getInlineParamsFromOptLevel(OptimizationLevel::O2), DebugLogging,
+        UseInlineAdvisor, MaxDevirtIterations);
+    MIWP.addRequiredModuleAnalysis<ProfileSummaryAnalysis>();
+    CGSCCPassManager &MainCGPipeline = MIWP.getPM();
+    MainCGPipeline.addPass(PostOrderFunctionAttrsPass());
+    // Simplify the callees before they are inlined, as the default pipelines
+    // do, but only with the passes of the optimizing tier. The inliner itself
+    // is not budgeted: the inline threshold bounds its cost per call site.
+    MainCGPipeline.addPass(createCGSCCToFunctionPassAdaptor(
+        buildJITFunctionPipeline(JITTier::Optimizing, Budget, DebugLogging)));
+    MPM.addPass(std::move(MIWP));
+  }
+
+  if (PTO.ParallelFunctionPasses)
+    MPM.addPass(ParallelModuleToFunctionPassAdaptor(
+        [this, Tier, Budget, DebugLogging] {
+          return buildJITFunctionPipeline(Tier, Budget, DebugLogging);
+        },
+        [this](ModuleAnalysisManager &MAM, FunctionAnalysisManager &FAM,
+               LoopAnalysisManager &LAM) {
+          FAM.registerPass([&] { return buildDefaultAAPipeline(); });
+          registerModuleAnalyses(MAM);
+          registerFunctionAnalyses(FAM);
+          registerLoopAnalyses(LAM);
+        },
+        PTO.ParallelFunctionPasses));
+  else
+    MPM.addPass(createModuleToFunctionPassAdaptor(
+        buildJITFunctionPipeline(Tier, Budget, DebugLogging)));
+
+  // Drop the internal functions that were inlined everywhere.
+  if (Tier == JITTier::Peak)
+    MPM.addPass(GlobalDCEPass());
+
+  return MPM;
+}
+
 AAManager PassBuilder::buildDefaultAAPipeline() {
   AAManager AA;
 
@@ -1918,6 +2094,8 @@ static bool isModulePassName(StringRef Name, CallbacksT &Callbacks) {
   // Manually handle aliases for pre-configured pipeline fragments.
   if (startsWithDefaultPipelineAliasPrefix(Name))
     return DefaultAliasRegex.match(Name);
+  if (Name.startswith("jit<"))
+    return JITAliasRegex.match(Name);
 
   // Explicitly handle pass manager names.
   if (Name == "module")
@@ -2194,6 +2372,21 @@ Error PassBuilder::parseModulePass(ModulePassManager &MPM,
     return Error::success();
   }
 
+  if (Name.startswith("jit<")) {
+    SmallVector<StringRef, 2> Matches;
+    if (!JITAliasRegex.match(Name, &Matches))
+      return make_error<StringError>(
+          formatv("unknown JIT pipeline alias '{0}'", Name).str(),
+          inconvertibleErrorCode());
+
+    JITTier Tier = StringSwitch<JITTier>(Matches[1])
+                       .Case("baseline", JITTier::Baseline)
+                       .Case("optimizing", JITTier::Optimizing)
+                       .Case("peak", JITTier::Peak);
+    MPM.addPass(buildJITPipeline(Tier, DebugLogging));
+    return Error::success();
+  }
+
   // Finally expand the basic registered passes from the .inc file.
 #define MODULE_PASS(NAME, CREATE_PASS)                                         \
   if (Name == NAME) {                                                          \
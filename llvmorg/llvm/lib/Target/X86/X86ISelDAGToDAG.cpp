@@ -250,6 +250,8 @@ namespace {
 
     bool isProfitableToFormMaskedOp(SDNode *N) const;
 
+    bool isTailCallLoadFoldable(const SDNode *N) const;
+
     /// Implement addressing mode selection for inline asm expressions.
     bool SelectInlineAsmMemoryOperand(const SDValue &Op,
                                       unsigned ConstraintID,
@@ -721,6 +723,27 @@ bool X86DAGToDAGISel::isProfitableToFormMaskedOp(SDNode *N) const {
   return N->getOperand(1).hasOneUse();
 }
 
+/// Return true if a load of the callee may be folded into the 64-bit tail
+/// call \p N. The base and index of the address need registers that are
+/// neither callee-saved nor carrying an argument.
+bool X86DAGToDAGISel::isTailCallLoadFoldable(const SDNode *N) const {
+  // GR64_TC leaves room for 6 argument registers. Barebone functions have no
+  // callee-saved registers, so the address may use any GPR that is not
+  // reserved: RSP, RBP and the no-clobber hardware registers.
+  unsigned MaxRegs = 6;
+  if (MF->getFunction().getCallingConv() == CallingConv::Barebone) {
+    unsigned NumReserved = 2 + MF->getNoClobberHWReg().size();
+    MaxRegs = NumReserved + 2 < 16 ? 16 - NumReserved - 2 : 0;
+  }
+
+  // X86tcret args: (*chain, ptr, imm, regs..., glue)
+  unsigned NumRegs = 0;
+  for (unsigned i = 3, e = N->getNumOperands(); i != e; ++i)
+    if (isa<RegisterSDNode>(N->getOperand(i)) && ++NumRegs > MaxRegs)
+      return false;
+  return true;
+}
+
 /// Replace the original chain operand of the call with
 /// load's chain operand and move load below the call's chain operand.
 static void moveBelowOrigChain(SelectionDAG *CurDAG, SDValue Load,
@@ -757,8 +780,11 @@ static void moveBelowOrigChain(SelectionDAG *CurDAG, SDValue Load,
 /// moved below CALLSEQ_START and the chains leading up to the call.
 /// Return the CALLSEQ_START by reference as a second output.
 /// In the case of a tail call, there isn't a callseq node between the call
-/// chain and the load.
-static bool isCalleeLoad(SDValue Callee, SDValue &Chain, bool HasCallSeq) {
+/// chain and the load. If \p SkipArgCopies is set, the CopyToReg nodes that
+/// pass the tail call arguments are looked through, and the first of them is
+/// returned instead.
+static bool isCalleeLoad(SDValue Callee, SDValue &Chain, bool HasCallSeq,
+                         bool SkipArgCopies = false) {
   // The transformation is somewhat dangerous if the call's chain was glued to
   // the call. After MoveBelowOrigChain the load is moved between the call and
   // the chain, this can create a cycle if the load is not folded. So it is
@@ -779,6 +805,11 @@ static bool isCalleeLoad(SDValue Callee, SDValue &Chain, bool HasCallSeq) {
     Chain = Chain.getOperand(0);
   }
 
+  while (SkipArgCopies && Chain.getOpcode() == ISD::CopyToReg &&
+         Chain.getOperand(0).getOpcode() == ISD::CopyToReg &&
+         Chain.getOperand(0).hasOneUse())
+    Chain = Chain.getOperand(0);
+
   if (!Chain.getNumOperands())
     return false;
   // Since we are not checking for AA here, conservatively abort if the chain
@@ -1116,9 +1147,16 @@ void X86DAGToDAGISel::PreprocessISelDAG() {
       ///       \      /
       ///       [CALL]
       bool HasCallSeq = N->getOpcode() == X86ISD::CALL;
+      // Barebone tail calls pass everything in registers and dispatch through
+      // a loaded pointer. Move the load past the argument copies as well, if
+      // the TCRETURNmi64 pattern is certain to fold it.
+      bool SkipArgCopies =
+          N->getOpcode() == X86ISD::TC_RETURN && Subtarget->is64Bit() &&
+          MF->getFunction().getCallingConv() == CallingConv::Barebone &&
+          isTailCallLoadFoldable(N);
       SDValue Chain = N->getOperand(0);
       SDValue Load  = N->getOperand(1);
-      if (!isCalleeLoad(Load, Chain, HasCallSeq))
+      if (!isCalleeLoad(Load, Chain, HasCallSeq, SkipArgCopies))
         continue;
       moveBelowOrigChain(CurDAG, Load, SDValue(N, 0), Chain);
       ++NumLoadMoved;
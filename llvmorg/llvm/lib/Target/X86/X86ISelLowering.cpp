@@ -32198,6 +32198,20 @@ static unsigned getOpcodeForIndirectThunk(unsigned RPOpc) {
   llvm_unreachable("not indirect thunk opcode");
 }
 
+static unsigned getOpcodeForLFenceIndirectBranch(unsigned RPOpc) {
+  switch (RPOpc) {
+  case X86::INDIRECT_THUNK_CALL32:
+    return X86::CALL32r;
+  case X86::INDIRECT_THUNK_CALL64:
+    return X86::CALL64r;
+  case X86::INDIRECT_THUNK_TCRETURN32:
+    return X86::TCRETURNri;
+  case X86::INDIRECT_THUNK_TCRETURN64:
+    return X86::TCRETURNri64;
+  }
+  llvm_unreachable("not indirect thunk opcode");
+}
+
 static const char *getIndirectThunkSymbol(const X86Subtarget &Subtarget,
                                           unsigned Reg) {
   if (Subtarget.useRetpolineExternalThunk()) {
@@ -32280,13 +32294,33 @@ X86TargetLowering::EmitLoweredIndirectThunk(MachineInstr &MI,
   // already a register use operand to the call to hold the callee. If none
   // are available, use EDI instead. EDI is chosen because EBX is the PIC base
   // register and ESI is the base pointer to realigned stack frames with VLAs.
-  SmallVector<unsigned, 3> AvailableRegs;
+  // Without a thunk, any other caller-saved register will do as well.
+  SmallVector<unsigned, 9> AvailableRegs;
   if (Subtarget.is64Bit())
     AvailableRegs.push_back(X86::R11);
   else
     AvailableRegs.append({X86::EAX, X86::ECX, X86::EDX, X86::EDI});
+  if (Subtarget.is64Bit() && Subtarget.useLFenceIndirectBranches())
+    AvailableRegs.append({X86::R10, X86::R9, X86::R8, X86::RDI, X86::RSI,
+                          X86::RDX, X86::RCX, X86::RAX});
 
-  // Zero out any registers that are already used.
+  // Zero out any registers that are already used or reserved, as the
+  // barebone no-clobber registers are.
+  MachineFunction &MF = *BB->getParent();
+  const X86RegisterInfo *TRI = Subtarget.getRegisterInfo();
+  BitVector Reserved = TRI->getReservedRegs(MF);
+  for (unsigned &Reg : AvailableRegs)
+    if (Reserved.test(Reg))
+      Reg = 0;
+  // Without a thunk the register is the target of the jump itself, so it must
+  // not be callee-saved: the epilogue of a tail call would restore it before
+  // the jump. The callee-saved registers of Win64, regcall, preserve_most and
+  // preserve_all overlap the candidates above.
+  if (Subtarget.useLFenceIndirectBranches())
+    for (const MCPhysReg *CSR = TRI->getCalleeSavedRegs(&MF); *CSR; ++CSR)
+      for (unsigned &Reg : AvailableRegs)
+        if (Reg && TRI->regsOverlap(Reg, *CSR))
+          Reg = 0;
   for (const auto &MO : MI.operands()) {
     if (MO.isReg() && MO.isUse())
       for (unsigned &Reg : AvailableRegs)
@@ -32306,6 +32340,18 @@ X86TargetLowering::EmitLoweredIndirectThunk(MachineInstr &MI,
     report_fatal_error("calling convention incompatible with retpoline, no "
                        "available registers");
 
+  if (Subtarget.useLFenceIndirectBranches()) {
+    // The LFENCE makes the branch wait for its target register at dispatch,
+    // which leaves almost no window to speculate at a mispredicted target.
+    BuildMI(*BB, MI, DL, TII->get(TargetOpcode::COPY), AvailableReg)
+        .addReg(CalleeVReg);
+    BuildMI(*BB, MI, DL, TII->get(X86::LFENCE));
+    MI.getOperand(0).ChangeToRegister(AvailableReg, /*isDef=*/false,
+                                      /*isImp=*/false, /*isKill=*/true);
+    MI.setDesc(TII->get(getOpcodeForLFenceIndirectBranch(MI.getOpcode())));
+    return BB;
+  }
+
   const char *Symbol = getIndirectThunkSymbol(Subtarget, AvailableReg);
 
   BuildMI(*BB, MI, DL, TII->get(TargetOpcode::COPY), AvailableReg)
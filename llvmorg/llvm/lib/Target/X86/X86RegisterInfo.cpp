@@ -228,6 +228,10 @@ bool X86RegisterInfo::shouldRewriteCopySrc(const TargetRegisterClass *DefRC,
 const TargetRegisterClass *
 X86RegisterInfo::getGPRsForTailCall(const MachineFunction &MF) const {
   const Function &F = MF.getFunction();
+  // Barebone functions have no callee-saved registers to restore before the
+  // jump, so the target and its address may live in any GPR.
+  if (Is64Bit && F.getCallingConv() == CallingConv::Barebone)
+    return &X86::GR64_NOSPRegClass;
   if (IsWin64 || (F.getCallingConv() == CallingConv::Win64))
     return &X86::GR64_TCW64RegClass;
   else if (Is64Bit)
@@ -442,6 +442,11 @@ protected:
   /// POP+LFENCE+JMP sequence.
   bool UseLVIControlFlowIntegrity = false;
 
+  /// Prevent generation of indirect call/branch instructions from memory,
+  /// and precede indirect call/branch instructions from a register with an
+  /// LFENCE instead of calling a thunk.
+  bool UseLFenceIndirectBranches = false;
+
   /// Enable Speculative Execution Side Effect Suppression
   bool UseSpeculativeExecutionSideEffectSuppression = false;
 
@@ -752,10 +757,18 @@ public:
   // supported by the subtarget. Therefore useIndirectThunk*() will return true
   // if any respective thunk feature is enabled.
   bool useIndirectThunkCalls() const {
-    return useRetpolineIndirectCalls() || useLVIControlFlowIntegrity();
+    return useRetpolineIndirectCalls() || useLVIControlFlowIntegrity() ||
+           UseLFenceIndirectBranches;
   }
   bool useIndirectThunkBranches() const {
-    return useRetpolineIndirectBranches() || useLVIControlFlowIntegrity();
+    return useRetpolineIndirectBranches() || useLVIControlFlowIntegrity() ||
+           UseLFenceIndirectBranches;
+  }
+  /// Return true if the indirect thunk pseudos are lowered to an LFENCE and a
+  /// call or jump through a register rather than to a thunk call.
+  bool useLFenceIndirectBranches() const {
+    return UseLFenceIndirectBranches && !useRetpolineIndirectCalls() &&
+           !useRetpolineIndirectBranches() && !useLVIControlFlowIntegrity();
   }
 
   bool preferMaskRegisters() const { return PreferMaskRegisters; }
@@ -265,6 +265,17 @@ X86TargetMachine::getSubtargetImpl(const Function &F) const {
   if (SoftFloat)
     Key += FS.empty() ? "+soft-float" : ",+soft-float";
 
+  // A function may replace the retpolines of its indirect calls and branches
+  // with the LFENCE mitigation, e.g. the dispatch of an interpreter written
+  // with barebone functions on processors where it is cheaper.
+  if (F.getFnAttribute("indirect-branch-mitigation").getValueAsString() ==
+      "lfence") {
+    if (Key.size() > CPU.size())
+      Key += ",";
+    Key += "-retpoline,-retpoline-indirect-calls,"
+           "-retpoline-indirect-branches,+lfence-indirect-branches";
+  }
+
   // Keep track of the key width after all features are added so we can extract
   // the feature string out later.
   unsigned CPUFSWidth = Key.size();
@@ -44,6 +44,7 @@
 #include "llvm/Transforms/Utils/Local.h"
 #include <cassert>
 #include <cstdint>
+#include <limits>
 
 #define DEBUG_TYPE "instcombine"
 
@@ -811,6 +812,17 @@ public:
   /// Maximum size of array considered when transforming.
   uint64_t MaxArraySizeForCombine = 0;
 
+  /// Maximum number of instructions visited by run(). The remaining
+  /// instructions are dropped from the worklist once it is reached.
+  uint64_t MaxVisits = std::numeric_limits<uint64_t>::max();
+
+  /// Number of instructions visited by run() so far.
+  uint64_t NumVisits = 0;
+
+  /// Whether run() dropped instructions from the worklist because MaxVisits
+  /// was reached.
+  bool BudgetExhausted = false;
+
 private:
   /// Performs a few simplifications for operators which are associative
   /// or commutative.
@@ -39,6 +39,7 @@
 #include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/None.h"
+#include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/Statistic.h"
@@ -96,14 +97,20 @@
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/DebugCounter.h"
 #include "llvm/Support/ErrorHandling.h"
+#include "llvm/Support/Format.h"
 #include "llvm/Support/KnownBits.h"
+#include "llvm/Support/ManagedStatic.h"
+#include "llvm/Support/Timer.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/Transforms/InstCombine/InstCombine.h"
 #include "llvm/Transforms/InstCombine/InstCombineWorklist.h"
 #include "llvm/Transforms/Utils/Local.h"
 #include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <chrono>
 #include <cstdint>
+#include <limits>
 #include <memory>
 #include <string>
 #include <utility>
@@ -120,6 +127,9 @@ STATISTIC(NumSunkInst , "Number of instructions sunk");
 STATISTIC(NumExpand,    "Number of expansions");
 STATISTIC(NumFactor   , "Number of factorizations");
 STATISTIC(NumReassoc  , "Number of reassociations");
+STATISTIC(NumVisited  , "Number of insts visited");
+STATISTIC(NumBudgetExhausted,
+          "Number of functions whose visit budget was exhausted");
 DEBUG_COUNTER(VisitCounter, "instcombine-visit",
               "Controls which instructions are visited");
 
@@ -141,6 +151,17 @@ static cl::opt<unsigned> InfiniteLoopDetectionThreshold(
              "infinite loop"),
     cl::init(InstCombineDefaultInfiniteLoopThreshold), cl::Hidden);
 
+static cl::opt<unsigned> LimitMaxVisitsPerInst(
+    "instcombine-max-visits-per-inst",
+    cl::desc("Limit the number of instructions visited in a function to this "
+             "many times its instruction count (0 = no limit)"),
+    cl::init(0), cl::Hidden);
+
+static cl::opt<bool> ProfileCombines(
+    "instcombine-profile", cl::Hidden,
+    cl::desc("Print the number of visits, combines and the time spent per "
+             "opcode when the program exits"));
+
 static cl::opt<unsigned>
 MaxArraySize("instcombine-maxarray-size", cl::init(1024),
              cl::desc("Maximum array size considered when doing a combine"));
@@ -155,6 +176,51 @@ MaxArraySize("instcombine-maxarray-size", cl::init(1024),
 static cl::opt<unsigned> ShouldLowerDbgDeclare("instcombine-lower-dbg-declare",
                                                cl::Hidden, cl::init(true));
 
+namespace {
+
+/// The visits, combines and time spent in visit() per opcode, collected with
+/// -instcombine-profile and printed when the program exits.
+struct CombineProfile {
+  struct Entry {
+    std::atomic<uint64_t> Visits{0};
+    std::atomic<uint64_t> Combines{0};
+    std::atomic<uint64_t> Nanoseconds{0};
+  };
+  Entry Entries[Instruction::OtherOpsEnd];
+
+  ~CombineProfile() { print(); }
+
+  void print() {
+    SmallVector<unsigned, 64> Opcodes;
+    for (unsigned Opcode = 0; Opcode != Instruction::OtherOpsEnd; ++Opcode)
+      if (Entries[Opcode].Visits)
+        Opcodes.push_back(Opcode);
+    if (Opcodes.empty())
+      return;
+    llvm::sort(Opcodes, [&](unsigned A, unsigned B) {
+      return Entries[A].Nanoseconds > Entries[B].Nanoseconds;
+    });
+
+    std::unique_ptr<raw_fd_ostream> OS = CreateInfoOutputFile();
+    *OS << "===" << std::string(73, '-') << "===\n"
+        << "                       InstCombine visits per opcode\n"
+        << "===" << std::string(73, '-') << "===\n\n"
+        << "      Visits    Combines    Time (s)  Opcode\n";
+    for (unsigned Opcode : Opcodes) {
+      const Entry &E = Entries[Opcode];
+      *OS << format("%12" PRIu64 "%12" PRIu64 "%12.6f  %s\n",
+                    E.Visits.load(), E.Combines.load(),
+                    E.Nanoseconds.load() / 1e9,
+                    Instruction::getOpcodeName(Opcode));
+    }
+    OS->flush();
+  }
+};
+
+} // end anonymous namespace
+
+static ManagedStatic<CombineProfile> Profile;
+
 Value *InstCombiner::EmitGEPOffset(User *GEP) {
   return llvm::EmitGEPOffset(&Builder, DL, GEP);
 }
@@ -3432,6 +3498,14 @@ static bool TryToSinkInstruction(Instruction *I, BasicBlock *DestBlock) {
 
 bool InstCombiner::run() {
   while (!Worklist.isEmpty()) {
+    if (NumVisits == MaxVisits) {
+      LLVM_DEBUG(dbgs() << "IC: Visit budget exhausted, dropping the "
+                           "remaining instructions\n");
+      Worklist.clear();
+      BudgetExhausted = true;
+      break;
+    }
+
     // Walk deferred instructions in reverse order, and push them to the
     // worklist, which means they'll end up popped from the worklist in-order.
     while (Instruction *I = Worklist.popDeferred()) {
@@ -3461,6 +3535,9 @@ bool InstCombiner::run() {
     if (!DebugCounter::shouldExecute(VisitCounter))
       continue;
 
+    ++NumVisits;
+    ++NumVisited;
+
     // Instruction isn't dead, see if we can constant propagate it.
     if (!I->use_empty() &&
         (I->getNumOperands() == 0 || isa<Constant>(I->getOperand(0)))) {
@@ -3534,7 +3611,22 @@ bool InstCombiner::run() {
     LLVM_DEBUG(raw_string_ostream SS(OrigI); I->print(SS); OrigI = SS.str(););
     LLVM_DEBUG(dbgs() << "IC: Visiting: " << OrigI << '\n');
 
-    if (Instruction *Result = visit(*I)) {
+    Instruction *Result;
+    if (LLVM_UNLIKELY(ProfileCombines)) {
+      CombineProfile::Entry &E = Profile->Entries[I->getOpcode()];
+      auto Start = std::chrono::steady_clock::now();
+      Result = visit(*I);
+      E.Nanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                           std::chrono::steady_clock::now() - Start)
+                           .count();
+      ++E.Visits;
+      if (Result)
+        ++E.Combines;
+    } else {
+      Result = visit(*I);
+    }
+
+    if (Result) {
       ++NumCombined;
       // Should we replace the old instruction with a new one?
       if (Result != I) {
@@ -3715,9 +3807,13 @@ static bool combineInstructionsOverFunction(
     Function &F, InstCombineWorklist &Worklist, AliasAnalysis *AA,
     AssumptionCache &AC, TargetLibraryInfo &TLI, DominatorTree &DT,
     OptimizationRemarkEmitter &ORE, BlockFrequencyInfo *BFI,
-    ProfileSummaryInfo *PSI, unsigned MaxIterations, LoopInfo *LI) {
+    ProfileSummaryInfo *PSI, unsigned MaxIterations, unsigned MaxVisitsPerInst,
+    LoopInfo *LI) {
   auto &DL = F.getParent()->getDataLayout();
   MaxIterations = std::min(MaxIterations, LimitMaxIterations.getValue());
+  if (LimitMaxVisitsPerInst &&
+      (!MaxVisitsPerInst || LimitMaxVisitsPerInst < MaxVisitsPerInst))
+    MaxVisitsPerInst = LimitMaxVisitsPerInst;
 
   /// Builder - This is an IRBuilder that automatically inserts new
   /// instructions into the worklist when they are created.
@@ -3735,6 +3831,12 @@ static bool combineInstructionsOverFunction(
   if (ShouldLowerDbgDeclare)
     MadeIRChange = LowerDbgDeclare(F);
 
+  // The visit budget is shared by all iterations.
+  uint64_t MaxVisits = std::numeric_limits<uint64_t>::max();
+  if (MaxVisitsPerInst)
+    MaxVisits = uint64_t(MaxVisitsPerInst) * F.getInstructionCount();
+  uint64_t NumVisits = 0;
+
   // Iterate while there is work to do.
   unsigned Iteration = 0;
   while (true) {
@@ -3761,20 +3863,35 @@ static bool combineInstructionsOverFunction(
     InstCombiner IC(Worklist, Builder, F.hasMinSize(), AA,
                     AC, TLI, DT, ORE, BFI, PSI, DL, LI);
     IC.MaxArraySizeForCombine = MaxArraySize;
-
-    if (!IC.run())
+    IC.MaxVisits = MaxVisits - NumVisits;
+
+    bool Changed = IC.run();
+    MadeIRChange |= Changed;
+    NumVisits += IC.NumVisits;
+    if (IC.BudgetExhausted) {
+      LLVM_DEBUG(dbgs() << "\n\n[IC] Visit budget of " << MaxVisits << " on "
+                        << F.getName()
+                        << " exhausted; stopping before reaching a fixpoint\n");
+      ++NumBudgetExhausted;
       break;
+    }
 
-    MadeIRChange = true;
+    if (!Changed)
+      break;
   }
 
   return MadeIRChange;
 }
 
-InstCombinePass::InstCombinePass() : MaxIterations(LimitMaxIterations) {}
+InstCombinePass::InstCombinePass()
+    : MaxIterations(LimitMaxIterations), MaxVisitsPerInst(0) {}
 
 InstCombinePass::InstCombinePass(unsigned MaxIterations)
-    : MaxIterations(MaxIterations) {}
+    : MaxIterations(MaxIterations), MaxVisitsPerInst(0) {}
+
+InstCombinePass::InstCombinePass(unsigned MaxIterations,
+                                 unsigned MaxVisitsPerInst)
+    : MaxIterations(MaxIterations), MaxVisitsPerInst(MaxVisitsPerInst) {}
 
 PreservedAnalyses InstCombinePass::run(Function &F,
                                        FunctionAnalysisManager &AM) {
@@ -3793,7 +3910,8 @@ PreservedAnalyses InstCombinePass::run(Function &F,
       &AM.getResult<BlockFrequencyAnalysis>(F) : nullptr;
 
   if (!combineInstructionsOverFunction(F, Worklist, AA, AC, TLI, DT, ORE, BFI,
-                                       PSI, MaxIterations, LI))
+                                       PSI, MaxIterations, MaxVisitsPerInst,
+                                       LI))
     // No changes, all analyses are preserved.
     return PreservedAnalyses::all();
 
@@ -3843,18 +3961,27 @@ bool InstructionCombiningPass::runOnFunction(Function &F) {
       nullptr;
 
   return combineInstructionsOverFunction(F, Worklist, AA, AC, TLI, DT, ORE, BFI,
-                                         PSI, MaxIterations, LI);
+                                         PSI, MaxIterations, MaxVisitsPerInst,
+                                         LI);
 }
 
 char InstructionCombiningPass::ID = 0;
 
 InstructionCombiningPass::InstructionCombiningPass()
-    : FunctionPass(ID), MaxIterations(InstCombineDefaultMaxIterations) {
+    : FunctionPass(ID), MaxIterations(InstCombineDefaultMaxIterations),
+      MaxVisitsPerInst(0) {
   initializeInstructionCombiningPassPass(*PassRegistry::getPassRegistry());
 }
 
 InstructionCombiningPass::InstructionCombiningPass(unsigned MaxIterations)
-    : FunctionPass(ID), MaxIterations(MaxIterations) {
+    : FunctionPass(ID), MaxIterations(MaxIterations), MaxVisitsPerInst(0) {
+  initializeInstructionCombiningPassPass(*PassRegistry::getPassRegistry());
+}
+
+InstructionCombiningPass::InstructionCombiningPass(unsigned MaxIterations,
+                                                   unsigned MaxVisitsPerInst)
+    : FunctionPass(ID), MaxIterations(MaxIterations),
+      MaxVisitsPerInst(MaxVisitsPerInst) {
   initializeInstructionCombiningPassPass(*PassRegistry::getPassRegistry());
 }
 
@@ -3888,6 +4015,11 @@ FunctionPass *llvm::createInstructionCombiningPass(unsigned MaxIterations) {
   return new InstructionCombiningPass(MaxIterations);
 }
 
+FunctionPass *llvm::createInstructionCombiningPass(unsigned MaxIterations,
+                                                   unsigned MaxVisitsPerInst) {
+  return new InstructionCombiningPass(MaxIterations, MaxVisitsPerInst);
+}
+
 void LLVMAddInstructionCombiningPass(LLVMPassManagerRef PM) {
   unwrap(PM)->add(createInstructionCombiningPass());
 }
@@ -35,6 +35,7 @@
 #include "llvm/IR/Instruction.h"
 #include "llvm/IR/Instructions.h"
 #include "llvm/IR/IntrinsicInst.h"
+#include "llvm/IR/MDBuilder.h"
 #include "llvm/IR/Module.h"
 #include "llvm/IR/Type.h"
 #include "llvm/InitializePasses.h"
@@ -84,6 +85,12 @@ cl::opt<bool> RuntimeCounterRelocation(
     cl::desc("Enable relocating counters at runtime."),
     cl::init(false));
 
+cl::opt<unsigned> SampledCounterPeriod(
+    "instrprof-sample-period", cl::ZeroOrMore, cl::init(0),
+    cl::desc("Only update profile counters about once every N counter updates "
+             "of a thread, adding N to the sampled counter. 0 or 1 updates "
+             "counters precisely."));
+
 cl::opt<bool> ValueProfileStaticAlloc(
     "vp-static-alloc",
     cl::desc("Do static counter allocation for value profiler"),
@@ -434,12 +441,17 @@ static InstrProfIncrementInst *castToIncrementInst(Instruction *Instr) {
 bool InstrProfiling::lowerIntrinsics(Function *F) {
   bool MadeChange = false;
   PromotionCandidates.clear();
+  // Sampled increments split blocks, so lower them after the walk.
+  SmallVector<InstrProfIncrementInst *, 16> SampledIncrements;
   for (BasicBlock &BB : *F) {
     for (auto I = BB.begin(), E = BB.end(); I != E;) {
       auto Instr = I++;
       InstrProfIncrementInst *Inc = castToIncrementInst(&*Instr);
       if (Inc) {
-        lowerIncrement(Inc);
+        if (isCounterSamplingEnabled())
+          SampledIncrements.push_back(Inc);
+        else
+          lowerIncrement(Inc);
         MadeChange = true;
       } else if (auto *Ind = dyn_cast<InstrProfValueProfileInst>(Instr)) {
         lowerValueProfileInst(Ind);
@@ -447,6 +459,8 @@ bool InstrProfiling::lowerIntrinsics(Function *F) {
       }
     }
   }
+  for (InstrProfIncrementInst *Inc : SampledIncrements)
+    lowerIncrement(Inc);
 
   if (!MadeChange)
     return false;
@@ -462,6 +476,10 @@ bool InstrProfiling::isRuntimeCounterRelocationEnabled() const {
   return TT.isOSFuchsia();
 }
 
+bool InstrProfiling::isCounterSamplingEnabled() const {
+  return SampledCounterPeriod > 1;
+}
+
 bool InstrProfiling::isCounterPromotionEnabled() const {
   if (DoCounterPromotion.getNumOccurrences() > 0)
     return DoCounterPromotion;
@@ -702,6 +720,11 @@ void InstrProfiling::lowerIncrement(InstrProfIncrementInst *Inc) {
     Addr = Builder.CreateIntToPtr(Add, Int64PtrTy);
   }
 
+  if (isCounterSamplingEnabled()) {
+    lowerSampledIncrement(Inc, Addr);
+    return;
+  }
+
   if (Options.Atomic || AtomicCounterUpdateAll ||
       (Index == 0 && AtomicFirstCounter)) {
     Builder.CreateAtomicRMW(AtomicRMWInst::Add, Addr, Inc->getStep(),
@@ -717,6 +740,58 @@ void InstrProfiling::lowerIncrement(InstrProfIncrementInst *Inc) {
   Inc->eraseFromParent();
 }
 
+void InstrProfiling::lowerSampledIncrement(InstrProfIncrementInst *Inc,
+                                           Value *Addr) {
+  LLVMContext &Ctx = M->getContext();
+  Type *Int32Ty = Type::getInt32Ty(Ctx);
+  Type *Int64Ty = Type::getInt64Ty(Ctx);
+
+  // The countdown is a 64-bit integer defined by the runtime, which holds
+  // intervals of up to twice the 32-bit period. Every thread decrements it on
+  // each counter update and takes the slow path once it drops below zero:
+  //
+  //   if (--__llvm_profile_sample_countdown < 0)
+  //     *Addr += Step * __llvm_profile_sample_hit(Period);
+  //
+  // The runtime resets it to a random interval averaging Period, so each
+  // update is counted with probability ~1/Period and weight Period.
+  GlobalVariable *Countdown =
+      M->getGlobalVariable(getInstrProfSampleCountdownVarName());
+  if (!Countdown) {
+    Countdown = new GlobalVariable(
+        *M, Int64Ty, false, GlobalValue::ExternalLinkage, nullptr,
+        getInstrProfSampleCountdownVarName(), nullptr,
+        GlobalVariable::InitialExecTLSModel);
+    Countdown->setVisibility(GlobalValue::HiddenVisibility);
+  }
+
+  IRBuilder<> Builder(Inc);
+  Value *Left = Builder.CreateSub(Builder.CreateLoad(Int64Ty, Countdown),
+                                  Builder.getInt64(1));
+  Builder.CreateStore(Left, Countdown);
+  Value *Expired = Builder.CreateICmpSLT(Left, Builder.getInt64(0));
+  MDBuilder MDB(Ctx);
+  Instruction *ThenTerm = SplitBlockAndInsertIfThen(
+      Expired, Inc, /*Unreachable=*/false,
+      MDB.createBranchWeights(1, SampledCounterPeriod - 1));
+
+  Builder.SetInsertPoint(ThenTerm);
+  FunctionCallee SampleHit = M->getOrInsertFunction(
+      getInstrProfSampleHitFuncName(), Int64Ty, Int32Ty);
+  Value *Weight =
+      Builder.CreateCall(SampleHit, Builder.getInt32(SampledCounterPeriod));
+  Value *IncStep = Builder.CreateMul(Inc->getStep(), Weight);
+  // Sampled updates are rare, so they are never promoted.
+  if (Options.Atomic || AtomicCounterUpdateAll) {
+    Builder.CreateAtomicRMW(AtomicRMWInst::Add, Addr, IncStep,
+                            AtomicOrdering::Monotonic);
+  } else {
+    Value *Load = Builder.CreateLoad(IncStep->getType(), Addr, "pgocount");
+    Builder.CreateStore(Builder.CreateAdd(Load, IncStep), Addr);
+  }
+  Inc->eraseFromParent();
+}
+
 void InstrProfiling::lowerCoverageData(GlobalVariable *CoverageNamesVar) {
   ConstantArray *Names =
       cast<ConstantArray>(CoverageNamesVar->getInitializer());
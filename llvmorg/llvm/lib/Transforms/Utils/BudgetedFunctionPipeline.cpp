@@ -0,0 +1,93 @@
+//===- BudgetedFunctionPipeline.cpp - Time-bounded function pipeline ------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Transforms/Utils/BudgetedFunctionPipeline.h"
+#include "llvm/ADT/Statistic.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/Module.h"
+#include "llvm/IR/PassInstrumentation.h"
+#include "llvm/Support/Debug.h"
+
+using namespace llvm;
+
+#define DEBUG_TYPE "budgeted-function-pipeline"
+
+STATISTIC(NumFunctionsOverBudget,
+          "Number of function visits skipped for lack of time budget");
+STATISTIC(NumStagesSkipped, "Number of pipeline stages skipped");
+
+unsigned FunctionTimeBudget::getUnnamedKey(const Function &F) {
+  unsigned Index = 0;
+  for (const Function &Other : *F.getParent()) {
+    if (&Other == &F)
+      break;
+    ++Index;
+  }
+  return Index;
+}
+
+bool FunctionTimeBudget::isExhausted(const Function &F) const {
+  if (Limit.count() == 0)
+    return false;
+  std::lock_guard<std::mutex> Guard(Lock);
+  if (F.hasName()) {
+    auto It = Spent.find(F.getName());
+    return It != Spent.end() && It->second > Limit;
+  }
+  auto It = SpentUnnamed.find(getUnnamedKey(F));
+  return It != SpentUnnamed.end() && It->second > Limit;
+}
+
+void FunctionTimeBudget::charge(const Function &F, Clock::duration Time) {
+  if (Limit.count() == 0)
+    return;
+  std::lock_guard<std::mutex> Guard(Lock);
+  if (F.hasName())
+    Spent[F.getName()] += Time;
+  else
+    SpentUnnamed[getUnnamedKey(F)] += Time;
+}
+
+void FunctionTimeBudget::reset() {
+  std::lock_guard<std::mutex> Guard(Lock);
+  Spent.clear();
+  SpentUnnamed.clear();
+}
+
+PreservedAnalyses ResetFunctionTimeBudgetPass::run(Module &M,
+                                                   ModuleAnalysisManager &) {
+  Budget->reset();
+  return PreservedAnalyses::all();
+}
+
+PreservedAnalyses BudgetedFunctionPipeline::run(Function &F,
+                                                FunctionAnalysisManager &AM) {
+  using Clock = FunctionTimeBudget::Clock;
+  PassInstrumentation PI = AM.getResult<PassInstrumentationAnalysis>(F);
+  PreservedAnalyses PA = PreservedAnalyses::all();
+
+  for (size_t I = 0, E = Stages.size(); I != E; ++I) {
+    if (I != 0 && Budget->isExhausted(F)) {
+      LLVM_DEBUG(dbgs() << "Time budget of " << F.getName()
+                        << " ran out, skipping " << E - I << " stage(s)\n");
+      ++NumFunctionsOverBudget;
+      NumStagesSkipped += E - I;
+      break;
+    }
+
+    FunctionPassManager &Stage = Stages[I];
+    if (!PI.runBeforePass<Function>(Stage, F))
+      continue;
+    Clock::time_point Start = Clock::now();
+    // The stage invalidates the analyses after each of its passes.
+    PA.intersect(Stage.run(F, AM));
+    Budget->charge(F, Clock::now() - Start);
+    PI.runAfterPass(Stage, F);
+  }
+  return PA;
+}
@@ -0,0 +1,771 @@
+//===- ParallelFunctionPassAdaptor.cpp - Run function passes in parallel --===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Transforms/Utils/ParallelFunctionPassAdaptor.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/DenseSet.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SmallPtrSet.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Analysis/GlobalsModRef.h"
+#include "llvm/Analysis/ProfileSummaryInfo.h"
+#include "llvm/Analysis/TargetTransformInfo.h"
+#include "llvm/Bitcode/BitcodeReader.h"
+#include "llvm/Bitcode/BitcodeWriter.h"
+#include "llvm/IR/DebugInfoMetadata.h"
+#include "llvm/IR/DiagnosticHandler.h"
+#include "llvm/IR/DiagnosticInfo.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
+#include "llvm/IR/PassInstrumentation.h"
+#include "llvm/IR/TypeFinder.h"
+#include "llvm/Support/Error.h"
+#include "llvm/Support/ErrorHandling.h"
+#include "llvm/Support/ThreadPool.h"
+#include "llvm/Support/Threading.h"
+#include "llvm/Transforms/Utils/ValueMapper.h"
+#include <memory>
+#include <mutex>
+#include <vector>
+
+using namespace llvm;
+
+#define DEBUG_TYPE "parallel-function-passes"
+
+/// The named metadata through which a copy of the module lists the subprogram
+/// of every function it had, or an empty tuple, since dropping the body of a
+/// function also drops its !dbg attachment.
+static const char SubprogramsMDName[] = "llvm.parallel.subprograms";
+
+namespace {
+
+/// What a thread sends back for its partition.
+struct PartitionResult {
+  /// The copy of the module, as bitcode.
+  SmallVector<char, 0> Bitcode;
+  /// The preserved analyses of the functions of the partition, in order.
+  std::vector<PreservedAnalyses> Results;
+};
+
+/// Forwards the diagnostics of the context of a thread to the context of the
+/// module, which may only be used by one thread at a time.
+class ForwardingDiagnosticHandler : public DiagnosticHandler {
+  LLVMContext &Outer;
+  std::mutex &Lock;
+
+public:
+  ForwardingDiagnosticHandler(LLVMContext &Outer, std::mutex &Lock)
+      : Outer(Outer), Lock(Lock) {}
+
+  bool handleDiagnostics(const DiagnosticInfo &DI) override {
+    std::lock_guard<std::mutex> Guard(Lock);
+    Outer.diagnose(DI);
+    return true;
+  }
+
+  bool isAnalysisRemarkEnabled(StringRef PassName) const override {
+    std::lock_guard<std::mutex> Guard(Lock);
+    return Outer.getLLVMRemarkStreamer() ||
+           Outer.getDiagHandlerPtr()->isAnalysisRemarkEnabled(PassName);
+  }
+
+  bool isMissedOptRemarkEnabled(StringRef PassName) const override {
+    std::lock_guard<std::mutex> Guard(Lock);
+    return Outer.getLLVMRemarkStreamer() ||
+           Outer.getDiagHandlerPtr()->isMissedOptRemarkEnabled(PassName);
+  }
+
+  bool isPassedOptRemarkEnabled(StringRef PassName) const override {
+    std::lock_guard<std::mutex> Guard(Lock);
+    return Outer.getLLVMRemarkStreamer() ||
+           Outer.getDiagHandlerPtr()->isPassedOptRemarkEnabled(PassName);
+  }
+};
+
+/// Maps the types of a copy of the module read back into the context of the
+/// module to the types of the module. The bitcode reader always creates new
+/// identified structs, renaming them when the name is taken, so every struct
+/// of the copy is paired with the struct of the module it was read from, or
+/// recreated when it is new.
+class CopyTypeMapper : public ValueMapTypeRemapper {
+  Module &M;
+  DenseSet<StructType *> CopyStructs;
+  DenseMap<Type *, Type *> Mapped;
+  SmallVector<StructType *, 8> Tentative;
+
+  bool areIsomorphic(Type *From, Type *To);
+  StructType *findOriginal(StructType *ST);
+  Type *mapStruct(StructType *ST);
+
+public:
+  CopyTypeMapper(Module &M, Module &Copy) : M(M) {
+    TypeFinder Finder;
+    Finder.run(Copy, /*onlyNamed=*/false);
+    CopyStructs.insert(Finder.begin(), Finder.end());
+  }
+
+  /// Pairs the structs of \p From, a type of the copy, with those of \p To,
+  /// the corresponding type of the module.
+  void pair(Type *From, Type *To) {
+    Tentative.clear();
+    if (!areIsomorphic(From, To))
+      for (StructType *Undo : Tentative)
+        Mapped.erase(Undo);
+    Tentative.clear();
+  }
+
+  Type *remapType(Type *Ty) override;
+  AttributeList remapAttributes(AttributeList Attrs);
+};
+
+} // end anonymous namespace
+
+/// Returns true if the types of the copy \p From and of the module \p To have
+/// the same structure, pairing their structs. The pairs are tentative until
+/// the caller accepts them.
+bool CopyTypeMapper::areIsomorphic(Type *From, Type *To) {
+  if (From == To)
+    return true;
+  if (From->getTypeID() != To->getTypeID())
+    return false;
+
+  if (auto *ST = dyn_cast<StructType>(From)) {
+    auto *DST = cast<StructType>(To);
+    if (ST->isLiteral() != DST->isLiteral())
+      return false;
+    if (!ST->isLiteral()) {
+      if (!CopyStructs.count(ST) || CopyStructs.count(DST))
+        return false;
+      auto It = Mapped.find(ST);
+      if (It != Mapped.end())
+        return It->second == DST;
+      Mapped[ST] = DST;
+      Tentative.push_back(ST);
+      if (ST->isOpaque() || DST->isOpaque())
+        return ST->isOpaque() == DST->isOpaque();
+    }
+    if (ST->isPacked() != DST->isPacked())
+      return false;
+  } else if (auto *AT = dyn_cast<ArrayType>(From)) {
+    if (AT->getNumElements() != cast<ArrayType>(To)->getNumElements())
+      return false;
+  } else if (auto *VT = dyn_cast<VectorType>(From)) {
+    if (VT->getElementCount() != cast<VectorType>(To)->getElementCount())
+      return false;
+  } else if (auto *PT = dyn_cast<PointerType>(From)) {
+    if (PT->getAddressSpace() != cast<PointerType>(To)->getAddressSpace())
+      return false;
+  } else if (auto *FT = dyn_cast<FunctionType>(From)) {
+    if (FT->isVarArg() != cast<FunctionType>(To)->isVarArg())
+      return false;
+  }
+
+  if (From->getNumContainedTypes() != To->getNumContainedTypes())
+    return false;
+  for (unsigned I = 0, E = From->getNumContainedTypes(); I != E; ++I)
+    if (!areIsomorphic(From->getContainedType(I), To->getContainedType(I)))
+      return false;
+  return true;
+}
+
+/// Returns the struct of the module that \p ST was read from, if it was not
+/// paired through the globals: the one named as \p ST without the suffix the
+/// bitcode reader added.
+StructType *CopyTypeMapper::findOriginal(StructType *ST) {
+  StringRef Name = ST->getName();
+  size_t Dot = Name.rfind('.');
+  if (Dot == StringRef::npos)
+    return nullptr;
+  StringRef Suffix = Name.substr(Dot + 1);
+  if (Suffix.empty() || !all_of(Suffix, isDigit))
+    return nullptr;
+
+  StructType *Orig = M.getTypeByName(Name.substr(0, Dot));
+  if (!Orig || CopyStructs.count(Orig))
+    return nullptr;
+
+  Tentative.clear();
+  if (areIsomorphic(ST, Orig))
+    return Orig;
+  for (StructType *Undo : Tentative)
+    Mapped.erase(Undo);
+  return nullptr;
+}
+
+Type *CopyTypeMapper::mapStruct(StructType *ST) {
+  if (StructType *Orig = findOriginal(ST)) {
+    Tentative.clear();
+    return Orig;
+  }
+
+  // A struct the pipeline created: recreate it, as its body may refer to the
+  // structs of the copy.
+  StringRef Name = ST->getName();
+  size_t Dot = Name.rfind('.');
+  if (Dot != StringRef::npos && all_of(Name.substr(Dot + 1), isDigit))
+    Name = Name.substr(0, Dot);
+  StructType *New = StructType::create(M.getContext(), Name);
+  Mapped[ST] = New;
+  if (!ST->isOpaque()) {
+    SmallVector<Type *, 8> Elements;
+    for (Type *Element : ST->elements())
+      Elements.push_back(remapType(Element));
+    New->setBody(Elements, ST->isPacked());
+  }
+  return New;
+}
+
+Type *CopyTypeMapper::remapType(Type *Ty) {
+  auto It = Mapped.find(Ty);
+  if (It != Mapped.end())
+    return It->second;
+
+  if (auto *ST = dyn_cast<StructType>(Ty))
+    if (!ST->isLiteral())
+      return CopyStructs.count(ST) ? mapStruct(ST) : Ty;
+
+  SmallVector<Type *, 8> Elements;
+  bool Changed = false;
+  for (Type *Element : Ty->subtypes()) {
+    Elements.push_back(remapType(Element));
+    Changed |= Elements.back() != Element;
+  }
+
+  Type *New = Ty;
+  if (Changed) {
+    switch (Ty->getTypeID()) {
+    case Type::ArrayTyID:
+      New = ArrayType::get(Elements[0], Ty->getArrayNumElements());
+      break;
+    case Type::FixedVectorTyID:
+    case Type::ScalableVectorTyID:
+      New = VectorType::get(Elements[0],
+                            cast<VectorType>(Ty)->getElementCount());
+      break;
+    case Type::PointerTyID:
+      New = PointerType::get(Elements[0], Ty->getPointerAddressSpace());
+      break;
+    case Type::FunctionTyID:
+      New = FunctionType::get(Elements[0], makeArrayRef(Elements).slice(1),
+                              cast<FunctionType>(Ty)->isVarArg());
+      break;
+    case Type::StructTyID:
+      New = StructType::get(Ty->getContext(), Elements,
+                            cast<StructType>(Ty)->isPacked());
+      break;
+    default:
+      llvm_unreachable("unexpected type with subtypes");
+    }
+  }
+  return Mapped[Ty] = New;
+}
+
+/// Remaps the types of the byval and preallocated attributes of \p Attrs.
+AttributeList CopyTypeMapper::remapAttributes(AttributeList Attrs) {
+  LLVMContext &C = M.getContext();
+  for (unsigned I = Attrs.index_begin(), E = Attrs.index_end(); I != E; ++I) {
+    if (Type *Ty = Attrs.getAttribute(I, Attribute::ByVal).getValueAsType()) {
+      Attrs = Attrs.removeAttribute(C, I, Attribute::ByVal);
+      Attrs = Attrs.addAttribute(
+          C, I, Attribute::getWithByValType(C, remapType(Ty)));
+    }
+    if (Type *Ty =
+            Attrs.getAttribute(I, Attribute::Preallocated).getValueAsType()) {
+      Attrs = Attrs.removeAttribute(C, I, Attribute::Preallocated);
+      Attrs = Attrs.addAttribute(
+          C, I, Attribute::getWithPreallocatedType(C, remapType(Ty)));
+    }
+  }
+  return Attrs;
+}
+
+/// Adds the attributes of \p From to \p To, as a pass adding attributes to
+/// a declaration would have.
+static AttributeList addAttributes(LLVMContext &C, AttributeList To,
+                                   AttributeList From) {
+  for (unsigned I = From.index_begin(), E = From.index_end(); I != E; ++I)
+    if (From.hasAttributes(I))
+      To = To.addAttributes(C, I, AttrBuilder(From.getAttributes(I)));
+  return To;
+}
+
+/// Returns the name \p GV was created with in the copy \p Copy: its name
+/// without the suffix that the symbol table of the copy added because the
+/// name was taken.
+static StringRef getRequestedName(const GlobalValue &GV, const Module &Copy) {
+  StringRef Name = GV.getName();
+  size_t Dot = Name.rfind('.');
+  if (Dot == StringRef::npos || Dot == 0)
+    return Name;
+  StringRef Suffix = Name.substr(Dot + 1);
+  if (Suffix.empty() || !all_of(Suffix, isDigit))
+    return Name;
+  StringRef Base = Name.substr(0, Dot);
+  return Copy.getNamedValue(Base) ? Base : Name;
+}
+
+/// Maps the distinct metadata of the copy reachable from \p From to the
+/// corresponding nodes of the module, reachable from \p To, so that remapping
+/// the moved bodies does not duplicate them.
+static void pairMetadata(ValueToValueMapTy &VM, const MDNode *From,
+                         const MDNode *To,
+                         SmallPtrSetImpl<const MDNode *> &Visited) {
+  SmallVector<std::pair<const MDNode *, const MDNode *>, 16> Worklist;
+  Worklist.emplace_back(From, To);
+  while (!Worklist.empty()) {
+    const MDNode *F, *T;
+    std::tie(F, T) = Worklist.pop_back_val();
+    if (F == T || !Visited.insert(F).second)
+      continue;
+    if (F->getMetadataID() != T->getMetadataID() ||
+        F->isDistinct() != T->isDistinct() ||
+        F->getNumOperands() != T->getNumOperands())
+      continue;
+    if (F->isDistinct())
+      VM.MD()[F].reset(const_cast<MDNode *>(T));
+    for (unsigned I = 0, E = F->getNumOperands(); I != E; ++I)
+      if (auto *FOp = dyn_cast_or_null<MDNode>(F->getOperand(I)))
+        if (auto *TOp = dyn_cast_or_null<MDNode>(T->getOperand(I)))
+          Worklist.emplace_back(FOp, TOp);
+  }
+}
+
+static bool hasAddressTakenBlock(const Function &F) {
+  return any_of(F, [](const BasicBlock &BB) { return BB.hasAddressTaken(); });
+}
+
+/// Runs \p Pipeline on the functions \p Partition of a copy of the module read
+/// from \p Input into a context of its own, then keeps in the copy only what
+/// mergePartition moves back: the bodies of the partition, the new globals and
+/// the declarations. The bodies of the other functions are dropped, except
+/// those the copy needs to be valid or that have their blocks' address taken.
+static void runPartition(
+    StringRef Input, StringRef ModuleID, LLVMContext &Outer,
+    std::mutex &DiagLock, ArrayRef<unsigned> Partition,
+    const ParallelModuleToFunctionPassAdaptor::PipelineBuilderT &BuildPipeline,
+    const ParallelModuleToFunctionPassAdaptor::AnalysisRegistrationT
+        &RegisterAnalyses,
+    bool HasGlobalsAA, bool HasProfileSummary, PartitionResult &Result) {
+  LLVMContext Ctx;
+  Ctx.setDiscardValueNames(Outer.shouldDiscardValueNames());
+  if (Outer.isODRUniquingDebugTypes())
+    Ctx.enableDebugTypeODRUniquing();
+  Ctx.setDiagnosticsHotnessRequested(Outer.getDiagnosticsHotnessRequested());
+  Ctx.setDiagnosticsHotnessThreshold(Outer.getDiagnosticsHotnessThreshold());
+  Ctx.setDiagnosticHandler(
+      std::make_unique<ForwardingDiagnosticHandler>(Outer, DiagLock));
+
+  Expected<std::unique_ptr<Module>> CopyOrErr =
+      parseBitcodeFile(MemoryBufferRef(Input, ModuleID), Ctx);
+  if (!CopyOrErr)
+    report_fatal_error("parallel function passes: " +
+                       toString(CopyOrErr.takeError()));
+  Module &Copy = **CopyOrErr;
+
+  SmallVector<Function *, 0> Functions;
+  for (Function &F : Copy)
+    Functions.push_back(&F);
+  SmallVector<GlobalVariable *, 0> Globals;
+  for (GlobalVariable &GV : Copy.globals())
+    Globals.push_back(&GV);
+
+  {
+    // The instrumentation is registered first, without callbacks, so that the
+    // callbacks of the module, which are not thread safe, are not run from
+    // the threads.
+    LoopAnalysisManager LAM;
+    FunctionAnalysisManager FAM;
+    ModuleAnalysisManager MAM;
+    MAM.registerPass([] { return PassInstrumentationAnalysis(); });
+    FAM.registerPass([] { return PassInstrumentationAnalysis(); });
+    LAM.registerPass([] { return PassInstrumentationAnalysis(); });
+    MAM.registerPass([&] { return FunctionAnalysisManagerModuleProxy(FAM); });
+    FAM.registerPass([&] { return ModuleAnalysisManagerFunctionProxy(MAM); });
+    FAM.registerPass([&] { return LoopAnalysisManagerFunctionProxy(LAM); });
+    LAM.registerPass([&] { return FunctionAnalysisManagerLoopProxy(FAM); });
+    RegisterAnalyses(MAM, FAM, LAM);
+    MAM.registerPass([] { return GlobalsAA(); });
+    MAM.registerPass([] { return ProfileSummaryAnalysis(); });
+    FAM.registerPass([] { return TargetIRAnalysis(); });
+
+    // The function passes only get the module analyses that are cached.
+    if (HasGlobalsAA)
+      MAM.getResult<GlobalsAA>(Copy);
+    if (HasProfileSummary)
+      MAM.getResult<ProfileSummaryAnalysis>(Copy);
+
+    FunctionPassManager Pipeline = BuildPipeline();
+    for (unsigned I : Partition) {
+      Function &F = *Functions[I];
+      PreservedAnalyses PA = Pipeline.run(F, FAM);
+      FAM.invalidate(F, PA);
+      Result.Results.push_back(std::move(PA));
+    }
+  }
+
+  // Every body of the partition is moved back, whatever the passes report: a
+  // pass that changes the IR but preserves all analyses, e.g. because none of
+  // them depends on what it changed, would otherwise have its changes dropped.
+  DenseSet<unsigned> Ran(Partition.begin(), Partition.end());
+
+  SmallPtrSet<const GlobalObject *, 8> Keep;
+  for (GlobalAlias &GA : Copy.aliases())
+    Keep.insert(GA.getBaseObject());
+  for (GlobalIFunc &GI : Copy.ifuncs())
+    Keep.insert(GI.getBaseObject());
+
+  NamedMDNode *Subprograms = Copy.getOrInsertNamedMetadata(SubprogramsMDName);
+  for (unsigned I = 0, E = Functions.size(); I != E; ++I) {
+    Function &F = *Functions[I];
+    if (DISubprogram *SP = F.getSubprogram())
+      Subprograms->addOperand(SP);
+    else
+      Subprograms->addOperand(MDNode::get(Ctx, None));
+
+    if (F.isDeclaration() || Ran.count(I) || Keep.count(&F) ||
+        hasAddressTakenBlock(F))
+      continue;
+    F.deleteBody();
+    F.setComdat(nullptr);
+  }
+
+  for (GlobalVariable *GV : Globals) {
+    if (!GV->hasInitializer() || GV->hasAppendingLinkage() || Keep.count(GV))
+      continue;
+    GV->setInitializer(nullptr);
+    GV->setLinkage(GlobalValue::ExternalLinkage);
+    GV->setComdat(nullptr);
+  }
+
+  raw_svector_ostream OS(Result.Bitcode);
+  WriteBitcodeToFile(Copy, OS, /*ShouldPreserveUseListOrder=*/true);
+}
+
+/// Moves the body of \p From, a function of a copy of the module, into \p To.
+/// The moved instructions still refer to the copy until they are remapped.
+static void moveBody(Function &From, Function &To, CopyTypeMapper &Types,
+                     ValueToValueMapTy &VM) {
+  for (Argument &A : To.args())
+    A.setName("");
+  To.dropAllReferences();
+
+  To.setCallingConv(From.getCallingConv());
+  To.setAttributes(Types.remapAttributes(From.getAttributes()));
+  if (From.hasGC())
+    To.setGC(From.getGC());
+  else
+    To.clearGC();
+  if (From.hasPersonalityFn())
+    To.setPersonalityFn(From.getPersonalityFn());
+  if (From.hasPrefixData())
+    To.setPrefixData(From.getPrefixData());
+  if (From.hasPrologueData())
+    To.setPrologueData(From.getPrologueData());
+  SmallVector<std::pair<unsigned, MDNode *>, 4> MDs;
+  From.getAllMetadata(MDs);
+  for (const auto &MD : MDs)
+    To.addMetadata(MD.first, *MD.second);
+
+  To.getBasicBlockList().splice(To.end(), From.getBasicBlockList());
+  for (auto Args : zip(From.args(), To.args())) {
+    std::get<1>(Args).takeName(&std::get<0>(Args));
+    VM[&std::get<0>(Args)] = &std::get<1>(Args);
+  }
+}
+
+/// Moves back into \p M the bodies of the functions \p Replaced, and the
+/// globals and declarations that the pipeline added to the copy \p Copy.
+/// \p Functions and \p Globals are those of \p M before the pipeline ran.
+static void mergePartition(Module &M, ArrayRef<Function *> Functions,
+                           ArrayRef<GlobalVariable *> Globals, Module &Copy,
+                           ArrayRef<unsigned> Replaced) {
+  LLVMContext &C = M.getContext();
+  CopyTypeMapper Types(M, Copy);
+  ValueToValueMapTy VM;
+
+  // The copy has the globals of the module first, in the same order.
+  auto Mismatch = [] {
+    report_fatal_error("parallel function passes: a function pass removed, "
+                       "renamed or added a global it must not");
+  };
+  SmallVector<Function *, 0> CopyFunctions;
+  for (Function &F : Copy)
+    CopyFunctions.push_back(&F);
+  SmallVector<GlobalVariable *, 0> CopyGlobals;
+  for (GlobalVariable &GV : Copy.globals())
+    CopyGlobals.push_back(&GV);
+  if (CopyFunctions.size() < Functions.size() ||
+      CopyGlobals.size() < Globals.size() ||
+      Copy.alias_size() != M.alias_size() ||
+      Copy.ifunc_size() != M.ifunc_size())
+    Mismatch();
+
+  for (size_t I = 0, E = Functions.size(); I != E; ++I) {
+    if (CopyFunctions[I]->getName() != Functions[I]->getName())
+      Mismatch();
+    VM[CopyFunctions[I]] = Functions[I];
+    Types.pair(CopyFunctions[I]->getFunctionType(),
+               Functions[I]->getFunctionType());
+  }
+  for (size_t I = 0, E = Globals.size(); I != E; ++I) {
+    if (CopyGlobals[I]->getName() != Globals[I]->getName())
+      Mismatch();
+    VM[CopyGlobals[I]] = Globals[I];
+    Types.pair(CopyGlobals[I]->getValueType(), Globals[I]->getValueType());
+  }
+  for (auto Aliases : zip(Copy.aliases(), M.aliases()))
+    VM[&std::get<0>(Aliases)] = &std::get<1>(Aliases);
+  for (auto IFuncs : zip(Copy.ifuncs(), M.ifuncs()))
+    VM[&std::get<0>(IFuncs)] = &std::get<1>(IFuncs);
+
+  // Pair the debug info of the copy with that of the module.
+  SmallPtrSet<const MDNode *, 32> Visited;
+  if (NamedMDNode *CopyCUs = Copy.getNamedMetadata("llvm.dbg.cu"))
+    if (NamedMDNode *CUs = M.getNamedMetadata("llvm.dbg.cu"))
+      for (unsigned I = 0, E = std::min(CopyCUs->getNumOperands(),
+                                        CUs->getNumOperands());
+           I != E; ++I)
+        pairMetadata(VM, CopyCUs->getOperand(I), CUs->getOperand(I), Visited);
+  NamedMDNode *Subprograms = Copy.getNamedMetadata(SubprogramsMDName);
+  for (size_t I = 0, E = Functions.size(); I != E; ++I)
+    if (DISubprogram *SP = Functions[I]->getSubprogram())
+      pairMetadata(VM, Subprograms->getOperand(I), SP, Visited);
+  Copy.eraseNamedMetadata(Subprograms);
+  for (size_t I = 0, E = Globals.size(); I != E; ++I) {
+    SmallVector<std::pair<unsigned, MDNode *>, 4> CopyMDs, MDs;
+    CopyGlobals[I]->getAllMetadata(CopyMDs);
+    Globals[I]->getAllMetadata(MDs);
+    for (auto MD : zip(CopyMDs, MDs))
+      if (std::get<0>(MD).first == std::get<1>(MD).first)
+        pairMetadata(VM, std::get<0>(MD).second, std::get<1>(MD).second,
+                     Visited);
+  }
+
+  // Passes may increase the alignment of the globals they access, and add
+  // attributes to the declarations they call.
+  for (size_t I = 0, E = Globals.size(); I != E; ++I)
+    if (CopyGlobals[I]->getAlignment() > Globals[I]->getAlignment())
+      Globals[I]->setAlignment(CopyGlobals[I]->getAlign());
+  for (size_t I = 0, E = Functions.size(); I != E; ++I)
+    if (Functions[I]->isDeclaration())
+      Functions[I]->setAttributes(addAttributes(
+          C, Functions[I]->getAttributes(),
+          Types.remapAttributes(CopyFunctions[I]->getAttributes())));
+
+  // The functions whose blocks have their address taken are not optimized in
+  // the copies and are only kept for the block addresses to be mapped.
+  for (size_t I = 0, E = Functions.size(); I != E; ++I)
+    if (!CopyFunctions[I]->isDeclaration() &&
+        hasAddressTakenBlock(*CopyFunctions[I]))
+      for (auto Blocks : zip(*CopyFunctions[I], *Functions[I]))
+        VM[&std::get<0>(Blocks)] = &std::get<1>(Blocks);
+
+  // Map the added globals to those added by previous partitions, or create
+  // them. The names of the local ones are uniqued by the module again.
+  SmallVector<std::pair<Function *, Function *>, 8> Bodies;
+  for (unsigned I : Replaced)
+    Bodies.emplace_back(CopyFunctions[I], Functions[I]);
+  SmallVector<std::pair<GlobalVariable *, GlobalVariable *>, 8> Initializers;
+  SmallVector<std::pair<GlobalObject *, GlobalObject *>, 8> Attachments;
+
+  auto AddGlobal = [&](GlobalObject &GO) {
+    StringRef Name = getRequestedName(GO, Copy);
+    if (!GO.hasLocalLinkage())
+      if (GlobalValue *Existing = M.getNamedValue(Name)) {
+        auto *Ty = cast<PointerType>(Types.remapType(GO.getType()));
+        VM[&GO] = ConstantExpr::getPointerBitCastOrAddrSpaceCast(Existing, Ty);
+        auto *ExistingGO = dyn_cast<GlobalObject>(Existing);
+        if (!ExistingGO || !ExistingGO->isDeclaration())
+          return;
+        if (auto *F = dyn_cast<Function>(&GO)) {
+          if (auto *ExistingF = dyn_cast<Function>(ExistingGO)) {
+            ExistingF->setAttributes(
+                addAttributes(C, ExistingF->getAttributes(),
+                              Types.remapAttributes(F->getAttributes())));
+            if (!F->isDeclaration()) {
+              ExistingF->setLinkage(F->getLinkage());
+              Bodies.emplace_back(F, ExistingF);
+            }
+          }
+        } else if (auto *GV = dyn_cast<GlobalVariable>(&GO)) {
+          if (auto *ExistingGV = dyn_cast<GlobalVariable>(ExistingGO))
+            if (GV->hasInitializer()) {
+              ExistingGV->setLinkage(GV->getLinkage());
+              Initializers.emplace_back(GV, ExistingGV);
+            }
+        }
+        return;
+      }
+
+    GlobalObject *New;
+    if (auto *F = dyn_cast<Function>(&GO)) {
+      Function *NewF = Function::Create(
+          cast<FunctionType>(Types.remapType(F->getFunctionType())),
+          F->getLinkage(), F->getAddressSpace(), Name, &M);
+      NewF->copyAttributesFrom(F);
+      NewF->setAttributes(Types.remapAttributes(F->getAttributes()));
+      if (!F->isDeclaration())
+        Bodies.emplace_back(F, NewF);
+      New = NewF;
+    } else {
+      auto *GV = cast<GlobalVariable>(&GO);
+      auto *NewGV = new GlobalVariable(
+          M, Types.remapType(GV->getValueType()), GV->isConstant(),
+          GV->getLinkage(), /*Initializer=*/nullptr, Name,
+          /*InsertBefore=*/nullptr, GlobalValue::NotThreadLocal,
+          GV->getAddressSpace());
+      NewGV->copyAttributesFrom(GV);
+      if (GV->hasInitializer())
+        Initializers.emplace_back(GV, NewGV);
+      Attachments.emplace_back(GV, NewGV);
+      New = NewGV;
+    }
+    if (const Comdat *CopyC = GO.getComdat()) {
+      Comdat *NewC = M.getOrInsertComdat(CopyC->getName());
+      NewC->setSelectionKind(CopyC->getSelectionKind());
+      New->setComdat(NewC);
+    }
+    VM[&GO] = New;
+  };
+  for (Function *F : makeArrayRef(CopyFunctions).drop_front(Functions.size()))
+    AddGlobal(*F);
+  for (GlobalVariable *GV : makeArrayRef(CopyGlobals).drop_front(Globals.size()))
+    AddGlobal(*GV);
+
+  for (auto &Body : Bodies)
+    moveBody(*Body.first, *Body.second, Types, VM);
+
+  ValueMapper Mapper(VM, RF_IgnoreMissingLocals | RF_MoveDistinctMDs,
+                     &Types);
+  for (auto &Init : Initializers)
+    Init.second->setInitializer(Mapper.mapConstant(*Init.first->getInitializer()));
+  for (auto &Attached : Attachments) {
+    SmallVector<std::pair<unsigned, MDNode *>, 4> MDs;
+    Attached.first->getAllMetadata(MDs);
+    for (const auto &MD : MDs)
+      Attached.second->addMetadata(MD.first, *Mapper.mapMDNode(*MD.second));
+  }
+  for (auto &Body : Bodies)
+    Mapper.remapFunction(*Body.second);
+}
+
+PreservedAnalyses
+ParallelModuleToFunctionPassAdaptor::run(Module &M,
+                                         ModuleAnalysisManager &AM) {
+  FunctionAnalysisManager &FAM =
+      AM.getResult<FunctionAnalysisManagerModuleProxy>(M).getManager();
+  PassInstrumentation PI = AM.getResult<PassInstrumentationAnalysis>(M);
+
+  // The pipeline the instrumentation sees, and the one run on the calling
+  // thread. Every thread builds its own.
+  FunctionPassManager Pipeline = BuildPipeline();
+
+  SmallVector<Function *, 0> Functions;
+  for (Function &F : M)
+    Functions.push_back(&F);
+  SmallVector<GlobalVariable *, 0> Globals;
+  for (GlobalVariable &GV : M.globals())
+    Globals.push_back(&GV);
+
+  // The functions whose blocks have their address taken cannot have their body
+  // replaced, as the block addresses refer to the blocks. They are run in
+  // place once the others are merged.
+  std::vector<unsigned> Scheduled, InPlace;
+  size_t ScheduledSize = 0;
+  for (unsigned I = 0, E = Functions.size(); I != E; ++I) {
+    Function &F = *Functions[I];
+    if (F.isDeclaration() || !PI.runBeforePass<Function>(Pipeline, F))
+      continue;
+    if (hasAddressTakenBlock(F)) {
+      InPlace.push_back(I);
+      continue;
+    }
+    Scheduled.push_back(I);
+    ScheduledSize += F.getInstructionCount();
+
+    // The target machine creates the subtarget of a function on the first
+    // query and caches it in a map that is not thread safe, so create them
+    // all here.
+    FAM.getResult<TargetIRAnalysis>(F);
+  }
+
+  // Contiguous partitions of about the same number of instructions, one per
+  // thread.
+  ThreadPoolStrategy Strategy = hardware_concurrency(NumThreads);
+  unsigned NumPartitions =
+      std::min<size_t>(Strategy.compute_thread_count(), Scheduled.size());
+  std::vector<ArrayRef<unsigned>> Partitions;
+  for (size_t Begin = 0, End = 0, Size = 0; Begin != Scheduled.size();
+       Begin = End) {
+    size_t Limit = ScheduledSize * (Partitions.size() + 1) / NumPartitions;
+    do
+      Size += Functions[Scheduled[End++]]->getInstructionCount();
+    while (End != Scheduled.size() && Size < Limit);
+    Partitions.push_back(makeArrayRef(Scheduled).slice(Begin, End - Begin));
+  }
+
+  std::vector<PartitionResult> Results(Partitions.size());
+  if (!Partitions.empty()) {
+    SmallVector<char, 0> Input;
+    raw_svector_ostream OS(Input);
+    // The passes may depend on the order of the uses, e.g. of the
+    // predecessors of a block, so it is kept both ways.
+    WriteBitcodeToFile(M, OS, /*ShouldPreserveUseListOrder=*/true);
+    StringRef InputRef(Input.data(), Input.size());
+    bool HasGlobalsAA = AM.getCachedResult<GlobalsAA>(M);
+    bool HasProfileSummary = AM.getCachedResult<ProfileSummaryAnalysis>(M);
+
+    std::mutex DiagLock;
+    ThreadPool Pool(hardware_concurrency(Partitions.size()));
+    for (size_t P = 0, E = Partitions.size(); P != E; ++P)
+      Pool.async([&, P] {
+        runPartition(InputRef, M.getModuleIdentifier(), M.getContext(),
+                     DiagLock, Partitions[P], BuildPipeline, RegisterAnalyses,
+                     HasGlobalsAA, HasProfileSummary, Results[P]);
+      });
+    Pool.wait();
+  }
+
+  PreservedAnalyses PA = PreservedAnalyses::all();
+  for (size_t P = 0, E = Partitions.size(); P != E; ++P) {
+    for (unsigned I : Partitions[P]) {
+      Function &F = *Functions[I];
+      FAM.clear(F, F.getName());
+    }
+
+    Expected<std::unique_ptr<Module>> CopyOrErr = parseBitcodeFile(
+        MemoryBufferRef(StringRef(Results[P].Bitcode.data(),
+                                  Results[P].Bitcode.size()),
+                        M.getModuleIdentifier()),
+        M.getContext());
+    if (!CopyOrErr)
+      report_fatal_error("parallel function passes: " +
+                         toString(CopyOrErr.takeError()));
+    mergePartition(M, Functions, Globals, **CopyOrErr, Partitions[P]);
+
+    for (size_t I = 0, E = Partitions[P].size(); I != E; ++I) {
+      PI.runAfterPass(Pipeline, *Functions[Partitions[P][I]]);
+      PA.intersect(std::move(Results[P].Results[I]));
+    }
+  }
+
+  for (unsigned I : InPlace) {
+    Function &F = *Functions[I];
+    PreservedAnalyses PassPA = Pipeline.run(F, FAM);
+    PI.runAfterPass(Pipeline, F);
+    FAM.invalidate(F, PassPA);
+    PA.intersect(std::move(PassPA));
+  }
+
+  // The results cached for the functions whose body was replaced are cleared
+  // above, the others were invalidated as the sequential adaptor would have.
+  PA.preserveSet<AllAnalysesOn<Function>>();
+  PA.preserve<FunctionAnalysisManagerModuleProxy>();
+  return PA;
+}
@@ -234,6 +234,14 @@ static cl::opt<bool>
     Statistics("statistics",
                cl::desc("Emit JSON-formatted debug info quality metrics."),
                cat(DwarfDumpCategory));
+static opt<unsigned>
+    NumThreads("num-threads",
+               desc("Extract all units up front using up to N threads "
+                    "(0 means the number of cores). Speeds up --statistics "
+                    "and --verify on large inputs."),
+               cat(DwarfDumpCategory), init(1), value_desc("N"));
+static alias NumThreadsAlias("j", desc("Alias for -num-threads."),
+                             aliasopt(NumThreads));
 static cl::opt<bool>
     ShowSectionSizes("show-section-sizes",
                      cl::desc("Show the sizes of all debug sections, "
@@ -527,6 +535,8 @@ static bool handleBuffer(StringRef Filename, MemoryBufferRef Buffer,
     if (filterArch(*Obj)) {
       std::unique_ptr<DWARFContext> DICtx =
           DWARFContext::create(*Obj, nullptr, "", RecoverableErrorHandler);
+      if (NumThreads != 1)
+        DICtx->extractAllUnits(hardware_concurrency(NumThreads));
       if (!HandleObj(*Obj, *DICtx, Filename, OS))
         Result = false;
     }
@@ -540,6 +550,8 @@ static bool handleBuffer(StringRef Filename, MemoryBufferRef Buffer,
         if (filterArch(Obj)) {
           std::unique_ptr<DWARFContext> DICtx =
               DWARFContext::create(Obj, nullptr, "", RecoverableErrorHandler);
+          if (NumThreads != 1)
+            DICtx->extractAllUnits(hardware_concurrency(NumThreads));
           if (!HandleObj(Obj, *DICtx, ObjName, OS))
             Result = false;
         }
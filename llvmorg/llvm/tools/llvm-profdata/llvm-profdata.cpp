@@ -291,6 +291,161 @@ static void mergeWriterContexts(WriterContext *Dst, WriterContext *Src) {
   });
 }
 
+/// The records read from one input of a batched merge. The records refer to
+/// function names owned by the reader, so the two are kept together.
+struct LoadedInput {
+  std::unique_ptr<InstrProfReader> Reader;
+  std::vector<NamedInstrProfRecord> Records;
+};
+
+/// Order records by function hash, then by name.
+static bool compareRecords(const NamedInstrProfRecord &L,
+                           const NamedInstrProfRecord &R) {
+  if (L.Hash != R.Hash)
+    return L.Hash < R.Hash;
+  return L.Name < R.Name;
+}
+
+/// Read all records of an input into \p LI, sorted with compareRecords().
+static void readInput(const WeightedFile &Input, SymbolRemapper *Remapper,
+                      WriterContext *WC, LoadedInput *LI) {
+  // Copy the filename, see loadInput().
+  std::string Filename = Input.Filename;
+
+  auto ReaderOrErr = InstrProfReader::create(Filename);
+  if (Error E = ReaderOrErr.takeError()) {
+    // Skip the empty profiles by returning sliently.
+    instrprof_error IPE = InstrProfError::take(std::move(E));
+    if (IPE != instrprof_error::empty_raw_profile) {
+      std::unique_lock<std::mutex> CtxGuard{WC->Lock};
+      WC->Errors.emplace_back(make_error<InstrProfError>(IPE), Filename);
+    }
+    return;
+  }
+
+  auto Reader = std::move(ReaderOrErr.get());
+  for (auto &I : *Reader) {
+    if (Remapper)
+      I.Name = (*Remapper)(I.Name);
+    LI->Records.push_back(std::move(I));
+  }
+  if (Reader->hasError())
+    if (Error E = Reader->getError()) {
+      std::unique_lock<std::mutex> CtxGuard{WC->Lock};
+      WC->Errors.emplace_back(std::move(E), Filename);
+    }
+  llvm::sort(LI->Records, compareRecords);
+  LI->Reader = std::move(Reader);
+}
+
+/// Merge a batch of loaded inputs into \p WC. Each input is sorted by
+/// function hash, so a k-way merge visits all copies of a function together
+/// and combines them before adding a single record to the writer.
+static void mergeLoadedInputs(ArrayRef<WeightedFile> Inputs,
+                              MutableArrayRef<LoadedInput> Loaded,
+                              WriterContext *WC) {
+  auto reportError = [&](instrprof_error IPE, StringRef Filename,
+                         StringRef FuncName) {
+    std::unique_lock<std::mutex> ErrGuard{WC->ErrLock};
+    bool firstTime = WC->WriterErrorCodes.insert(IPE).second;
+    handleMergeWriterError(make_error<InstrProfError>(IPE), Filename, FuncName,
+                           firstTime);
+  };
+
+  for (size_t I = 0, E = Loaded.size(); I != E; ++I) {
+    InstrProfReader *Reader = Loaded[I].Reader.get();
+    if (!Reader)
+      continue;
+    if (WC->Writer.setIsIRLevelProfile(Reader->isIRLevelProfile(),
+                                       Reader->hasCSIRLevelProfile())) {
+      WC->Errors.emplace_back(
+          make_error<StringError>(
+              "Merge IR generated profile with Clang generated profile.",
+              std::error_code()),
+          Inputs[I].Filename);
+      Loaded[I].Records.clear();
+    }
+  }
+
+  // A min-heap of (input, record index) cursors.
+  using Cursor = std::pair<size_t, size_t>;
+  auto getRecord = [&](const Cursor &C) -> NamedInstrProfRecord & {
+    return Loaded[C.first].Records[C.second];
+  };
+  auto Greater = [&](const Cursor &L, const Cursor &R) {
+    return compareRecords(getRecord(R), getRecord(L));
+  };
+  std::vector<Cursor> Heap;
+  for (size_t I = 0, E = Loaded.size(); I != E; ++I)
+    if (!Loaded[I].Records.empty())
+      Heap.emplace_back(I, 0);
+  std::make_heap(Heap.begin(), Heap.end(), Greater);
+
+  auto popCursor = [&]() {
+    std::pop_heap(Heap.begin(), Heap.end(), Greater);
+    Cursor C = Heap.back();
+    Heap.pop_back();
+    if (C.second + 1 < Loaded[C.first].Records.size()) {
+      Heap.emplace_back(C.first, C.second + 1);
+      std::push_heap(Heap.begin(), Heap.end(), Greater);
+    }
+    return C;
+  };
+
+  while (!Heap.empty()) {
+    Cursor First = popCursor();
+    NamedInstrProfRecord Merged = std::move(getRecord(First));
+    const StringRef FuncName = Merged.Name;
+    StringRef Filename = Inputs[First.first].Filename;
+    bool Reported = false;
+    auto Warn = [&](instrprof_error IPE) {
+      // Only report the first error for each input record.
+      if (Reported)
+        return;
+      Reported = true;
+      reportError(IPE, Filename, FuncName);
+    };
+    if (Inputs[First.first].Weight > 1)
+      Merged.scale(Inputs[First.first].Weight, Warn);
+
+    while (!Heap.empty() && !compareRecords(Merged, getRecord(Heap.front()))) {
+      Cursor Next = popCursor();
+      Filename = Inputs[Next.first].Filename;
+      Reported = false;
+      Merged.merge(getRecord(Next), Inputs[Next.first].Weight, Warn);
+      // The cursor has moved past this record, release its counters early.
+      getRecord(Next) = NamedInstrProfRecord();
+    }
+
+    // Errors from merging with earlier batches are attributed to the first
+    // input of this batch the function was seen in.
+    Filename = Inputs[First.first].Filename;
+    Reported = false;
+    WC->Writer.addRecord(std::move(Merged), 1, [&](Error E) {
+      Warn(InstrProfError::take(std::move(E)));
+    });
+  }
+}
+
+/// Merge \p Inputs into \p WC in batches of \p BatchSize inputs. The inputs
+/// of a batch are read in parallel and merged into the single writer before
+/// the next batch is read, so memory use is bounded by the batch size and the
+/// number of unique functions, independent of the number of inputs.
+static void mergeInputsInBatches(const WeightedFileVector &Inputs,
+                                 SymbolRemapper *Remapper, WriterContext *WC,
+                                 unsigned NumThreads, unsigned BatchSize) {
+  ThreadPool Pool(hardware_concurrency(NumThreads));
+  for (size_t Begin = 0, E = Inputs.size(); Begin < E; Begin += BatchSize) {
+    ArrayRef<WeightedFile> Batch = makeArrayRef(Inputs).slice(
+        Begin, std::min<size_t>(BatchSize, E - Begin));
+    std::vector<LoadedInput> Loaded(Batch.size());
+    for (size_t I = 0, BE = Batch.size(); I != BE; ++I)
+      Pool.async(readInput, Batch[I], Remapper, WC, &Loaded[I]);
+    Pool.wait();
+    mergeLoadedInputs(Batch, Loaded, WC);
+  }
+}
+
 static void writeInstrProfile(StringRef OutputFilename,
                               ProfileFormat OutputFormat,
                               InstrProfWriter &Writer) {
@@ -311,7 +466,8 @@ static void mergeInstrProfile(const WeightedFileVector &Inputs,
                               SymbolRemapper *Remapper,
                               StringRef OutputFilename,
                               ProfileFormat OutputFormat, bool OutputSparse,
-                              unsigned NumThreads, FailureMode FailMode) {
+                              unsigned NumThreads, unsigned BatchSize,
+                              FailureMode FailMode) {
   if (OutputFilename.compare("-") == 0)
     exitWithError("Cannot write indexed profdata format to stdout.");
 
@@ -325,18 +481,24 @@ static void mergeInstrProfile(const WeightedFileVector &Inputs,
   // If NumThreads is not specified, auto-detect a good default.
   if (NumThreads == 0)
     NumThreads = std::min(hardware_concurrency().compute_thread_count(),
-                          unsigned((Inputs.size() + 1) / 2));
+                          BatchSize ? BatchSize
+                                    : unsigned((Inputs.size() + 1) / 2));
   // FIXME: There's a bug here, where setting NumThreads = Inputs.size() fails
   // the merge_empty_profile.test because the InstrProfWriter.ProfileKind isn't
   // merged, thus the emitted file ends up with a PF_Unknown kind.
 
-  // Initialize the writer contexts.
+  // Initialize the writer contexts. A batched merge uses a single writer, the
+  // threads only read inputs.
   SmallVector<std::unique_ptr<WriterContext>, 4> Contexts;
-  for (unsigned I = 0; I < NumThreads; ++I)
+  unsigned NumContexts = BatchSize ? 1 : NumThreads;
+  for (unsigned I = 0; I < NumContexts; ++I)
     Contexts.emplace_back(std::make_unique<WriterContext>(
         OutputSparse, ErrorLock, WriterErrorCodes));
 
-  if (NumThreads == 1) {
+  if (BatchSize) {
+    mergeInputsInBatches(Inputs, Remapper, Contexts[0].get(), NumThreads,
+                         BatchSize);
+  } else if (NumThreads == 1) {
     for (const auto &Input : Inputs)
       loadInput(Input, Remapper, Contexts[0].get());
   } else {
@@ -664,6 +826,11 @@ static int merge_main(int argc, const char *argv[]) {
       cl::desc("Number of merge threads to use (default: autodetect)"));
   cl::alias NumThreadsA("j", cl::desc("Alias for --num-threads"),
                         cl::aliasopt(NumThreads));
+  cl::opt<unsigned> BatchSize(
+      "batch-size", cl::init(0),
+      cl::desc("Merge instrumentation profiles in batches of this many inputs "
+               "into a single writer, bounding memory use independently of "
+               "the number of inputs and threads (default: 0, disabled)"));
   cl::opt<std::string> ProfileSymbolListFile(
       "prof-sym-list", cl::init(""),
       cl::desc("Path to file containing the list of function symbols "
@@ -709,7 +876,8 @@ static int merge_main(int argc, const char *argv[]) {
 
   if (ProfileKind == instr)
     mergeInstrProfile(WeightedInputs, Remapper.get(), OutputFilename,
-                      OutputFormat, OutputSparse, NumThreads, FailureMode);
+                      OutputFormat, OutputSparse, NumThreads, BatchSize,
+                      FailureMode);
   else
     mergeSampleProfile(WeightedInputs, Remapper.get(), OutputFilename,
                        OutputFormat, ProfileSymbolListFile, CompressAllSections,
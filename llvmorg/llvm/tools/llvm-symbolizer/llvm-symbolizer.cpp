@@ -155,6 +155,16 @@ static cl::list<std::string>
                          cl::desc("Path to directory where to look for debug "
                                   "files."));
 
+static cl::opt<std::string>
+    ClGsymDirectory("gsym-directory", cl::init(""), cl::value_desc("dir"),
+                    cl::desc("Path to directory where to look for GSYM files "
+                             "named after the build ID of ELF objects."));
+
+static cl::opt<bool>
+    ClCreateGsym("create-gsym", cl::init(false),
+                 cl::desc("Create missing GSYM files in --gsym-directory "
+                          "from DWARF."));
+
 static cl::opt<DIPrinter::OutputStyle>
     ClOutputStyle("output-style", cl::init(DIPrinter::OutputStyle::LLVM),
                   cl::desc("Specify print style"),
@@ -317,6 +327,8 @@ int main(int argc, char **argv) {
   Opts.FallbackDebugPath = ClFallbackDebugPath;
   Opts.DWPName = ClDwpName;
   Opts.DebugFileDirectory = ClDebugFileDirectory;
+  Opts.GsymDirectory = ClGsymDirectory;
+  Opts.CreateGsym = ClCreateGsym;
   Opts.UseNativePDBReader = ClUseNativePDBReader;
   Opts.PathStyle = DILineInfoSpecifier::FileLineInfoKind::AbsoluteFilePath;
   // If both --basenames and --relativenames are specified then pick the last
@@ -0,0 +1,122 @@
+//===- EmbeddedModelRunnerTest.cpp - embedded model runner unit tests -----===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Analysis/EmbeddedModelRunner.h"
+#include "llvm/Analysis/AssumptionCache.h"
+#include "llvm/Analysis/InlineAdvisor.h"
+#include "llvm/Analysis/InlineFeaturesAnalysis.h"
+#include "llvm/Analysis/OptimizationRemarkEmitter.h"
+#include "llvm/Analysis/TargetLibraryInfo.h"
+#include "llvm/Analysis/TargetTransformInfo.h"
+#include "llvm/AsmParser/Parser.h"
+#include "llvm/IR/Instructions.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
+#include "llvm/IR/PassInstrumentation.h"
+#include "llvm/Support/SourceMgr.h"
+#include "llvm/Testing/Support/Error.h"
+#include "gtest/gtest.h"
+
+using namespace llvm;
+
+namespace {
+
+TEST(EmbeddedModelRunnerTest, BuiltInModelFollowsThreshold) {
+  LLVMContext C;
+  EmbeddedModelRunner Runner(C);
+  Runner.setFeature(FeatureIndex::CostEstimate, 100);
+  EXPECT_TRUE(Runner.run());
+  Runner.setFeature(FeatureIndex::CostEstimate, 1000);
+  EXPECT_FALSE(Runner.run());
+  Runner.setFeature(FeatureIndex::CostEstimate, -50);
+  EXPECT_TRUE(Runner.run());
+  EXPECT_EQ(-50, Runner.getFeature(
+                     static_cast<int>(FeatureIndex::CostEstimate)));
+}
+
+TEST(EmbeddedModelRunnerTest, LoadedModel) {
+  LLVMContext C;
+  auto RunnerOrErr = EmbeddedModelRunner::create(C, R"(
+# Inline callees with less than 10 blocks: the bias is just below
+# log(1 + 10), about 2.3979.
+bias 2.39789
+callee_basic_block_count -1
+)");
+  ASSERT_THAT_EXPECTED(RunnerOrErr, Succeeded());
+  EmbeddedModelRunner &Runner = **RunnerOrErr;
+
+  // The cost estimate has no weight in this model.
+  Runner.setFeature(FeatureIndex::CostEstimate, 100000);
+  Runner.setFeature(FeatureIndex::CalleeBasicBlockCount, 9);
+  EXPECT_TRUE(Runner.run());
+  EXPECT_NEAR(2.39789 - std::log(10.0), Runner.getScore(), 1e-9);
+  Runner.setFeature(FeatureIndex::CalleeBasicBlockCount, 10);
+  EXPECT_FALSE(Runner.run());
+}
+
+TEST(EmbeddedModelRunnerTest, InvalidModel) {
+  LLVMContext C;
+  EXPECT_THAT_EXPECTED(EmbeddedModelRunner::create(C, "callee_weight 1\n"),
+                       Failed());
+  EXPECT_THAT_EXPECTED(EmbeddedModelRunner::create(C, "bias one\n"), Failed());
+  EXPECT_THAT_EXPECTED(EmbeddedModelRunner::create(C, "bias\n"), Failed());
+}
+
+// Returns a function adding 1 to its argument N times. It is external, so
+// that the cost estimate of its only call does not get the last call to
+// static bonus.
+std::string getAddChain(StringRef Name, unsigned N) {
+  std::string IR = ("define i32 @" + Name + "(i32 %x0) {\n").str();
+  for (unsigned I = 1; I <= N; ++I)
+    IR += "  %x" + std::to_string(I) + " = add i32 %x" + std::to_string(I - 1) +
+          ", 1\n";
+  IR += "  ret i32 %x" + std::to_string(N) + "\n}\n";
+  return IR;
+}
+
+TEST(EmbeddedModelRunnerTest, Advisor) {
+  LLVMContext C;
+  SMDiagnostic Err;
+  std::unique_ptr<Module> M = parseAssemblyString(
+      getAddChain("small", 2) + getAddChain("large", 200) + R"IR(
+define i32 @caller(i32 %x) {
+  %a = call i32 @small(i32 %x)
+  %b = call i32 @large(i32 %a)
+  ret i32 %b
+}
+)IR",
+      Err, C);
+  ASSERT_TRUE(M);
+
+  FunctionAnalysisManager FAM;
+  ModuleAnalysisManager MAM;
+  FAM.registerPass([] { return AssumptionAnalysis(); });
+  FAM.registerPass([] { return InlineFeaturesAnalysis(); });
+  FAM.registerPass([] { return OptimizationRemarkEmitterAnalysis(); });
+  FAM.registerPass([] { return PassInstrumentationAnalysis(); });
+  FAM.registerPass([] { return TargetIRAnalysis(); });
+  FAM.registerPass([] { return TargetLibraryAnalysis(); });
+  FAM.registerPass([&] { return ModuleAnalysisManagerFunctionProxy(MAM); });
+  MAM.registerPass([&] { return FunctionAnalysisManagerModuleProxy(FAM); });
+  MAM.registerPass([] { return PassInstrumentationAnalysis(); });
+
+  std::unique_ptr<InlineAdvisor> Advisor = getEmbeddedModeAdvisor(*M, MAM);
+  ASSERT_TRUE(Advisor);
+  Advisor->onPassEntry();
+  for (Instruction &I : M->getFunction("caller")->getEntryBlock()) {
+    auto *CB = dyn_cast<CallBase>(&I);
+    if (!CB)
+      continue;
+    std::unique_ptr<InlineAdvice> Advice = Advisor->getAdvice(*CB);
+    EXPECT_EQ(CB->getCalledFunction()->getName() == "small",
+              Advice->isInliningRecommended());
+    Advice->recordUnattemptedInlining();
+  }
+}
+
+} // end anonymous namespace
@@ -22,6 +22,7 @@
 #include "llvm/IR/LegacyPassManager.h"
 #include "llvm/IR/Module.h"
 #include "llvm/IR/Verifier.h"
+#include "llvm/Support/CommandLine.h"
 #include "llvm/Support/SourceMgr.h"
 #include "gtest/gtest.h"
 
@@ -63,6 +64,10 @@ protected:
                                                    const SCEV *RHS) {
     return SE.computeConstantDifference(LHS, RHS);
   }
+
+  static unsigned getValueExprMapSize(ScalarEvolution &SE) {
+    return SE.ValueExprMap.size();
+  }
 };
 
 TEST_F(ScalarEvolutionsTest, SCEVUnknownRAUW) {
@@ -1120,4 +1125,242 @@ TEST_F(ScalarEvolutionsTest, SCEVComputeConstantDifference) {
   });
 }
 
+TEST_F(ScalarEvolutionsTest, BoundedCaches) {
+  LLVMContext C;
+  SMDiagnostic Err;
+  std::unique_ptr<Module> M = parseAssemblyString(
+      "define void @foo(i32 %n, i32 %m) { "
+      "entry: "
+      "  br label %outer "
+      "outer: "
+      "  %i = phi i32 [ 0, %entry ], [ %i.next, %outer.latch ] "
+      "  br label %inner "
+      "inner: "
+      "  %j = phi i32 [ 0, %outer ], [ %j.next, %inner ] "
+      "  %a = add i32 %i, %j "
+      "  %b = mul i32 %a, 3 "
+      "  %j.next = add nuw nsw i32 %j, 1 "
+      "  %inner.cmp = icmp ult i32 %j.next, %m "
+      "  br i1 %inner.cmp, label %inner, label %outer.latch "
+      "outer.latch: "
+      "  %i.next = add nuw nsw i32 %i, 1 "
+      "  %outer.cmp = icmp ult i32 %i.next, %n "
+      "  br i1 %outer.cmp, label %outer, label %exit "
+      "exit: "
+      "  ret void "
+      "} ",
+      Err, C);
+
+  ASSERT_TRUE(M && "Could not parse module?");
+  ASSERT_TRUE(!verifyModule(*M) && "Must have been well formed!");
+
+  auto &Opts = cl::getRegisteredOptions();
+  auto *ValueCacheSize = static_cast<cl::opt<unsigned> *>(
+      Opts["scalar-evolution-max-value-cache-size"]);
+  auto *LoopCacheSize = static_cast<cl::opt<unsigned> *>(
+      Opts["scalar-evolution-max-backedge-taken-cache-size"]);
+  unsigned OldValueCacheSize = *ValueCacheSize;
+  unsigned OldLoopCacheSize = *LoopCacheSize;
+
+  // Prints the SCEV of every value and the backedge-taken count of every
+  // loop.
+  auto Collect = [](Function &F, LoopInfo &LI, ScalarEvolution &SE) {
+    SmallVector<std::string, 16> Result;
+    auto Print = [&](const SCEV *S) {
+      Result.emplace_back();
+      raw_string_ostream OS(Result.back());
+      OS << *S;
+    };
+    for (Instruction &I : instructions(F))
+      if (SE.isSCEVable(I.getType()))
+        Print(SE.getSCEV(&I));
+    for (Loop *L : LI.getLoopsInPreorder())
+      Print(SE.getBackedgeTakenCount(L));
+    return Result;
+  };
+
+  SmallVector<std::string, 16> Expected;
+  unsigned ExpectedMapSize = 0;
+  runWithSE(*M, "foo", [&](Function &F, LoopInfo &LI, ScalarEvolution &SE) {
+    Expected = Collect(F, LI, SE);
+    ExpectedMapSize = getValueExprMapSize(SE);
+  });
+
+  // With caches that are evicted all the time, the SCEVs are recomputed to the
+  // same expressions and the value cache stays smaller.
+  ValueCacheSize->setValue(2);
+  LoopCacheSize->setValue(1);
+  runWithSE(*M, "foo", [&](Function &F, LoopInfo &LI, ScalarEvolution &SE) {
+    for (unsigned Round = 0; Round < 2; ++Round) {
+      EXPECT_EQ(Expected, Collect(F, LI, SE));
+      EXPECT_LT(getValueExprMapSize(SE), ExpectedMapSize);
+    }
+  });
+
+  ValueCacheSize->setValue(OldValueCacheSize);
+  LoopCacheSize->setValue(OldLoopCacheSize);
+}
+
+TEST_F(ScalarEvolutionsTest, BoundedCachesForget) {
+  LLVMContext C;
+  SMDiagnostic Err;
+  std::unique_ptr<Module> M = parseAssemblyString(
+      "define void @loop(i32 %x) { "
+      "entry: "
+      "  %other = mul i32 %x, 3 "
+      "  br label %loop "
+      "loop: "
+      "  %i = phi i32 [ 0, %entry ], [ %i.next, %loop ] "
+      "  %p = phi i32 [ 1, %entry ], [ %p.next, %loop ] "
+      "  %p.next = mul i32 %p, 3 "
+      "  %i.next = add nuw nsw i32 %i, 1 "
+      "  %cmp = icmp ult i32 %i.next, 4 "
+      "  br i1 %cmp, label %loop, label %exit "
+      "exit: "
+      "  ret void "
+      "} "
+      " "
+      "define void @btc(i32 %x) { "
+      "entry: "
+      "  %other = mul i32 %x, 3 "
+      "  %limit = add nuw i32 %x, 10 "
+      "  br label %loop "
+      "loop: "
+      "  %i = phi i32 [ 0, %entry ], [ %i.next, %loop ] "
+      "  %i.next = add nuw nsw i32 %i, 1 "
+      "  %cmp = icmp ult i32 %i.next, %limit "
+      "  br i1 %cmp, label %loop, label %exit "
+      "exit: "
+      "  ret void "
+      "} ",
+      Err, C);
+
+  ASSERT_TRUE(M && "Could not parse module?");
+  ASSERT_TRUE(!verifyModule(*M) && "Must have been well formed!");
+
+  auto &Opts = cl::getRegisteredOptions();
+  auto *ValueCacheSize = static_cast<cl::opt<unsigned> *>(
+      Opts["scalar-evolution-max-value-cache-size"]);
+  unsigned OldValueCacheSize = *ValueCacheSize;
+
+  // Queries a value that is not cached yet while the cache limit is 1, which
+  // evicts everything computed so far.
+  auto Evict = [&](Function &F, ScalarEvolution &SE) {
+    unsigned SizeBefore = getValueExprMapSize(SE);
+    ValueCacheSize->setValue(1);
+    SE.getSCEV(getInstructionByName(F, "other"));
+    ValueCacheSize->setValue(OldValueCacheSize);
+    EXPECT_LT(getValueExprMapSize(SE), SizeBefore);
+  };
+  auto Print = [](const SCEV *S) {
+    std::string Result;
+    raw_string_ostream OS(Result);
+    OS << *S;
+    return OS.str();
+  };
+
+  // The range of the induction variable and the exit value of %p depend on
+  // the trip count. After the trip count changes and forgetLoop is called,
+  // both must be recomputed even though the loop's values were evicted from
+  // the cache.
+  ConstantRange ForgottenRange(32, /*isFullSet=*/true);
+  std::string ForgottenBTC, ForgottenExitValue;
+  runWithSE(*M, "loop", [&](Function &F, LoopInfo &LI, ScalarEvolution &SE) {
+    Instruction *I = getInstructionByName(F, "i");
+    Instruction *P = getInstructionByName(F, "p");
+    Loop *L = LI.getLoopFor(I->getParent());
+    EXPECT_EQ(SE.getUnsignedRange(SE.getSCEV(I)).getUpper(), 4u);
+    EXPECT_EQ(Print(SE.getBackedgeTakenCount(L)), "3");
+    EXPECT_EQ(Print(SE.getSCEVAtScope(SE.getSCEV(P), nullptr)), "27");
+    Evict(F, SE);
+
+    getInstructionByName(F, "cmp")->setOperand(
+        1, ConstantInt::get(I->getType(), 3));
+    SE.forgetLoop(L);
+    ForgottenRange = SE.getUnsignedRange(SE.getSCEV(I));
+    ForgottenBTC = Print(SE.getBackedgeTakenCount(L));
+    ForgottenExitValue = Print(SE.getSCEVAtScope(SE.getSCEV(P), nullptr));
+  });
+  runWithSE(*M, "loop", [&](Function &F, LoopInfo &LI, ScalarEvolution &SE) {
+    Instruction *I = getInstructionByName(F, "i");
+    Instruction *P = getInstructionByName(F, "p");
+    EXPECT_EQ(ForgottenRange, SE.getUnsignedRange(SE.getSCEV(I)));
+    EXPECT_EQ(ForgottenRange.getUpper(), 3u);
+    EXPECT_EQ(ForgottenBTC,
+              Print(SE.getBackedgeTakenCount(LI.getLoopFor(I->getParent()))));
+    EXPECT_EQ(ForgottenExitValue, "9");
+    EXPECT_EQ(ForgottenExitValue,
+              Print(SE.getSCEVAtScope(SE.getSCEV(P), nullptr)));
+  });
+
+  // The trip count contains the SCEV of %limit. After %limit changes and
+  // forgetValue is called on it, the trip count must be recomputed even
+  // though %limit was evicted from the cache.
+  std::string OriginalBTC;
+  runWithSE(*M, "btc", [&](Function &F, LoopInfo &LI, ScalarEvolution &SE) {
+    Instruction *Limit = getInstructionByName(F, "limit");
+    Loop *L = LI.getLoopFor(getInstructionByName(F, "i")->getParent());
+    OriginalBTC = Print(SE.getBackedgeTakenCount(L));
+    Evict(F, SE);
+
+    Limit->setOperand(1, ConstantInt::get(Limit->getType(), 20));
+    SE.forgetValue(Limit);
+    ForgottenBTC = Print(SE.getBackedgeTakenCount(L));
+  });
+  runWithSE(*M, "btc", [&](Function &F, LoopInfo &LI, ScalarEvolution &SE) {
+    Loop *L = LI.getLoopFor(getInstructionByName(F, "i")->getParent());
+    EXPECT_NE(OriginalBTC, ForgottenBTC);
+    EXPECT_EQ(ForgottenBTC, Print(SE.getBackedgeTakenCount(L)));
+  });
+}
+
+TEST_F(ScalarEvolutionsTest, BoundedCachesPredicatedBackedgeTakenCount) {
+  LLVMContext C;
+  SMDiagnostic Err;
+  std::unique_ptr<Module> M = parseAssemblyString(
+      "define void @foo(i32 %n) { "
+      "entry: "
+      "  br label %loop "
+      "loop: "
+      "  %i = phi i8 [ 0, %entry ], [ %i.next, %latch ] "
+      "  %j = phi i32 [ 0, %entry ], [ %j.next, %latch ] "
+      "  %j.next = add nuw nsw i32 %j, 1 "
+      "  %j.cmp = icmp ult i32 %j.next, 1000 "
+      "  br i1 %j.cmp, label %latch, label %exit "
+      "latch: "
+      "  %i.next = add i8 %i, 1 "
+      "  %ext = zext i8 %i.next to i32 "
+      "  %cmp = icmp ult i32 %ext, %n "
+      "  br i1 %cmp, label %loop, label %exit "
+      "exit: "
+      "  ret void "
+      "} ",
+      Err, C);
+
+  ASSERT_TRUE(M && "Could not parse module?");
+  ASSERT_TRUE(!verifyModule(*M) && "Must have been well formed!");
+
+  auto &Opts = cl::getRegisteredOptions();
+  auto *ValueCacheSize = static_cast<cl::opt<unsigned> *>(
+      Opts["scalar-evolution-max-value-cache-size"]);
+  unsigned OldValueCacheSize = *ValueCacheSize;
+
+  // The exit on %cmp is only computable under a no-wrap predicate on %i.
+  // Computing the exit on %j.cmp forgets the SCEVs of the loop's values, so
+  // computing the count with predicates queries values that are not cached
+  // any more. That must not evict the placeholder of the loop from the
+  // predicated backedge-taken counts.
+  ValueCacheSize->setValue(1);
+  runWithSE(*M, "foo", [&](Function &F, LoopInfo &LI, ScalarEvolution &SE) {
+    Loop *L = LI.getLoopFor(getInstructionByName(F, "i")->getParent());
+    EXPECT_TRUE(isa<SCEVCouldNotCompute>(SE.getBackedgeTakenCount(L)));
+    SCEVUnionPredicate Preds;
+    const SCEV *BTC = SE.getPredicatedBackedgeTakenCount(L, Preds);
+    EXPECT_FALSE(isa<SCEVCouldNotCompute>(BTC));
+    EXPECT_FALSE(Preds.isAlwaysTrue());
+    EXPECT_EQ(BTC, SE.getPredicatedBackedgeTakenCount(L, Preds));
+  });
+  ValueCacheSize->setValue(OldValueCacheSize);
+}
+
 }  // end namespace llvm
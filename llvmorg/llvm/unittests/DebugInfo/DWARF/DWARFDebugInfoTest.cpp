@@ -2526,6 +2526,98 @@ TEST(DWARFDebugInfo, TestDwarfVerifyCUDontShareLineTable) {
               "offset:");
 }
 
+TEST(DWARFDebugInfo, TestExtractAllUnits) {
+  // Extract two compile units sharing one line table concurrently and verify
+  // that both end up with their DIEs and the same parsed line table.
+  StringRef yamldata = R"(
+    debug_str:
+      - ''
+      - /tmp/main.c
+      - /tmp/foo.c
+    debug_abbrev:
+      - Code:            0x00000001
+        Tag:             DW_TAG_compile_unit
+        Children:        DW_CHILDREN_no
+        Attributes:
+          - Attribute:       DW_AT_name
+            Form:            DW_FORM_strp
+          - Attribute:       DW_AT_stmt_list
+            Form:            DW_FORM_sec_offset
+    debug_info:
+      - Length:          16
+        Version:         4
+        AbbrOffset:      0
+        AddrSize:        8
+        Entries:
+          - AbbrCode:        0x00000001
+            Values:
+              - Value:           0x0000000000000001
+              - Value:           0x0000000000000000
+      - Length:          16
+        Version:         4
+        AbbrOffset:      0
+        AddrSize:        8
+        Entries:
+          - AbbrCode:        0x00000001
+            Values:
+              - Value:           0x000000000000000D
+              - Value:           0x0000000000000000
+    debug_line:
+      - Length:          60
+        Version:         2
+        PrologueLength:  34
+        MinInstLength:   1
+        DefaultIsStmt:   1
+        LineBase:        251
+        LineRange:       14
+        OpcodeBase:      13
+        StandardOpcodeLengths: [ 0, 1, 1, 1, 1, 0, 0, 0, 1, 0, 0, 1 ]
+        IncludeDirs:
+          - /tmp
+        Files:
+          - Name:            main.c
+            DirIdx:          1
+            ModTime:         0
+            Length:          0
+        Opcodes:
+          - Opcode:          DW_LNS_extended_op
+            ExtLen:          9
+            SubOpcode:       DW_LNE_set_address
+            Data:            4096
+          - Opcode:          DW_LNS_advance_line
+            SData:           9
+            Data:            4096
+          - Opcode:          DW_LNS_copy
+            Data:            4096
+          - Opcode:          DW_LNS_advance_pc
+            Data:            256
+          - Opcode:          DW_LNS_extended_op
+            ExtLen:          1
+            SubOpcode:       DW_LNE_end_sequence
+            Data:            256
+  )";
+  auto ErrOrSections = DWARFYAML::emitDebugSections(yamldata);
+  ASSERT_TRUE((bool)ErrOrSections);
+  std::unique_ptr<DWARFContext> DwarfContext =
+      DWARFContext::create(*ErrOrSections, 8);
+  DwarfContext->extractAllUnits(hardware_concurrency(2));
+
+  ASSERT_EQ(DwarfContext->getNumCompileUnits(), 2u);
+  DWARFUnit *U0 = DwarfContext->getUnitAtIndex(0);
+  DWARFUnit *U1 = DwarfContext->getUnitAtIndex(1);
+  EXPECT_EQ(U0->getNumDIEs(), 1u);
+  EXPECT_EQ(U1->getNumDIEs(), 1u);
+  Optional<const char *> Name = toString(U1->getUnitDIE().find(DW_AT_name));
+  ASSERT_TRUE(Name.hasValue());
+  EXPECT_STREQ(*Name, "/tmp/foo.c");
+
+  const DWARFDebugLine::LineTable *LT0 =
+      DwarfContext->getLineTableForUnit(U0);
+  ASSERT_NE(LT0, nullptr);
+  EXPECT_EQ(LT0, DwarfContext->getLineTableForUnit(U1));
+  EXPECT_EQ(LT0->Rows.size(), 2u);
+}
+
 TEST(DWARFDebugInfo, TestErrorReporting) {
   Triple Triple("x86_64-pc-linux");
   if (!isConfigurationSupported(Triple))
@@ -15,6 +15,7 @@
 #include "llvm/DebugInfo/GSYM/FileEntry.h"
 #include "llvm/DebugInfo/GSYM/FileWriter.h"
 #include "llvm/DebugInfo/GSYM/FunctionInfo.h"
+#include "llvm/DebugInfo/GSYM/GsymContext.h"
 #include "llvm/DebugInfo/GSYM/GsymCreator.h"
 #include "llvm/DebugInfo/GSYM/GsymReader.h"
 #include "llvm/DebugInfo/GSYM/InlineInfo.h"
@@ -1403,6 +1404,77 @@ TEST(GSYMTest, TestGsymLookups) {
     testing::ElementsAre(SourceLocation{"main", "/tmp", "main.c", 8, 32}));
 }
 
+TEST(GSYMTest, TestGsymContext) {
+  // Verify that a GsymContext answers the DIContext queries used by the
+  // symbolizer from the GSYM lookup results.
+  GsymCreator GC;
+  FunctionInfo FI(0x1000, 0x100, GC.insertString("main"));
+  const auto ByteOrder = support::endian::system_endianness();
+  FI.OptLineTable = LineTable();
+  const uint32_t MainFileIndex = GC.insertFile("/tmp/main.c");
+  const uint32_t FooFileIndex = GC.insertFile("/tmp/foo.h");
+  FI.OptLineTable->push(LineEntry(0x1000, MainFileIndex, 5));
+  FI.OptLineTable->push(LineEntry(0x1010, FooFileIndex, 10));
+  FI.OptLineTable->push(LineEntry(0x1020, MainFileIndex, 8));
+  FI.Inline = InlineInfo();
+  FI.Inline->Name = GC.insertString("inline1");
+  FI.Inline->CallFile = MainFileIndex;
+  FI.Inline->CallLine = 6;
+  FI.Inline->Ranges.insert(AddressRange(0x1010, 0x1020));
+  GC.addFunctionInfo(std::move(FI));
+  Error FinalizeErr = GC.finalize(llvm::nulls());
+  ASSERT_FALSE(FinalizeErr);
+  SmallString<512> Str;
+  raw_svector_ostream OutStrm(Str);
+  FileWriter FW(OutStrm, ByteOrder);
+  llvm::Error Err = GC.encode(FW);
+  ASSERT_FALSE((bool)Err);
+  Expected<GsymReader> GR = GsymReader::copyBuffer(OutStrm.str());
+  ASSERT_THAT_EXPECTED(GR, Succeeded());
+  GsymContext Ctx(std::move(*GR));
+
+  using FileLineInfoKind = DILineInfoSpecifier::FileLineInfoKind;
+  DILineInfoSpecifier Spec(FileLineInfoKind::AbsoluteFilePath,
+                           DINameKind::LinkageName);
+  DILineInfo Info = Ctx.getLineInfoForAddress({0x1004}, Spec);
+  EXPECT_EQ(Info.FunctionName, "main");
+  EXPECT_EQ(Info.FileName, "/tmp/main.c");
+  EXPECT_EQ(Info.Line, 5u);
+
+  // The innermost inlined function is reported for line info.
+  Info = Ctx.getLineInfoForAddress({0x1010}, Spec);
+  EXPECT_EQ(Info.FunctionName, "inline1");
+  EXPECT_EQ(Info.FileName, "/tmp/foo.h");
+  EXPECT_EQ(Info.Line, 10u);
+
+  DIInliningInfo Inlining = Ctx.getInliningInfoForAddress({0x1010}, Spec);
+  ASSERT_EQ(Inlining.getNumberOfFrames(), 2u);
+  EXPECT_EQ(Inlining.getFrame(0).FunctionName, "inline1");
+  EXPECT_EQ(Inlining.getFrame(0).Line, 10u);
+  EXPECT_EQ(Inlining.getFrame(1).FunctionName, "main");
+  EXPECT_EQ(Inlining.getFrame(1).FileName, "/tmp/main.c");
+  EXPECT_EQ(Inlining.getFrame(1).Line, 6u);
+
+  DILineInfoSpecifier BaseSpec(FileLineInfoKind::BaseNameOnly,
+                               DINameKind::None);
+  Info = Ctx.getLineInfoForAddress({0x1020}, BaseSpec);
+  EXPECT_EQ(Info.FunctionName, DILineInfo::BadString);
+  EXPECT_EQ(Info.FileName, "main.c");
+  EXPECT_EQ(Info.Line, 8u);
+
+  DILineInfoTable Table = Ctx.getLineInfoForAddressRange({0x1000}, 0x20, Spec);
+  ASSERT_EQ(Table.size(), 2u);
+  EXPECT_EQ(Table[0].first, 0x1000u);
+  EXPECT_EQ(Table[0].second.Line, 5u);
+  EXPECT_EQ(Table[1].first, 0x1010u);
+  EXPECT_EQ(Table[1].second.FileName, "/tmp/foo.h");
+
+  // Addresses outside of any function yield no information.
+  Info = Ctx.getLineInfoForAddress({0x2000}, Spec);
+  EXPECT_EQ(Info.Line, 0u);
+  EXPECT_EQ(Info.FileName, DILineInfo::BadString);
+}
+
 
 TEST(GSYMTest, TestDWARFFunctionWithAddresses) {
   // Create a single compile unit with a single function and make sure it gets
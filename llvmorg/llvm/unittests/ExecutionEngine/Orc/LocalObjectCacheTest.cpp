@@ -0,0 +1,108 @@
+//===---- LocalObjectCacheTest.cpp - Test the on-disk ORC object cache ----===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ExecutionEngine/Orc/LocalObjectCache.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/IR/IRBuilder.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Testing/Support/Error.h"
+#include "gtest/gtest.h"
+
+using namespace llvm;
+using namespace llvm::orc;
+
+namespace {
+
+class LocalObjectCacheTest : public testing::Test {
+protected:
+  void SetUp() override {
+    ASSERT_FALSE(sys::fs::createUniqueDirectory("orc-cache", CacheDir));
+  }
+
+  void TearDown() override { sys::fs::remove_directories(CacheDir); }
+
+  std::unique_ptr<Module> createModule(StringRef FnName) {
+    auto M = std::make_unique<Module>("M", Ctx);
+    auto *FTy = FunctionType::get(Type::getInt32Ty(Ctx), false);
+    auto *F = Function::Create(FTy, GlobalValue::ExternalLinkage, FnName,
+                               M.get());
+    IRBuilder<> B(BasicBlock::Create(Ctx, "entry", F));
+    B.CreateRet(B.getInt32(42));
+    return M;
+  }
+
+  std::unique_ptr<LocalObjectCache> createCache(StringRef ContextKey = "") {
+    auto Cache = LocalObjectCache::Create(CacheDir, ContextKey);
+    EXPECT_THAT_EXPECTED(Cache, Succeeded());
+    return Cache ? std::move(*Cache) : nullptr;
+  }
+
+  SmallString<128> CacheDir;
+  LLVMContext Ctx;
+};
+
+TEST_F(LocalObjectCacheTest, SharedAcrossInstances) {
+  // An object stored by one cache instance must be visible to another
+  // instance using the same directory, as it would be in another process.
+  StringRef ObjBytes = "not-really-an-object";
+  auto M = createModule("foo");
+  {
+    auto Cache = createCache();
+    ASSERT_TRUE(Cache);
+    EXPECT_EQ(Cache->getObject(M.get()), nullptr);
+    Cache->notifyObjectCompiled(M.get(), MemoryBufferRef(ObjBytes, "obj"));
+  }
+
+  auto Cache = createCache();
+  ASSERT_TRUE(Cache);
+  auto Obj = Cache->getObject(M.get());
+  ASSERT_NE(Obj, nullptr);
+  EXPECT_EQ(Obj->getBuffer(), ObjBytes);
+}
+
+TEST_F(LocalObjectCacheTest, KeyedOnContentAndContext) {
+  StringRef ObjBytes = "not-really-an-object";
+  auto Cache = createCache("cpu=generic");
+  ASSERT_TRUE(Cache);
+  auto M = createModule("foo");
+  EXPECT_EQ(Cache->getObject(M.get()), nullptr);
+  Cache->notifyObjectCompiled(M.get(), MemoryBufferRef(ObjBytes, "obj"));
+
+  // An identical module created independently hits the same entry.
+  auto Same = createModule("foo");
+  EXPECT_NE(Cache->getObject(Same.get()), nullptr);
+
+  // Different IR misses.
+  auto Other = createModule("bar");
+  EXPECT_EQ(Cache->getObject(Other.get()), nullptr);
+
+  // The same IR compiled under a different context key misses.
+  auto OtherContext = createCache("cpu=skylake");
+  ASSERT_TRUE(OtherContext);
+  EXPECT_EQ(OtherContext->getObject(M.get()), nullptr);
+}
+
+TEST_F(LocalObjectCacheTest, KeyComputedBeforeCodeGen) {
+  // Code generation may rewrite the module between the lookup and the
+  // notification; the entry must be stored under the pre-codegen key.
+  StringRef ObjBytes = "not-really-an-object";
+  auto Cache = createCache();
+  ASSERT_TRUE(Cache);
+  auto M = createModule("foo");
+  EXPECT_EQ(Cache->getObject(M.get()), nullptr);
+  M->getFunction("foo")->setName("mutated");
+  Cache->notifyObjectCompiled(M.get(), MemoryBufferRef(ObjBytes, "obj"));
+
+  auto Fresh = createModule("foo");
+  EXPECT_NE(Cache->getObject(Fresh.get()), nullptr);
+}
+
+} // end anonymous namespace
@@ -0,0 +1,127 @@
+//===- BareboneTailCallTest.cpp -------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "TestBase.h"
+
+using namespace llvm;
+
+namespace {
+
+// InstNext from the barebone example in README.md: decode the instruction at
+// %ip and dispatch to its handler with the operands in rax and rcx.
+const char *InstNextIR = R"(
+define barebonecc void @InstNext(i8* %dispatch, i32* %ip) #0 {
+entry:
+  %w = load i32, i32* %ip, align 4
+  %w64 = zext i32 %w to i64
+  %op = and i64 %w64, 255
+  %table = bitcast i8* %dispatch to void (i8*, i32*, i64, i64)**
+  %slot = getelementptr inbounds void (i8*, i32*, i64, i64)*,
+                                 void (i8*, i32*, i64, i64)** %table, i64 %op
+  %handler = load void (i8*, i32*, i64, i64)*,
+                  void (i8*, i32*, i64, i64)** %slot, align 8
+  %ip.next = getelementptr inbounds i32, i32* %ip, i64 1
+  %b.shift = lshr i64 %w64, 8
+  %b = and i64 %b.shift, 255
+  %ac = lshr i64 %w64, 16
+  musttail call barebonecc void %handler(i8* %dispatch, i32* %ip.next,
+                                         i64 %b, i64 %ac) #1
+  ret void
+}
+
+attributes #0 = { nounwind "frame-pointer"="none" "hwreg"="r15,rbx" ATTRS }
+attributes #1 = { "hwreg"="r15,rbx,rax,rcx" }
+)";
+
+class BareboneTailCallTest : public X86AsmTestBase {
+protected:
+  // Compiles InstNext with the given extra function attributes and returns
+  // its instructions. Any thunks emitted after it are skipped.
+  SmallVector<std::string, 32> compile(StringRef Attrs = "") {
+    return getInstructions(
+        X86AsmTestBase::compile(InstNextIR, Attrs, CodeGenOpt::Aggressive));
+  }
+};
+
+TEST_F(BareboneTailCallTest, DispatchThroughMemory) {
+  SmallVector<std::string, 32> Insts = compile();
+  ASSERT_FALSE(Insts.empty());
+
+  // The handler is not loaded into a register first: the tail call jumps
+  // through the dispatch table entry.
+  EXPECT_TRUE(StringRef(Insts.back()).startswith("jmpq\t*(%r15,"))
+      << Insts.back();
+  for (StringRef Inst : Insts)
+    EXPECT_FALSE(Inst.startswith("movq\t(%r15,")) << Inst;
+}
+
+TEST_F(BareboneTailCallTest, NarrowOperandDecode) {
+  SmallVector<std::string, 32> Insts = compile();
+  ASSERT_FALSE(Insts.empty());
+
+  // The upper half of the instruction word is known to be zero, so the ac
+  // operand is extracted with a 32-bit shift.
+  bool HasShr32 = false;
+  for (StringRef Inst : Insts) {
+    EXPECT_FALSE(Inst.startswith("shrq")) << Inst;
+    HasShr32 |= Inst.startswith("shrl\t$16");
+  }
+  EXPECT_TRUE(HasShr32);
+}
+
+#define RETPOLINE                                                              \
+  "\"target-features\"=\"+retpoline-indirect-calls,"                          \
+  "+retpoline-indirect-branches\""
+
+TEST_F(BareboneTailCallTest, RetpolineDispatch) {
+  SmallVector<std::string, 32> Insts = compile(RETPOLINE);
+  ASSERT_FALSE(Insts.empty());
+  EXPECT_EQ("jmp\t__llvm_retpoline_r11", Insts.back());
+}
+
+TEST_F(BareboneTailCallTest, LFenceDispatch) {
+  SmallVector<std::string, 32> Insts =
+      compile(RETPOLINE " \"indirect-branch-mitigation\"=\"lfence\"");
+  ASSERT_GE(Insts.size(), 2u);
+
+  // The dispatch jumps through a register right after an LFENCE.
+  EXPECT_EQ("lfence", Insts[Insts.size() - 2]);
+  EXPECT_TRUE(StringRef(Insts.back()).startswith("jmpq\t*%r"))
+      << Insts.back();
+  for (StringRef Inst : Insts)
+    EXPECT_EQ(StringRef::npos, Inst.find("retpoline")) << Inst;
+}
+
+TEST_F(BareboneTailCallTest, LFenceDispatchCalleeSavedRegisters) {
+  // R10 to R15 are callee-saved under regcall on Win64, so the epilogue of
+  // the tail call restores them before the jump.
+  SmallVector<std::string, 32> Insts = getInstructions(X86AsmTestBase::compile(
+      R"(
+target triple = "x86_64-pc-windows-msvc"
+
+define x86_regcallcc void @f(void (i64)* %p, i64 %a) #0 {
+  musttail call x86_regcallcc void %p(i64 %a)
+  ret void
+}
+
+attributes #0 = { nounwind ATTRS }
+)",
+      RETPOLINE " \"indirect-branch-mitigation\"=\"lfence\""));
+  ASSERT_FALSE(Insts.empty());
+
+  // Win64 tail calls are marked with a REX.W prefix.
+  StringRef Jump = Insts.back();
+  EXPECT_TRUE(Jump.consume_front("rex64 jmpq\t*%")) << Jump;
+  for (StringRef Reg : {"r10", "r11", "r12", "r13", "r14", "r15", "rbx", "rbp"})
+    EXPECT_NE(Reg, Jump);
+  EXPECT_TRUE(llvm::is_contained(Insts, "lfence"));
+  for (StringRef Inst : Insts)
+    EXPECT_FALSE(Inst.startswith("pop")) << Inst;
+}
+
+} // end anonymous namespace
@@ -0,0 +1,162 @@
+//===- TailCallPathLayoutTest.cpp -----------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "TestBase.h"
+#include "llvm/ADT/STLExtras.h"
+
+using namespace llvm;
+
+namespace {
+
+// A division handler: the rarely taken error checks come first in the source
+// and branch to blocks that tail call the error handler, the fast path ends in
+// the dispatch to the next handler.
+const char *InstDivIR = R"(
+define barebonecc void @InstDiv(i8* %dispatch, i32* %ip, i64 %b, i64 %c) #0 {
+entry:
+  %zero = icmp eq i64 %c, 0
+  br i1 %zero, label %div.zero, label %check.ovf, !prof !0
+
+div.zero:
+  musttail call barebonecc void @Throw(i8* %dispatch, i32* %ip, i64 0,
+                                       i64 %c) #1
+  ret void
+
+check.ovf:
+  %minus1 = icmp eq i64 %c, -1
+  br i1 %minus1, label %div.ovf, label %div, !prof !0
+
+div.ovf:
+  musttail call barebonecc void @Throw(i8* %dispatch, i32* %ip, i64 1,
+                                       i64 %c) #1
+  ret void
+
+div:
+  %q = sdiv i64 %b, %c
+  %w = load i32, i32* %ip, align 4
+  %op = zext i32 %w to i64
+  %op.masked = and i64 %op, 255
+  %table = bitcast i8* %dispatch to void (i8*, i32*, i64, i64)**
+  %slot = getelementptr inbounds void (i8*, i32*, i64, i64)*,
+                                 void (i8*, i32*, i64, i64)** %table,
+                                 i64 %op.masked
+  %handler = load void (i8*, i32*, i64, i64)*,
+                  void (i8*, i32*, i64, i64)** %slot, align 8
+  %ip.next = getelementptr inbounds i32, i32* %ip, i64 1
+  musttail call barebonecc void %handler(i8* %dispatch, i32* %ip.next,
+                                         i64 %q, i64 %c) #1
+  ret void
+}
+
+declare barebonecc void @Throw(i8*, i32*, i64, i64)
+
+attributes #0 = { nounwind "frame-pointer"="none" "hwreg"="r15,rbx,rax,rcx" }
+attributes #1 = { "hwreg"="r15,rbx,rax,rcx" }
+
+!0 = !{!"branch_weights", i32 1, i32 2000}
+)";
+
+// An addition handler with a fast path for small operands, taken three times
+// out of four, and a slower one. Each path has a rarely taken overflow check
+// branching to a block of its own that tail calls the error handler, and both
+// join in the dispatch to the next handler. The greedy layout places the
+// error block of the first path between it and the dispatch.
+const char *InstAddIR = R"(
+define barebonecc void @InstAdd(i8* %dispatch, i32* %ip, i64 %b, i64 %c) #0 {
+entry:
+  %small = icmp ult i64 %b, 256
+  br i1 %small, label %add.small, label %add.wide, !prof !1
+
+add.small:
+  %s = add i64 %b, %c
+  %s.ovf = icmp ugt i64 %s, 4294967295
+  br i1 %s.ovf, label %small.ovf, label %next, !prof !0
+
+small.ovf:
+  musttail call barebonecc void @Throw(i8* %dispatch, i32* %ip, i64 0,
+                                       i64 %c) #1
+  ret void
+
+add.wide:
+  %r = call { i64, i1 } @llvm.sadd.with.overflow.i64(i64 %b, i64 %c)
+  %w = extractvalue { i64, i1 } %r, 0
+  %w.ovf = extractvalue { i64, i1 } %r, 1
+  br i1 %w.ovf, label %wide.ovf, label %next, !prof !0
+
+wide.ovf:
+  musttail call barebonecc void @Throw(i8* %dispatch, i32* %ip, i64 1,
+                                       i64 %c) #1
+  ret void
+
+next:
+  %v = phi i64 [ %s, %add.small ], [ %w, %add.wide ]
+  %word = load i32, i32* %ip, align 4
+  %op = zext i32 %word to i64
+  %op.masked = and i64 %op, 255
+  %table = bitcast i8* %dispatch to void (i8*, i32*, i64, i64)**
+  %slot = getelementptr inbounds void (i8*, i32*, i64, i64)*,
+                                 void (i8*, i32*, i64, i64)** %table,
+                                 i64 %op.masked
+  %handler = load void (i8*, i32*, i64, i64)*,
+                  void (i8*, i32*, i64, i64)** %slot, align 8
+  %ip.next = getelementptr inbounds i32, i32* %ip, i64 1
+  musttail call barebonecc void %handler(i8* %dispatch, i32* %ip.next,
+                                         i64 %v, i64 %c) #1
+  ret void
+}
+
+declare barebonecc void @Throw(i8*, i32*, i64, i64)
+declare { i64, i1 } @llvm.sadd.with.overflow.i64(i64, i64)
+
+attributes #0 = { nounwind "frame-pointer"="none" "hwreg"="r15,rbx,rax,rcx" }
+attributes #1 = { "hwreg"="r15,rbx,rax,rcx" }
+
+!0 = !{!"branch_weights", i32 1, i32 2000}
+!1 = !{!"branch_weights", i32 3, i32 1}
+)";
+
+class TailCallPathLayoutTest : public X86AsmTestBase {
+protected:
+  // Compiles the handler in \p IR and returns its instructions.
+  SmallVector<std::string, 32> compile(StringRef IR) {
+    return getInstructions(
+        X86AsmTestBase::compile(IR, "", CodeGenOpt::Aggressive));
+  }
+
+  // Checks that the most probable path of the handler in \p IR runs from the
+  // entry to the dispatch without an unconditional jump, and that the error
+  // paths are placed after the dispatch.
+  void expectFastPathFallsThrough(StringRef IR) {
+    SmallVector<std::string, 32> Insts = compile(IR);
+    ASSERT_FALSE(Insts.empty());
+
+    auto Dispatch = llvm::find_if(Insts, [](StringRef Inst) {
+      return Inst.startswith("jmpq\t*");
+    });
+    ASSERT_NE(Insts.end(), Dispatch);
+    for (auto I = Insts.begin(); I != Dispatch; ++I) {
+      EXPECT_FALSE(StringRef(*I).startswith("jmp\t")) << *I;
+      EXPECT_EQ(StringRef::npos, I->find("Throw")) << *I;
+    }
+
+    bool HasThrow = false;
+    for (auto I = Dispatch; I != Insts.end(); ++I)
+      HasThrow |= I->find("Throw") != std::string::npos;
+    EXPECT_TRUE(HasThrow);
+  }
+};
+
+TEST_F(TailCallPathLayoutTest, FastPathFallsThrough) {
+  expectFastPathFallsThrough(InstDivIR);
+}
+
+TEST_F(TailCallPathLayoutTest, ErrorBlockOffJoiningPath) {
+  expectFastPathFallsThrough(InstAddIR);
+}
+
+} // end anonymous namespace
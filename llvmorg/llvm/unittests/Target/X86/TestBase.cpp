@@ -0,0 +1,68 @@
+//===- TestBase.cpp -------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "TestBase.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/AsmParser/Parser.h"
+#include "llvm/IR/LegacyPassManager.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/SourceMgr.h"
+#include "llvm/Support/TargetRegistry.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Target/TargetMachine.h"
+
+using namespace llvm;
+
+std::string X86AsmTestBase::compile(StringRef IR, StringRef Attrs,
+                                    CodeGenOpt::Level OptLevel) {
+  std::string Source = IR.str();
+  size_t Pos = Source.find("ATTRS");
+  if (Pos != std::string::npos)
+    Source.replace(Pos, 5, Attrs.str());
+
+  LLVMContext Context;
+  SMDiagnostic Err;
+  std::unique_ptr<Module> M = parseAssemblyString(Source, Err, Context);
+  if (!M) {
+    Err.print("X86Tests", errs());
+    ADD_FAILURE() << "cannot parse the IR";
+    return "";
+  }
+
+  std::string Error;
+  Triple TT(M->getTargetTriple().empty() ? "x86_64-unknown-linux-gnu"
+                                         : M->getTargetTriple());
+  const Target *T = TargetRegistry::lookupTarget(TT.getTriple(), Error);
+  std::unique_ptr<TargetMachine> TM(T->createTargetMachine(
+      TT.getTriple(), "", "", TargetOptions(), Reloc::Static, None, OptLevel));
+  M->setDataLayout(TM->createDataLayout());
+
+  SmallString<4096> Asm;
+  raw_svector_ostream OS(Asm);
+  legacy::PassManager PM;
+  if (TM->addPassesToEmitFile(PM, OS, nullptr, CGFT_AssemblyFile)) {
+    ADD_FAILURE() << "cannot emit assembly";
+    return "";
+  }
+  PM.run(*M);
+  return Asm.str().str();
+}
+
+SmallVector<std::string, 32> X86AsmTestBase::getInstructions(StringRef Asm) {
+  SmallVector<std::string, 32> Insts;
+  for (StringRef Rest = Asm; !Rest.empty();) {
+    StringRef Line;
+    std::tie(Line, Rest) = Rest.split('\n');
+    Line = Line.split('#').first.trim();
+    if (Line.startswith(".Lfunc_end"))
+      break;
+    if (!Line.empty() && !Line.startswith(".") && !Line.endswith(":"))
+      Insts.push_back(Line.str());
+  }
+  return Insts;
+}
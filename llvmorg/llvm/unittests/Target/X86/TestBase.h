@@ -0,0 +1,45 @@
+//===-- TestBase.h ----------------------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+// Test fixture for the X86 tests that check the assembly of a function.
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_UNITTESTS_TARGET_X86_TESTBASE_H
+#define LLVM_UNITTESTS_TARGET_X86_TESTBASE_H
+
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/CodeGen.h"
+#include "llvm/Support/TargetSelect.h"
+#include "gtest/gtest.h"
+#include <string>
+
+namespace llvm {
+
+class X86AsmTestBase : public testing::Test {
+protected:
+  static void SetUpTestCase() {
+    LLVMInitializeX86TargetInfo();
+    LLVMInitializeX86Target();
+    LLVMInitializeX86TargetMC();
+    LLVMInitializeX86AsmPrinter();
+  }
+
+  /// Compiles \p IR for its target triple, or x86_64-unknown-linux-gnu if it
+  /// has none, and returns the assembly, or an empty string if the IR does not
+  /// parse. The first "ATTRS" in \p IR, if any, is replaced by \p Attrs.
+  static std::string compile(StringRef IR, StringRef Attrs = "",
+                             CodeGenOpt::Level OptLevel = CodeGenOpt::Default);
+
+  /// Returns the instructions of the first function in \p Asm, one per line,
+  /// without labels, directives and comments.
+  static SmallVector<std::string, 32> getInstructions(StringRef Asm);
+};
+
+} // end namespace llvm
+
+#endif
@@ -0,0 +1,93 @@
+//===- ThreadedDispatchTest.cpp -------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "TestBase.h"
+#include "llvm/ADT/STLExtras.h"
+
+using namespace llvm;
+
+namespace {
+
+// A bytecode interpreter loop: the switch is lowered to a range check and a
+// jump through a jump table.
+const char *InterpreterIR = R"(
+define i32 @interp(i8* %code, i32 %acc0) ATTRS {
+entry:
+  br label %dispatch
+
+dispatch:
+  %pc = phi i8* [ %code, %entry ], [ %pc.next, %inc ], [ %pc.next, %dec ],
+                [ %pc.next, %dbl ], [ %pc.next, %neg ], [ %pc.next, %xor ],
+                [ %pc.next, %shr ]
+  %acc = phi i32 [ %acc0, %entry ], [ %acc.inc, %inc ], [ %acc.dec, %dec ],
+                 [ %acc.dbl, %dbl ], [ %acc.neg, %neg ], [ %acc.xor, %xor ],
+                 [ %acc.shr, %shr ]
+  %op = load i8, i8* %pc
+  %pc.next = getelementptr i8, i8* %pc, i64 1
+  switch i8 %op, label %exit [
+    i8 0, label %inc
+    i8 1, label %dec
+    i8 2, label %dbl
+    i8 3, label %neg
+    i8 4, label %xor
+    i8 5, label %shr
+  ]
+
+inc:
+  %acc.inc = add i32 %acc, 1
+  br label %dispatch
+
+dec:
+  %acc.dec = add i32 %acc, -1
+  br label %dispatch
+
+dbl:
+  %acc.dbl = shl i32 %acc, 1
+  br label %dispatch
+
+neg:
+  %acc.neg = sub i32 0, %acc
+  br label %dispatch
+
+xor:
+  %acc.xor = xor i32 %acc, 1431655765
+  br label %dispatch
+
+shr:
+  %acc.shr = lshr i32 %acc, 3
+  br label %dispatch
+
+exit:
+  ret i32 %acc
+}
+
+attributes #0 = { "threaded-dispatch" }
+)";
+
+class ThreadedDispatchTest : public X86AsmTestBase {
+protected:
+  // Compiles the interpreter with the given function attributes and returns
+  // the number of jumps through its jump table.
+  unsigned countJumpTableBranches(StringRef Attrs) {
+    return llvm::count_if(
+        getInstructions(compile(InterpreterIR, Attrs)), [](StringRef Inst) {
+          return Inst.startswith("jmpq\t*.LJTI0_0");
+        });
+  }
+};
+
+TEST_F(ThreadedDispatchTest, SharedDispatch) {
+  EXPECT_EQ(1u, countJumpTableBranches(""));
+}
+
+TEST_F(ThreadedDispatchTest, ReplicatedDispatch) {
+  // One jump from the entry and one at the end of each of the six cases.
+  EXPECT_EQ(7u, countJumpTableBranches("#0"));
+}
+
+} // end anonymous namespace
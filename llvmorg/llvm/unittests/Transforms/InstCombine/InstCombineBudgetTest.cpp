@@ -0,0 +1,102 @@
+//===- InstCombineBudgetTest.cpp - InstCombine visit budget unit tests ----===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ADT/Statistic.h"
+#include "llvm/AsmParser/Parser.h"
+#include "llvm/IR/Module.h"
+#include "llvm/IR/Verifier.h"
+#include "llvm/Passes/PassBuilder.h"
+#include "llvm/Support/SourceMgr.h"
+#include "llvm/Testing/Support/Error.h"
+#include "gtest/gtest.h"
+
+using namespace llvm;
+
+namespace {
+
+// Returns a function adding 1 to its argument N times, which instcombine folds
+// into a single add.
+std::string getAddChain(unsigned N) {
+  std::string IR = "define i32 @f(i32 %x0) {\n";
+  for (unsigned I = 1; I <= N; ++I)
+    IR += "  %x" + std::to_string(I) + " = add i32 %x" + std::to_string(I - 1) +
+          ", 1\n";
+  IR += "  ret i32 %x" + std::to_string(N) + "\n}\n";
+  return IR;
+}
+
+// Runs the given pipeline on the add chain and returns the number of
+// instructions left in @f.
+unsigned runPipeline(StringRef PipelineStr, unsigned N) {
+  LLVMContext Ctx;
+  SMDiagnostic Error;
+  std::unique_ptr<Module> M = parseAssemblyString(getAddChain(N), Error, Ctx);
+  EXPECT_TRUE(M);
+  if (!M)
+    return 0;
+
+  PassBuilder PB;
+  LoopAnalysisManager LAM;
+  FunctionAnalysisManager FAM;
+  CGSCCAnalysisManager CGAM;
+  ModuleAnalysisManager MAM;
+  PB.registerModuleAnalyses(MAM);
+  PB.registerCGSCCAnalyses(CGAM);
+  PB.registerFunctionAnalyses(FAM);
+  PB.registerLoopAnalyses(LAM);
+  PB.crossRegisterProxies(LAM, FAM, CGAM, MAM);
+
+  ModulePassManager MPM;
+  EXPECT_THAT_ERROR(PB.parsePassPipeline(MPM, PipelineStr), Succeeded());
+  MPM.run(*M, MAM);
+  EXPECT_FALSE(verifyModule(*M, &errs()));
+  return M->getFunction("f")->getInstructionCount();
+}
+
+class InstCombineBudgetTest : public testing::Test {
+protected:
+  // A statistic only registers if statistics are enabled when it is first
+  // incremented.
+  static void SetUpTestCase() { EnableStatistics(/*PrintOnExit=*/false); }
+};
+
+TEST_F(InstCombineBudgetTest, FixpointFoldsChain) {
+  EXPECT_EQ(2u, runPipeline("instcombine", 32));
+}
+
+TEST_F(InstCombineBudgetTest, OneShotStopsEarly) {
+  // Each fold revisits the folded instruction, so a single visit per
+  // instruction is not enough to fold the whole chain.
+  unsigned Left = runPipeline("instcombine-one-shot", 32);
+  EXPECT_GT(Left, 2u);
+  EXPECT_LT(Left, 34u);
+}
+
+#if LLVM_ENABLE_STATS
+// Returns the number of functions whose visit budget was exhausted.
+unsigned getNumBudgetExhausted() {
+  for (const auto &Stat : GetStatistics())
+    if (Stat.first == "NumBudgetExhausted")
+      return Stat.second;
+  return 0;
+}
+
+TEST_F(InstCombineBudgetTest, BudgetExhaustedOnlyWhenWorkIsDropped) {
+  ResetStatistics();
+
+  // Nothing folds in a single add, so the worklist empties exactly when the
+  // one visit per instruction is used up.
+  EXPECT_EQ(2u, runPipeline("instcombine-one-shot", 1));
+  EXPECT_EQ(0u, getNumBudgetExhausted());
+
+  EXPECT_GT(runPipeline("instcombine-one-shot", 32), 2u);
+  EXPECT_EQ(1u, getNumBudgetExhausted());
+}
+#endif
+
+} // end anonymous namespace
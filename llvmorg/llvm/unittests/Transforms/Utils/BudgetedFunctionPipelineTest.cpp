@@ -0,0 +1,237 @@
+//===- BudgetedFunctionPipelineTest.cpp - JIT pipeline unit tests ---------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Transforms/Utils/BudgetedFunctionPipeline.h"
+#include "llvm/AsmParser/Parser.h"
+#include "llvm/IR/InstIterator.h"
+#include "llvm/IR/Instructions.h"
+#include "llvm/IR/Module.h"
+#include "llvm/IR/Verifier.h"
+#include "llvm/Passes/PassBuilder.h"
+#include "llvm/Support/SourceMgr.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Testing/Support/Error.h"
+#include "gtest/gtest.h"
+#include <thread>
+
+using namespace llvm;
+
+namespace {
+
+const char *ModuleIR = R"IR(
+define internal i32 @callee(i32 %x) {
+  %a = alloca i32
+  store i32 %x, i32* %a
+  %v = load i32, i32* %a
+  %r = add i32 %v, 1
+  ret i32 %r
+}
+
+define i32 @loop(i32* %p, i32 %n, i32 %k) {
+entry:
+  br label %header
+header:
+  %i = phi i32 [ 0, %entry ], [ %i.next, %body ]
+  %done = icmp eq i32 %i, %n
+  br i1 %done, label %exit, label %body
+body:
+  %inv = mul i32 %k, %k
+  %c = call i32 @callee(i32 %inv)
+  %gep = getelementptr i32, i32* %p, i32 %i
+  store i32 %c, i32* %gep
+  %i.next = add i32 %i, 1
+  br label %header
+exit:
+  ret i32 %i
+}
+)IR";
+
+/// Counts its runs, and takes Delay to run.
+struct StagePass : PassInfoMixin<StagePass> {
+  unsigned &Runs;
+  std::chrono::microseconds Delay;
+
+  StagePass(unsigned &Runs, std::chrono::microseconds Delay = {})
+      : Runs(Runs), Delay(Delay) {}
+
+  PreservedAnalyses run(Function &F, FunctionAnalysisManager &) {
+    ++Runs;
+    std::this_thread::sleep_for(Delay);
+    return PreservedAnalyses::all();
+  }
+};
+
+FunctionPassManager getStage(unsigned &Runs,
+                             std::chrono::microseconds Delay = {}) {
+  FunctionPassManager FPM;
+  FPM.addPass(StagePass(Runs, Delay));
+  return FPM;
+}
+
+// Runs three stages, the first one taking FirstStageDelay, on every function
+// of the module, NumVisits times. Returns the number of functions.
+unsigned runStages(std::chrono::microseconds Budget,
+                   std::chrono::microseconds FirstStageDelay,
+                   unsigned (&Runs)[3], unsigned NumVisits = 1) {
+  LLVMContext Ctx;
+  SMDiagnostic Error;
+  std::unique_ptr<Module> M = parseAssemblyString(ModuleIR, Error, Ctx);
+  EXPECT_TRUE(M);
+
+  FunctionAnalysisManager FAM;
+  FAM.registerPass([] { return PassInstrumentationAnalysis(); });
+
+  auto FunctionBudget = std::make_shared<FunctionTimeBudget>(Budget);
+  BudgetedFunctionPipeline Stages(FunctionBudget);
+  Stages.addStage(getStage(Runs[0], FirstStageDelay));
+  Stages.addStage(getStage(Runs[1]));
+  Stages.addStage(getStage(Runs[2]));
+  for (unsigned I = 0; I < NumVisits; ++I)
+    for (Function &F : *M)
+      Stages.run(F, FAM);
+  return M->size();
+}
+
+TEST(BudgetedFunctionPipelineTest, NoBudget) {
+  unsigned Runs[3] = {0, 0, 0};
+  unsigned NumFunctions = runStages(std::chrono::microseconds(0),
+                                    std::chrono::milliseconds(2), Runs);
+  EXPECT_EQ(NumFunctions, Runs[0]);
+  EXPECT_EQ(NumFunctions, Runs[1]);
+  EXPECT_EQ(NumFunctions, Runs[2]);
+}
+
+TEST(BudgetedFunctionPipelineTest, WithinBudget) {
+  unsigned Runs[3] = {0, 0, 0};
+  unsigned NumFunctions =
+      runStages(std::chrono::seconds(60), std::chrono::microseconds(0), Runs);
+  EXPECT_EQ(NumFunctions, Runs[0]);
+  EXPECT_EQ(NumFunctions, Runs[1]);
+  EXPECT_EQ(NumFunctions, Runs[2]);
+}
+
+TEST(BudgetedFunctionPipelineTest, OverBudget) {
+  // The first stage always runs, even when it overruns the budget.
+  unsigned Runs[3] = {0, 0, 0};
+  unsigned NumFunctions = runStages(std::chrono::microseconds(100),
+                                    std::chrono::milliseconds(2), Runs);
+  EXPECT_EQ(NumFunctions, Runs[0]);
+  EXPECT_EQ(0u, Runs[1]);
+  EXPECT_EQ(0u, Runs[2]);
+}
+
+TEST(BudgetedFunctionPipelineTest, BudgetSpansVisits) {
+  // A function visited again does not get a new budget: the first visit
+  // leaves it 10ms, which the first stage of the second visit uses up.
+  unsigned Runs[3] = {0, 0, 0};
+  auto Budget = std::chrono::milliseconds(30);
+  auto Delay = std::chrono::milliseconds(20);
+  unsigned NumFunctions = runStages(Budget, Delay, Runs, /*NumVisits=*/2);
+  EXPECT_EQ(2 * NumFunctions, Runs[0]);
+  EXPECT_EQ(NumFunctions, Runs[1]);
+  EXPECT_EQ(NumFunctions, Runs[2]);
+}
+
+TEST(BudgetedFunctionPipelineTest, ResetBudget) {
+  LLVMContext Ctx;
+  SMDiagnostic Error;
+  std::unique_ptr<Module> M = parseAssemblyString(ModuleIR, Error, Ctx);
+  ASSERT_TRUE(M);
+  Function &F = *M->getFunction("loop");
+
+  FunctionTimeBudget Budget(std::chrono::milliseconds(30));
+  Budget.charge(F, std::chrono::milliseconds(20));
+  EXPECT_FALSE(Budget.isExhausted(F));
+  Budget.charge(F, std::chrono::milliseconds(20));
+  EXPECT_TRUE(Budget.isExhausted(F));
+  EXPECT_FALSE(Budget.isExhausted(*M->getFunction("callee")));
+
+  ModuleAnalysisManager MAM;
+  auto Shared =
+      std::make_shared<FunctionTimeBudget>(std::chrono::milliseconds(30));
+  Shared->charge(F, std::chrono::milliseconds(40));
+  ResetFunctionTimeBudgetPass(Shared).run(*M, MAM);
+  EXPECT_FALSE(Shared->isExhausted(F));
+}
+
+TEST(BudgetedFunctionPipelineTest, UnnamedFunctions) {
+  LLVMContext Ctx;
+  SMDiagnostic Error;
+  const char *IR = R"IR(
+define internal void @0() {
+  ret void
+}
+
+define internal void @1() {
+  ret void
+}
+)IR";
+  std::unique_ptr<Module> M = parseAssemblyString(IR, Error, Ctx);
+  ASSERT_TRUE(M);
+  Function &F0 = *M->begin();
+  Function &F1 = *std::next(M->begin());
+  ASSERT_FALSE(F0.hasName());
+  ASSERT_FALSE(F1.hasName());
+
+  // Unnamed functions do not share a budget.
+  FunctionTimeBudget Budget(std::chrono::milliseconds(30));
+  Budget.charge(F0, std::chrono::milliseconds(40));
+  EXPECT_TRUE(Budget.isExhausted(F0));
+  EXPECT_FALSE(Budget.isExhausted(F1));
+  Budget.charge(F1, std::chrono::milliseconds(20));
+  EXPECT_FALSE(Budget.isExhausted(F1));
+
+  Budget.reset();
+  EXPECT_FALSE(Budget.isExhausted(F0));
+}
+
+TEST(BudgetedFunctionPipelineTest, JITPipelines) {
+  for (const char *Pipeline : {"jit<baseline>", "jit<optimizing>",
+                               "jit<peak>"}) {
+    LLVMContext Ctx;
+    SMDiagnostic Error;
+    std::unique_ptr<Module> M = parseAssemblyString(ModuleIR, Error, Ctx);
+    ASSERT_TRUE(M);
+
+    PassBuilder PB;
+    LoopAnalysisManager LAM;
+    FunctionAnalysisManager FAM;
+    CGSCCAnalysisManager CGAM;
+    ModuleAnalysisManager MAM;
+    FAM.registerPass([&] { return PB.buildDefaultAAPipeline(); });
+    PB.registerModuleAnalyses(MAM);
+    PB.registerCGSCCAnalyses(CGAM);
+    PB.registerFunctionAnalyses(FAM);
+    PB.registerLoopAnalyses(LAM);
+    PB.crossRegisterProxies(LAM, FAM, CGAM, MAM);
+
+    ModulePassManager MPM;
+    ASSERT_THAT_ERROR(PB.parsePassPipeline(MPM, Pipeline), Succeeded());
+    MPM.run(*M, MAM);
+    EXPECT_FALSE(verifyModule(*M, &errs()));
+
+    bool HasAlloca = false, HasCallee = false;
+    for (Function &F : *M)
+      for (Instruction &I : instructions(F)) {
+        HasAlloca |= isa<AllocaInst>(I);
+        if (auto *CB = dyn_cast<CallBase>(&I))
+          HasCallee |= CB->getCalledFunction() == M->getFunction("callee");
+      }
+    EXPECT_FALSE(HasAlloca) << Pipeline;
+    // Only the peak tier inlines, and then drops the callee.
+    EXPECT_EQ(StringRef(Pipeline) != "jit<peak>", HasCallee) << Pipeline;
+    EXPECT_EQ(StringRef(Pipeline) == "jit<peak>", !M->getFunction("callee"))
+        << Pipeline;
+  }
+
+  PassBuilder PB;
+  ModulePassManager MPM;
+  EXPECT_THAT_ERROR(PB.parsePassPipeline(MPM, "jit<fast>"), Failed());
+}
+
+} // end anonymous namespace
@@ -0,0 +1,263 @@
+//===- ParallelFunctionPassAdaptorTest.cpp - Parallel adaptor unit tests --===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Transforms/Utils/ParallelFunctionPassAdaptor.h"
+#include "llvm/AsmParser/Parser.h"
+#include "llvm/IR/IRBuilder.h"
+#include "llvm/IR/Module.h"
+#include "llvm/IR/Verifier.h"
+#include "llvm/Passes/PassBuilder.h"
+#include "llvm/Support/Error.h"
+#include "llvm/Support/SourceMgr.h"
+#include "llvm/Support/raw_ostream.h"
+#include "gtest/gtest.h"
+
+using namespace llvm;
+
+namespace {
+
+const char *Pipeline = "instcombine,simplifycfg,sroa,early-cse-memssa,gvn,"
+                       "loop-mssa(licm),instcombine,simplifycfg";
+
+const unsigned NumFunctions = 64;
+
+// Adds to the module what the library call simplifications do: a declaration
+// shared by all the functions, with an attribute inferred on it, and a string
+// private to the function. Also adds a global of a struct the module only
+// uses in bodies.
+struct AddGlobalsPass : PassInfoMixin<AddGlobalsPass> {
+  PreservedAnalyses run(Function &F, FunctionAnalysisManager &) {
+    Module &M = *F.getParent();
+    IRBuilder<> B(&*F.getEntryBlock().getFirstInsertionPt());
+
+    FunctionCallee Puts = M.getOrInsertFunction(
+        "puts", B.getInt32Ty(), PointerType::getUnqual(B.getInt8Ty()));
+    cast<Function>(Puts.getCallee())->addFnAttr(Attribute::NoUnwind);
+    B.CreateCall(Puts, B.CreateGlobalStringPtr(F.getName(), ".str"));
+
+    StructType *S = M.getTypeByName("struct.S");
+    auto *Counter = new GlobalVariable(M, S, /*isConstant=*/false,
+                                       GlobalValue::InternalLinkage,
+                                       ConstantAggregateZero::get(S), "counter");
+    B.CreateStore(B.getInt32(F.arg_size()),
+                  B.CreateStructGEP(S, Counter, 0));
+    return PreservedAnalyses::none();
+  }
+};
+
+// Returns a module of NumFunctions functions with debug info, using the same
+// globals, constants and types, followed by a function whose blocks have
+// their address taken.
+std::string getModuleIR() {
+  std::string IR = "%struct.S = type { i32, [4 x i8] }\n"
+                   "@g = global [16 x i32] zeroinitializer\n"
+                   "@s = constant [4 x i8] c\"abc\\00\"\n"
+                   "@tbl = constant [4 x i32] [i32 3, i32 5, i32 7, i32 9]\n"
+                   "@targets = constant [2 x i8*] [i8* blockaddress(@computed, "
+                   "%a), i8* blockaddress(@computed, %b)]\n"
+                   "declare void @use(i8*)\n\n";
+  for (unsigned I = 0; I < NumFunctions; ++I) {
+    std::string C = std::to_string(I % 7 + 1);
+    std::string SP = "!" + std::to_string(10 + 2 * I);
+    std::string Loc = "!" + std::to_string(11 + 2 * I);
+    IR += "define i32 @f" + std::to_string(I) + "(i32 %n, i1 %c) !dbg " + SP +
+          " {\n"
+          "entry:\n"
+          "  %p = alloca i32\n"
+          "  %obj = alloca %struct.S\n"
+          "  %f = getelementptr %struct.S, %struct.S* %obj, i32 0, i32 0\n"
+          "  store i32 " + C + ", i32* %f\n"
+          "  %raw = bitcast %struct.S* %obj to i8*\n"
+          "  call void @use(i8* %raw), !dbg " + Loc + "\n"
+          "  store i32 " + C + ", i32* %p\n"
+          "  call void @use(i8* getelementptr ([4 x i8], [4 x i8]* @s, "
+          "i64 0, i64 " + std::to_string(I % 4) + ")), !dbg " + Loc + "\n"
+          "  %e = load i32, i32* getelementptr ([4 x i32], [4 x i32]* @tbl, "
+          "i64 0, i64 " + std::to_string(I % 4) + ")\n"
+          "  br i1 %c, label %loop, label %exit, !prof !0\n"
+          "loop:\n"
+          "  %i = phi i32 [ 0, %entry ], [ %i.next, %loop ]\n"
+          "  %acc = phi i32 [ 0, %entry ], [ %acc.next, %loop ]\n"
+          "  %k = load i32, i32* %p\n"
+          "  %gep = getelementptr [16 x i32], [16 x i32]* @g, i32 0, i32 " +
+          std::to_string(I % 16) + "\n"
+          "  %v = load i32, i32* %gep\n"
+          "  %m = mul i32 %i, " + C + "\n"
+          "  %x = xor i32 %m, -1\n"
+          "  %y = xor i32 %x, -1\n"
+          "  %s = add i32 %y, %v\n"
+          "  %t = add i32 %s, %k\n"
+          "  %acc.next = add i32 %acc, %t\n"
+          "  %i.next = add i32 %i, 1\n"
+          "  %done = icmp eq i32 %i.next, %n\n"
+          "  br i1 %done, label %exit, label %loop\n"
+          "exit:\n"
+          "  %r = phi i32 [ %e, %entry ], [ %acc.next, %loop ]\n"
+          "  %cmp = icmp sgt i32 %r, " + C + "\n"
+          "  %sel = select i1 %cmp, i32 %r, i32 " + C + "\n"
+          "  ret i32 %sel, !dbg " + Loc + "\n"
+          "}\n\n";
+  }
+  IR += "define i32 @computed(i32 %i) {\n"
+        "entry:\n"
+        "  %gep = getelementptr [2 x i8*], [2 x i8*]* @targets, i32 0, i32 %i\n"
+        "  %dest = load i8*, i8** %gep\n"
+        "  indirectbr i8* %dest, [label %a, label %b]\n"
+        "a:\n"
+        "  ret i32 1\n"
+        "b:\n"
+        "  ret i32 2\n"
+        "}\n\n";
+
+  IR += "!llvm.dbg.cu = !{!1}\n"
+        "!llvm.module.flags = !{!2}\n"
+        "!0 = !{!\"branch_weights\", i32 1, i32 100}\n"
+        "!1 = distinct !DICompileUnit(language: DW_LANG_C99, file: !3, "
+        "producer: \"test\", isOptimized: true, runtimeVersion: 0, "
+        "emissionKind: FullDebug)\n"
+        "!2 = !{i32 2, !\"Debug Info Version\", i32 3}\n"
+        "!3 = !DIFile(filename: \"t.c\", directory: \"/\")\n"
+        "!4 = !DISubroutineType(types: !{})\n";
+  for (unsigned I = 0; I < NumFunctions; ++I)
+    IR += "!" + std::to_string(10 + 2 * I) +
+          " = distinct !DISubprogram(name: \"f" + std::to_string(I) +
+          "\", scope: !3, file: !3, line: " + std::to_string(I + 1) +
+          ", type: !4, unit: !1, spFlags: DISPFlagDefinition | "
+          "DISPFlagOptimized)\n"
+          "!" + std::to_string(11 + 2 * I) + " = !DILocation(line: " +
+          std::to_string(I + 1) + ", scope: !" + std::to_string(10 + 2 * I) +
+          ")\n";
+  return IR;
+}
+
+// Adds a call at the start of the function, but reports that all the analyses
+// are preserved.
+struct AddCallPass : PassInfoMixin<AddCallPass> {
+  PreservedAnalyses run(Function &F, FunctionAnalysisManager &) {
+    IRBuilder<> B(&*F.getEntryBlock().getFirstInsertionPt());
+    Function *Use = F.getParent()->getFunction("use");
+    B.CreateCall(Use, ConstantPointerNull::get(B.getInt8PtrTy()));
+    return PreservedAnalyses::all();
+  }
+};
+
+void addDefaultPasses(FunctionPassManager &FPM, PassBuilder &PB) {
+  FPM.addPass(AddGlobalsPass());
+  cantFail(PB.parsePassPipeline(FPM, Pipeline));
+}
+
+// Runs the passes added by AddPasses on the module, with the parallel adaptor
+// on NumThreads threads, or with the sequential one if NumThreads is 0.
+void runPipeline(Module &M, unsigned NumThreads,
+                 function_ref<void(FunctionPassManager &, PassBuilder &)>
+                     AddPasses) {
+  PassBuilder PB;
+  LoopAnalysisManager LAM;
+  FunctionAnalysisManager FAM;
+  CGSCCAnalysisManager CGAM;
+  ModuleAnalysisManager MAM;
+  FAM.registerPass([&] { return PB.buildDefaultAAPipeline(); });
+  PB.registerModuleAnalyses(MAM);
+  PB.registerCGSCCAnalyses(CGAM);
+  PB.registerFunctionAnalyses(FAM);
+  PB.registerLoopAnalyses(LAM);
+  PB.crossRegisterProxies(LAM, FAM, CGAM, MAM);
+
+  auto BuildPipeline = [&] {
+    FunctionPassManager FPM;
+    AddPasses(FPM, PB);
+    return FPM;
+  };
+
+  ModulePassManager MPM;
+  if (NumThreads)
+    MPM.addPass(ParallelModuleToFunctionPassAdaptor(
+        BuildPipeline,
+        [&](ModuleAnalysisManager &WorkerMAM, FunctionAnalysisManager &WorkerFAM,
+            LoopAnalysisManager &WorkerLAM) {
+          WorkerFAM.registerPass([&] { return PB.buildDefaultAAPipeline(); });
+          PB.registerModuleAnalyses(WorkerMAM);
+          PB.registerFunctionAnalyses(WorkerFAM);
+          PB.registerLoopAnalyses(WorkerLAM);
+        },
+        NumThreads));
+  else
+    MPM.addPass(createModuleToFunctionPassAdaptor(BuildPipeline()));
+  MPM.run(M, MAM);
+  EXPECT_FALSE(verifyModule(M, &errs()));
+}
+
+// Runs the passes on a new module and returns the printed result.
+std::string runPipeline(unsigned NumThreads,
+                        function_ref<void(FunctionPassManager &, PassBuilder &)>
+                            AddPasses = addDefaultPasses) {
+  LLVMContext Ctx;
+  SMDiagnostic Error;
+  std::unique_ptr<Module> M = parseAssemblyString(getModuleIR(), Error, Ctx);
+  EXPECT_TRUE(M);
+  if (!M) {
+    Error.print("ParallelFunctionPassAdaptorTest", errs());
+    return "";
+  }
+  runPipeline(*M, NumThreads, AddPasses);
+
+  std::string Result;
+  raw_string_ostream OS(Result);
+  M->print(OS, nullptr);
+  return OS.str();
+}
+
+TEST(ParallelFunctionPassAdaptorTest, SameAsSequential) {
+  std::string Sequential = runPipeline(0);
+  ASSERT_NE(std::string::npos, Sequential.find("define i32 @f63"));
+  EXPECT_EQ(1u, StringRef(Sequential).count("declare i32 @puts(i8*)"));
+  EXPECT_EQ(NumFunctions + 1, StringRef(Sequential).count("call i32 @puts("));
+  EXPECT_EQ(NumFunctions + 1,
+            StringRef(Sequential).count("= private unnamed_addr constant"));
+  EXPECT_EQ(NumFunctions + 1,
+            StringRef(Sequential).count("= internal global %struct.S"));
+  EXPECT_EQ(0u, StringRef(Sequential).count("%struct.S."));
+  EXPECT_EQ(NumFunctions,
+            StringRef(Sequential).count("distinct !DISubprogram("));
+
+  EXPECT_EQ(Sequential, runPipeline(1));
+  for (unsigned I = 0; I < 4; ++I) {
+    EXPECT_EQ(Sequential, runPipeline(2));
+    EXPECT_EQ(Sequential, runPipeline(4));
+  }
+}
+
+TEST(ParallelFunctionPassAdaptorTest, ChangeWithAllPreserved) {
+  auto AddPasses = [](FunctionPassManager &FPM, PassBuilder &) {
+    FPM.addPass(AddCallPass());
+  };
+  std::string Sequential = runPipeline(0, AddPasses);
+  EXPECT_EQ(NumFunctions + 1,
+            StringRef(Sequential).count("call void @use(i8* null)"));
+  EXPECT_EQ(Sequential, runPipeline(2, AddPasses));
+}
+
+// Every partition is read back into the context of the module, which keeps the
+// struct types it creates: each run adds a copy of %struct.S per partition.
+TEST(ParallelFunctionPassAdaptorTest, ContextGrowth) {
+  LLVMContext Ctx;
+  SMDiagnostic Error;
+  std::unique_ptr<Module> M = parseAssemblyString(getModuleIR(), Error, Ctx);
+  ASSERT_TRUE(M);
+
+  const unsigned NumRuns = 3, NumThreads = 2;
+  for (unsigned I = 0; I < NumRuns; ++I)
+    runPipeline(*M, NumThreads, addDefaultPasses);
+
+  unsigned NumCopies = 0;
+  while (M->getTypeByName("struct.S." + std::to_string(NumCopies)))
+    ++NumCopies;
+  EXPECT_EQ(NumRuns * NumThreads, NumCopies);
+}
+
+} // end anonymous namespace
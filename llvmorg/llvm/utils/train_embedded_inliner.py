@@ -0,0 +1,284 @@
+#!/usr/bin/env python3
+"""Trains the model of the embedded ML inliner on a local corpus.
+
+The embedded inliner (-enable-ml-inliner=embedded) evaluates a linear model
+over log-scaled features, see llvm/include/llvm/Analysis/EmbeddedModelRunner.h.
+This script tunes its weights with an evolution strategy: every iteration it
+perturbs the current model, compiles the corpus with each perturbed model, and
+moves the model towards the perturbations that lowered the cost. The cost of a
+model combines, relative to the initial model,
+
+  - the text size of the objects (llvm-size),
+  - the time spent in opt and llc,
+  - optionally, the result of a benchmark command run on the objects.
+
+Only the Python standard library and the LLVM tools are needed. Example:
+
+  train_embedded_inliner.py --bin-dir build/bin --corpus interp/bitcode \\
+      --benchmark 'sh run-bench.sh {dir}' --output interp.model
+
+  opt -enable-ml-inliner=embedded -ml-inliner-embedded-model=interp.model ...
+
+The corpus is a directory of .bc or .ll files, typically produced with
+-fembed-bitcode or -emit-llvm from the interpreter sources. The benchmark
+command gets {objects}, the space separated list of objects, and {dir}, the
+directory holding them; it must link and run them, and print the cost to
+minimize, e.g. a run time, on the last line of its standard output.
+
+Use --output-def to regenerate the built-in model,
+llvm/lib/Analysis/models/EmbeddedInlinerModel.def.
+"""
+
+import argparse
+import concurrent.futures
+import os
+import random
+import re
+import shlex
+import shutil
+import subprocess
+import sys
+import tempfile
+import textwrap
+import time
+
+# Same order and names as the features of
+# llvm/include/llvm/Analysis/InlineModelFeatureMaps.h.
+FEATURES = [
+    'callee_basic_block_count',
+    'callsite_height',
+    'node_count',
+    'nr_ctant_params',
+    'cost_estimate',
+    'edge_count',
+    'caller_users',
+    'caller_conditionally_executed_blocks',
+    'caller_basic_block_count',
+    'callee_conditionally_executed_blocks',
+    'callee_users',
+]
+NAMES = ['bias'] + FEATURES
+
+DEFAULT_DEF = os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                           os.pardir, 'lib', 'Analysis', 'models',
+                           'EmbeddedInlinerModel.def')
+
+
+def read_model(path):
+    """Reads a model file, or the built-in .def file, into a weight list."""
+    weights = dict.fromkeys(NAMES, 0.0)
+    def_entry = re.compile(r'^EMBEDDED_INLINER_WEIGHT\("(\w+)",\s*(\S+)\)')
+    with open(path) as f:
+        for line in f:
+            line = line.strip()
+            match = def_entry.match(line)
+            if match:
+                name, value = match.groups()
+            elif path.endswith('.def') or not line or line.startswith('#'):
+                continue
+            else:
+                name, value = line.split()
+            if name not in weights:
+                sys.exit('%s: unknown feature %s' % (path, name))
+            weights[name] = float(value)
+    return [weights[name] for name in NAMES]
+
+
+def write_model(path, weights, comment):
+    with open(path, 'w') as f:
+        f.write('# %s\n' % comment)
+        for name, weight in zip(NAMES, weights):
+            if weight != 0.0:
+                f.write('%s %r\n' % (name, weight))
+
+
+DEF_HEADER = """\
+//===- EmbeddedInlinerModel.def - Built-in embedded inliner model -*- C++ -*-=//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// The weights of the model built into EmbeddedModelRunner, as
+// EMBEDDED_INLINER_WEIGHT(<"bias" or feature name>, <weight>) entries. This
+// file is regenerated by utils/train_embedded_inliner.py --output-def.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef EMBEDDED_INLINER_WEIGHT
+#error "EMBEDDED_INLINER_WEIGHT must be defined"
+#endif
+
+"""
+
+
+def write_def(path, weights, comment):
+    """Writes the model in the format of EmbeddedInlinerModel.def."""
+    with open(path, 'w') as f:
+        f.write(DEF_HEADER)
+        f.write(textwrap.fill(comment, width=80, initial_indent='// ',
+                              subsequent_indent='// ') + '\n\n')
+        for name, weight in zip(NAMES, weights):
+            if weight != 0.0:
+                f.write('EMBEDDED_INLINER_WEIGHT("%s", %r)\n' % (name, weight))
+        f.write('\n#undef EMBEDDED_INLINER_WEIGHT\n')
+
+
+class Evaluator(object):
+    """Compiles the corpus with a model and measures the result."""
+
+    def __init__(self, args, corpus):
+        self.args = args
+        self.corpus = corpus
+        self.opt = os.path.join(args.bin_dir, 'opt')
+        self.llc = os.path.join(args.bin_dir, 'llc')
+        self.size = os.path.join(args.bin_dir, 'llvm-size')
+        self.pool = concurrent.futures.ThreadPoolExecutor(args.jobs)
+
+    def _compile(self, model, source, workdir):
+        # Keep the extension, a.ll and a.bc must not share outputs.
+        base = os.path.basename(source)
+        optimized = os.path.join(workdir, base + '.opt.bc')
+        obj = os.path.join(workdir, base + '.o')
+        start = time.time()
+        subprocess.check_call(
+            [self.opt, '-passes=default<%s>' % self.args.opt_level,
+             '-enable-ml-inliner=embedded',
+             '-ml-inliner-embedded-model=' + model, source, '-o', optimized])
+        subprocess.check_call(
+            [self.llc, '-' + self.args.opt_level, '-filetype=obj', optimized,
+             '-o', obj])
+        elapsed = time.time() - start
+        output = subprocess.check_output([self.size, obj],
+                                         universal_newlines=True)
+        # Berkeley format: text data bss dec hex filename.
+        text = int(output.splitlines()[-1].split()[0])
+        return obj, text, elapsed
+
+    def _benchmark(self, objects, workdir):
+        if not self.args.benchmark:
+            return 0.0
+        command = self.args.benchmark.format(
+            objects=' '.join(shlex.quote(o) for o in objects), dir=workdir)
+        results = []
+        for _ in range(self.args.repeats):
+            output = subprocess.check_output(command, shell=True, cwd=workdir,
+                                             universal_newlines=True)
+            results.append(float(output.strip().splitlines()[-1]))
+        # The minimum is the least noisy estimate of the run time.
+        return min(results)
+
+    def measure(self, weights):
+        """Returns (size, compile time, benchmark) for the model."""
+        workdir = tempfile.mkdtemp(prefix='inliner-')
+        try:
+            model = os.path.join(workdir, 'model')
+            write_model(model, weights, 'candidate')
+            futures = [self.pool.submit(self._compile, model, source, workdir)
+                       for source in self.corpus]
+            results = [future.result() for future in futures]
+            objects = [obj for obj, _, _ in results]
+            size = sum(text for _, text, _ in results)
+            compile_time = sum(elapsed for _, _, elapsed in results)
+            return size, compile_time, self._benchmark(objects, workdir)
+        finally:
+            shutil.rmtree(workdir)
+
+
+def cost(args, measures, baseline):
+    """Weighted sum of the relative changes against the baseline."""
+    total = 0.0
+    for weight, value, base in zip(
+            [args.size_weight, args.compile_time_weight, args.perf_weight],
+            measures, baseline):
+        if weight and base:
+            total += weight * (value - base) / base
+    return total
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description=__doc__,
+        formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('--bin-dir', required=True,
+                        help='directory holding opt, llc and llvm-size')
+    parser.add_argument('--corpus', required=True,
+                        help='directory of .bc or .ll files to compile')
+    parser.add_argument('--benchmark',
+                        help='command linking and running the objects, '
+                        'printing the cost on its last line')
+    parser.add_argument('--opt-level', default='O2', choices=['O1', 'O2', 'O3'])
+    parser.add_argument('-j', '--jobs', type=int, default=os.cpu_count())
+    parser.add_argument('--iterations', type=int, default=50)
+    parser.add_argument('--population', type=int, default=8,
+                        help='number of perturbation pairs per iteration')
+    parser.add_argument('--sigma', type=float, default=0.1,
+                        help='standard deviation of the perturbations')
+    parser.add_argument('--learning-rate', type=float, default=0.05)
+    parser.add_argument('--repeats', type=int, default=3,
+                        help='number of runs of the benchmark per model')
+    parser.add_argument('--size-weight', type=float, default=1.0)
+    parser.add_argument('--compile-time-weight', type=float, default=0.1)
+    parser.add_argument('--perf-weight', type=float, default=1.0)
+    parser.add_argument('--seed', type=int, default=0)
+    parser.add_argument('--initial-model', default=DEFAULT_DEF,
+                        help='model file or .def to start from (default: '
+                        'the built-in model)')
+    parser.add_argument('--output', required=True,
+                        help='model file to write the best model to')
+    parser.add_argument('--output-def',
+                        help='also write the best model as a .def file')
+    args = parser.parse_args()
+
+    corpus = sorted(
+        os.path.join(args.corpus, name) for name in os.listdir(args.corpus)
+        if name.endswith('.bc') or name.endswith('.ll'))
+    if not corpus:
+        sys.exit('no .bc or .ll file in %s' % args.corpus)
+
+    rng = random.Random(args.seed)
+    evaluator = Evaluator(args, corpus)
+    weights = read_model(args.initial_model)
+    baseline = evaluator.measure(weights)
+    print('baseline: size %d, compile time %.2fs, benchmark %g' % baseline)
+    best, best_cost = list(weights), 0.0
+
+    for iteration in range(args.iterations):
+        # Antithetic sampling: evaluate each perturbation in both directions,
+        # which cancels the noise common to both.
+        gradient = [0.0] * len(weights)
+        for _ in range(args.population):
+            epsilon = [rng.gauss(0, 1) for _ in weights]
+            costs = []
+            for sign in (1, -1):
+                candidate = [w + sign * args.sigma * e
+                             for w, e in zip(weights, epsilon)]
+                candidate_cost = cost(args, evaluator.measure(candidate),
+                                      baseline)
+                costs.append(candidate_cost)
+                if candidate_cost < best_cost:
+                    best, best_cost = candidate, candidate_cost
+            for i, e in enumerate(epsilon):
+                gradient[i] += (costs[0] - costs[1]) * e
+        scale = args.learning_rate / (2 * args.population * args.sigma)
+        weights = [w - scale * g for w, g in zip(weights, gradient)]
+
+        current = cost(args, evaluator.measure(weights), baseline)
+        if current < best_cost:
+            best, best_cost = list(weights), current
+        print('iteration %d: cost %+.4f, best %+.4f' %
+              (iteration, current, best_cost))
+        sys.stdout.flush()
+
+        # Keep the best model on disk so that the training can be interrupted.
+        comment = 'cost %+.4f relative to %s' % (
+            best_cost, os.path.basename(args.initial_model))
+        write_model(args.output, best, comment)
+        if args.output_def:
+            write_def(args.output_def, best, comment)
+
+
+if __name__ == '__main__':
+    main()
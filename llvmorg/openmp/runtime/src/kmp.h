@@ -788,6 +788,8 @@ extern int __kmp_affinity_respect_mask; // Respect process' init affinity mask?
 extern char *__kmp_affinity_proclist; /* proc ID list */
 extern kmp_affin_mask_t *__kmp_affinity_masks;
 extern unsigned __kmp_affinity_num_masks;
+extern int *__kmp_affinity_domains; /* NUMA domain of each place, or NULL */
+extern int __kmp_affinity_num_domains;
 extern void __kmp_affinity_bind_thread(int which);
 
 extern kmp_affin_mask_t *__kmp_affin_fullMask;
@@ -806,6 +808,12 @@ typedef enum kmp_proc_bind_t {
   proc_bind_default
 } kmp_proc_bind_t;
 
+// This needs to be kept in sync with kmp_set_task_affinity() in omp.h !!!
+typedef enum kmp_task_affinity_t {
+  task_affinity_none = 0, // tasks may be stolen by any thread
+  task_affinity_domain // tasks are only stolen within their NUMA domain
+} kmp_task_affinity_t;
+
 typedef struct kmp_nested_proc_bind_t {
   kmp_proc_bind_t *bind_types;
   int size;
@@ -2058,6 +2066,10 @@ extern kmp_tasking_mode_t
     __kmp_tasking_mode; /* determines how/when to execute tasks */
 extern int __kmp_task_stealing_constraint;
 extern int __kmp_enable_task_throttling;
+// Set via KMP_TASK_STEAL_REMOTE_BACKOFF, the maximum number of failed steal
+// attempts in its own NUMA domain a thread makes before stealing from another
+// domain; 0 disables NUMA-aware stealing
+extern int __kmp_task_steal_remote_backoff;
 extern kmp_int32 __kmp_default_device; // Set via OMP_DEFAULT_DEVICE if
 // specified, defaults to 0 otherwise
 // Set via OMP_MAX_TASK_PRIORITY if specified, defaults to 0 otherwise
@@ -2146,11 +2158,13 @@ struct kmp_depnode_list {
 #define MAX_MTX_DEPS 4
 
 typedef struct kmp_base_depnode {
-  kmp_depnode_list_t *successors; /* used under lock */
-  kmp_task_t *task; /* non-NULL if depnode is active, used under lock */
+  // Successors are pushed with a CAS until the task completes, which swaps the
+  // list for KMP_DEPNODE_RELEASED
+  std::atomic<kmp_depnode_list_t *> successors;
+  kmp_task_t *task; /* non-NULL if depnode is active */
   kmp_lock_t *mtx_locks[MAX_MTX_DEPS]; /* lock mutexinoutset dependent tasks */
   kmp_int32 mtx_num_locks; /* number of locks in mtx_locks array */
-  kmp_lock_t lock; /* guards shared fields: task, successors */
+  kmp_lock_t lock; /* keeps task alive while dependence tools look at it */
 #if KMP_SUPPORT_GRAPH_OUTPUT
   kmp_uint32 id;
 #endif
@@ -2251,7 +2265,8 @@ typedef struct kmp_tasking_flags { /* Total struct must be exactly 32 bits */
   unsigned complete : 1; /* 1==complete, 0==not complete   */
   unsigned freed : 1; /* 1==freed, 0==allocated        */
   unsigned native : 1; /* 1==gcc-compiled task, 0==intel */
-  unsigned reserved31 : 7; /* reserved for library use */
+  unsigned domain_affinity : 1; /* 1==only stolen within the NUMA domain */
+  unsigned reserved31 : 6; /* reserved for library use */
 
 } kmp_tasking_flags_t;
 
@@ -2316,6 +2331,10 @@ typedef struct kmp_base_thread_data {
   kmp_int32 td_deque_ntasks; // Number of tasks in deque
   // GEH: shouldn't this be volatile since used in while-spin?
   kmp_int32 td_deque_last_stolen; // Thread number of last successful steal
+  // Steal attempts in the thread's NUMA domain since the last remote one, and
+  // the number of them needed before stealing from another domain again
+  kmp_int32 td_local_steal_attempts;
+  kmp_int32 td_remote_steal_backoff;
 #ifdef BUILD_TIED_TASK_STACK
   kmp_task_stack_t td_susp_tied_tasks; // Stack of suspended tied tasks for task
 // scheduling constraint
@@ -2446,6 +2465,7 @@ typedef struct KMP_ALIGN_CACHE kmp_base_info {
   kmp_affin_mask_t *th_affin_mask; /* thread's current affinity mask */
 #endif
   omp_allocator_handle_t th_def_allocator; /* default allocator */
+  kmp_task_affinity_t th_task_affinity; /* affinity of the tasks created */
   /* The data set by the master at reinit, then R/W by the worker */
   KMP_ALIGN_CACHE int
       th_set_nproc; /* if > 0, then only use this request for the next fork */
@@ -4109,6 +4109,32 @@ static void __kmp_create_affinity_none_places() {
   KMP_CPU_COPY(dest, __kmp_affin_fullMask);
 }
 
+// Record the package of each place as its NUMA domain, for the tasking layer
+// to steal from victims in the same domain first. place_procs[i] is the entry
+// of address2os that the i-th place was built from.
+static void __kmp_affinity_create_domains(const int *place_procs) {
+  KMP_DEBUG_ASSERT(__kmp_affinity_domains == NULL);
+  __kmp_affinity_num_domains = 0;
+  // The flat map has no notion of packages
+  if (nPackages < 2 || __kmp_affinity_top_method == affinity_top_method_flat)
+    return;
+  __kmp_affinity_domains =
+      (int *)__kmp_allocate(sizeof(int) * __kmp_affinity_num_masks);
+  int *packages = (int *)__kmp_allocate(sizeof(int) * nPackages);
+  for (unsigned i = 0; i < __kmp_affinity_num_masks; i++) {
+    int package = address2os[place_procs[i]].first.labels[0];
+    int domain = 0;
+    while (domain < __kmp_affinity_num_domains && packages[domain] != package)
+      domain++;
+    if (domain == __kmp_affinity_num_domains) {
+      KMP_DEBUG_ASSERT(domain < nPackages);
+      packages[__kmp_affinity_num_domains++] = package;
+    }
+    __kmp_affinity_domains[i] = domain;
+  }
+  __kmp_free(packages);
+}
+
 static int __kmp_affinity_cmp_Address_child_num(const void *a, const void *b) {
   const Address *aa = &(((const AddrUnsPair *)a)->first);
   const Address *bb = &(((const AddrUnsPair *)b)->first);
@@ -4622,6 +4648,8 @@ static void __kmp_aux_affinity_initialize(void) {
     {
       int i;
       unsigned j;
+      int *place_procs =
+          (int *)__kmp_allocate(sizeof(int) * __kmp_affinity_num_masks);
       for (i = 0, j = 0; i < __kmp_avail_proc; i++) {
         if ((!__kmp_affinity_dups) && (!address2os[i].first.leader)) {
           continue;
@@ -4631,11 +4659,14 @@ static void __kmp_aux_affinity_initialize(void) {
         kmp_affin_mask_t *dest = KMP_CPU_INDEX(__kmp_affinity_masks, j);
         KMP_ASSERT(KMP_CPU_ISSET(osId, src));
         KMP_CPU_COPY(dest, src);
+        place_procs[j] = i;
         if (++j >= __kmp_affinity_num_masks) {
           break;
         }
       }
       KMP_DEBUG_ASSERT(j == __kmp_affinity_num_masks);
+      __kmp_affinity_create_domains(place_procs);
+      __kmp_free(place_procs);
     }
     break;
 
@@ -4680,6 +4711,11 @@ void __kmp_affinity_uninitialize(void) {
     __kmp_affin_fullMask = NULL;
   }
   __kmp_affinity_num_masks = 0;
+  if (__kmp_affinity_domains != NULL) {
+    __kmp_free(__kmp_affinity_domains);
+    __kmp_affinity_domains = NULL;
+  }
+  __kmp_affinity_num_domains = 0;
   __kmp_affinity_type = affinity_default;
   __kmp_affinity_num_places = 0;
   if (__kmp_affinity_proclist != NULL) {
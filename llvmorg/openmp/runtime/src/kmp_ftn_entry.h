@@ -207,6 +207,26 @@ void FTN_STDCALL FTN_SET_DISP_NUM_BUFFERS(int KMP_DEREF arg) {
 #endif
 }
 
+void FTN_STDCALL FTN_SET_TASK_AFFINITY(int KMP_DEREF arg) {
+#ifdef KMP_STUB
+  ; // empty routine
+#else
+  // Applies to the tasks created by the calling thread from now on
+  kmp_info_t *thread = __kmp_threads[__kmp_entry_gtid()];
+  thread->th.th_task_affinity = (KMP_DEREF arg) == task_affinity_domain
+                                    ? task_affinity_domain
+                                    : task_affinity_none;
+#endif
+}
+
+int FTN_STDCALL FTN_GET_TASK_AFFINITY(void) {
+#ifdef KMP_STUB
+  return 0;
+#else
+  return __kmp_threads[__kmp_entry_gtid()]->th.th_task_affinity;
+#endif
+}
+
 int FTN_STDCALL FTN_SET_AFFINITY(void **mask) {
 #if defined(KMP_STUB) || !KMP_AFFINITY_SUPPORTED
   return -1;
@@ -263,6 +263,8 @@ int __kmp_affinity_respect_mask = affinity_respect_mask_default;
 char *__kmp_affinity_proclist = NULL;
 kmp_affin_mask_t *__kmp_affinity_masks = NULL;
 unsigned __kmp_affinity_num_masks = 0;
+int *__kmp_affinity_domains = NULL;
+int __kmp_affinity_num_domains = 0;
 
 char *__kmp_cpuinfo_file = NULL;
 
@@ -329,6 +331,7 @@ KMP_BUILD_ASSERT(sizeof(kmp_tasking_flags_t) == 4);
 
 int __kmp_task_stealing_constraint = 1; /* Constrain task stealing by default */
 int __kmp_enable_task_throttling = 1;
+int __kmp_task_steal_remote_backoff = 64;
 
 #ifdef DEBUG_SUSPEND
 int __kmp_suspend_count = 0;
@@ -3776,6 +3776,7 @@ int __kmp_register_root(int initial_thread) {
   }
 #endif /* KMP_AFFINITY_SUPPORTED */
   root_thread->th.th_def_allocator = __kmp_def_allocator;
+  root_thread->th.th_task_affinity = task_affinity_none;
   root_thread->th.th_prev_level = 0;
   root_thread->th.th_prev_num_threads = 1;
 
@@ -4366,6 +4367,7 @@ kmp_info_t *__kmp_allocate_thread(kmp_root_t *root, kmp_team_t *team,
   new_thr->th.th_last_place = KMP_PLACE_UNDEFINED;
 #endif
   new_thr->th.th_def_allocator = __kmp_def_allocator;
+  new_thr->th.th_task_affinity = task_affinity_none;
   new_thr->th.th_prev_level = 0;
   new_thr->th.th_prev_num_threads = 1;
 
@@ -1211,6 +1211,21 @@ static void __kmp_stg_print_task_stealing(kmp_str_buf_t *buffer,
   __kmp_stg_print_int(buffer, name, __kmp_task_stealing_constraint);
 } // __kmp_stg_print_task_stealing
 
+// -----------------------------------------------------------------------------
+// KMP_TASK_STEAL_REMOTE_BACKOFF
+static void __kmp_stg_parse_task_steal_remote_backoff(char const *name,
+                                                      char const *value,
+                                                      void *data) {
+  __kmp_stg_parse_int(name, value, 0, INT_MAX / 2,
+                      &__kmp_task_steal_remote_backoff);
+} // __kmp_stg_parse_task_steal_remote_backoff
+
+static void __kmp_stg_print_task_steal_remote_backoff(kmp_str_buf_t *buffer,
+                                                      char const *name,
+                                                      void *data) {
+  __kmp_stg_print_int(buffer, name, __kmp_task_steal_remote_backoff);
+} // __kmp_stg_print_task_steal_remote_backoff
+
 static void __kmp_stg_parse_max_active_levels(char const *name,
                                               char const *value, void *data) {
   kmp_uint64 tmp_dflt = 0;
@@ -4739,6 +4754,9 @@ static kmp_setting_t __kmp_stg_table[] = {
      0},
     {"KMP_TASK_STEALING_CONSTRAINT", __kmp_stg_parse_task_stealing,
      __kmp_stg_print_task_stealing, NULL, 0, 0},
+    {"KMP_TASK_STEAL_REMOTE_BACKOFF",
+     __kmp_stg_parse_task_steal_remote_backoff,
+     __kmp_stg_print_task_steal_remote_backoff, NULL, 0, 0},
     {"OMP_MAX_ACTIVE_LEVELS", __kmp_stg_parse_max_active_levels,
      __kmp_stg_print_max_active_levels, NULL, 0, 0},
     {"OMP_DEFAULT_DEVICE", __kmp_stg_parse_default_device,
@@ -236,6 +236,67 @@ static inline void __kmp_track_dependence(kmp_int32 gtid, kmp_depnode_t *source,
 #endif /* OMPT_SUPPORT && OMPT_OPTIONAL */
 }
 
+// Whether dependences are reported as they are found. Tools look at the task
+// of the source node, which then must not complete while this is done.
+static inline bool __kmp_track_dependences() {
+#ifdef KMP_SUPPORT_GRAPH_OUTPUT
+  return true;
+#elif OMPT_SUPPORT && OMPT_OPTIONAL
+  return ompt_enabled.ompt_callback_task_dependence;
+#else
+  return false;
+#endif
+}
+
+// Push sink on the successor list of source without locking, unless the task
+// of source completed. Returns the number of predecessors added to sink.
+static inline kmp_int32 __kmp_depnode_push_successor(kmp_info_t *thread,
+                                                     kmp_depnode_t *source,
+                                                     kmp_depnode_t *sink) {
+  kmp_depnode_list_t *head =
+      source->dn.successors.load(std::memory_order_acquire);
+  if (head == KMP_DEPNODE_RELEASED)
+    return 0;
+  kmp_depnode_list_t *item = __kmp_add_node(thread, head, sink);
+  // On failure, the CAS reloads the current head into item->next
+  while (!source->dn.successors.compare_exchange_weak(
+      item->next, item, std::memory_order_release,
+      std::memory_order_acquire)) {
+    if (item->next == KMP_DEPNODE_RELEASED) {
+      // The task completed meanwhile
+      item->next = NULL;
+      __kmp_depnode_list_free(thread, item);
+      return 0;
+    }
+  }
+  return 1;
+}
+
+static inline kmp_int32
+__kmp_depnode_add_successor(kmp_int32 gtid, kmp_info_t *thread,
+                            kmp_task_t *task, kmp_depnode_t *source,
+                            kmp_depnode_t *sink) {
+  if (!source->dn.task)
+    return 0;
+  kmp_int32 npredecessors;
+  if (__kmp_track_dependences()) {
+    KMP_ACQUIRE_DEPNODE(gtid, source);
+    npredecessors = 0;
+    if (source->dn.task) {
+      __kmp_track_dependence(gtid, source, sink, task);
+      npredecessors = __kmp_depnode_push_successor(thread, source, sink);
+    }
+    KMP_RELEASE_DEPNODE(gtid, source);
+  } else {
+    npredecessors = __kmp_depnode_push_successor(thread, source, sink);
+  }
+  if (npredecessors) {
+    KA_TRACE(40, ("__kmp_process_deps: T#%d adding dependence from %p to %p\n",
+                  gtid, source, sink));
+  }
+  return npredecessors;
+}
+
 static inline kmp_int32
 __kmp_depnode_link_successor(kmp_int32 gtid, kmp_info_t *thread,
                              kmp_task_t *task, kmp_depnode_t *node,
@@ -244,22 +305,9 @@ __kmp_depnode_link_successor(kmp_int32 gtid, kmp_info_t *thread,
     return 0;
   kmp_int32 npredecessors = 0;
   // link node as successor of list elements
-  for (kmp_depnode_list_t *p = plist; p; p = p->next) {
-    kmp_depnode_t *dep = p->node;
-    if (dep->dn.task) {
-      KMP_ACQUIRE_DEPNODE(gtid, dep);
-      if (dep->dn.task) {
-        __kmp_track_dependence(gtid, dep, node, task);
-        dep->dn.successors = __kmp_add_node(thread, dep->dn.successors, node);
-        KA_TRACE(40, ("__kmp_process_deps: T#%d adding dependence from %p to "
-                      "%p\n",
-                      gtid, KMP_TASK_TO_TASKDATA(dep->dn.task),
-                      KMP_TASK_TO_TASKDATA(task)));
-        npredecessors++;
-      }
-      KMP_RELEASE_DEPNODE(gtid, dep);
-    }
-  }
+  for (kmp_depnode_list_t *p = plist; p; p = p->next)
+    npredecessors +=
+        __kmp_depnode_add_successor(gtid, thread, task, p->node, node);
   return npredecessors;
 }
 
@@ -270,22 +318,8 @@ static inline kmp_int32 __kmp_depnode_link_successor(kmp_int32 gtid,
                                                      kmp_depnode_t *sink) {
   if (!sink)
     return 0;
-  kmp_int32 npredecessors = 0;
-  if (sink->dn.task) {
-    // synchronously add source to sink' list of successors
-    KMP_ACQUIRE_DEPNODE(gtid, sink);
-    if (sink->dn.task) {
-      __kmp_track_dependence(gtid, sink, source, task);
-      sink->dn.successors = __kmp_add_node(thread, sink->dn.successors, source);
-      KA_TRACE(40, ("__kmp_process_deps: T#%d adding dependence from %p to "
-                    "%p\n",
-                    gtid, KMP_TASK_TO_TASKDATA(sink->dn.task),
-                    KMP_TASK_TO_TASKDATA(task)));
-      npredecessors++;
-    }
-    KMP_RELEASE_DEPNODE(gtid, sink);
-  }
-  return npredecessors;
+  // add source to sink' list of successors
+  return __kmp_depnode_add_successor(gtid, thread, task, sink, source);
 }
 
 template <bool filter>
@@ -20,6 +20,9 @@
 #define KMP_ACQUIRE_DEPNODE(gtid, n) __kmp_acquire_lock(&(n)->dn.lock, (gtid))
 #define KMP_RELEASE_DEPNODE(gtid, n) __kmp_release_lock(&(n)->dn.lock, (gtid))
 
+// Successor list of a depnode whose task completed: no successors can be added
+#define KMP_DEPNODE_RELEASED ((kmp_depnode_list_t *)1)
+
 static inline void __kmp_node_deref(kmp_info_t *thread, kmp_depnode_t *node) {
   if (!node)
     return;
@@ -103,13 +106,17 @@ static inline void __kmp_release_deps(kmp_int32 gtid, kmp_taskdata_t *task) {
   KA_TRACE(20, ("__kmp_release_deps: T#%d notifying successors of task %p.\n",
                 gtid, task));
 
+  // The lock only waits for dependence tools looking at the task, successors
+  // are added without it
   KMP_ACQUIRE_DEPNODE(gtid, node);
   node->dn.task =
       NULL; // mark this task as finished, so no new dependencies are generated
+  kmp_depnode_list_t *successors =
+      node->dn.successors.exchange(KMP_DEPNODE_RELEASED);
   KMP_RELEASE_DEPNODE(gtid, node);
 
   kmp_depnode_list_t *next;
-  for (kmp_depnode_list_t *p = node->dn.successors; p; p = next) {
+  for (kmp_depnode_list_t *p = successors; p; p = next) {
     kmp_depnode_t *successor = p->node;
     kmp_int32 npredecessors = KMP_ATOMIC_DEC(&successor->dn.npredecessors) - 1;
 
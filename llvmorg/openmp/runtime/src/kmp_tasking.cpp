@@ -1334,6 +1334,8 @@ kmp_task_t *__kmp_task_alloc(ident_t *loc_ref, kmp_int32 gtid,
   taskdata->td_flags.freed = 0;
 
   taskdata->td_flags.native = flags->native;
+  taskdata->td_flags.domain_affinity =
+      thread->th.th_task_affinity == task_affinity_domain;
 
   KMP_ATOMIC_ST_RLX(&taskdata->td_incomplete_child_tasks, 0);
   // start at one because counts current task and children
@@ -2660,6 +2662,30 @@ static kmp_task_t *__kmp_remove_my_task(kmp_info_t *thread, kmp_int32 gtid,
   return task;
 }
 
+// __kmp_task_domain: return the NUMA domain of the place the thread is bound
+// to, or -1 if it is unknown.
+static inline int __kmp_task_domain(kmp_info_t *thread) {
+#if KMP_AFFINITY_SUPPORTED
+  int place = thread->th.th_current_place;
+  if (__kmp_affinity_domains != NULL && place >= 0 &&
+      place < (int)__kmp_affinity_num_masks)
+    return __kmp_affinity_domains[place];
+#endif
+  return -1;
+}
+
+// __kmp_task_is_remote_steal: return true if thief and victim are known to be
+// bound to different NUMA domains.
+static inline bool __kmp_task_is_remote_steal(kmp_info_t *thief,
+                                              kmp_info_t *victim) {
+  if (__kmp_task_steal_remote_backoff == 0)
+    return false;
+  int thief_domain = __kmp_task_domain(thief);
+  int victim_domain = __kmp_task_domain(victim);
+  return thief_domain >= 0 && victim_domain >= 0 &&
+         thief_domain != victim_domain;
+}
+
 // __kmp_steal_task: remove a task from another thread's deque
 // Assume that calling thread has already checked existence of
 // task_team thread_data before calling this routine.
@@ -2674,6 +2700,7 @@ static kmp_task_t *__kmp_steal_task(kmp_info_t *victim_thr, kmp_int32 gtid,
   kmp_thread_data_t *victim_td, *threads_data;
   kmp_int32 target;
   kmp_int32 victim_tid;
+  bool remote;
 
   KMP_DEBUG_ASSERT(__kmp_tasking_mode != tskm_immediate_exec);
 
@@ -2713,7 +2740,17 @@ static kmp_task_t *__kmp_steal_task(kmp_info_t *victim_thr, kmp_int32 gtid,
 
   KMP_DEBUG_ASSERT(victim_td->td.td_deque != NULL);
   current = __kmp_threads[gtid]->th.th_current_task;
+  remote = __kmp_task_is_remote_steal(__kmp_threads[gtid], victim_thr);
   taskdata = victim_td->td.td_deque[victim_td->td.td_deque_head];
+  if (remote && taskdata->td_flags.domain_affinity) {
+    // The task asked to stay in its NUMA domain
+    __kmp_release_bootstrap_lock(&victim_td->td.td_deque_lock);
+    KA_TRACE(10, ("__kmp_steal_task(exit #3a): T#%d could not steal from "
+                  "remote T#%d: task_team=%p ntasks=%d head=%u tail=%u\n",
+                  gtid, __kmp_gtid_from_thread(victim_thr), task_team, ntasks,
+                  victim_td->td.td_deque_head, victim_td->td.td_deque_tail));
+    return NULL;
+  }
   if (__kmp_task_is_allowed(gtid, is_constrained, taskdata, current)) {
     // Bump head pointer and Wrap.
     victim_td->td.td_deque_head =
@@ -2735,7 +2772,8 @@ static kmp_task_t *__kmp_steal_task(kmp_info_t *victim_thr, kmp_int32 gtid,
     for (i = 1; i < ntasks; ++i) {
       target = (target + 1) & TASK_DEQUE_MASK(victim_td->td);
       taskdata = victim_td->td.td_deque[target];
-      if (__kmp_task_is_allowed(gtid, is_constrained, taskdata, current)) {
+      if (!(remote && taskdata->td_flags.domain_affinity) &&
+          __kmp_task_is_allowed(gtid, is_constrained, taskdata, current)) {
         break; // found victim task
       } else {
         taskdata = NULL;
@@ -2782,6 +2820,9 @@ static kmp_task_t *__kmp_steal_task(kmp_info_t *victim_thr, kmp_int32 gtid,
   __kmp_release_bootstrap_lock(&victim_td->td.td_deque_lock);
 
   KMP_COUNT_BLOCK(TASK_stolen);
+  if (remote) {
+    KMP_COUNT_BLOCK(TASK_stolen_remote);
+  }
   KA_TRACE(10,
            ("__kmp_steal_task(exit #5): T#%d stole task %p from T#%d: "
             "task_team=%p ntasks=%d head=%u tail=%u\n",
@@ -2855,6 +2896,7 @@ static inline int __kmp_execute_tasks_template(
           asleep = 0;
         } else if (!new_victim) { // no recent steals and we haven't already
           // used a new victim; select a random thread
+          int remote_skipped = 0;
           do { // Find a different thread to steal work from.
             // Pick a random thread. Initial plan was to cycle through all the
             // threads, and only return if we tried to steal from every thread,
@@ -2865,6 +2907,15 @@ static inline int __kmp_execute_tasks_template(
             }
             // Found a potential victim
             other_thread = threads_data[victim_tid].td.td_thr;
+            // Prefer victims in our own NUMA domain: a remote one is skipped
+            // until enough local steals have failed, unless we keep drawing
+            // remote ones only.
+            if (__kmp_task_is_remote_steal(thread, other_thread) &&
+                threads_data[tid].td.td_local_steal_attempts <
+                    threads_data[tid].td.td_remote_steal_backoff &&
+                ++remote_skipped < nthreads) {
+              continue;
+            }
             // There is a slight chance that __kmp_enable_tasking() did not wake
             // up all threads waiting at the barrier.  If victim is sleeping,
             // then wake it up. Since we were going to pay the cache miss
@@ -2893,9 +2944,23 @@ static inline int __kmp_execute_tasks_template(
 
         if (!asleep) {
           // We have a victim to try to steal from
+          bool remote = __kmp_task_is_remote_steal(thread, other_thread);
           task = __kmp_steal_task(other_thread, gtid, task_team,
                                   unfinished_threads, thread_finished,
                                   is_constrained);
+          kmp_base_thread_data_t *td = &threads_data[tid].td;
+          if (remote) {
+            // Back off exponentially from remote domains with no work
+            td->td_local_steal_attempts = 0;
+            if (task != NULL)
+              td->td_remote_steal_backoff = 1;
+            else
+              td->td_remote_steal_backoff =
+                  KMP_MIN(KMP_MAX(2 * td->td_remote_steal_backoff, 1),
+                          __kmp_task_steal_remote_backoff);
+          } else if (task == NULL) {
+            td->td_local_steal_attempts++;
+          }
         }
         if (task != NULL) { // set last stolen to victim
           if (threads_data[tid].td.td_deque_last_stolen != victim_tid) {
@@ -0,0 +1,96 @@
+// RUN: %libomp-compile && env OMP_PROC_BIND=close OMP_PLACES=cores %libomp-run
+// RUN: env OMP_PROC_BIND=close OMP_PLACES=cores KMP_TASK_STEAL_REMOTE_BACKOFF=0 %libomp-run
+// REQUIRES: linux
+
+// Tasking microbenchmark for NUMA-aware stealing: one thread creates all of
+// the tasks, the others steal them. Reports the throughput and the number of
+// tasks run on another package than the one of their creator, with and without
+// the kmp_set_task_affinity() hint, and checks that all of the tasks ran.
+// Run with KMP_TASK_STEAL_REMOTE_BACKOFF=0 to compare with NUMA-oblivious
+// stealing.
+
+#define _GNU_SOURCE
+#include <omp.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// kmp_task_affinity_t
+#define TASK_AFFINITY_NONE 0
+#define TASK_AFFINITY_DOMAIN 1
+
+extern void kmp_set_task_affinity(int);
+extern int kmp_get_task_affinity(void);
+
+#define NTASKS 100000
+#define MAX_CPUS 4096
+
+static int cpu_package[MAX_CPUS];
+
+static int get_package(void) {
+  int cpu = sched_getcpu();
+  return cpu >= 0 && cpu < MAX_CPUS ? cpu_package[cpu] : -1;
+}
+
+static void read_packages(void) {
+  for (int cpu = 0; cpu < MAX_CPUS; cpu++) {
+    char path[128];
+    snprintf(path, sizeof(path),
+             "/sys/devices/system/cpu/cpu%d/topology/physical_package_id", cpu);
+    FILE *f = fopen(path, "r");
+    cpu_package[cpu] = -1;
+    if (!f)
+      continue;
+    if (fscanf(f, "%d", &cpu_package[cpu]) != 1)
+      cpu_package[cpu] = -1;
+    fclose(f);
+  }
+}
+
+static volatile double sink;
+
+static void work(int package, int *remote, int *executed) {
+  double x = 0;
+  for (int i = 0; i < 200; i++)
+    x += i * 0.5;
+  sink = x;
+  if (get_package() != package) {
+#pragma omp atomic
+    (*remote)++;
+  }
+#pragma omp atomic
+  (*executed)++;
+}
+
+static int run(int affinity, const char *name) {
+  int remote = 0, executed = 0;
+  double start = omp_get_wtime();
+#pragma omp parallel
+#pragma omp single
+  {
+    kmp_set_task_affinity(affinity);
+    if (kmp_get_task_affinity() != affinity) {
+      fprintf(stderr, "kmp_get_task_affinity() != %d\n", affinity);
+      exit(1);
+    }
+    int package = get_package();
+    for (int i = 0; i < NTASKS; i++) {
+#pragma omp task firstprivate(package) shared(remote, executed)
+      work(package, &remote, &executed);
+    }
+#pragma omp taskwait
+    kmp_set_task_affinity(TASK_AFFINITY_NONE);
+  }
+  double elapsed = omp_get_wtime() - start;
+  printf("%-8s %10.0f tasks/s, %d of %d tasks run on a remote package\n", name,
+         executed / elapsed, remote, executed);
+  return executed == NTASKS;
+}
+
+int main(void) {
+  read_packages();
+  int passed = run(TASK_AFFINITY_NONE, "none") &&
+               run(TASK_AFFINITY_DOMAIN, "domain");
+  printf(passed ? "passed\n" : "failed\n");
+  return !passed;
+}